@@ -0,0 +1,58 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/bench/foray_hostbenchmark.hpp"
+#include "../src/scene/foray_scenedrawing.hpp"
+#include "../src/util/foray_workerpool.hpp"
+#include "../tests/foray_testanimation.hpp"
+#include "foray_bench.hpp"
+#include <algorithm>
+#include <string>
+#include <thread>
+
+using namespace foray;
+
+/// @brief AnimationManager::Update for 1000 animated characters, evaluated serially and on worker pools of increasing size
+
+const uint32_t CHARACTER_COUNT = 1000;
+const uint32_t BONE_COUNT      = 30;
+const uint32_t FRAME_COUNT     = 200;
+
+/// @brief Times the animation update only, transforms are not recalculated
+void RunScenario(scene::gcomp::AnimationManager* manager, util::WorkerPool* pool)
+{
+    manager->SetWorkerPool(pool);
+    base::FrameRenderInfo  renderInfo;
+    scene::SceneUpdateInfo updateInfo(renderInfo, (VkCommandBuffer) nullptr);
+    renderInfo.SetFrameTime(1.f / 60.f);
+
+    bench::HostBenchmark benchmark;
+    for(uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        benchmark.Begin();
+        manager->Update(updateInfo);
+        benchmark.LogTimestamp("Update");
+        benchmark.End();
+    }
+    manager->SetWorkerPool(nullptr);
+
+    std::string title = std::to_string(CHARACTER_COUNT) + " characters, " + std::to_string(CHARACTER_COUNT * BONE_COUNT * 3) + " channels, ";
+    title += !!pool ? std::to_string(pool->GetThreadCount() + 1) + " threads" : std::string("serial");
+    benchmarks::PrintSummary(title, benchmark);
+}
+
+int main()
+{
+    scene::Scene                    scene(nullptr);
+    scene::gcomp::AnimationManager* manager = test::MakeAnimatedCharacters(scene, CHARACTER_COUNT, BONE_COUNT, 42);
+
+    RunScenario(manager, nullptr);
+    const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    for(uint32_t threads = 2; threads <= hardwareThreads; threads *= 2)
+    {
+        util::WorkerPool pool;
+        // The calling thread participates in loops
+        pool.Create(threads - 1);
+        RunScenario(manager, &pool);
+        pool.Destroy();
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "../src/bench/foray_benchmarkbase.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace foray::benchmarks {
+    /// @brief Prints mean and minimum of every timestamp delta, the total and every value over all logs of benchmark
+    inline void PrintSummary(std::string_view title, const bench::BenchmarkBase& benchmark)
+    {
+        struct Row
+        {
+            std::string_view Id;
+            fp64_t           Sum = 0.0;
+            fp64_t           Min = std::numeric_limits<fp64_t>::max();
+            size_t           Count = 0;
+        };
+        std::vector<Row> deltas;
+        std::vector<Row> values;
+        auto             lAdd = [](std::vector<Row>& rows, std::string_view id, fp64_t value) {
+            auto iter = std::find_if(rows.begin(), rows.end(), [&](const Row& row) { return row.Id == id; });
+            if(iter == rows.end())
+            {
+                rows.push_back(Row{.Id = id});
+                iter = rows.end() - 1;
+            }
+            iter->Sum += value;
+            iter->Min = std::min(iter->Min, value);
+            iter->Count++;
+        };
+        for(const bench::BenchmarkLog& log : benchmark.GetLogs())
+        {
+            // Deltas[i] is the time passed from Timestamps[i] to Timestamps[i + 1]
+            for(size_t i = 0; i < log.Deltas.size(); i++)
+            {
+                lAdd(deltas, log.Timestamps[i + 1].Id, log.Deltas[i]);
+            }
+            lAdd(deltas, "Total", log.End - log.Begin);
+            for(const bench::BenchmarkValue& value : log.Values)
+            {
+                lAdd(values, value.Id, value.Value);
+            }
+        }
+
+        std::printf("%.*s (%zu runs)\n", (int)title.size(), title.data(), benchmark.GetLogs().size());
+        std::printf("  %-28s | %14s | %14s\n", "Id", "Mean [ms]", "Min [ms]");
+        for(const Row& row : deltas)
+        {
+            std::printf("  %-28.*s | %14.5f | %14.5f\n", (int)row.Id.size(), row.Id.data(), row.Sum / (fp64_t)row.Count, row.Min);
+        }
+        for(const Row& row : values)
+        {
+            std::printf("  %-28.*s | %14.1f | %14.1f\n", (int)row.Id.size(), row.Id.data(), row.Sum / (fp64_t)row.Count, row.Min);
+        }
+        std::printf("\n");
+    }
+
+    /// @brief Prints why a benchmark did not run. Benchmarks exit normally afterwards
+    inline int Skip(std::string_view reason)
+    {
+        std::printf("Skipped: %.*s\n", (int)reason.size(), reason.data());
+        return 0;
+    }
+}  // namespace foray::benchmarks
@@ -0,0 +1,103 @@
+#include "../src/bench/foray_hostbenchmark.hpp"
+#include "../src/scene/foray_callbackdispatcher.hpp"
+#include "../src/scene/foray_registry.hpp"
+#include "foray_bench.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+
+using namespace foray;
+
+/// @brief Registry::GetComponent throughput on registries holding 1, 4 and 16 components, compared to the dynamic_cast scan it replaces
+
+const uint32_t LOOKUP_COUNT = 1000000;
+const uint32_t RUN_COUNT    = 20;
+
+template <uint32_t N>
+class LookupComponent : public scene::NodeComponent
+{
+};
+
+/// @brief Never registered
+class MissingComponent : public scene::NodeComponent
+{
+};
+
+/// @brief Keeps lookup results alive
+volatile uintptr_t gSink = 0;
+
+/// @brief The lookup as done before caching: First component that can be cast to TComponent
+template <typename TComponent>
+TComponent* ScanLookup(const scene::Registry& registry)
+{
+    for(scene::Component* component : registry.GetComponents())
+    {
+        TComponent* result = dynamic_cast<TComponent*>(component);
+        if(result)
+        {
+            return result;
+        }
+    }
+    return nullptr;
+}
+
+/// @brief Queries the last registered component type (the worst case for the scan), a base class and a type not registered
+template <uint32_t Count>
+void RunLookups()
+{
+    using TLast = LookupComponent<Count - 1>;
+
+    scene::CallbackDispatcher dispatcher;
+    scene::Registry           registry(&dispatcher);
+    [&]<uint32_t... I>(std::integer_sequence<uint32_t, I...>) { (registry.MakeComponent<LookupComponent<I>>(), ...); }(std::make_integer_sequence<uint32_t, Count>{});
+    const scene::Registry& constRegistry = registry;
+
+    bench::HostBenchmark benchmark;
+    for(uint32_t run = 0; run < RUN_COUNT; run++)
+    {
+        uintptr_t sink = 0;
+        benchmark.Begin();
+        for(uint32_t i = 0; i < LOOKUP_COUNT; i++)
+        {
+            sink += (uintptr_t)ScanLookup<TLast>(registry);
+        }
+        benchmark.LogTimestamp("Scan");
+        for(uint32_t i = 0; i < LOOKUP_COUNT; i++)
+        {
+            sink += (uintptr_t)registry.GetComponent<TLast>();
+        }
+        benchmark.LogTimestamp("Cached");
+        for(uint32_t i = 0; i < LOOKUP_COUNT; i++)
+        {
+            sink += (uintptr_t)constRegistry.GetComponent<TLast>();
+        }
+        benchmark.LogTimestamp("Cached (const)");
+        for(uint32_t i = 0; i < LOOKUP_COUNT; i++)
+        {
+            sink += (uintptr_t)registry.GetComponent<scene::NodeComponent>();
+        }
+        benchmark.LogTimestamp("Cached base class");
+        for(uint32_t i = 0; i < LOOKUP_COUNT; i++)
+        {
+            sink += (uintptr_t)ScanLookup<MissingComponent>(registry);
+        }
+        benchmark.LogTimestamp("Scan miss");
+        for(uint32_t i = 0; i < LOOKUP_COUNT; i++)
+        {
+            sink += (uintptr_t)registry.GetComponent<MissingComponent>();
+        }
+        benchmark.LogTimestamp("Cached miss");
+        benchmark.End();
+        gSink = gSink + sink;
+    }
+    std::string title = std::to_string(LOOKUP_COUNT) + " lookups, " + std::to_string(Count) + " components";
+    benchmarks::PrintSummary(title, benchmark);
+}
+
+int main()
+{
+    RunLookups<1>();
+    RunLookups<4>();
+    RunLookups<16>();
+    return 0;
+}
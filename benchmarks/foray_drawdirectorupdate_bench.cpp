@@ -0,0 +1,101 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/bench/foray_hostbenchmark.hpp"
+#include "../src/core/foray_commandbuffer.hpp"
+#include "../src/scene/components/foray_meshinstance.hpp"
+#include "../src/scene/components/foray_transform.hpp"
+#include "../src/scene/foray_mesh.hpp"
+#include "../src/scene/foray_node.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/foray_scenedrawing.hpp"
+#include "../src/scene/globalcomponents/foray_drawmanager.hpp"
+#include "../src/scene/globalcomponents/foray_geometrymanager.hpp"
+#include "../tests/foray_testdevice.hpp"
+#include "foray_bench.hpp"
+#include <memory>
+
+using namespace foray;
+
+/// @brief CPU time of DrawDirector::Update for 50k static and 500 animated instances, compared to the same scene without static flags
+/// and to every instance moving (the cost of uploading all transforms every frame)
+
+const uint32_t STATIC_COUNT   = 50000;
+const uint32_t ANIMATED_COUNT = 500;
+const uint32_t FRAME_COUNT    = 200;
+
+/// @brief Builds the scene, moves the animated instances (or all, if moveAll) every frame and measures Update()
+void RunScenario(core::Context* context, std::string_view title, bool markStatic, bool moveAll)
+{
+    scene::Scene scene(context);
+    auto         geo          = scene.GetComponent<scene::gcomp::GeometryStore>();
+    auto         drawDirector = scene.GetComponent<scene::gcomp::DrawDirector>();
+
+    for(uint32_t corner = 0; corner < 3; corner++)
+    {
+        scene::Vertex vertex{};
+        vertex.Pos = glm::vec3(corner == 1 ? 1.f : 0.f, corner == 2 ? 1.f : 0.f, 0.f);
+        geo->GetVertices().push_back(vertex);
+        geo->GetIndices().push_back(corner);
+    }
+    auto mesh = std::make_unique<scene::Mesh>();
+    mesh->SetPrimitives({scene::Primitive(scene::Primitive::EType::Index, 0U, 3U, 0, 2, geo->GetVertices(), {})});
+    scene::Mesh* meshPtr = mesh.get();
+    geo->GetMeshes().push_back(std::move(mesh));
+    geo->InitOrUpdate();
+
+    std::vector<scene::ncomp::Transform*> moving;
+    for(uint32_t i = 0; i < STATIC_COUNT + ANIMATED_COUNT; i++)
+    {
+        scene::Node* node = scene.MakeNode();
+        node->MakeComponent<scene::ncomp::MeshInstance>()->SetMesh(meshPtr);
+        scene::ncomp::Transform* transform = node->GetTransform();
+        transform->SetTranslation(glm::vec3((fp32_t)(i % 256), (fp32_t)(i / 256), 0.f));
+        bool animated = i % ((STATIC_COUNT + ANIMATED_COUNT) / ANIMATED_COUNT) == 0;
+        transform->SetStatic(markStatic && !animated);
+        if(animated || moveAll)
+        {
+            moving.push_back(transform);
+        }
+    }
+    drawDirector->InitOrUpdate();
+
+    bench::HostBenchmark benchmark;
+    core::HostSyncCommandBuffer cmdBuffer;
+    cmdBuffer.Create(context);
+    base::FrameRenderInfo renderInfo;
+    for(uint32_t frame = 1; frame <= FRAME_COUNT; frame++)
+    {
+        for(scene::ncomp::Transform* transform : moving)
+        {
+            glm::vec3 translation = transform->GetTranslation();
+            translation.z         = (fp32_t)frame;
+            transform->SetTranslation(translation);
+        }
+        renderInfo.SetFrameNumber(frame);
+        cmdBuffer.Begin();
+        scene::SceneUpdateInfo updateInfo(renderInfo, cmdBuffer);
+        // The first frames upload every matrix to both sets, only measure the steady state
+        drawDirector->SetBenchmark(frame > 2 ? &benchmark : nullptr);
+        drawDirector->Update(updateInfo);
+        cmdBuffer.SubmitAndWait();
+    }
+    drawDirector->SetBenchmark(nullptr);
+    benchmarks::PrintSummary(title, benchmark);
+    cmdBuffer.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(false))
+    {
+        return benchmarks::Skip("No Vulkan 1.3 device");
+    }
+    core::Context* context = &device.GetContext();
+
+    RunScenario(context, "DrawDirector::Update, 50k static + 500 animated", true, false);
+    RunScenario(context, "DrawDirector::Update, 50.5k not marked static, 500 animated", false, false);
+    RunScenario(context, "DrawDirector::Update, 50.5k animated", false, true);
+
+    device.Destroy();
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "../src/bench/foray_hostbenchmark.hpp"
+#include "../src/scene/foray_animation.hpp"
+#include "foray_bench.hpp"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace foray;
+
+/// @brief Keyframe selection on a 10k keyframe clip during playback and random seeks: Cursor and binary search compared to the former linear scans
+
+const uint32_t KEYFRAME_COUNT = 10000;
+const uint32_t SAMPLE_COUNT   = 10000;
+const uint32_t RUN_COUNT      = 5;
+
+/// @brief Exposes the protected keyframe selection
+struct BenchSampler : public scene::AnimationSampler
+{
+    using AnimationSampler::SelectKeyframe;
+};
+
+/// @brief Keyframe selection as implemented before the cursor and binary search: forward scan for lower, backward scan for upper
+void SelectKeyframeLinear(const std::vector<scene::AnimationKeyframe>& keyframes, float time, const scene::AnimationKeyframe*& lower, const scene::AnimationKeyframe*& upper)
+{
+    int32_t lowerIndex = 0;
+    int32_t upperIndex = (int32_t)keyframes.size() - 1;
+    while(lowerIndex + 1 < (int32_t)keyframes.size() && keyframes[lowerIndex + 1].Time <= time)
+    {
+        lowerIndex++;
+    }
+    while(upperIndex - 1 >= 0 && keyframes[upperIndex - 1].Time >= time)
+    {
+        upperIndex--;
+    }
+    lower = &keyframes[lowerIndex];
+    upper = &keyframes[upperIndex];
+}
+
+/// @brief Selects keyframes for all sample times with both implementations
+void RunScenario(const BenchSampler& sampler, std::string_view title, const std::vector<float>& times)
+{
+    bench::HostBenchmark benchmark;
+    fp32_t               sink = 0.f;
+    for(uint32_t run = 0; run < RUN_COUNT; run++)
+    {
+        const scene::AnimationKeyframe* lower = nullptr;
+        const scene::AnimationKeyframe* upper = nullptr;
+        benchmark.Begin();
+        for(float time : times)
+        {
+            SelectKeyframeLinear(sampler.Keyframes, time, lower, upper);
+            sink += lower->Time + upper->Time;
+        }
+        benchmark.LogTimestamp("Linear scan");
+        for(float time : times)
+        {
+            sampler.SelectKeyframe(time, lower, upper);
+            sink += lower->Time + upper->Time;
+        }
+        benchmark.LogTimestamp("SelectKeyframe");
+        for(float time : times)
+        {
+            sink += sampler.SampleVec(time).x;
+        }
+        benchmark.LogTimestamp("SampleVec");
+        benchmark.End();
+    }
+    benchmarks::PrintSummary(std::string(title) + ", " + std::to_string(times.size()) + " samples", benchmark);
+    std::printf("(checksum %f)\n\n", (fp64_t)sink);
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    BenchSampler sampler;
+    sampler.Interpolation = scene::EAnimationInterpolation::Linear;
+    for(uint32_t i = 0; i < KEYFRAME_COUNT; i++)
+    {
+        sampler.Keyframes.push_back(scene::AnimationKeyframe((float)i / 30.f, glm::vec4((float)i)));
+    }
+    const float duration = sampler.Keyframes.back().Time;
+
+    // Playback at 60 fps, looping
+    std::vector<float> playback;
+    for(uint32_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        playback.push_back(std::fmod((float)i / 60.f, duration));
+    }
+    RunScenario(sampler, "10k keyframes, playback", playback);
+
+    std::vector<float>                    seeks;
+    std::uniform_real_distribution<float> time(0.f, duration);
+    for(uint32_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        seeks.push_back(time(rng));
+    }
+    RunScenario(sampler, "10k keyframes, random seeks", seeks);
+    return 0;
+}
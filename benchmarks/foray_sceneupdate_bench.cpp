@@ -0,0 +1,97 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/bench/foray_hostbenchmark.hpp"
+#include "../src/core/foray_context.hpp"
+#include "../src/scene/foray_scenedrawing.hpp"
+#include "../src/util/foray_workerpool.hpp"
+#include "../tests/foray_testanimation.hpp"
+#include "foray_bench.hpp"
+#include <algorithm>
+#include <string>
+#include <thread>
+
+using namespace foray;
+
+/// @brief Scene::Update speedup from concurrent update callbacks. A host only scene animates 500 characters, recalculates transforms and then runs four
+/// independent transform readers, standing in for the draw director, camera, light and tlas managers (which require a device)
+
+const uint32_t CHARACTER_COUNT = 500;
+const uint32_t BONE_COUNT      = 30;
+const uint32_t FRAME_COUNT     = 200;
+
+/// @brief Reads all world matrices after the TransformSystem and derives normal matrices, writing only its own data category
+class TransformReader : public scene::GlobalComponent, public scene::Component::UpdateCallback
+{
+  public:
+    TransformReader(uint32_t writes, const std::vector<scene::Node*>* nodes) : mWrites(writes), mNodes(nodes) {}
+
+    virtual void Update(scene::SceneUpdateInfo&) override
+    {
+        mNormalMatrices.resize(mNodes->size());
+        for(size_t i = 0; i < mNodes->size(); i++)
+        {
+            mNormalMatrices[i] = glm::transpose(glm::inverse(glm::mat3((*mNodes)[i]->GetTransform()->GetGlobalMatrix())));
+        }
+    }
+    virtual int32_t  GetOrder() const override { return ORDER_DEVICEUPLOAD; }
+    virtual uint32_t GetUpdateReads() const override { return DATA_TRANSFORMS; }
+    virtual uint32_t GetUpdateWrites() const override { return mWrites; }
+    virtual bool     GetUpdateRecordsCommands() const override { return false; }
+
+  protected:
+    uint32_t                         mWrites;
+    const std::vector<scene::Node*>* mNodes;
+    std::vector<glm::mat3>           mNormalMatrices;
+};
+
+void RunScenario(scene::Scene& scene, core::Context* context, util::WorkerPool* pool)
+{
+    if(!!pool)
+    {
+        scene.EnableParallelUpdate(context, pool);
+    }
+    base::FrameRenderInfo renderInfo;
+    renderInfo.SetFrameTime(1.f / 60.f);
+
+    bench::HostBenchmark benchmark;
+    for(uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        renderInfo.SetFrameNumber(frame);
+        benchmark.Begin();
+        scene.Update(renderInfo, (VkCommandBuffer) nullptr);
+        benchmark.LogTimestamp("Scene::Update");
+        benchmark.End();
+    }
+    scene.DisableParallelUpdate();
+
+    std::string title = "Scene::Update, " + std::to_string(scene.GetUpdateWaves().size()) + " waves, ";
+    title += !!pool ? std::to_string(pool->GetThreadCount() + 1) + " threads" : std::string("serial");
+    benchmarks::PrintSummary(title, benchmark);
+}
+
+int main()
+{
+    using C = scene::Component::UpdateCallback;
+
+    scene::Scene scene(nullptr);
+    test::MakeAnimatedCharacters(scene, CHARACTER_COUNT, BONE_COUNT, 42);
+    std::vector<scene::Node*> nodes;
+    scene.FindNodesWithComponent<scene::ncomp::Transform>(nodes);
+    for(uint32_t writes : {C::DATA_DRAWDATA, C::DATA_CAMERAS, C::DATA_LIGHTS, C::DATA_TLAS})
+    {
+        scene.MakeComponent<TransformReader>(writes, &nodes);
+    }
+
+    // No device is used, as no callback records commands
+    core::Context context;
+    RunScenario(scene, &context, nullptr);
+    const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    for(uint32_t threads = 2; threads <= hardwareThreads; threads *= 2)
+    {
+        util::WorkerPool pool;
+        // The calling thread participates in loops
+        pool.Create(threads - 1);
+        RunScenario(scene, &context, &pool);
+        pool.Destroy();
+    }
+    return 0;
+}
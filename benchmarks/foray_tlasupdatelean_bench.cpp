@@ -0,0 +1,97 @@
+#include "../src/as/foray_blas.hpp"
+#include "../src/as/foray_tlas.hpp"
+#include "../src/bench/foray_hostbenchmark.hpp"
+#include "../src/core/foray_commandbuffer.hpp"
+#include "../src/scene/foray_mesh.hpp"
+#include "../src/scene/globalcomponents/foray_geometrymanager.hpp"
+#include "../tests/foray_testdevice.hpp"
+#include "foray_bench.hpp"
+#include <memory>
+
+using namespace foray;
+
+/// @brief CPU time of Tlas::UpdateLean for 100k animated instances, of which 1% move per frame (scattered or clustered), compared to all of them moving
+
+const uint32_t INSTANCE_COUNT = 100000;
+const uint32_t FRAME_COUNT    = 200;
+
+/// @brief Geometry store holding a single triangle mesh
+class TriangleStore : public scene::gcomp::GeometryStore
+{
+  public:
+    void Fill(core::Context* context)
+    {
+        for(uint32_t corner = 0; corner < 3; corner++)
+        {
+            scene::Vertex vertex{};
+            vertex.Pos = glm::vec3(corner == 1 ? 1.f : 0.f, corner == 2 ? 1.f : 0.f, 0.f);
+            mIndices.push_back(corner);
+            mVertices.push_back(vertex);
+        }
+        scene::Primitive primitive(scene::Primitive::EType::Index, 0U, 3U, 0, 2, mVertices, {});
+        auto             mesh = std::make_unique<scene::Mesh>();
+        mesh->SetPrimitives({primitive});
+        mMeshes.push_back(std::move(mesh));
+
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+                                   | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+        mVerticesBuffer.Create(context, usage, mVertices.size() * sizeof(scene::Vertex), VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        mIndicesBuffer.Create(context, usage, mIndices.size() * sizeof(uint32_t), VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        mVerticesBuffer.WriteDataDeviceLocal(mVertices.data(), mVertices.size() * sizeof(scene::Vertex));
+        mIndicesBuffer.WriteDataDeviceLocal(mIndices.data(), mIndices.size() * sizeof(uint32_t));
+    }
+};
+
+/// @brief Moves every stride-th instance of the first count instances each frame and measures UpdateLean
+void RunScenario(core::Context* context, const as::Blas& blas, std::string_view title, uint32_t stride, uint32_t count)
+{
+    std::vector<glm::mat4> transforms(INSTANCE_COUNT, glm::mat4(1.f));
+    as::Tlas               tlas;
+    for(uint32_t i = 0; i < INSTANCE_COUNT; i++)
+    {
+        tlas.AddBlasInstanceAnimated(blas, [&transforms, i](glm::mat4& out_transform) { out_transform = transforms[i]; });
+    }
+    tlas.CreateOrUpdate(context);
+
+    core::HostSyncCommandBuffer cmdBuffer;
+    cmdBuffer.Create(context);
+    bench::HostBenchmark benchmark;
+    for(uint32_t frame = 1; frame <= FRAME_COUNT; frame++)
+    {
+        for(uint32_t i = 0; i < count; i += stride)
+        {
+            transforms[i][3].x = (fp32_t)frame;
+        }
+        cmdBuffer.Begin();
+        benchmark.Begin();
+        tlas.UpdateLean(cmdBuffer, frame % INFLIGHT_FRAME_COUNT);
+        benchmark.End();
+        cmdBuffer.SubmitAndWait();
+    }
+    benchmarks::PrintSummary(title, benchmark);
+    cmdBuffer.Destroy();
+    tlas.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(false, true) || !device.HasAccelerationStructure())
+    {
+        return benchmarks::Skip("No device with acceleration structure support");
+    }
+    core::Context* context = &device.GetContext();
+
+    TriangleStore store;
+    store.Fill(context);
+    scene::Mesh* mesh = store.GetMeshes().front().get();
+    mesh->BuildAccelerationStructure(context, &store);
+
+    RunScenario(context, mesh->GetBlas(), "UpdateLean, 1% dirty, scattered", 100, INSTANCE_COUNT);
+    RunScenario(context, mesh->GetBlas(), "UpdateLean, 1% dirty, clustered", 1, INSTANCE_COUNT / 100);
+    RunScenario(context, mesh->GetBlas(), "UpdateLean, 100% dirty", 1, INSTANCE_COUNT);
+
+    store.Destroy();
+    device.Destroy();
+    return 0;
+}
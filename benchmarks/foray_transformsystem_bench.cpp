@@ -0,0 +1,94 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/bench/foray_hostbenchmark.hpp"
+#include "../src/scene/components/foray_transform.hpp"
+#include "../src/scene/foray_node.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/foray_scenedrawing.hpp"
+#include "../src/scene/globalcomponents/foray_transformsystem.hpp"
+#include "foray_bench.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace foray;
+
+/// @brief World matrix evaluation of a 100k node hierarchy: TransformSystem::Update compared to the recursive Transform::GetGlobalMatrix() path
+
+const uint32_t NODE_COUNT  = 100000;
+const uint32_t ROOT_COUNT  = 100;
+const uint32_t FRAME_COUNT = 50;
+
+/// @brief Identical host only hierarchies. Parents are picked among the preceding 1000 nodes, which yields deep chains
+struct ScenePair
+{
+    scene::Scene              System{nullptr};
+    scene::Scene              Recursive{nullptr};
+    std::vector<scene::Node*> SystemNodes;
+    std::vector<scene::Node*> RecursiveNodes;
+
+    ScenePair()
+    {
+        std::mt19937 rng(42);
+        for(uint32_t i = 0; i < NODE_COUNT; i++)
+        {
+            int32_t parent = -1;
+            if(i >= ROOT_COUNT)
+            {
+                parent = (int32_t)(i - 1 - rng() % std::min(i, 1000U));
+            }
+            SystemNodes.push_back(System.MakeNode(parent >= 0 ? SystemNodes[parent] : nullptr));
+            RecursiveNodes.push_back(Recursive.MakeNode(parent >= 0 ? RecursiveNodes[parent] : nullptr));
+            glm::vec3 translation((fp32_t)(i % 7), (fp32_t)(i % 5), (fp32_t)(i % 3));
+            SystemNodes.back()->GetTransform()->SetTranslation(translation);
+            RecursiveNodes.back()->GetTransform()->SetTranslation(translation);
+        }
+    }
+};
+
+/// @brief Rotates every stride-th node each frame, then evaluates all world matrices with both paths
+void RunScenario(ScenePair& scenes, std::string_view title, uint32_t stride)
+{
+    scene::gcomp::TransformSystem* system = scenes.System.GetComponent<scene::gcomp::TransformSystem>();
+    base::FrameRenderInfo          renderInfo;
+    scene::SceneUpdateInfo         updateInfo(renderInfo, (VkCommandBuffer) nullptr);
+
+    bench::HostBenchmark systemBenchmark;
+    bench::HostBenchmark recursiveBenchmark;
+    fp32_t               sink = 0.f;
+    for(uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        glm::quat rotation = glm::angleAxis(0.01f * (fp32_t)frame, glm::vec3(0.f, 1.f, 0.f));
+        for(uint32_t i = frame % stride; i < NODE_COUNT; i += stride)
+        {
+            scenes.SystemNodes[i]->GetTransform()->SetRotation(rotation);
+            scenes.RecursiveNodes[i]->GetTransform()->SetRotation(rotation);
+        }
+
+        system->SetBenchmark(&systemBenchmark);
+        system->Update(updateInfo);
+        system->SetBenchmark(nullptr);
+
+        recursiveBenchmark.Begin();
+        for(scene::Node* node : scenes.RecursiveNodes)
+        {
+            sink += node->GetTransform()->GetGlobalMatrix()[3][0];
+        }
+        recursiveBenchmark.LogTimestamp("GetGlobalMatrix()");
+        recursiveBenchmark.End();
+    }
+    benchmarks::PrintSummary(std::string(title) + ", TransformSystem::Update", systemBenchmark);
+    benchmarks::PrintSummary(std::string(title) + ", recursive", recursiveBenchmark);
+    std::printf("(checksum %f)\n\n", (fp64_t)sink);
+}
+
+int main()
+{
+    ScenePair scenes;
+    // Flattens the hierarchy, not measured
+    scenes.System.GetComponent<scene::gcomp::TransformSystem>()->InitOrUpdate();
+
+    RunScenario(scenes, "100k nodes, 1% rotated", 100);
+    RunScenario(scenes, "100k nodes, all rotated", 1);
+    return 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "foray_blas.hpp"
+#include "foray_blasbatchbuilder.hpp"
 #include "foray_blasinstance.hpp"
 #include "foray_geometrymetabuffer.hpp"
 #include "foray_tlas.hpp"
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 namespace foray::as {
     class Blas;
+    class BlasBatchBuilder;
     class Tlas;
     class BlasInstance;
     struct GeometryMeta;
@@ -10,22 +10,127 @@ namespace foray::as {
 
     void Blas::CreateOrUpdate(core::Context* context, const scene::Mesh* mesh, const scene::gcomp::GeometryStore* store, bench::HostBenchmark* benchmark)
     {
-        // STEP #0    Reset state
         if(!!benchmark)
         {
             benchmark->Begin();
         }
 
+        // STEP #1    Reset state, build geometries and fetch build sizes
+
+        BuildInfo buildInfo;
+        PrepareBuild(context, mesh, store, buildInfo, benchmark);
+
+        // STEP #2    Create scratch buffer
+
+        VkPhysicalDeviceAccelerationStructurePropertiesKHR asProperties{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
+        {
+            VkPhysicalDeviceProperties2 prop2{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &asProperties};
+            vkGetPhysicalDeviceProperties2(mContext->PhysicalDevice(), &prop2);
+        }
+
+        core::ManagedBuffer             scratchBuffer;
+        std::string                     scratchName = fmt::format("Blas #{:x} scratch", reinterpret_cast<uint64_t>(mMesh));
+        core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, buildInfo.BuildSizesInfo.buildScratchSize,
+                                           VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT, scratchName);
+        ci.Alignment = asProperties.minAccelerationStructureScratchOffsetAlignment;
+        scratchBuffer.Create(mContext, ci);
+        buildInfo.BuildGeometryInfo.scratchData.deviceAddress = scratchBuffer.GetDeviceAddress();
+
+        // STEP #3    Create the Blas
+
+        CreateAccelerationStructure(buildInfo);
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_CREATE);
+        }
+
+        // STEP #4   Build the Blas
+
+        core::HostSyncCommandBuffer commandBuffer;
+        commandBuffer.Create(context);
+        commandBuffer.Begin();
+
+        VkQueryPool queryPool = nullptr;
+        if(mAllowCompaction)
+        {
+            VkQueryPoolCreateInfo queryPoolCi{.sType      = VkStructureType::VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                              .queryType  = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+                                              .queryCount = 1U};
+            AssertVkResult(mContext->VkbDispatchTable->createQueryPool(&queryPoolCi, nullptr, &queryPool));
+            mContext->VkbDispatchTable->cmdResetQueryPool(commandBuffer, queryPool, 0, 1);
+        }
+
+        VkAccelerationStructureBuildRangeInfoKHR* buildRangeInfosPtr = buildInfo.BuildRangeInfos.data();
+        mContext->VkbDispatchTable->cmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildInfo.BuildGeometryInfo, &buildRangeInfosPtr);
+
+        if(mAllowCompaction)
+        {
+            VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+            barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &barrier,
+                                 0, nullptr, 0, nullptr);
+            CmdWriteCompactedSize(commandBuffer, queryPool, 0);
+        }
+
+        commandBuffer.SubmitAndWait();
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_BUILD);
+        }
+
+        // STEP #5    Compact the Blas (opt-in)
+
+        if(mAllowCompaction)
+        {
+            VkDeviceSize compactedSize = 0;
+            AssertVkResult(mContext->VkbDispatchTable->getQueryPoolResults(queryPool, 0, 1, sizeof(VkDeviceSize), &compactedSize, sizeof(VkDeviceSize),
+                                                                           VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+            mContext->VkbDispatchTable->destroyQueryPool(queryPool, nullptr);
+
+            if(!!benchmark)
+            {
+                benchmark->LogTimestamp(BENCH_QUERYCOMPACTSIZE);
+            }
+
+            commandBuffer.Begin();
+            CmdCompact(commandBuffer, compactedSize);
+            commandBuffer.SubmitAndWait();
+            VkDeviceSize bytesSaved = FinishCompaction();
+
+            if(!!benchmark)
+            {
+                benchmark->LogTimestamp(BENCH_COMPACT);
+                benchmark->LogValue(BENCH_BYTESSAVED, (fp64_t)bytesSaved);
+            }
+        }
+
+        if(!!benchmark)
+        {
+            benchmark->End();
+        }
+    }
+
+    void Blas::PrepareBuild(core::Context* context, const scene::Mesh* mesh, const scene::gcomp::GeometryStore* store, BuildInfo& buildInfo, bench::HostBenchmark* benchmark)
+    {
+        // STEP #0    Reset state
+
         mContext = context;
         mMesh    = mesh;
 
-        std::string name = fmt::format("Blas #{:x}", reinterpret_cast<uint64_t>(mMesh));
-
         if(mAccelerationStructure != VK_NULL_HANDLE)
         {
             mContext->VkbDispatchTable->destroyAccelerationStructureKHR(mAccelerationStructure, nullptr);
             mAccelerationStructure = VK_NULL_HANDLE;
         }
+        FinishCompaction();
+        if(mCompacted)
+        {
+            mCompactedMemory.Destroy();
+            mCompacted = false;
+        }
         mBlasAddress = {};
 
         if(!!benchmark)
@@ -33,12 +138,6 @@ namespace foray::as {
             benchmark->LogTimestamp(BENCH_RESET);
         }
 
-        VkPhysicalDeviceAccelerationStructurePropertiesKHR asProperties{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
-        {
-            VkPhysicalDeviceProperties2 prop2{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &asProperties};
-            vkGetPhysicalDeviceProperties2(mContext->PhysicalDevice(), &prop2);
-        }
-
         // STEP #1    Build geometries (1 primitve = 1 geometry)
         auto           primitives     = mesh->GetPrimitives();
         const uint32_t primitiveCount = primitives.size();
@@ -46,9 +145,12 @@ namespace foray::as {
         VkDeviceOrHostAddressConstKHR vertex_data_device_address{.deviceAddress = store->GetVerticesBuffer().GetDeviceAddress()};
         VkDeviceOrHostAddressConstKHR index_data_device_address{.deviceAddress = store->GetIndicesBuffer().GetDeviceAddress()};
 
-        std::vector<VkAccelerationStructureBuildRangeInfoKHR> buildRangeInfos(primitiveCount);  // Counterparts to VkCmdDrawIndexed
-        std::vector<uint32_t>                                 primitiveCounts(primitiveCount);  // Counts of vertices per geometry, used to determine build size of the BLAS
-        std::vector<VkAccelerationStructureGeometryKHR>       geometries(primitiveCount);       // Additional information per geometry/primitive
+        std::vector<VkAccelerationStructureBuildRangeInfoKHR>& buildRangeInfos = buildInfo.BuildRangeInfos;
+        std::vector<uint32_t>&                                 primitiveCounts = buildInfo.PrimitiveCounts;
+        std::vector<VkAccelerationStructureGeometryKHR>&       geometries      = buildInfo.Geometries;
+        buildRangeInfos.resize(primitiveCount);
+        primitiveCounts.resize(primitiveCount);
+        geometries.resize(primitiveCount);
 
         // Template geometry with all fields set which are the same for all geometries across this BLAS
         VkAccelerationStructureGeometryKHR geometryTemplate{
@@ -87,10 +189,15 @@ namespace foray::as {
             buildRangeInfos[i] = build_range_info;
         }
 
-        VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo{};
+        VkAccelerationStructureBuildGeometryInfoKHR& buildGeometryInfo = buildInfo.BuildGeometryInfo;
+        buildGeometryInfo               = VkAccelerationStructureBuildGeometryInfoKHR{};
         buildGeometryInfo.sType         = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
         buildGeometryInfo.type          = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
         buildGeometryInfo.flags         = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+        if(mAllowCompaction)
+        {
+            buildGeometryInfo.flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
+        }
         buildGeometryInfo.mode          = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
         buildGeometryInfo.geometryCount = static_cast<uint32_t>(geometries.size());
         buildGeometryInfo.pGeometries   = geometries.data();
@@ -100,34 +207,30 @@ namespace foray::as {
             benchmark->LogTimestamp(BENCH_CREATESTRUCTS);
         }
 
-        // STEP #2    Fetch build sizes, (re)create buffers
+        // STEP #2    Fetch build sizes
 
-        VkAccelerationStructureBuildSizesInfoKHR buildSizesInfo{.sType = VkStructureType::VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR};
+        buildInfo.BuildSizesInfo = VkAccelerationStructureBuildSizesInfoKHR{.sType = VkStructureType::VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR};
         mContext->VkbDispatchTable->getAccelerationStructureBuildSizesKHR(VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &buildGeometryInfo, primitiveCounts.data(),
-                                                                          &buildSizesInfo);
+                                                                          &buildInfo.BuildSizesInfo);
 
-        if(buildSizesInfo.accelerationStructureSize > mBlasMemory.GetSize())
+        if(!!benchmark)
         {
-            mBlasMemory.Destroy();
-            mBlasMemory.Create(mContext, VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR, buildSizesInfo.accelerationStructureSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0,
-                               name);
+            benchmark->LogTimestamp(BENCH_GETSIZES);
         }
+    }
 
-        core::ManagedBuffer                          scratchBuffer;
-        std::string                                  scratchName = fmt::format("{} scratch", name);
-        core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, buildSizesInfo.buildScratchSize,
-                                                        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT, scratchName);
-        ci.Alignment = asProperties.minAccelerationStructureScratchOffsetAlignment;
-        scratchBuffer.Create(mContext, ci);
-        buildGeometryInfo.scratchData.deviceAddress = scratchBuffer.GetDeviceAddress();
+    void Blas::CreateAccelerationStructure(BuildInfo& buildInfo)
+    {
+        const VkAccelerationStructureBuildSizesInfoKHR& buildSizesInfo = buildInfo.BuildSizesInfo;
 
-        if(!!benchmark)
+        if(buildSizesInfo.accelerationStructureSize > mBlasMemory.GetSize())
         {
-            benchmark->LogTimestamp(BENCH_GETSIZES);
+            std::string name = fmt::format("Blas #{:x}", reinterpret_cast<uint64_t>(mMesh));
+            mBlasMemory.Destroy();
+            mBlasMemory.Create(mContext, VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR, buildSizesInfo.accelerationStructureSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0,
+                               name);
         }
 
-        // STEP #3    Create the Blas
-
         VkAccelerationStructureCreateInfoKHR asCi{.sType         = VkStructureType::VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
                                                   .pNext         = nullptr,
                                                   .createFlags   = 0U,
@@ -136,39 +239,72 @@ namespace foray::as {
                                                   .size          = buildSizesInfo.accelerationStructureSize,
                                                   .type          = VkAccelerationStructureTypeKHR::VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
                                                   .deviceAddress = {}};
-        mContext->VkbDispatchTable->createAccelerationStructureKHR(&asCi, nullptr, &mAccelerationStructure);
+        AssertVkResult(mContext->VkbDispatchTable->createAccelerationStructureKHR(&asCi, nullptr, &mAccelerationStructure));
 
-        buildGeometryInfo.dstAccelerationStructure = mAccelerationStructure;
+        buildInfo.BuildGeometryInfo.dstAccelerationStructure = mAccelerationStructure;
 
-        if(!!benchmark)
-        {
-            benchmark->LogTimestamp(BENCH_CREATE);
-        }
+        FetchDeviceAddress();
+    }
 
-        // STEP #4   Build the Blas
+    void Blas::CmdWriteCompactedSize(VkCommandBuffer cmdBuffer, VkQueryPool queryPool, uint32_t query) const
+    {
+        mContext->VkbDispatchTable->cmdWriteAccelerationStructuresPropertiesKHR(cmdBuffer, 1, &mAccelerationStructure,
+                                                                                VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, queryPool, query);
+    }
 
-        core::HostSyncCommandBuffer commandBuffer;
-        commandBuffer.Create(context);
-        commandBuffer.Begin();
-        VkAccelerationStructureBuildRangeInfoKHR* buildRangeInfosPtr = buildRangeInfos.data();
-        mContext->VkbDispatchTable->cmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildGeometryInfo, &buildRangeInfosPtr);
-        commandBuffer.SubmitAndWait();
+    void Blas::CmdCompact(VkCommandBuffer cmdBuffer, VkDeviceSize compactedSize)
+    {
+        Assert(!mUncompactedAccelerationStructure, "Blas::CmdCompact called again before Blas::FinishCompaction!");
+        Assert(!mCompacted, "Blas::CmdCompact called on an already compacted Blas!");
 
-        if(!!benchmark)
+        std::string name = fmt::format("Blas #{:x} compacted", reinterpret_cast<uint64_t>(mMesh));
+        mCompactedMemory.Destroy();
+        mCompactedMemory.Create(mContext, VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR, compactedSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, name);
+
+        VkAccelerationStructureCreateInfoKHR asCi{.sType         = VkStructureType::VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
+                                                  .pNext         = nullptr,
+                                                  .createFlags   = 0U,
+                                                  .buffer        = mCompactedMemory.GetBuffer(),
+                                                  .offset        = 0U,
+                                                  .size          = compactedSize,
+                                                  .type          = VkAccelerationStructureTypeKHR::VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+                                                  .deviceAddress = {}};
+        VkAccelerationStructureKHR compacted = nullptr;
+        AssertVkResult(mContext->VkbDispatchTable->createAccelerationStructureKHR(&asCi, nullptr, &compacted));
+
+        VkCopyAccelerationStructureInfoKHR copyInfo{.sType = VkStructureType::VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR,
+                                                    .src   = mAccelerationStructure,
+                                                    .dst   = compacted,
+                                                    .mode  = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR};
+        mContext->VkbDispatchTable->cmdCopyAccelerationStructureKHR(cmdBuffer, &copyInfo);
+
+        mUncompactedAccelerationStructure = mAccelerationStructure;
+        mAccelerationStructure            = compacted;
+        mCompacted                        = true;
+        FetchDeviceAddress();
+    }
+
+    VkDeviceSize Blas::FinishCompaction()
+    {
+        if(!mUncompactedAccelerationStructure)
         {
-            benchmark->LogTimestamp(BENCH_BUILD);
+            return 0;
         }
+        mContext->VkbDispatchTable->destroyAccelerationStructureKHR(mUncompactedAccelerationStructure, nullptr);
+        mUncompactedAccelerationStructure = nullptr;
+
+        VkDeviceSize originalSize  = mBlasMemory.GetSize();
+        VkDeviceSize compactedSize = mCompactedMemory.GetSize();
+        mBlasMemory.Destroy();
+        return originalSize > compactedSize ? originalSize - compactedSize : 0;
+    }
 
-        // STEP #5    Get device address
+    void Blas::FetchDeviceAddress()
+    {
         VkAccelerationStructureDeviceAddressInfoKHR acceleration_device_address_info{};
         acceleration_device_address_info.sType                 = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
         acceleration_device_address_info.accelerationStructure = mAccelerationStructure;
         mBlasAddress                                           = mContext->VkbDispatchTable->getAccelerationStructureDeviceAddressKHR(&acceleration_device_address_info);
-
-        if(!!benchmark)
-        {
-            benchmark->End();
-        }
     }
 
     void Blas::Destroy()
@@ -178,10 +314,20 @@ namespace foray::as {
             mContext->VkbDispatchTable->destroyAccelerationStructureKHR(mAccelerationStructure, nullptr);
             mAccelerationStructure = nullptr;
         }
+        if(!!mUncompactedAccelerationStructure)
+        {
+            mContext->VkbDispatchTable->destroyAccelerationStructureKHR(mUncompactedAccelerationStructure, nullptr);
+            mUncompactedAccelerationStructure = nullptr;
+        }
         if(mBlasMemory.Exists())
         {
             mBlasMemory.Destroy();
         }
+        if(mCompactedMemory.Exists())
+        {
+            mCompactedMemory.Destroy();
+        }
+        mCompacted = false;
         mBlasAddress = 0;
     }
 }  // namespace foray::as
\ No newline at end of file
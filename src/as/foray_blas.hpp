@@ -21,11 +21,31 @@ namespace foray::as {
         inline static const char* BENCH_GETSIZES = "Get Build Sizes";
         inline static const char* BENCH_CREATE = "Create";
         inline static const char* BENCH_BUILD = "Build";
+        inline static const char* BENCH_QUERYCOMPACTSIZE = "Query Compacted Size";
+        inline static const char* BENCH_COMPACT = "Compact";
+        inline static const char* BENCH_BYTESSAVED = "Bytes saved by compaction";
 
         inline virtual std::string_view GetTypeName() const override { return "Bottom-Level AS"; }
 
+        /// @brief Structures describing a single Blas build. Filled by PrepareBuild(), consumed when recording the build command.
+        /// @remark BuildGeometryInfo.pGeometries points into Geometries. Moving the object is fine, copying it is not.
+        struct BuildInfo
+        {
+            /// @brief Geometry descriptions (1 primitive = 1 geometry)
+            std::vector<VkAccelerationStructureGeometryKHR> Geometries;
+            /// @brief Build ranges (counterparts to VkCmdDrawIndexed), one per geometry
+            std::vector<VkAccelerationStructureBuildRangeInfoKHR> BuildRangeInfos;
+            /// @brief Triangle counts per geometry, used to determine build size of the BLAS
+            std::vector<uint32_t> PrimitiveCounts;
+            /// @brief Build geometry info. scratchData and dstAccelerationStructure are left for the caller to fill
+            VkAccelerationStructureBuildGeometryInfoKHR BuildGeometryInfo{};
+            /// @brief Acceleration structure and scratch sizes as queried from the driver
+            VkAccelerationStructureBuildSizesInfoKHR BuildSizesInfo{};
+        };
+
         /// @brief Recreates the acceleration structure
         /// @details For each primitive in mesh, creates a geometry structure and corresponding build range.
+        /// If AllowCompaction is set, the built acceleration structure is compacted into a right-sized buffer afterwards.
         /// See static BENCH_... members for benchmark timestamps
         /// @param context Requires DispatchTable, PhysicalDevice, LogicalDevice
         /// @param mesh Required mesh object referencing the geometry
@@ -33,13 +53,42 @@ namespace foray::as {
         /// @param benchmark Optional benchmark for timing the build process
         virtual void CreateOrUpdate(core::Context* context, const scene::Mesh* mesh, const scene::gcomp::GeometryStore* store, bench::HostBenchmark* benchmark = nullptr);
 
+        /// @brief Resets the acceleration structure handle and fills buildInfo with geometries, build ranges and build sizes. Records no commands.
+        /// @param context Requires DispatchTable
+        /// @param mesh Required mesh object referencing the geometry
+        /// @param store Required GeometryStore owning the Vertex+Index buffers
+        /// @param buildInfo Output build structures
+        /// @param benchmark Optional benchmark (must be recording) for logging the BENCH_RESET, BENCH_CREATESTRUCTS and BENCH_GETSIZES timestamps
+        virtual void PrepareBuild(
+            core::Context* context, const scene::Mesh* mesh, const scene::gcomp::GeometryStore* store, BuildInfo& buildInfo, bench::HostBenchmark* benchmark = nullptr);
+        /// @brief (Re)creates the backing buffer and the acceleration structure handle, and fetches the device address.
+        /// Sets buildInfo.BuildGeometryInfo.dstAccelerationStructure. The acceleration structure contents are undefined until the build has executed.
+        /// @param buildInfo Build structures previously filled by PrepareBuild()
+        virtual void CreateAccelerationStructure(BuildInfo& buildInfo);
+
+        /// @brief Records a query of the compacted size into queryPool (of type VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR)
+        /// @remark Requires a build with AllowCompaction set. The build must be made visible to the query by a barrier beforehand.
+        virtual void CmdWriteCompactedSize(VkCommandBuffer cmdBuffer, VkQueryPool queryPool, uint32_t query) const;
+        /// @brief Creates a right-sized acceleration structure and records a COMPACT mode copy into it.
+        /// The acceleration structure handle and address switch to the compacted version immediately. The original is freed by FinishCompaction().
+        /// @param compactedSize Size as read back from the query written by CmdWriteCompactedSize()
+        virtual void CmdCompact(VkCommandBuffer cmdBuffer, VkDeviceSize compactedSize);
+        /// @brief Destroys the original acceleration structure and its buffer. Call once the copy recorded by CmdCompact() has executed.
+        /// @return Device memory freed in bytes (original buffer size minus compacted buffer size)
+        virtual VkDeviceSize FinishCompaction();
+
         inline virtual bool Exists() const override { return !mAccelerationStructure; }
         virtual void        Destroy() override;
 
         FORAY_GETTER_V(AccelerationStructure)
         FORAY_GETTER_V(BlasAddress)
-        FORAY_GETTER_CR(BlasMemory)
         FORAY_GETTER_V(Mesh)
+        /// @brief If set, builds are flagged ALLOW_COMPACTION and compacted after building (opt-in, best suited for static geometry)
+        FORAY_PROPERTY_V(AllowCompaction)
+        FORAY_GETTER_V(Compacted)
+
+        /// @brief Get the buffer backing the acceleration structure (the compacted buffer, if compacted)
+        inline const core::ManagedBuffer& GetBlasMemory() const { return mCompacted ? mCompactedMemory : mBlasMemory; }
 
       protected:
         core::Context*             mContext = nullptr;
@@ -47,5 +96,14 @@ namespace foray::as {
         core::ManagedBuffer        mBlasMemory;
         VkAccelerationStructureKHR mAccelerationStructure{};
         VkDeviceAddress            mBlasAddress{};
+        bool                       mAllowCompaction = false;
+        /// @brief True, if mAccelerationStructure lives in mCompactedMemory
+        bool mCompacted = false;
+        /// @brief Right-sized buffer the acceleration structure is copied into when compacting
+        core::ManagedBuffer mCompactedMemory;
+        /// @brief Original acceleration structure, kept alive between CmdCompact() and FinishCompaction()
+        VkAccelerationStructureKHR mUncompactedAccelerationStructure{};
+
+        void FetchDeviceAddress();
     };
 }  // namespace foray::as
\ No newline at end of file
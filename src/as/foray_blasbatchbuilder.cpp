@@ -0,0 +1,220 @@
+#include "foray_blasbatchbuilder.hpp"
+#include "../bench/foray_hostbenchmark.hpp"
+#include "../core/foray_commandbuffer.hpp"
+#include "../core/foray_managedbuffer.hpp"
+#include "../scene/foray_mesh.hpp"
+#include "../scene/globalcomponents/foray_geometrymanager.hpp"
+#include <algorithm>
+
+namespace foray::as {
+
+    BlasBatchBuilder& BlasBatchBuilder::Add(Blas* blas, const scene::Mesh* mesh)
+    {
+        Assert(!!blas && !!mesh, "BlasBatchBuilder::Add requires blas and mesh to be set");
+        mEntries.push_back(Entry{.Target = blas, .Mesh = mesh});
+        return *this;
+    }
+
+    BlasBatchBuilder& BlasBatchBuilder::Add(scene::Mesh* mesh)
+    {
+        return Add(&mesh->GetBlas(), mesh);
+    }
+
+    void BlasBatchBuilder::Clear()
+    {
+        mEntries.clear();
+    }
+
+    void BlasBatchBuilder::Build(core::Context* context, const scene::gcomp::GeometryStore* store, bench::HostBenchmark* benchmark)
+    {
+        if(mEntries.empty())
+        {
+            return;
+        }
+
+        if(!!benchmark)
+        {
+            benchmark->Begin();
+        }
+
+        VkPhysicalDeviceAccelerationStructurePropertiesKHR asProperties{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
+        {
+            VkPhysicalDeviceProperties2 prop2{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &asProperties};
+            vkGetPhysicalDeviceProperties2(context->PhysicalDevice(), &prop2);
+        }
+        const VkDeviceSize scratchAlignment = std::max<VkDeviceSize>(asProperties.minAccelerationStructureScratchOffsetAlignment, 1);
+
+        // STEP #1    Prepare build structures for all entries. Sized once, as the build infos hold pointers into their own vectors.
+
+        std::vector<Blas::BuildInfo> buildInfos(mEntries.size());
+        for(size_t i = 0; i < mEntries.size(); i++)
+        {
+            mEntries[i].Target->PrepareBuild(context, mEntries[i].Mesh, store, buildInfos[i]);
+        }
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_PREPARE);
+        }
+
+        // STEP #2    Create acceleration structures, assign scratch arena offsets
+
+        // Builds are grouped into passes. All builds of a pass execute concurrently, so each needs its own scratch region.
+        // A new pass is started whenever the arena would exceed mMaxScratchSize.
+        std::vector<VkDeviceSize> scratchOffsets(mEntries.size());
+        std::vector<size_t>       passBegins{0};
+        VkDeviceSize              passScratchSize  = 0;
+        VkDeviceSize              arenaScratchSize = 0;
+
+        for(size_t i = 0; i < mEntries.size(); i++)
+        {
+            mEntries[i].Target->CreateAccelerationStructure(buildInfos[i]);
+
+            VkDeviceSize scratchSize = buildInfos[i].BuildSizesInfo.buildScratchSize;
+            scratchSize              = ((scratchSize + (scratchAlignment - 1)) / scratchAlignment) * scratchAlignment;
+
+            if(passScratchSize > 0 && passScratchSize + scratchSize > mMaxScratchSize)
+            {
+                passBegins.push_back(i);
+                passScratchSize = 0;
+            }
+            scratchOffsets[i] = passScratchSize;
+            passScratchSize += scratchSize;
+            arenaScratchSize = std::max(arenaScratchSize, passScratchSize);
+        }
+
+        core::ManagedBuffer             scratchArena;
+        core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, arenaScratchSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                                           0, "Blas Batch Scratch Arena");
+        ci.Alignment = scratchAlignment;
+        scratchArena.Create(context, ci);
+
+        VkDeviceAddress arenaAddress = scratchArena.GetDeviceAddress();
+        for(size_t i = 0; i < mEntries.size(); i++)
+        {
+            buildInfos[i].BuildGeometryInfo.scratchData.deviceAddress = arenaAddress + scratchOffsets[i];
+        }
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_CREATE);
+        }
+
+        // STEP #3    Record all builds into a single command buffer
+
+        core::HostSyncCommandBuffer commandBuffer;
+        commandBuffer.Create(context);
+        commandBuffer.Begin();
+
+        // Blas which opted into compaction get their compacted size queried right after building
+        std::vector<size_t> compactionEntries;
+        for(size_t i = 0; i < mEntries.size(); i++)
+        {
+            if(mEntries[i].Target->GetAllowCompaction())
+            {
+                compactionEntries.push_back(i);
+            }
+        }
+        VkQueryPool queryPool = nullptr;
+        if(!compactionEntries.empty())
+        {
+            VkQueryPoolCreateInfo queryPoolCi{.sType      = VkStructureType::VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                              .queryType  = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+                                              .queryCount = static_cast<uint32_t>(compactionEntries.size())};
+            AssertVkResult(context->VkbDispatchTable->createQueryPool(&queryPoolCi, nullptr, &queryPool));
+            context->VkbDispatchTable->cmdResetQueryPool(commandBuffer, queryPool, 0, static_cast<uint32_t>(compactionEntries.size()));
+        }
+
+        std::vector<VkAccelerationStructureBuildGeometryInfoKHR> passGeometryInfos;
+        std::vector<VkAccelerationStructureBuildRangeInfoKHR*>   passRangeInfos;
+        for(size_t pass = 0; pass < passBegins.size(); pass++)
+        {
+            size_t begin = passBegins[pass];
+            size_t end   = pass + 1 < passBegins.size() ? passBegins[pass + 1] : mEntries.size();
+
+            if(pass > 0)
+            {
+                // The previous pass must have finished using the scratch arena before it is reused
+                VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+                barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+                barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1,
+                                     &barrier, 0, nullptr, 0, nullptr);
+            }
+
+            passGeometryInfos.clear();
+            passRangeInfos.clear();
+            for(size_t i = begin; i < end; i++)
+            {
+                passGeometryInfos.push_back(buildInfos[i].BuildGeometryInfo);
+                passRangeInfos.push_back(buildInfos[i].BuildRangeInfos.data());
+            }
+            context->VkbDispatchTable->cmdBuildAccelerationStructuresKHR(commandBuffer, static_cast<uint32_t>(passGeometryInfos.size()), passGeometryInfos.data(),
+                                                                         passRangeInfos.data());
+        }
+
+        if(!compactionEntries.empty())
+        {
+            VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+            barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &barrier,
+                                 0, nullptr, 0, nullptr);
+            for(size_t i = 0; i < compactionEntries.size(); i++)
+            {
+                mEntries[compactionEntries[i]].Target->CmdWriteCompactedSize(commandBuffer, queryPool, static_cast<uint32_t>(i));
+            }
+        }
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_RECORD);
+        }
+
+        // STEP #4    Submit once and wait
+
+        commandBuffer.SubmitAndWait();
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_BUILD);
+        }
+
+        // STEP #5    Compact all Blas which opted in, again with a single submission
+
+        if(!compactionEntries.empty())
+        {
+            std::vector<VkDeviceSize> compactedSizes(compactionEntries.size());
+            AssertVkResult(context->VkbDispatchTable->getQueryPoolResults(queryPool, 0, static_cast<uint32_t>(compactionEntries.size()),
+                                                                          compactedSizes.size() * sizeof(VkDeviceSize), compactedSizes.data(), sizeof(VkDeviceSize),
+                                                                          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+            context->VkbDispatchTable->destroyQueryPool(queryPool, nullptr);
+
+            commandBuffer.Begin();
+            for(size_t i = 0; i < compactionEntries.size(); i++)
+            {
+                mEntries[compactionEntries[i]].Target->CmdCompact(commandBuffer, compactedSizes[i]);
+            }
+            commandBuffer.SubmitAndWait();
+
+            VkDeviceSize bytesSaved = 0;
+            for(size_t index : compactionEntries)
+            {
+                bytesSaved += mEntries[index].Target->FinishCompaction();
+            }
+
+            if(!!benchmark)
+            {
+                benchmark->LogTimestamp(BENCH_COMPACT);
+                benchmark->LogValue(BENCH_BYTESSAVED, (fp64_t)bytesSaved);
+            }
+        }
+
+        if(!!benchmark)
+        {
+            benchmark->End();
+        }
+
+        mEntries.clear();
+    }
+}  // namespace foray::as
@@ -0,0 +1,61 @@
+#pragma once
+#include "../bench/foray_bench_declares.hpp"
+#include "../core/foray_context.hpp"
+#include "../scene/foray_scene_declares.hpp"
+#include "foray_as_declares.hpp"
+#include "foray_blas.hpp"
+#include <vector>
+
+namespace foray::as {
+
+    /// @brief Builds many Blas with a single command buffer submission
+    /// @details
+    /// Blas::CreateOrUpdate allocates a scratch buffer and synchronizes with the host for every mesh. For scenes with many meshes, collect them in a
+    /// BlasBatchBuilder instead: Scratch memory for all builds is sub-allocated from one arena buffer (offsets aligned to minAccelerationStructureScratchOffsetAlignment),
+    /// and all build commands are recorded into one command buffer, which is submitted and waited on exactly once.
+    /// If the scratch memory required exceeds MaxScratchSize, builds are split into multiple vkCmdBuildAccelerationStructuresKHR calls
+    /// which reuse the arena, separated by a pipeline barrier.
+    /// Blas with AllowCompaction set are compacted afterwards, which costs one additional submission for the whole batch.
+    class BlasBatchBuilder : public NoMoveDefaults
+    {
+      public:
+        inline static const char* BENCH_PREPARE = "Prepare Build Structs";
+        inline static const char* BENCH_CREATE  = "Create";
+        inline static const char* BENCH_RECORD  = "Record";
+        inline static const char* BENCH_BUILD   = "Build";
+        inline static const char* BENCH_COMPACT = "Compact";
+        inline static const char* BENCH_BYTESSAVED = "Bytes saved by compaction";
+
+        /// @brief Queue a Blas for building
+        /// @param blas Blas to (re)build
+        /// @param mesh Mesh object referencing the geometry
+        BlasBatchBuilder& Add(Blas* blas, const scene::Mesh* mesh);
+        /// @brief Queue a meshes Blas for building
+        BlasBatchBuilder& Add(scene::Mesh* mesh);
+
+        /// @brief Builds all queued Blas and clears the queue
+        /// @details See static BENCH_... members for benchmark timestamps
+        /// @param context Requires DispatchTable, PhysicalDevice, LogicalDevice, Allocator, CommandPool, Queue
+        /// @param store Required GeometryStore owning the Vertex+Index buffers of all queued meshes
+        /// @param benchmark Optional benchmark for timing the build process
+        void Build(core::Context* context, const scene::gcomp::GeometryStore* store, bench::HostBenchmark* benchmark = nullptr);
+
+        /// @brief Removes all queued Blas without building
+        void Clear();
+
+        inline size_t GetCount() const { return mEntries.size(); }
+
+        /// @brief Upper limit for the scratch arena size. If a single build requires more, the arena is sized to fit it.
+        FORAY_PROPERTY_V(MaxScratchSize)
+
+      protected:
+        struct Entry
+        {
+            Blas*              Target = nullptr;
+            const scene::Mesh* Mesh   = nullptr;
+        };
+
+        std::vector<Entry> mEntries;
+        VkDeviceSize       mMaxScratchSize = 256ULL * 1024ULL * 1024ULL;
+    };
+}  // namespace foray::as
@@ -1,31 +1,27 @@
 #include "foray_blasinstance.hpp"
 #include "foray_blas.hpp"
+#include <cstring>
 
 namespace foray::as {
     BlasInstance::BlasInstance(uint64_t instanceId, const Blas* blas, TransformUpdateFunc getUpdatedGlobalTransformFunc)
-        : mInstanceId(instanceId), mGetUpdatedGlobalTransformFunc(getUpdatedGlobalTransformFunc), mAsInstance{}
+        : mInstanceId(instanceId), mBlas(blas), mGetUpdatedGlobalTransformFunc(getUpdatedGlobalTransformFunc)
     {
-        mBlas                                              = blas;
-        mAsInstance.accelerationStructureReference         = blas->GetBlasAddress();
-        mAsInstance.instanceCustomIndex                    = 0;
-        mAsInstance.mask                                   = 0xFF;
-        mAsInstance.instanceShaderBindingTableRecordOffset = 0;
-        mAsInstance.flags                                  = 0;
-
-        Update();
     }
 
-    BlasInstance::BlasInstance(uint64_t instanceId, const Blas* blas, const glm::mat4& globalTransform)
-        : mInstanceId(instanceId), mGetUpdatedGlobalTransformFunc(nullptr), mAsInstance{}
-    {
-        mBlas                                              = blas;
-        mAsInstance.accelerationStructureReference         = blas->GetBlasAddress();
-        mAsInstance.instanceCustomIndex                    = 0;
-        mAsInstance.mask                                   = 0xFF;
-        mAsInstance.instanceShaderBindingTableRecordOffset = 0;
-        mAsInstance.flags                                  = 0;
+    BlasInstance::BlasInstance(uint64_t instanceId, const Blas* blas) : mInstanceId(instanceId), mBlas(blas), mGetUpdatedGlobalTransformFunc(nullptr) {}
 
-        TranslateTransformMatrix(globalTransform, mAsInstance.transform);
+    VkAccelerationStructureInstanceKHR BlasInstance::MakeAsInstance(const glm::mat4& globalTransform) const
+    {
+        VkAccelerationStructureInstanceKHR asInstance{};
+        asInstance.accelerationStructureReference         = mBlas->GetBlasAddress();
+        asInstance.instanceCustomIndex                    = 0;
+        asInstance.mask                                   = 0xFF;
+        asInstance.instanceShaderBindingTableRecordOffset = 0;
+        asInstance.flags                                  = 0;
+
+        TranslateTransformMatrix(globalTransform, asInstance.transform);
+        Update(asInstance);
+        return asInstance;
     }
 
     void BlasInstance::TranslateTransformMatrix(const glm::mat4& in, VkTransformMatrixKHR& out)
@@ -39,23 +35,20 @@ namespace foray::as {
         }
     }
 
-    void BlasInstance::SetGeometryMetaOffset(uint32_t offset)
-    {
-        mAsInstance.instanceCustomIndex = offset;
-    }
-
-    void BlasInstance::SetShaderBindingTableOffset(uint32_t offset)
-    {
-        mAsInstance.instanceShaderBindingTableRecordOffset = offset;
-    }
-
-    void BlasInstance::Update()
+    bool BlasInstance::Update(VkAccelerationStructureInstanceKHR& asInstance) const
     {
         if(!!mGetUpdatedGlobalTransformFunc)
         {
             glm::mat4 transform;
             std::invoke(mGetUpdatedGlobalTransformFunc, transform);
-            TranslateTransformMatrix(transform, mAsInstance.transform);
+            VkTransformMatrixKHR translated;
+            TranslateTransformMatrix(transform, translated);
+            if(memcmp(&translated, &asInstance.transform, sizeof(VkTransformMatrixKHR)) != 0)
+            {
+                asInstance.transform = translated;
+                return true;
+            }
         }
+        return false;
     }
 }  // namespace foray
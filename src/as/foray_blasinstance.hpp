@@ -6,7 +6,9 @@
 #include <functional>
 
 namespace foray::as {
-    /// @brief A reference to a BLAS maintained by the TLAS
+    /// @brief Host side bookkeeping of a BLAS instance maintained by the TLAS
+    /// @details The VkAccelerationStructureInstanceKHR uploaded to the TLAS is owned by the TLAS (see Tlas::GetAsInstance()). MakeAsInstance() initializes it,
+    /// Update() writes new transforms to it.
     class BlasInstance
     {
       public:
@@ -17,36 +19,21 @@ namespace foray::as {
         /// @brief Initialize as animated
         BlasInstance(uint64_t instanceId, const Blas* blas, TransformUpdateFunc getUpdatedGlobalTransformFunc);
         /// @brief Initialize as static
-        BlasInstance(uint64_t instanceId, const Blas* blas, const glm::mat4& globalTransform);
+        BlasInstance(uint64_t instanceId, const Blas* blas);
 
-        FORAY_GETTER_V(InstanceId)
-        FORAY_GETTER_CR(AsInstance)
+        FORAY_PROPERTY_V(InstanceId)
         FORAY_GETTER_V(Blas)
         FORAY_PROPERTY_V(GetUpdatedGlobalTransformFunc)
 
         bool IsAnimated() const { return !!mGetUpdatedGlobalTransformFunc; }
 
-        /// @brief Set the offset into the GeometryMetaBuffer (see foray_geometrymetabuffer.hpp)
-        void SetGeometryMetaOffset(uint32_t offset);
+        /// @brief Makes the instance struct referencing the BLAS, with custom index and shader binding table offset zero
+        /// @param globalTransform Transform of static instances. Animated instances fetch their current transform instead
+        VkAccelerationStructureInstanceKHR MakeAsInstance(const glm::mat4& globalTransform = glm::mat4(1.f)) const;
 
-        /// @brief Set the offset for shader binding table
-        void SetShaderBindingTableOffset(uint32_t offset);
-
-        inline VkGeometryInstanceFlagsKHR GetGeometryInstanceFlags() const { return mAsInstance.flags; }
-        inline BlasInstance&              SetGeometryInstanceFlags(VkGeometryFlagsKHR flags)
-        {
-            mAsInstance.flags = flags;
-            return *this;
-        }
-        inline BlasInstance& AddGeometryInstanceFlag(VkGeometryFlagBitsKHR flag)
-        {
-            mAsInstance.flags |= flag;
-            return *this;
-        }
-
-
-        /// @brief Updates the transform by fetching a new matrix
-        void Update();
+        /// @brief Updates the transform of asInstance by fetching a new matrix
+        /// @return True, if the transform changed (always false for static instances)
+        bool Update(VkAccelerationStructureInstanceKHR& asInstance) const;
 
         /// @brief Translates glms column major 4x4 matrix to the row major 4x3 matrix type VkTransformMatrixKHR
         static void TranslateTransformMatrix(const glm::mat4& in, VkTransformMatrixKHR& out);
@@ -58,7 +45,5 @@ namespace foray::as {
         const Blas* mBlas;
         /// @brief Function used to update transform (if animated, nullptr otherwise)
         TransformUpdateFunc mGetUpdatedGlobalTransformFunc = nullptr;
-        /// @brief Vulkans instance struct, contains the actual reference to the BLAS, the transform and the custom index (used to offset into GeometryMetaBuffer)
-        VkAccelerationStructureInstanceKHR mAsInstance = {};
     };
 }  // namespace foray::as
\ No newline at end of file
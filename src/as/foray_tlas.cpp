@@ -13,38 +13,22 @@ namespace foray::as {
     void Tlas::RemoveBlasInstance(uint64_t id)
     {
         mDirty = true;
+        if(!!(id & ANIMATED_ID_BIT))
         {
-            auto iter = mStaticBlasInstances.find(id);
-            if(iter != mStaticBlasInstances.end())
-            {
-                mStaticBlasInstances.erase(iter);
-            }
+            mAnimatedBlasInstances.Remove(id & ~ANIMATED_ID_BIT);
         }
+        else
         {
-            auto iter = mAnimatedBlasInstances.find(id);
-            if(iter != mAnimatedBlasInstances.end())
-            {
-                mAnimatedBlasInstances.erase(iter);
-            }
+            mStaticBlasInstances.Remove(id);
         }
     }
     const BlasInstance* Tlas::GetBlasInstance(uint64_t id) const
     {
+        if(!!(id & ANIMATED_ID_BIT))
         {
-            auto iter = mStaticBlasInstances.find(id);
-            if(iter != mStaticBlasInstances.end())
-            {
-                return &(iter->second);
-            }
-        }
-        {
-            auto iter = mAnimatedBlasInstances.find(id);
-            if(iter != mAnimatedBlasInstances.end())
-            {
-                return &(iter->second);
-            }
+            return mAnimatedBlasInstances.GetAux(id & ~ANIMATED_ID_BIT);
         }
-        return nullptr;
+        return mStaticBlasInstances.GetAux(id);
     }
     uint64_t Tlas::AddBlasInstanceAuto(scene::ncomp::MeshInstance* meshInstance)
     {
@@ -61,30 +45,41 @@ namespace foray::as {
             return AddBlasInstanceAnimated(blas, getFunc);
         }
     }
+    const VkAccelerationStructureInstanceKHR* Tlas::GetAsInstance(uint64_t id) const
+    {
+        if(!!(id & ANIMATED_ID_BIT))
+        {
+            return mAnimatedBlasInstances.GetValue(id & ~ANIMATED_ID_BIT);
+        }
+        return mStaticBlasInstances.GetValue(id);
+    }
     uint64_t Tlas::AddBlasInstanceAnimated(const Blas& blas, BlasInstance::TransformUpdateFunc getUpdatedGlobalTransformFunc)
     {
-        mDirty      = true;
-        uint64_t id = mNextId;
-        mNextId++;
-
-        mAnimatedBlasInstances.emplace(id, BlasInstance(id, &blas, getUpdatedGlobalTransformFunc));
-        return id;
+        BlasInstance instance(0, &blas, getUpdatedGlobalTransformFunc);
+        return AddBlasInstance(mAnimatedBlasInstances, ANIMATED_ID_BIT, instance, instance.MakeAsInstance());
     }
     uint64_t Tlas::AddBlasInstanceStatic(const Blas& blas, const glm::mat4& transform)
     {
-        mDirty      = true;
-        uint64_t id = mNextId;
-        mNextId++;
+        BlasInstance instance(0, &blas);
+        return AddBlasInstance(mStaticBlasInstances, 0, instance, instance.MakeAsInstance(transform));
+    }
+    uint64_t Tlas::AddBlasInstance(BlasInstanceMap& map, uint64_t idFlags, const BlasInstance& instance, const VkAccelerationStructureInstanceKHR& asInstance)
+    {
+        mDirty = true;
 
-        mStaticBlasInstances.emplace(id, BlasInstance(id, &blas, transform));
+        BlasInstanceMap::Key key = map.Insert(asInstance, instance);
+        uint64_t             id  = key | idFlags;
+
+        // The id is only known after insertion
+        map.GetAux(key)->SetInstanceId(id);
         return id;
     }
 
     void Tlas::ClearBlasInstances()
     {
         mDirty = true;
-        mAnimatedBlasInstances.clear();
-        mStaticBlasInstances.clear();
+        mAnimatedBlasInstances.Clear();
+        mStaticBlasInstances.Clear();
     }
 
 
@@ -112,39 +107,39 @@ namespace foray::as {
 
         // STEP #1   Rebuild meta buffer, get and assign buffer offsets
         std::unordered_set<const Blas*> usedBlas;  // used to reconstruct the meta info buffer
-        for(const auto& blasInstancePair : mStaticBlasInstances)
+        for(const BlasInstance& blasInstance : mStaticBlasInstances.GetAuxValues())
         {
-            usedBlas.emplace(blasInstancePair.second.GetBlas());
+            usedBlas.emplace(blasInstance.GetBlas());
         }
-        for(const auto& blasInstancePair : mAnimatedBlasInstances)
+        for(const BlasInstance& blasInstance : mAnimatedBlasInstances.GetAuxValues())
         {
-            usedBlas.emplace(blasInstancePair.second.GetBlas());
+            usedBlas.emplace(blasInstance.GetBlas());
         }
         auto offsets = mMetaBuffer.CreateOrUpdate(mContext, usedBlas);
 
-        // STEP #2   Build instance buffer data. Static first, animated after (this way the buffer data that is updated every frame is in memory in one region)
-        std::vector<VkAccelerationStructureInstanceKHR> instanceBufferData;  // Vector of instances (each being a reference to a BLAS, with a transform)
-
-        for(auto& blasInstancePair : mStaticBlasInstances)
+        for(BlasInstanceMap* map : {&mStaticBlasInstances, &mAnimatedBlasInstances})
         {
-            auto& blasInstance = blasInstancePair.second;
-            blasInstance.SetGeometryMetaOffset(offsets[blasInstance.GetBlas()]);
-            instanceBufferData.push_back(blasInstance.GetAsInstance());
-        }
-        for(auto& blasInstancePair : mAnimatedBlasInstances)
-        {
-            auto& blasInstance = blasInstancePair.second;
-            blasInstance.SetGeometryMetaOffset(offsets[blasInstance.GetBlas()]);
-            instanceBufferData.push_back(blasInstance.GetAsInstance());
+            auto& asInstances   = map->GetValues();
+            auto& blasInstances = map->GetAuxValues();
+            for(size_t i = 0; i < blasInstances.size(); i++)
+            {
+                // Custom index is used to offset into the GeometryMetaBuffer
+                asInstances[i].instanceCustomIndex = offsets[blasInstances[i].GetBlas()];
+            }
         }
 
+        // STEP #2   Instance buffer layout. Static first, animated after (this way the buffer data that is updated every frame is in memory in one region)
+
+        VkDeviceSize staticSize   = mStaticBlasInstances.Size() * sizeof(VkAccelerationStructureInstanceKHR);
+        VkDeviceSize animatedSize = mAnimatedBlasInstances.Size() * sizeof(VkAccelerationStructureInstanceKHR);
+
         VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo{};
-        buildRangeInfo.primitiveCount = instanceBufferData.size();
+        buildRangeInfo.primitiveCount = static_cast<uint32_t>(mStaticBlasInstances.Size() + mAnimatedBlasInstances.Size());
 
 
         // STEP #3   Build instance buffer
 
-        VkDeviceSize instanceBufferSize = instanceBufferData.size() * sizeof(VkAccelerationStructureInstanceKHR);
+        VkDeviceSize instanceBufferSize = staticSize + animatedSize;
 
         if(instanceBufferSize > mInstanceBuffer.GetDeviceBuffer().GetSize())
         {
@@ -156,9 +151,16 @@ namespace foray::as {
             mInstanceBuffer.Create(mContext, instanceBufferCI);
         }
 
-        // Misuse the staging function to upload data to GPU
+        // Misuse the staging function to upload data to GPU. The slot maps store instances densely, so they are copied directly.
 
-        mInstanceBuffer.StageSection(0, instanceBufferData.data(), 0, instanceBufferSize);
+        if(staticSize > 0)
+        {
+            mInstanceBuffer.StageSection(0, mStaticBlasInstances.GetValues().data(), 0, staticSize);
+        }
+        if(animatedSize > 0)
+        {
+            mInstanceBuffer.StageSection(0, mAnimatedBlasInstances.GetValues().data(), staticSize, animatedSize);
+        }
 
         // STEP #4    Get Size
 
@@ -252,7 +254,7 @@ namespace foray::as {
 
     void Tlas::UpdateLean(VkCommandBuffer cmdBuffer, uint32_t frameIndex)
     {
-        if(!mAnimatedBlasInstances.size())
+        if(mAnimatedBlasInstances.Empty())
         {
             return;
         }
@@ -262,20 +264,41 @@ namespace foray::as {
             Exception::Throw("Tlas::UpdateLean called when Tlas is in dirty state! Use Tlas::CreateOrUpdate to properly reconfigure!");
         }
 
-        // STEP #1 Grab updated transforms of animated instances and upload them to host buffer
+        // STEP #1 Grab updated transforms of animated instances, collect changed ones into contiguous sections
 
-        std::vector<VkAccelerationStructureInstanceKHR> instanceBufferData;
+        mDirtySections.clear();
 
+        auto&        asInstances   = mAnimatedBlasInstances.GetValues();
+        auto&        blasInstances = mAnimatedBlasInstances.GetAuxValues();
+        VkDeviceSize staticCount   = mStaticBlasInstances.Size();  // Animated instances are stored after static ones
+        for(size_t i = 0; i < blasInstances.size(); i++)
+        {
+            if(blasInstances[i].Update(asInstances[i]))
+            {
+                VkDeviceSize instanceIndex = staticCount + i;
+                if(mDirtySections.size() > 0 && mDirtySections.back().offset + mDirtySections.back().count == instanceIndex)
+                {
+                    mDirtySections.back().count++;
+                }
+                else
+                {
+                    mDirtySections.push_back(util::BufferSection{.offset = instanceIndex, .count = 1});
+                }
+            }
+        }
 
-        for(auto& blasInstancePair : mAnimatedBlasInstances)
+        if(!mDirtySections.size())
         {
-            blasInstancePair.second.Update();
-            instanceBufferData.push_back(blasInstancePair.second.GetAsInstance());
+            // No instance moved, the TLAS is still up to date
+            return;
         }
 
-        size_t writeOffset = sizeof(VkAccelerationStructureInstanceKHR) * mStaticBlasInstances.size();
-        size_t writeSize   = sizeof(VkAccelerationStructureInstanceKHR) * mAnimatedBlasInstances.size();
-        mInstanceBuffer.StageSection(frameIndex, instanceBufferData.data(), writeOffset, writeSize);
+        // Stage one buffer copy per contiguous section
+        for(const util::BufferSection& section : mDirtySections)
+        {
+            mInstanceBuffer.StageSection(frameIndex, asInstances.data() + (section.offset - staticCount), section.offset * sizeof(VkAccelerationStructureInstanceKHR),
+                                         section.count * sizeof(VkAccelerationStructureInstanceKHR));
+        }
 
         // STEP #2 Configure upload from host to device buffer for animated instances
 
@@ -311,7 +334,7 @@ namespace foray::as {
         buildInfo.scratchData.deviceAddress = mScratchBuffer.GetDeviceAddress();
 
 
-        VkAccelerationStructureBuildRangeInfoKHR  buildRangeInfo{.primitiveCount = static_cast<uint32_t>(mAnimatedBlasInstances.size() + mStaticBlasInstances.size())};
+        VkAccelerationStructureBuildRangeInfoKHR  buildRangeInfo{.primitiveCount = static_cast<uint32_t>(mAnimatedBlasInstances.Size() + mStaticBlasInstances.Size())};
         VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &buildRangeInfo;
 
         mContext->VkbDispatchTable->cmdBuildAccelerationStructuresKHR(cmdBuffer, 1, &buildInfo, &pRangeInfo);
@@ -319,8 +342,8 @@ namespace foray::as {
 
     void Tlas::Destroy()
     {
-        mStaticBlasInstances.clear();
-        mAnimatedBlasInstances.clear();
+        mStaticBlasInstances.Clear();
+        mAnimatedBlasInstances.Clear();
         if(!!mContext && !!mAccelerationStructure)
         {
             mContext->VkbDispatchTable->destroyAccelerationStructureKHR(mAccelerationStructure, nullptr);
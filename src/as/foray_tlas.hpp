@@ -3,11 +3,12 @@
 #include "../foray_basics.hpp"
 #include "../scene/foray_component.hpp"
 #include "../scene/foray_scene_declares.hpp"
+#include "../util/foray_denseslotmap.hpp"
 #include "../util/foray_dualbuffer.hpp"
+#include "../util/foray_managedvectorbuffer.hpp"
 #include "foray_as_declares.hpp"
 #include "foray_blasinstance.hpp"
 #include "foray_geometrymetabuffer.hpp"
-#include <map>
 #include <vulkan/vulkan.h>
 
 namespace foray::as {
@@ -18,6 +19,10 @@ namespace foray::as {
     class Tlas : public core::ManagedResource
     {
       public:
+        /// @brief Instance storage. Values are laid out exactly as uploaded to the instance buffer and are the only copy of the instance structs.
+        /// BlasInstance objects holding host side bookkeeping are kept alongside.
+        using BlasInstanceMap = util::DenseSlotMap<VkAccelerationStructureInstanceKHR, BlasInstance>;
+
         Tlas() = default;
         virtual ~Tlas() { Destroy(); }
 
@@ -26,6 +31,7 @@ namespace foray::as {
         /// @brief (Re)creates the TLAS. Required to invoke when changes to the TLAS transitioned it to Dirty state. Will synchronize with the CPU.
         virtual void CreateOrUpdate(core::Context* context = nullptr);
         /// @brief Updates transforms only. TLAS rebuild is performed and synchronized on GPU only. TLAS must by non-Dirty!
+        /// @details Only instances whose transform changed are staged, merged into contiguous sections. If no instance changed, no commands are recorded.
         virtual void UpdateLean(VkCommandBuffer cmdBuffer, uint32_t frameIndex);
 
         inline virtual bool Exists() const override { return !!mAccelerationStructure; }
@@ -44,6 +50,8 @@ namespace foray::as {
         void RemoveBlasInstance(uint64_t id);
         /// @brief Get A BLAS instance by id
         const BlasInstance* GetBlasInstance(uint64_t id) const;
+        /// @brief Get the instance struct uploaded to the TLAS by id (transform, custom index, flags)
+        const VkAccelerationStructureInstanceKHR* GetAsInstance(uint64_t id) const;
         /// @brief Add a BLAS instance from meshInstance component
         /// @remark TLAS will be marked Dirty!
         uint64_t AddBlasInstanceAuto(scene::ncomp::MeshInstance* meshInstance);
@@ -62,6 +70,11 @@ namespace foray::as {
         FORAY_GETTER_CR(StaticBlasInstances)
 
       protected:
+        /// @brief Set on ids of animated instances, to identify the slot map they are stored in
+        inline static constexpr uint64_t ANIMATED_ID_BIT = 1ULL << 63;
+
+        uint64_t AddBlasInstance(BlasInstanceMap& map, uint64_t idFlags, const BlasInstance& instance, const VkAccelerationStructureInstanceKHR& asInstance);
+
         core::Context*                   mContext               = nullptr;
         bool                             mDirty                 = false;
         VkAccelerationStructureKHR       mAccelerationStructure = nullptr;
@@ -69,9 +82,11 @@ namespace foray::as {
         util::DualBuffer                 mInstanceBuffer;
         core::ManagedBuffer              mScratchBuffer;
         VkDeviceAddress                  mTlasAddress = 0;
-        std::map<uint64_t, BlasInstance> mAnimatedBlasInstances;
-        std::map<uint64_t, BlasInstance> mStaticBlasInstances;
-        uint64_t                         mNextId = 0;
+        BlasInstanceMap                  mAnimatedBlasInstances;
+        BlasInstanceMap                  mStaticBlasInstances;
         GeometryMetaBuffer               mMetaBuffer;
+
+        /// @brief Contiguous sections (in instances) of the instance buffer changed during the current UpdateLean call
+        std::vector<util::BufferSection> mDirtySections;
     };
 }  // namespace foray::as
\ No newline at end of file
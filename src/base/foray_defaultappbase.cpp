@@ -62,6 +62,11 @@ namespace foray::base {
         InitGetQueue();
         InitCommandPool();
         InitCreateVma();
+        InitPipelineCache();
+        InitDescriptorPoolAllocator();
+        InitBindlessHeap();
+        InitTransientImageAllocator();
+        InitFrameTimeline();
         InitSyncObjects();
 
         mSamplerCollection.Init(&mContext);
@@ -99,6 +104,18 @@ namespace foray::base {
         poolInfo.queueFamilyIndex = mContext.QueueFamilyIndex;
 
         AssertVkResult(mDevice.GetDispatchTable().createCommandPool(&poolInfo, nullptr, &mContext.CommandPool));
+
+        // Dedicated transfer and async compute queues get their own pools. Without them, they stay unset and the main queue is used.
+        if(!!mContext.TransferQueue && mContext.TransferQueueFamilyIndex != mContext.QueueFamilyIndex)
+        {
+            poolInfo.queueFamilyIndex = mContext.TransferQueueFamilyIndex;
+            AssertVkResult(mDevice.GetDispatchTable().createCommandPool(&poolInfo, nullptr, &mContext.TransferCommandPool));
+        }
+        if(!!mContext.ComputeQueue && mContext.ComputeQueueFamilyIndex != mContext.QueueFamilyIndex)
+        {
+            poolInfo.queueFamilyIndex = mContext.ComputeQueueFamilyIndex;
+            AssertVkResult(mDevice.GetDispatchTable().createCommandPool(&poolInfo, nullptr, &mContext.ComputeCommandPool));
+        }
     }
 
     void DefaultAppBase::InitCreateVma()
@@ -122,6 +139,78 @@ namespace foray::base {
         vmaCreateAllocator(&allocatorCreateInfo, &mContext.Allocator);
     }
 
+    void DefaultAppBase::InitPipelineCache()
+    {
+        if(!mEnablePipelineCache)
+        {
+            return;
+        }
+        mPipelineCache.Create(&mContext, mPipelineCacheDirectory, &mPipelineCacheBenchmark);
+        mContext.PipelineCache = mPipelineCache;
+    }
+
+    void DefaultAppBase::InitDescriptorPoolAllocator()
+    {
+        if(!mEnableDescriptorPoolAllocator)
+        {
+            return;
+        }
+        mDescriptorPoolAllocator.Create(&mContext);
+        mContext.DescriptorAllocator = &mDescriptorPoolAllocator;
+    }
+
+    void DefaultAppBase::InitBindlessHeap()
+    {
+        if(!mEnableBindlessHeap || !mDevice.GetEnableDefaultDeviceFeatures())
+        {
+            return;
+        }
+        if(!mDevice.HasBindlessSupport())
+        {
+            logger()->info("Device lacks the descriptor indexing features required by the bindless descriptor heap, Context::Bindless is not set. GBufferStage and DefaultRaytracingStageBase are unavailable");
+            return;
+        }
+        mBindlessHeap.Create(&mContext);
+        mContext.Bindless = &mBindlessHeap;
+    }
+
+    void DefaultAppBase::InitTransientImageAllocator()
+    {
+        if(!mEnableTransientImageAllocator)
+        {
+            return;
+        }
+        mTransientImageAllocator.Create(&mContext);
+        mContext.TransientImages = &mTransientImageAllocator;
+    }
+
+    void DefaultAppBase::InitFrameTimeline()
+    {
+        // Timeline semaphores are enabled as part of the default device features
+        if(!mEnableFrameTimeline || !mDevice.GetEnableDefaultDeviceFeatures())
+        {
+            return;
+        }
+        mFrameTimeline.Create(&mContext);
+        mContext.Timeline = &mFrameTimeline;
+    }
+
+    void DefaultAppBase::BuildTransientImages(const std::unordered_map<const core::ManagedImage*, core::TransientImageAllocator::Lifetime>& lifetimes)
+    {
+        if(!mTransientImageAllocator.Exists())
+        {
+            return;
+        }
+        AssertVkResult(mContext.VkbDispatchTable->deviceWaitIdle());
+        mTransientImageAllocator.Build(lifetimes);
+        // Recreating their images places them in the blocks
+        for(stages::RenderStage* stage : mRegisteredStages)
+        {
+            stage->Resize(mContext.GetSwapchainSize());
+        }
+        mTransientImageAllocator.RecreateStale();
+    }
+
     void DefaultAppBase::InitSyncObjects()
     {
         for(auto& frame : mInFlightFrames)
@@ -134,16 +223,48 @@ namespace foray::base {
     {
         AssertVkResult(mDevice.GetDispatchTable().deviceWaitIdle());
 
+        // All frames have finished, run deferred destructions while the resources they reference still exist
+        if(mFrameTimeline.Exists())
+        {
+            mFrameTimeline.Collect();
+        }
+
         ApiDestroy();
 
         mSamplerCollection.Destroy();
 
+        mDescriptorPoolAllocator.Destroy();
+        mContext.DescriptorAllocator = nullptr;
+        mBindlessHeap.Destroy();
+        mContext.Bindless = nullptr;
+        mTransientImageAllocator.Destroy();
+        mContext.TransientImages = nullptr;
+
+        if(mPipelineCache.Exists())
+        {
+            mPipelineCache.Save();
+            mPipelineCache.Destroy();
+            mContext.PipelineCache = nullptr;
+        }
+
         for(InFlightFrame& frame : mInFlightFrames)
         {
             frame.Destroy();
         }
+        mFrameTimeline.Destroy();
+        mContext.Timeline = nullptr;
 
         mDevice.GetDispatchTable().destroyCommandPool(mContext.CommandPool, nullptr);
+        if(!!mContext.TransferCommandPool)
+        {
+            mDevice.GetDispatchTable().destroyCommandPool(mContext.TransferCommandPool, nullptr);
+            mContext.TransferCommandPool = nullptr;
+        }
+        if(!!mContext.ComputeCommandPool)
+        {
+            mDevice.GetDispatchTable().destroyCommandPool(mContext.ComputeCommandPool, nullptr);
+            mContext.ComputeCommandPool = nullptr;
+        }
 
         core::ManagedResource::sPrintAllocatedResources(true);
 
@@ -211,9 +332,15 @@ namespace foray::base {
         // Fetch next in flight frame
         InFlightFrame& currentFrame = mInFlightFrames[mInFlightFrameIndex];
 
-        // Wait for it to finish vkWaitForFences(...)
+        // Wait for it to finish vkWaitForFences(...) or vkWaitSemaphores(...) in timeline mode
         currentFrame.WaitForExecutionFinished();
 
+        // Frames finish in order, so everything deferred up to this frame can be destroyed
+        if(mFrameTimeline.Exists())
+        {
+            mFrameTimeline.Collect();
+        }
+
         // The previous time this frame was used would now have query results available
         if(mRenderedFrameCount > INFLIGHT_FRAME_COUNT)
         {
@@ -245,8 +372,8 @@ namespace foray::base {
             return;
         }
 
-        // Reset the fence so it can be signalled again
-        currentFrame.ResetFence();
+        // Reset the fence so it can be signalled again, or assign the next timeline value
+        currentFrame.BeginFrame();
 
 
         FrameRenderInfo frameRenderInfo(renderInfo, &currentFrame);
@@ -294,6 +421,16 @@ namespace foray::base {
         {
             stage->Resize(size);
         }
+        if(mTransientImageAllocator.GetDirty())
+        {
+            // Some transient images outgrew their memory blocks
+            mTransientImageAllocator.Rebuild();
+            for(stages::RenderStage* stage : mRegisteredStages)
+            {
+                stage->Resize(size);
+            }
+            mTransientImageAllocator.RecreateStale();
+        }
     }
 
     void DefaultAppBase::OnShadersRecompiled(std::unordered_set<uint64_t>& recompiledShaderKeys)
@@ -1,7 +1,12 @@
 #pragma once
 #include "../bench/foray_hostbenchmark.hpp"
+#include "../core/foray_bindlessheap.hpp"
+#include "../core/foray_descriptorpoolallocator.hpp"
+#include "../core/foray_frametimeline.hpp"
+#include "../core/foray_pipelinecache.hpp"
 #include "../core/foray_samplercollection.hpp"
 #include "../core/foray_shadermanager.hpp"
+#include "../core/foray_transientimageallocator.hpp"
 #include "../foray_vma.hpp"
 #include "../osi/foray_osmanager.hpp"
 #include "../stages/foray_stages_declares.hpp"
@@ -28,6 +33,12 @@ namespace foray::base {
         FORAY_GETTER_MR(Device)
         FORAY_GETTER_MR(WindowSwapchain)
         FORAY_GETTER_MR(HostFrameRecordBenchmark)
+        FORAY_GETTER_MR(PipelineCache)
+        FORAY_GETTER_MR(PipelineCacheBenchmark)
+        FORAY_GETTER_MR(DescriptorPoolAllocator)
+        FORAY_GETTER_MR(BindlessHeap)
+        FORAY_GETTER_MR(TransientImageAllocator)
+        FORAY_GETTER_MR(FrameTimeline)
 
         /// @brief Runs through the entire application lifetime
         int32_t Run();
@@ -81,6 +92,22 @@ namespace foray::base {
         virtual void InitCreateVma();
         /// @brief [Internal] Initializes Synchronization Objects (InFlightFrame vector)
         virtual void InitSyncObjects();
+        /// @brief [Internal] Initializes the pipeline cache (loaded from disk) and sets Context::PipelineCache
+        virtual void InitPipelineCache();
+        /// @brief [Internal] Initializes the shared descriptor pool allocator and sets Context::DescriptorAllocator
+        virtual void InitDescriptorPoolAllocator();
+        /// @brief [Internal] Initializes the bindless descriptor heap and sets Context::Bindless
+        virtual void InitBindlessHeap();
+        /// @brief [Internal] Initializes the transient image allocator and sets Context::TransientImages
+        virtual void InitTransientImageAllocator();
+        /// @brief [Internal] Initializes the frame timeline and sets Context::Timeline
+        virtual void InitFrameTimeline();
+
+        /// @brief Assigns transient images to shared memory blocks according to lifetimes (see core::TransientImageAllocator::Build()), then resizes all registered
+        /// render stages to the current swapchain size, so they recreate their images in the blocks and update their descriptors. Transient images not owned
+        /// by a registered stage are recreated via core::TransientImageAllocator::RecreateStale(). Call after stage initialization
+        /// @param lifetimes Image lifetimes within a frame, e.g. stages::RenderGraph::GetImageLifetimes()
+        void BuildTransientImages(const std::unordered_map<const core::ManagedImage*, core::TransientImageAllocator::Lifetime>& lifetimes);
 
         /// @brief [Internal] Recreates the swapchain
         virtual void RecreateSwapchain();
@@ -100,14 +127,19 @@ namespace foray::base {
         /// @brief [Internal] Finalizer
         virtual void Destroy();
 
-        RenderLoop              mRenderLoop;
-        osi::OsManager          mOsManager;
-        VulkanInstance          mInstance;
-        VulkanDevice            mDevice;
-        VulkanWindowSwapchain   mWindowSwapchain;
-        core::SamplerCollection mSamplerCollection;
-        core::Context           mContext;
-        core::ShaderManager     mShaderManager;
+        RenderLoop                    mRenderLoop;
+        osi::OsManager                mOsManager;
+        VulkanInstance                mInstance;
+        VulkanDevice                  mDevice;
+        VulkanWindowSwapchain         mWindowSwapchain;
+        core::SamplerCollection       mSamplerCollection;
+        core::Context                 mContext;
+        core::ShaderManager           mShaderManager;
+        core::PipelineCache           mPipelineCache;
+        core::DescriptorPoolAllocator mDescriptorPoolAllocator;
+        core::BindlessHeap            mBindlessHeap;
+        core::TransientImageAllocator mTransientImageAllocator;
+        core::FrameTimeline           mFrameTimeline;
 
         /// @brief Increase this in an early init method to get auxiliary command buffers
         uint32_t                                        mAuxiliaryCommandBufferCount = 0;
@@ -126,5 +158,21 @@ namespace foray::base {
 
         bool                 mEnableFrameRecordBenchmark = false;
         bench::HostBenchmark mHostFrameRecordBenchmark;
+
+        /// @brief If true, a pipeline cache is loaded at init and written back to disk on shutdown. Set in ApiBeforeInit()
+        bool mEnablePipelineCache = true;
+        /// @brief Directory the pipeline cache file is stored in. Empty: current working directory
+        std::string mPipelineCacheDirectory;
+        /// @brief Records pipeline cache load timing and hit/miss. See core::PipelineCache::BENCH_... members
+        bench::HostBenchmark mPipelineCacheBenchmark;
+
+        /// @brief If true, descriptor sets are allocated from shared growable pools rather than a pool each. Set in ApiBeforeInit()
+        bool mEnableDescriptorPoolAllocator = true;
+        /// @brief If true, a bindless descriptor heap is created which scene managers register their resources with. Requires the default device features and VulkanDevice::HasBindlessSupport(). GBufferStage and DefaultRaytracingStageBase sample textures through it. Set in ApiBeforeInit()
+        bool mEnableBindlessHeap = true;
+        /// @brief If true, images created as transient (core::ManagedImage::CreateInfo::Transient) may alias each others memory once BuildTransientImages() has been called. Set in ApiBeforeInit()
+        bool mEnableTransientImageAllocator = true;
+        /// @brief If true, in flight frames signal a shared timeline semaphore instead of a fence each, and deferred destruction via core::FrameTimeline::Defer() is available. Requires the default device features. Set in ApiBeforeInit()
+        bool mEnableFrameTimeline = true;
     };
 }  // namespace foray::base
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "foray_inflightframe.hpp"
 #include "../core/foray_context.hpp"
+#include "../core/foray_frametimeline.hpp"
 #include "../core/foray_imagelayoutcache.hpp"
 
 
@@ -32,9 +33,20 @@ namespace foray::base {
 
         AssertVkResult(mContext->VkbDispatchTable->createSemaphore(&semaphoreCI, nullptr, &mPrimaryCompletedSemaphore));
 
-        AssertVkResult(mContext->VkbDispatchTable->createFence(&fenceCI, nullptr, &mPrimaryCompletedFence));
-        mPrimaryCommandBuffer.SetFence(mPrimaryCompletedFence);
         mPrimaryCommandBuffer.AddSignalSemaphore(core::SemaphoreReference::Binary(mPrimaryCompletedSemaphore));
+        if(!!mContext->Timeline)
+        {
+            Assert(mContext->Timeline->Exists(), "[InFlightFrame::Create] Context::Timeline must be created first");
+            mTimeline      = mContext->Timeline;
+            mTimelineValue = 0;
+            // Value is set by BeginFrame()
+            mPrimaryCommandBuffer.AddSignalSemaphore(core::SemaphoreReference::Timeline(mTimeline->GetSemaphore(), 0));
+        }
+        else
+        {
+            AssertVkResult(mContext->VkbDispatchTable->createFence(&fenceCI, nullptr, &mPrimaryCompletedFence));
+            mPrimaryCommandBuffer.SetFence(mPrimaryCompletedFence);
+        }
         if(auxCommandBufferCount == 0)
         {
             mPrimaryCommandBuffer.AddWaitSemaphore(core::SemaphoreReference::Binary(mSwapchainImageReady));
@@ -61,7 +73,9 @@ namespace foray::base {
             mContext->VkbDispatchTable->destroyFence(mPrimaryCompletedFence, nullptr);
             mPrimaryCompletedFence = nullptr;
         }
-        mContext = nullptr;
+        mTimeline      = nullptr;
+        mTimelineValue = 0;
+        mContext       = nullptr;
     }
     ESwapchainInteractResult InFlightFrame::AcquireSwapchainImage()
     {
@@ -199,6 +213,10 @@ namespace foray::base {
 
     bool InFlightFrame::HasFinishedExecution()
     {
+        if(!!mTimeline)
+        {
+            return mTimeline->HasCompleted(mTimelineValue);
+        }
         VkResult result = mContext->VkbDispatchTable->getFenceStatus(mPrimaryCompletedFence);
         if(result == VK_NOT_READY)
         {
@@ -209,14 +227,37 @@ namespace foray::base {
     }
     void InFlightFrame::WaitForExecutionFinished()
     {
+        if(!!mTimeline)
+        {
+            mTimeline->Wait(mTimelineValue);
+            return;
+        }
         AssertVkResult(mContext->VkbDispatchTable->waitForFences(1, &mPrimaryCompletedFence, VK_TRUE, UINT64_MAX));
     }
 
     void InFlightFrame::ResetFence()
     {
+        Assert(!mTimeline, "[InFlightFrame::ResetFence] Frame uses timeline synchronization, use BeginFrame()");
         AssertVkResult(mContext->VkbDispatchTable->resetFences(1, &mPrimaryCompletedFence));
     }
 
+    void InFlightFrame::BeginFrame()
+    {
+        if(!mTimeline)
+        {
+            ResetFence();
+            return;
+        }
+        mTimelineValue = mTimeline->Advance();
+        for(core::SemaphoreReference& signal : mPrimaryCommandBuffer.GetSignalSemaphores())
+        {
+            if(signal.Semaphore == mTimeline->GetSemaphore())
+            {
+                signal.TimelineValue = mTimelineValue;
+            }
+        }
+    }
+
     void InFlightFrame::SubmitAll()
     {
         std::vector<VkSubmitInfo2> submitInfos;
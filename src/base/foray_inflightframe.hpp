@@ -28,6 +28,11 @@ namespace foray::base {
     ///   - The user must synchronize all commandbuffers themselves, so the primary commandbuffer functions properly:
     ///     - Add the SwapchainImageReady Semaphore as a waitsemaphore to one of the command buffers
     ///     - Use semaphores to synchronise your command buffers as needed
+    ///
+    /// HOST SYNCHRONIZATION
+    ///   - Fence mode (default): The primary command buffer signals a fence per frame
+    ///   - Timeline mode (Context::Timeline set at Create()): BeginFrame() assigns the frame the next value of the shared core::FrameTimeline,
+    ///     which the primary command buffer signals instead of a fence. Binary semaphores remain in use for swapchain acquire and present only
     class InFlightFrame
     {
       public:
@@ -52,8 +57,13 @@ namespace foray::base {
         bool HasFinishedExecution();
         /// @brief Blocks the current thread until the frame has finished execution
         void WaitForExecutionFinished();
-        /// @brief Resets the frames host synchronization fence
+        /// @brief Resets the frames host synchronization fence (fence mode only)
         void ResetFence();
+        /// @brief Prepares host synchronization for the next submission: Resets the fence (fence mode) or assigns the next timeline value (timeline mode).
+        /// Call after waiting for the previous execution to finish, before submitting
+        void BeginFrame();
+        /// @brief True, if the frame signals Context::Timeline rather than a fence
+        inline bool UsesTimeline() const { return !!mTimeline; }
 
         /// @brief Submits all command buffers by getting all VkSubmitInfo2{} structures from DeviceSyncCommandBuffer::WriteToSubmitInfo(...) 
         /// and submitting them in a single vkQueueSubmit2(...) call
@@ -80,6 +90,8 @@ namespace foray::base {
         FORAY_GETTER_V(SwapchainImageReady)
         FORAY_GETTER_V(PrimaryCompletedSemaphore)
         FORAY_GETTER_V(PrimaryCompletedFence)
+        /// @brief Timeline value signalled once the frame has finished execution (timeline mode only, zero before the first frame)
+        FORAY_GETTER_V(TimelineValue)
 
       protected:
         core::Context* mContext = nullptr;
@@ -92,9 +104,14 @@ namespace foray::base {
         VkSemaphore mSwapchainImageReady       = nullptr;
         /// @brief Semaphore signalled by the primary command buffer when execution has finished
         VkSemaphore mPrimaryCompletedSemaphore = nullptr;
-        /// @brief Fence signalled after the primary / all command buffers have finished execution
+        /// @brief Fence signalled after the primary / all command buffers have finished execution (fence mode only)
         VkFence     mPrimaryCompletedFence     = nullptr;
 
+        /// @brief Timeline signalled by the primary command buffer (timeline mode only)
+        core::FrameTimeline* mTimeline      = nullptr;
+        /// @brief Value of mTimeline assigned to the current frame
+        uint64_t             mTimelineValue = 0;
+
         uint32_t mSwapchainImageIndex = 0;
     };
 }  // namespace foray::base
@@ -58,6 +58,14 @@ namespace foray::base {
                                                         VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME};
             deviceSelector.add_required_extensions(requiredExtensions);
 
+#ifdef VK_EXT_descriptor_buffer
+            if(mEnableDescriptorBuffer && mEnableDefaultDeviceFeatures)
+            {
+                // Enabled if present. DescriptorSet falls back to descriptor pools otherwise
+                deviceSelector.add_desired_extension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+            }
+#endif
+
 			if(mEnableDefaultPhysicalDeviceFeatures)
             {
 				// Enable samplerAnisotropy
@@ -109,12 +117,42 @@ namespace foray::base {
     {
         Assert(!!mPhysicalDevice.physical_device, "[VulkanDevice::BuildDevice] Must select physical device first!");
 
+        // Features used only by optional code paths are enabled if supported. Components check Context::Enabled...Features before using them
+        VkPhysicalDeviceVulkan11Features supported11{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
+        VkPhysicalDeviceVulkan12Features supported12{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, .pNext = &supported11};
+        VkPhysicalDeviceFeatures2        supported{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &supported12};
+        if(mEnableDefaultDeviceFeatures)
+        {
+            vkGetPhysicalDeviceFeatures2(mPhysicalDevice.physical_device, &supported);
+            // Multi draw indirect is the fallback for indirect draws without drawIndirectCount. Set before the device builder copies the physical device
+            mPhysicalDevice.features.multiDrawIndirect = supported.features.multiDrawIndirect;
+        }
+
         vkb::DeviceBuilder deviceBuilder(mPhysicalDevice);
 
         if(mEnableDefaultDeviceFeatures)
         {
-            mDefaultFeatures.BufferDeviceAdressFeatures = {.sType               = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES,
-                                                           .bufferDeviceAddress = VK_TRUE};
+            mDefaultFeatures.Vulkan11Features = {.sType                = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+                                                 .shaderDrawParameters = supported11.shaderDrawParameters};  // gl_DrawID for indirect drawing
+
+            // Vulkan 1.2 features are enabled via the aggregate struct, as chaining it together with the individual feature structs it replaces is not allowed
+            mDefaultFeatures.Vulkan12Features = {.sType                                     = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+                                                 .drawIndirectCount                         = supported12.drawIndirectCount,
+                                                 .descriptorIndexing                        = supported12.descriptorIndexing,
+                                                 .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+                                                 .runtimeDescriptorArray                    = VK_TRUE,  // enable this for unbound descriptor arrays
+                                                 .timelineSemaphore                         = VK_TRUE,
+                                                 .bufferDeviceAddress                       = VK_TRUE};
+
+            if(HasBindlessSupport())
+            {
+                // core::BindlessHeap
+                mDefaultFeatures.Vulkan12Features.shaderStorageBufferArrayNonUniformIndexing    = VK_TRUE;
+                mDefaultFeatures.Vulkan12Features.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+                mDefaultFeatures.Vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+                mDefaultFeatures.Vulkan12Features.descriptorBindingUpdateUnusedWhilePending     = VK_TRUE;
+                mDefaultFeatures.Vulkan12Features.descriptorBindingPartiallyBound               = VK_TRUE;
+            }
 
             mDefaultFeatures.RayTracingPipelineFeatures = {.sType              = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR,
                                                            .rayTracingPipeline = VK_TRUE};
@@ -122,17 +160,27 @@ namespace foray::base {
             mDefaultFeatures.AccelerationStructureFeatures = {.sType                 = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR,
                                                               .accelerationStructure = VK_TRUE};
 
-            mDefaultFeatures.DescriptorIndexingFeatures = {.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT,
-                                                           .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
-                                                           .runtimeDescriptorArray                    = VK_TRUE};  // enable this for unbound descriptor arrays
-
             mDefaultFeatures.Sync2FEatures = {.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES, .synchronization2 = VK_TRUE};
 
-            deviceBuilder.add_pNext(&mDefaultFeatures.BufferDeviceAdressFeatures);
+            deviceBuilder.add_pNext(&mDefaultFeatures.Vulkan11Features);
+            deviceBuilder.add_pNext(&mDefaultFeatures.Vulkan12Features);
             deviceBuilder.add_pNext(&mDefaultFeatures.RayTracingPipelineFeatures);
             deviceBuilder.add_pNext(&mDefaultFeatures.AccelerationStructureFeatures);
-            deviceBuilder.add_pNext(&mDefaultFeatures.DescriptorIndexingFeatures);
             deviceBuilder.add_pNext(&mDefaultFeatures.Sync2FEatures);
+
+#ifdef VK_EXT_descriptor_buffer
+            if(mEnableDescriptorBuffer && HasDescriptorBufferSupport())
+            {
+                mDefaultFeatures.DescriptorBufferFeatures = {.sType            = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+                                                             .descriptorBuffer = VK_TRUE};
+                deviceBuilder.add_pNext(&mDefaultFeatures.DescriptorBufferFeatures);
+
+                mDescriptorBufferProperties = {.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+                VkPhysicalDeviceProperties2 properties{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &mDescriptorBufferProperties};
+                vkGetPhysicalDeviceProperties2(mPhysicalDevice.physical_device, &properties);
+                mContext->DescriptorBufferProperties = &mDescriptorBufferProperties;
+            }
+#endif
         }
 
         if(!!mBeforeDeviceBuildFunc)
@@ -148,6 +196,103 @@ namespace foray::base {
         mDispatchTable             = mDevice.make_table();
         mContext->VkbDevice        = &mDevice;
         mContext->VkbDispatchTable = &mDispatchTable;
+
+        if(mEnableDefaultDeviceFeatures)
+        {
+            mContext->EnabledFeatures         = &mPhysicalDevice.features;
+            mContext->EnabledVulkan11Features = &mDefaultFeatures.Vulkan11Features;
+            mContext->EnabledVulkan12Features = &mDefaultFeatures.Vulkan12Features;
+        }
+
+        SelectQueues();
+    }
+
+    void VulkanDevice::SelectQueues()
+    {
+        Assert(!!mDevice.device, "[VulkanDevice::SelectQueues] Must build device first!");
+
+        mContext->TransferQueue            = nullptr;
+        mContext->TransferQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        mContext->ComputeQueue             = nullptr;
+        mContext->ComputeQueueFamilyIndex  = VK_QUEUE_FAMILY_IGNORED;
+
+        if(mSelectDedicatedTransferQueue)
+        {
+            // Prefer transfer-only families (DMA engines), accept any non-graphics family supporting transfer
+            auto retIndex = mDevice.get_dedicated_queue_index(vkb::QueueType::transfer);
+            if(!retIndex)
+            {
+                retIndex = mDevice.get_queue_index(vkb::QueueType::transfer);
+            }
+            if(!!retIndex)
+            {
+                mDispatchTable.getDeviceQueue(*retIndex, 0, &mContext->TransferQueue);
+                mContext->TransferQueueFamilyIndex = *retIndex;
+                logger()->info("Using dedicated transfer queue of queue family #{}", *retIndex);
+            }
+            else
+            {
+                logger()->info("No dedicated transfer queue available, transfers share the main queue");
+            }
+        }
+
+        if(mSelectAsyncComputeQueue)
+        {
+            auto retIndex = mDevice.get_dedicated_queue_index(vkb::QueueType::compute);
+            if(!retIndex)
+            {
+                retIndex = mDevice.get_queue_index(vkb::QueueType::compute);
+            }
+            if(!!retIndex)
+            {
+                mDispatchTable.getDeviceQueue(*retIndex, 0, &mContext->ComputeQueue);
+                mContext->ComputeQueueFamilyIndex = *retIndex;
+                logger()->info("Using async compute queue of queue family #{}", *retIndex);
+            }
+            else
+            {
+                logger()->info("No async compute queue available, compute shares the main queue");
+            }
+        }
+    }
+
+    bool VulkanDevice::HasBindlessSupport() const
+    {
+        if(!mPhysicalDevice.physical_device)
+        {
+            return false;
+        }
+        VkPhysicalDeviceVulkan12Features vulkan12Features{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+        VkPhysicalDeviceFeatures2        features{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &vulkan12Features};
+        vkGetPhysicalDeviceFeatures2(mPhysicalDevice.physical_device, &features);
+        return vulkan12Features.shaderStorageBufferArrayNonUniformIndexing == VK_TRUE && vulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE
+               && vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE && vulkan12Features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE
+               && vulkan12Features.descriptorBindingPartiallyBound == VK_TRUE;
+    }
+
+    bool VulkanDevice::HasDescriptorBufferSupport() const
+    {
+#ifdef VK_EXT_descriptor_buffer
+        if(!mPhysicalDevice.physical_device)
+        {
+            return false;
+        }
+        bool extensionEnabled = false;
+        for(const std::string& extension : mPhysicalDevice.get_extensions())
+        {
+            extensionEnabled |= extension == VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME;
+        }
+        if(!extensionEnabled)
+        {
+            return false;
+        }
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT};
+        VkPhysicalDeviceFeatures2                   features{.sType = VkStructureType::VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &descriptorBufferFeatures};
+        vkGetPhysicalDeviceFeatures2(mPhysicalDevice.physical_device, &features);
+        return descriptorBufferFeatures.descriptorBuffer == VK_TRUE;
+#else
+        return false;
+#endif
     }
 
     void VulkanDevice::Destroy()
@@ -161,9 +306,15 @@ namespace foray::base {
         mPhysicalDevice = vkb::PhysicalDevice();
         if(!!mContext)
         {
-            mContext->VkbPhysicalDevice = nullptr;
-            mContext->VkbDevice         = nullptr;
-            mContext->VkbDispatchTable  = nullptr;
+            mContext->VkbPhysicalDevice       = nullptr;
+            mContext->VkbDevice               = nullptr;
+            mContext->VkbDispatchTable        = nullptr;
+            mContext->EnabledFeatures         = nullptr;
+            mContext->EnabledVulkan11Features = nullptr;
+            mContext->EnabledVulkan12Features = nullptr;
+#ifdef VK_EXT_descriptor_buffer
+            mContext->DescriptorBufferProperties = nullptr;
+#endif
         }
     }
 
@@ -36,6 +36,9 @@ namespace foray::base {
         FORAY_PROPERTY_V(EnableDefaultDeviceFeatures)
         FORAY_PROPERTY_V(EnableDefaultPhysicalDeviceFeatures)
         FORAY_PROPERTY_V(ShowConsoleDeviceSelectionPrompt)
+        FORAY_PROPERTY_V(SelectDedicatedTransferQueue)
+        FORAY_PROPERTY_V(SelectAsyncComputeQueue)
+        FORAY_PROPERTY_V(EnableDescriptorBuffer)
         FORAY_PROPERTY_R(PhysicalDeviceFeatures)
         FORAY_PROPERTY_R(PhysicalDevice)
         FORAY_PROPERTY_R(Device)
@@ -51,6 +54,13 @@ namespace foray::base {
         /// @brief If mEnableDefaultDeviceFeatures is set, configures defaults. If mBeforeDeviceBuildFunc is set, invokes it. Builds device.
         /// @remark Will throw std::exception if building fails
         void        BuildDevice();
+        /// @brief Writes transfer and compute queues to the context (Context::TransferQueue, Context::ComputeQueue), if enabled and available. Called by BuildDevice().
+        /// @remark Relies on vkb's default queue setup (one queue per queue family). If the queue setup is customized in mBeforeDeviceBuildFunc, disable queue selection.
+        void SelectQueues();
+        /// @brief True, if the selected physical device supports VK_EXT_descriptor_buffer (extension and descriptorBuffer feature)
+        bool        HasDescriptorBufferSupport() const;
+        /// @brief True, if the selected physical device supports the descriptor indexing features core::BindlessHeap requires (update after bind, partially bound, non uniform storage buffer indexing). If so, they are part of the default device features
+        bool        HasBindlessSupport() const;
         inline bool Exists() const { return !!mDevice.device; }
         void        Destroy();
 
@@ -70,6 +80,13 @@ namespace foray::base {
         /// @brief If enabled, prompts the user in the console to select a device if multiple suitable devices are present. If disabled, selects the first index.
         bool mShowConsoleDeviceSelectionPrompt = false;
 
+        /// @brief If enabled, selects a transfer queue from a queue family without graphics capability (preferring families without compute capability). Falls back to the main queue if none exists.
+        bool mSelectDedicatedTransferQueue = true;
+        /// @brief If enabled, selects a compute queue from a queue family without graphics capability. Falls back to the main queue if none exists.
+        bool mSelectAsyncComputeQueue = true;
+        /// @brief If enabled (and default device features are enabled), VK_EXT_descriptor_buffer is enabled if the device supports it and its properties are published via Context::DescriptorBufferProperties
+        bool mEnableDescriptorBuffer = true;
+
         core::Context* mContext = nullptr;
 
         vkb::PhysicalDevice mPhysicalDevice;
@@ -78,13 +95,20 @@ namespace foray::base {
 
         struct DefaultFeatures
         {
-            VkPhysicalDeviceBufferDeviceAddressFeatures      BufferDeviceAdressFeatures    = {};
+            VkPhysicalDeviceVulkan11Features                 Vulkan11Features              = {};
+            VkPhysicalDeviceVulkan12Features                 Vulkan12Features              = {};
             VkPhysicalDeviceRayTracingPipelineFeaturesKHR    RayTracingPipelineFeatures    = {};
             VkPhysicalDeviceAccelerationStructureFeaturesKHR AccelerationStructureFeatures = {};
-            VkPhysicalDeviceDescriptorIndexingFeaturesEXT    DescriptorIndexingFeatures    = {};
             VkPhysicalDeviceSynchronization2Features         Sync2FEatures                 = {};
+#ifdef VK_EXT_descriptor_buffer
+            VkPhysicalDeviceDescriptorBufferFeaturesEXT DescriptorBufferFeatures = {};
+#endif
         } mDefaultFeatures = {};
 
+#ifdef VK_EXT_descriptor_buffer
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT mDescriptorBufferProperties{};
+#endif
+
 		VkPhysicalDeviceFeatures mPhysicalDeviceFeatures{};
     };
 }  // namespace foray::base
\ No newline at end of file
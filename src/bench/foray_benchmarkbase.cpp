@@ -1,5 +1,6 @@
 #include "foray_benchmarkbase.hpp"
 #include "../foray_exception.hpp"
+#include <algorithm>
 #include <imgui/imgui.h>
 #include <iomanip>
 #include <limits>
@@ -15,6 +16,10 @@ namespace foray::bench {
         {
             tsLen = std::max(strlen(ts.Id), tsLen);
         }
+        for(const auto& value : Values)
+        {
+            tsLen = std::max(strlen(value.Id), tsLen);
+        }
         std::stringstream out;
         out << std::setprecision(5) << std::fixed;
         out << std::left << std::setw(tsLen + 2) << "Id"
@@ -55,6 +60,11 @@ namespace foray::bench {
                 out << " | " << std::setw(16) << "";
             }
         }
+
+        for(const auto& value : Values)
+        {
+            out << "\n  " << std::setw(tsLen) << value.Id << " | " << std::setw(16) << value.Value;
+        }
         return out.str();
     }
     std::string BenchmarkLog::PrintCsvLine(char separator, bool includeNewLine) const
@@ -146,12 +156,98 @@ namespace foray::bench {
                 ImGui::Text("%f ms", End - Begin);
             }
 
+            for(const auto& value : Values)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(value.Id);
+                ImGui::TableNextColumn();
+                ImGui::Text("%f", value.Value);
+            }
+
             ImGui::EndTable();
         }
     }
 
     BenchmarkBase::BenchmarkBase() {}
 
+    std::string BenchmarkBase::PrintCsv(char separator) const
+    {
+        // Columns: Every timestamp id, then every value id, in order of first appearance across all logs
+        std::vector<std::string_view> timestampIds;
+        std::vector<std::string_view> valueIds;
+        auto                          lAddId = [](std::vector<std::string_view>& ids, std::string_view id) {
+            if(std::find(ids.begin(), ids.end(), id) == ids.end())
+            {
+                ids.push_back(id);
+            }
+        };
+        for(const BenchmarkLog& log : mLogs)
+        {
+            for(const BenchmarkTimestamp& timestamp : log.Timestamps)
+            {
+                lAddId(timestampIds, timestamp.Id);
+            }
+            for(const BenchmarkValue& value : log.Values)
+            {
+                lAddId(valueIds, value.Id);
+            }
+        }
+        // End is logged last, but may be first seen before ids only some runs log
+        std::erase(timestampIds, std::string_view(BenchmarkTimestamp::END));
+        timestampIds.push_back(BenchmarkTimestamp::END);
+
+        std::stringstream out;
+        out << std::setprecision(std::numeric_limits<long double>::digits10 + 1) << std::fixed;
+        for(size_t i = 0; i < timestampIds.size(); i++)
+        {
+            if(i > 0)
+            {
+                out << separator;
+            }
+            out << timestampIds[i];
+        }
+        for(std::string_view id : valueIds)
+        {
+            out << separator << id;
+        }
+        out << "\n";
+
+        // Every row has the same columns. Cells of ids a run did not log are left empty
+        for(const BenchmarkLog& log : mLogs)
+        {
+            for(size_t i = 0; i < timestampIds.size(); i++)
+            {
+                if(i > 0)
+                {
+                    out << separator;
+                }
+                for(const BenchmarkTimestamp& timestamp : log.Timestamps)
+                {
+                    if(timestampIds[i] == timestamp.Id)
+                    {
+                        out << timestamp.Timestamp;
+                        break;
+                    }
+                }
+            }
+            for(std::string_view id : valueIds)
+            {
+                out << separator;
+                for(const BenchmarkValue& value : log.Values)
+                {
+                    if(id == value.Id)
+                    {
+                        out << value.Value;
+                        break;
+                    }
+                }
+            }
+            out << "\n";
+        }
+        return out.str();
+    }
+
     void BenchmarkBase::Begin(fp64_t timestamp)
     {
         Assert(!mRecording, "Can not begin new benchmark when a benchmark is already running! End previous benchmark with BenchmarkBase::End() first!");
@@ -175,4 +271,9 @@ namespace foray::bench {
         mRecording = false;
         mLogs.emplace_back(mCurrentLog);
     }
+    void BenchmarkBase::LogValue(const char* id, fp64_t value)
+    {
+        Assert(mRecording, "Cannot log value with no benchmark in progress! Call BenchmarkBase::Begin() first!");
+        mCurrentLog.Values.emplace_back(BenchmarkValue{.Id = id, .Value = value});
+    }
 }  // namespace foray::bench
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "../foray_basics.hpp"
+#include <string>
 #include <vector>
 
 namespace foray::bench {
@@ -16,6 +17,16 @@ namespace foray::bench {
         fp64_t Timestamp = 0.0;
     };
 
+    /// @brief Non-time value (sizes, counts, ...) recorded alongside the timestamps of a benchmark run
+    class BenchmarkValue
+    {
+      public:
+        /// @brief Id of the data point for identification
+        const char* Id = "no Id";
+        /// @brief Recorded value
+        fp64_t Value = 0.0;
+    };
+
     /// @brief Log of a single benchmark run. All timestamps given must be relative to the same base time
     class BenchmarkLog
     {
@@ -28,12 +39,14 @@ namespace foray::bench {
         std::vector<BenchmarkTimestamp> Timestamps;
         /// @brief Deltas between the timestamps in milliseconds
         std::vector<fp64_t> Deltas;
+        /// @brief Non-time values recorded during the run, in order of recording
+        std::vector<BenchmarkValue> Values;
 
         /// @brief Prints a table with all timestamps and deltas, aswell as a total delta
         std::string PrintPretty(bool omitTimestamps = true) const;
         /// @brief Prints all timestamps, separated by the separator character
         std::string PrintCsvLine(char separator = ';', bool includeNewLine = true) const;
-        /// @brief Prints all timestamps, separated by the separator character
+        /// @brief Prints the ids of all timestamps, separated by the separator character
         std::string PrintCsvHeader(char separator = ';', bool includeNewLine = true) const;
         /// @brief Execute imgui command sequence to display the benchmark results
         void PrintImGui(bool omitTimestamps = true);
@@ -45,6 +58,10 @@ namespace foray::bench {
       public:
         BenchmarkBase();
 
+        /// @brief Prints all logs as csv table with a single header line. Columns are the union of all timestamp ids followed by all value ids,
+        /// so every row has the same columns. Cells for ids a run did not record stay empty.
+        std::string PrintCsv(char separator = ';') const;
+
         FORAY_GETTER_MR(Logs)
         FORAY_GETTER_CR(Logs)
 
@@ -55,6 +72,8 @@ namespace foray::bench {
         void LogTimestamp(const char* id, fp64_t timestamp);
         /// @brief Records the "End" timestamp and finalizes the benchmark
         void End(fp64_t timestamp);
+        /// @brief Records a non-time value of id
+        void LogValue(const char* id, fp64_t value);
 
         std::vector<BenchmarkLog> mLogs;
         BenchmarkLog              mCurrentLog;
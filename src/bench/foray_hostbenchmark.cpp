@@ -25,4 +25,8 @@ namespace foray::bench {
     {
         BenchmarkBase::End(lGetTimestamp());
     }
+    void HostBenchmark::LogValue(const char* id, fp64_t value)
+    {
+        BenchmarkBase::LogValue(id, value);
+    }
 }  // namespace foray
\ No newline at end of file
@@ -13,5 +13,7 @@ namespace foray::bench {
         void LogTimestamp(const char* id);
         /// @brief Records the "End" timestamp and finalizes the benchmark
         void End();
+        /// @brief Records a non-time value (for example a size in bytes) of id
+        void LogValue(const char* id, fp64_t value);
     };
 }  // namespace foray
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "foray_barrierbatch.hpp"
+#include "../foray_exception.hpp"
+#include "foray_context.hpp"
+#include "foray_managedimage.hpp"
+
+namespace foray::core {
+    BarrierBatch& BarrierBatch::AddImage(VkImage image, const ImageLayoutCache::Barrier2& barrier)
+    {
+        Assert(!!mLayoutCache, "BarrierBatch requires an ImageLayoutCache for tracked image barriers");
+        mLayoutCache->MakeBarriers(image, barrier, mImageBarriers);
+        return *this;
+    }
+
+    BarrierBatch& BarrierBatch::AddImage(const ManagedImage* image, const ImageLayoutCache::Barrier2& barrier)
+    {
+        return AddImage(*image, barrier);
+    }
+
+    BarrierBatch& BarrierBatch::AddImage(const ManagedImage& image, const ImageLayoutCache::Barrier2& barrier)
+    {
+        Assert(!!mLayoutCache, "BarrierBatch requires an ImageLayoutCache for tracked image barriers");
+        mLayoutCache->MakeBarriers(image, barrier, mImageBarriers);
+        return *this;
+    }
+
+    BarrierBatch& BarrierBatch::AddImage(const VkImageMemoryBarrier2& barrier)
+    {
+        mImageBarriers.push_back(barrier);
+        return *this;
+    }
+
+    BarrierBatch& BarrierBatch::AddBuffer(const VkBufferMemoryBarrier2& barrier)
+    {
+        mBufferBarriers.push_back(barrier);
+        return *this;
+    }
+
+    BarrierBatch& BarrierBatch::AddBuffer(VkBuffer              buffer,
+                                          VkPipelineStageFlags2 srcStageMask,
+                                          VkAccessFlags2        srcAccessMask,
+                                          VkPipelineStageFlags2 dstStageMask,
+                                          VkAccessFlags2        dstAccessMask,
+                                          VkDeviceSize          offset,
+                                          VkDeviceSize          size)
+    {
+        return AddBuffer(VkBufferMemoryBarrier2{.sType               = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                                                .srcStageMask        = srcStageMask,
+                                                .srcAccessMask       = srcAccessMask,
+                                                .dstStageMask        = dstStageMask,
+                                                .dstAccessMask       = dstAccessMask,
+                                                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                .buffer              = buffer,
+                                                .offset              = offset,
+                                                .size                = size});
+    }
+
+    BarrierBatch& BarrierBatch::AddMemory(const VkMemoryBarrier2& barrier)
+    {
+        mMemoryBarriers.push_back(barrier);
+        return *this;
+    }
+
+    BarrierBatch& BarrierBatch::AddMemory(VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+    {
+        return AddMemory(VkMemoryBarrier2{.sType         = VkStructureType::VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                                          .srcStageMask  = srcStageMask,
+                                          .srcAccessMask = srcAccessMask,
+                                          .dstStageMask  = dstStageMask,
+                                          .dstAccessMask = dstAccessMask});
+    }
+
+    uint32_t BarrierBatch::CmdFlush(VkCommandBuffer cmdBuffer, VkDependencyFlags depFlags)
+    {
+        return CmdFlushInternal(nullptr, cmdBuffer, depFlags);
+    }
+
+    uint32_t BarrierBatch::CmdFlush(Context* context, VkCommandBuffer cmdBuffer, VkDependencyFlags depFlags)
+    {
+        Assert(!!context, "BarrierBatch::CmdFlush: context is nullptr");
+        return CmdFlushInternal(context, cmdBuffer, depFlags);
+    }
+
+    uint32_t BarrierBatch::CmdFlushInternal(Context* context, VkCommandBuffer cmdBuffer, VkDependencyFlags depFlags)
+    {
+        uint32_t count = GetBarrierCount();
+        if(count == 0)
+        {
+            return 0;
+        }
+        VkDependencyInfo depInfo{.sType                    = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                 .dependencyFlags          = depFlags,
+                                 .memoryBarrierCount       = (uint32_t)mMemoryBarriers.size(),
+                                 .pMemoryBarriers          = mMemoryBarriers.data(),
+                                 .bufferMemoryBarrierCount = (uint32_t)mBufferBarriers.size(),
+                                 .pBufferMemoryBarriers    = mBufferBarriers.data(),
+                                 .imageMemoryBarrierCount  = (uint32_t)mImageBarriers.size(),
+                                 .pImageMemoryBarriers     = mImageBarriers.data()};
+        if(!!context)
+        {
+            context->VkbDispatchTable->cmdPipelineBarrier2(cmdBuffer, &depInfo);
+        }
+        else
+        {
+            vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
+        }
+        mFlushCount++;
+        mFlushedBarrierCount += count;
+        Clear();
+        return count;
+    }
+
+    void BarrierBatch::Clear()
+    {
+        mImageBarriers.clear();
+        mBufferBarriers.clear();
+        mMemoryBarriers.clear();
+    }
+}  // namespace foray::core
@@ -0,0 +1,78 @@
+#pragma once
+#include "../foray_basics.hpp"
+#include "../foray_vulkan.hpp"
+#include "foray_core_declares.hpp"
+#include "foray_imagelayoutcache.hpp"
+#include <vector>
+
+namespace foray::core {
+    /// @brief Accumulates image, buffer and memory barriers and records them in a single vkCmdPipelineBarrier2 command
+    /// @details
+    /// Tracked image barriers take their old layout from the ImageLayoutCache and update it. If the barriers subresource range contains
+    /// differing layouts, one barrier per uniform subrange is added.
+    class BarrierBatch
+    {
+      public:
+        /// @param layoutCache Layout cache used for tracked image barriers. May be nullptr if only untracked barriers are added
+        inline explicit BarrierBatch(ImageLayoutCache* layoutCache = nullptr) : mLayoutCache(layoutCache) {}
+        /// @param layoutCache Layout cache used for tracked image barriers
+        inline explicit BarrierBatch(ImageLayoutCache& layoutCache) : mLayoutCache(&layoutCache) {}
+
+        /// @brief Adds a layout transition, old layout(s) are taken from and new layout written to the layout cache
+        BarrierBatch& AddImage(VkImage image, const ImageLayoutCache::Barrier2& barrier);
+        /// @brief Adds a layout transition, old layout(s) are taken from and new layout written to the layout cache
+        BarrierBatch& AddImage(const ManagedImage* image, const ImageLayoutCache::Barrier2& barrier);
+        /// @brief Adds a layout transition, old layout(s) are taken from and new layout written to the layout cache
+        BarrierBatch& AddImage(const ManagedImage& image, const ImageLayoutCache::Barrier2& barrier);
+        /// @brief Adds an image barrier as-is. The layout cache is not consulted or updated
+        BarrierBatch& AddImage(const VkImageMemoryBarrier2& barrier);
+
+        /// @brief Adds a buffer barrier as-is
+        BarrierBatch& AddBuffer(const VkBufferMemoryBarrier2& barrier);
+        /// @brief Adds a buffer barrier
+        BarrierBatch& AddBuffer(VkBuffer              buffer,
+                                VkPipelineStageFlags2 srcStageMask,
+                                VkAccessFlags2        srcAccessMask,
+                                VkPipelineStageFlags2 dstStageMask,
+                                VkAccessFlags2        dstAccessMask,
+                                VkDeviceSize          offset = 0,
+                                VkDeviceSize          size   = VK_WHOLE_SIZE);
+
+        /// @brief Adds a global memory barrier as-is
+        BarrierBatch& AddMemory(const VkMemoryBarrier2& barrier);
+        /// @brief Adds a global memory barrier
+        BarrierBatch& AddMemory(VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+
+        /// @brief Records all accumulated barriers in a single vkCmdPipelineBarrier2 command (none if the batch is empty) and clears the batch
+        /// @return Number of barriers recorded
+        uint32_t CmdFlush(VkCommandBuffer cmdBuffer, VkDependencyFlags depFlags = 0);
+        /// @brief Records all accumulated barriers through the device dispatch table of context (none if the batch is empty) and clears the batch
+        /// @return Number of barriers recorded
+        uint32_t CmdFlush(Context* context, VkCommandBuffer cmdBuffer, VkDependencyFlags depFlags = 0);
+
+        /// @brief Discards all accumulated barriers
+        void Clear();
+
+        inline bool IsEmpty() const { return mImageBarriers.empty() && mBufferBarriers.empty() && mMemoryBarriers.empty(); }
+        inline uint32_t GetBarrierCount() const { return (uint32_t)(mImageBarriers.size() + mBufferBarriers.size() + mMemoryBarriers.size()); }
+
+        FORAY_GETTER_CR(ImageBarriers)
+        FORAY_GETTER_CR(BufferBarriers)
+        FORAY_GETTER_CR(MemoryBarriers)
+        /// @brief Number of vkCmdPipelineBarrier2 commands recorded by this batch
+        FORAY_GETTER_V(FlushCount)
+        /// @brief Number of barriers recorded by this batch over all flushes
+        FORAY_GETTER_V(FlushedBarrierCount)
+
+      protected:
+        ImageLayoutCache*                   mLayoutCache = nullptr;
+        std::vector<VkImageMemoryBarrier2>  mImageBarriers;
+        std::vector<VkBufferMemoryBarrier2> mBufferBarriers;
+        std::vector<VkMemoryBarrier2>       mMemoryBarriers;
+        uint32_t                            mFlushCount          = 0;
+        uint32_t                            mFlushedBarrierCount = 0;
+
+        /// @brief Records the batch with cmdPipelineBarrier2, or the global vkCmdPipelineBarrier2 if context is nullptr
+        uint32_t CmdFlushInternal(Context* context, VkCommandBuffer cmdBuffer, VkDependencyFlags depFlags);
+    };
+}  // namespace foray::core
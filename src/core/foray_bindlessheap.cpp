@@ -0,0 +1,266 @@
+#include "foray_bindlessheap.hpp"
+#include "../foray_exception.hpp"
+#include <array>
+
+namespace foray::core {
+    uint32_t BindlessHeap::Slots::Acquire()
+    {
+        uint32_t index = INVALID_INDEX;
+        if(Next < Capacity)
+        {
+            // Prefer never used indices, so freed ones stay untouched for as long as possible
+            index = Next++;
+        }
+        else
+        {
+            FORAY_ASSERTFMT(Free.size() > 0, "[BindlessHeap] Capacity of {} descriptors exhausted", Capacity)
+            index = Free.front();
+            Free.pop_front();
+        }
+        if(index >= Used.size())
+        {
+            Used.resize(index + 1, false);
+        }
+        Used[index] = true;
+        Live++;
+        return index;
+    }
+
+    void BindlessHeap::Slots::Release(uint32_t index)
+    {
+        FORAY_ASSERTFMT(IsUsed(index), "[BindlessHeap] Index {} is not registered", index)
+        Used[index] = false;
+        Free.push_back(index);
+        Live--;
+    }
+
+    void BindlessHeap::Create(Context* context, uint32_t imageCapacity, uint32_t bufferCapacity)
+    {
+        Destroy();
+        mContext        = context;
+        mImageCapacity  = imageCapacity;
+        mBufferCapacity = bufferCapacity;
+        mImageSlots     = Slots{.Capacity = imageCapacity};
+        mBufferSlots    = Slots{.Capacity = bufferCapacity};
+        if(mName.empty())
+        {
+            mName = "Bindless Heap";
+        }
+#ifdef VK_EXT_descriptor_buffer
+        mUsesDescriptorBuffer = mAllowDescriptorBuffer && !!mContext->DescriptorBufferProperties;
+#endif
+
+        std::array<VkDescriptorSetLayoutBinding, 2> bindings{
+            VkDescriptorSetLayoutBinding{
+                .binding         = BINDING_SAMPLED_IMAGES,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .descriptorCount = imageCapacity,
+                .stageFlags      = VK_SHADER_STAGE_ALL,
+            },
+            VkDescriptorSetLayoutBinding{
+                .binding         = BINDING_STORAGE_BUFFERS,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = bufferCapacity,
+                .stageFlags      = VK_SHADER_STAGE_ALL,
+            },
+        };
+
+        // Descriptor buffers are plain memory, writing elements not accessed by in flight commands needs no update after bind semantics
+        VkDescriptorBindingFlags bindingFlag = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+        mDescriptorSetLayoutCreateFlags      = 0;
+        if(mUsesDescriptorBuffer)
+        {
+#ifdef VK_EXT_descriptor_buffer
+            mDescriptorSetLayoutCreateFlags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+#endif
+        }
+        else
+        {
+            bindingFlag |= VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+            mDescriptorSetLayoutCreateFlags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        }
+        std::array<VkDescriptorBindingFlags, 2> bindingFlags{bindingFlag, bindingFlag};
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCi{
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount  = (uint32_t)bindingFlags.size(),
+            .pBindingFlags = bindingFlags.data(),
+        };
+
+        VkDescriptorSetLayoutCreateInfo layoutCi{
+            .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext        = &bindingFlagsCi,
+            .flags        = mDescriptorSetLayoutCreateFlags,
+            .bindingCount = (uint32_t)bindings.size(),
+            .pBindings    = bindings.data(),
+        };
+        AssertVkResult(mContext->VkbDispatchTable->createDescriptorSetLayout(&layoutCi, nullptr, &mDescriptorSetLayout));
+
+        if(mUsesDescriptorBuffer)
+        {
+            CreateDescriptorBuffer({BINDING_SAMPLED_IMAGES, BINDING_STORAGE_BUFFERS}, true);
+        }
+        else
+        {
+            CreatePool();
+        }
+    }
+
+    void BindlessHeap::CreatePool()
+    {
+        std::array<VkDescriptorPoolSize, 2> poolSizes{
+            VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = mImageCapacity},
+            VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = mBufferCapacity},
+        };
+        VkDescriptorPoolCreateInfo poolCi{
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+            .maxSets       = 1U,
+            .poolSizeCount = (uint32_t)poolSizes.size(),
+            .pPoolSizes    = poolSizes.data(),
+        };
+        AssertVkResult(mContext->VkbDispatchTable->createDescriptorPool(&poolCi, nullptr, &mDescriptorPool));
+
+        VkDescriptorSetAllocateInfo allocInfo{
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool     = mDescriptorPool,
+            .descriptorSetCount = 1U,
+            .pSetLayouts        = &mDescriptorSetLayout,
+        };
+        AssertVkResult(mContext->VkbDispatchTable->allocateDescriptorSets(&allocInfo, &mDescriptorSet));
+
+        SetObjectName(mContext, mDescriptorSet, mName);
+    }
+
+    uint32_t BindlessHeap::RegisterImage(const VkDescriptorImageInfo& imageInfo)
+    {
+        uint32_t index = mImageSlots.Acquire();
+        WriteImage(index, imageInfo);
+        return index;
+    }
+
+    void BindlessHeap::UpdateImage(uint32_t index, const VkDescriptorImageInfo& imageInfo)
+    {
+        FORAY_ASSERTFMT(mImageSlots.IsUsed(index), "[BindlessHeap] Image index {} is not registered", index)
+        WriteImage(index, imageInfo);
+    }
+
+    void BindlessHeap::UnregisterImage(uint32_t index)
+    {
+        mImageSlots.Release(index);
+    }
+
+    uint32_t BindlessHeap::RegisterBuffer(const VkDescriptorBufferInfo& bufferInfo)
+    {
+        uint32_t index = mBufferSlots.Acquire();
+        WriteBuffer(index, bufferInfo);
+        return index;
+    }
+
+    void BindlessHeap::UpdateBuffer(uint32_t index, const VkDescriptorBufferInfo& bufferInfo)
+    {
+        FORAY_ASSERTFMT(mBufferSlots.IsUsed(index), "[BindlessHeap] Buffer index {} is not registered", index)
+        WriteBuffer(index, bufferInfo);
+    }
+
+    void BindlessHeap::UnregisterBuffer(uint32_t index)
+    {
+        mBufferSlots.Release(index);
+    }
+
+    void BindlessHeap::RegisterOrUpdateBuffer(uint32_t& index, const VkDescriptorBufferInfo& bufferInfo)
+    {
+        if(index == INVALID_INDEX)
+        {
+            index = RegisterBuffer(bufferInfo);
+        }
+        else
+        {
+            UpdateBuffer(index, bufferInfo);
+        }
+    }
+
+    void BindlessHeap::WriteImage(uint32_t index, const VkDescriptorImageInfo& imageInfo)
+    {
+        Assert(!!imageInfo.imageView && !!imageInfo.sampler, "[BindlessHeap] Image descriptors require image view and sampler");
+#ifdef VK_EXT_descriptor_buffer
+        if(mUsesDescriptorBuffer)
+        {
+            const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props = *mContext->DescriptorBufferProperties;
+
+            uint8_t* dst = mDescriptorBufferMapped + mMapBindingToBufferOffset[BINDING_SAMPLED_IMAGES];
+            if(props.combinedImageSamplerDescriptorSingleArray)
+            {
+                VkDescriptorGetInfoEXT getInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER};
+                getInfo.data.pCombinedImageSampler = &imageInfo;
+                mContext->VkbDispatchTable->getDescriptorEXT(&getInfo, props.combinedImageSamplerDescriptorSize, dst + index * props.combinedImageSamplerDescriptorSize);
+            }
+            else
+            {
+                // The array is laid out as all image descriptors, followed by all sampler descriptors
+                VkDescriptorGetInfoEXT imageGetInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE};
+                imageGetInfo.data.pSampledImage = &imageInfo;
+                mContext->VkbDispatchTable->getDescriptorEXT(&imageGetInfo, props.sampledImageDescriptorSize, dst + index * props.sampledImageDescriptorSize);
+                VkDescriptorGetInfoEXT samplerGetInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = VK_DESCRIPTOR_TYPE_SAMPLER};
+                samplerGetInfo.data.pSampler = &imageInfo.sampler;
+                mContext->VkbDispatchTable->getDescriptorEXT(&samplerGetInfo, props.samplerDescriptorSize,
+                                                            dst + mImageCapacity * props.sampledImageDescriptorSize + index * props.samplerDescriptorSize);
+            }
+            return;
+        }
+#endif
+        VkWriteDescriptorSet write{
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = mDescriptorSet,
+            .dstBinding      = BINDING_SAMPLED_IMAGES,
+            .dstArrayElement = index,
+            .descriptorCount = 1U,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .pImageInfo      = &imageInfo,
+        };
+        mContext->VkbDispatchTable->updateDescriptorSets(1U, &write, 0U, nullptr);
+    }
+
+    void BindlessHeap::WriteBuffer(uint32_t index, const VkDescriptorBufferInfo& bufferInfo)
+    {
+        Assert(!!bufferInfo.buffer, "[BindlessHeap] Buffer descriptors require a buffer");
+#ifdef VK_EXT_descriptor_buffer
+        if(mUsesDescriptorBuffer)
+        {
+            FORAY_ASSERTFMT(bufferInfo.range != VK_WHOLE_SIZE, "[BindlessHeap] Buffer index {} uses VK_WHOLE_SIZE, which descriptor buffers do not support", index)
+            const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props = *mContext->DescriptorBufferProperties;
+
+            VkBufferDeviceAddressInfo  addressInfo{.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, .buffer = bufferInfo.buffer};
+            VkDescriptorAddressInfoEXT descriptorAddress{
+                .sType   = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                .address = mContext->VkbDispatchTable->getBufferDeviceAddress(&addressInfo) + bufferInfo.offset,
+                .range   = bufferInfo.range,
+                .format  = VK_FORMAT_UNDEFINED,
+            };
+            VkDescriptorGetInfoEXT getInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+            getInfo.data.pStorageBuffer = &descriptorAddress;
+
+            uint8_t* dst = mDescriptorBufferMapped + mMapBindingToBufferOffset[BINDING_STORAGE_BUFFERS];
+            mContext->VkbDispatchTable->getDescriptorEXT(&getInfo, props.storageBufferDescriptorSize, dst + index * props.storageBufferDescriptorSize);
+            return;
+        }
+#endif
+        VkWriteDescriptorSet write{
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = mDescriptorSet,
+            .dstBinding      = BINDING_STORAGE_BUFFERS,
+            .dstArrayElement = index,
+            .descriptorCount = 1U,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo     = &bufferInfo,
+        };
+        mContext->VkbDispatchTable->updateDescriptorSets(1U, &write, 0U, nullptr);
+    }
+
+    void BindlessHeap::Destroy()
+    {
+        DescriptorSet::Destroy();
+        mImageSlots  = Slots{};
+        mBufferSlots = Slots{};
+    }
+}  // namespace foray::core
@@ -0,0 +1,89 @@
+#pragma once
+#include "foray_context.hpp"
+#include "foray_descriptorset.hpp"
+#include <deque>
+
+namespace foray::core {
+
+    /// @brief Global descriptor set holding runtime sized arrays of sampled images and storage buffers, addressed by stable indices
+    /// @details
+    /// Resources are registered once and keep their index until unregistered. Registering, updating and unregistering writes the affected
+    /// array element only. Freed indices are reused in the order they were freed, to keep them unused for as long as possible.
+    /// Like DescriptorSet, the heap is backed by a descriptor buffer if the device has VK_EXT_descriptor_buffer enabled (Context::DescriptorBufferProperties) and
+    /// AllowDescriptorBuffer is set. Otherwise it is a pool allocated set created with descriptor indexing (VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT,
+    /// VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT, VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT). Either way it may stay bound while elements not accessed
+    /// by in flight commands change.
+    /// Pipelines can not mix both backends, so sets bound alongside the heap should be created with SetAllowDescriptorBuffer(heap.GetUsesDescriptorBuffer()).
+    /// Bind the heap together with them via DescriptorSet::CmdBindSets(), and add it to pipeline layouts like any other DescriptorSet.
+    /// Shaders access the heap via shaders/common/bindless.glsl.
+    /// @remark Not thread safe. SetDescriptorAt() and Update() do not apply to the heap
+    {
+      public:
+        inline static constexpr uint32_t INVALID_INDEX = ~0U;
+
+        inline static constexpr uint32_t BINDING_SAMPLED_IMAGES  = 0;
+        inline static constexpr uint32_t BINDING_STORAGE_BUFFERS = 1;
+
+        BindlessHeap() = default;
+        inline virtual ~BindlessHeap() { Destroy(); }
+
+        /// @brief Creates layout and descriptor buffer, or layout, pool and descriptor set
+        /// @param context Requires DispatchTable. Device needs the descriptorBindingPartiallyBound and runtimeDescriptorArray features, and the
+        /// descriptorBinding...UpdateAfterBind features unless descriptor buffers are used
+        /// @param imageCapacity Size of the combined image sampler array
+        /// @param bufferCapacity Size of the storage buffer array
+        void Create(Context* context, uint32_t imageCapacity = 4096, uint32_t bufferCapacity = 1024);
+
+        /// @brief Writes imageInfo to a free array element
+        /// @return Index of the array element, stable until UnregisterImage()
+        uint32_t RegisterImage(const VkDescriptorImageInfo& imageInfo);
+        /// @brief Rewrites the array element at index (e.g. after the image was recreated)
+        void UpdateImage(uint32_t index, const VkDescriptorImageInfo& imageInfo);
+        /// @brief Marks the array element at index as free. The descriptor is not accessed by the heap anymore, but stays written until the index is reused
+        void UnregisterImage(uint32_t index);
+
+        /// @brief Writes bufferInfo to a free array element
+        /// @return Index of the array element, stable until UnregisterBuffer()
+        uint32_t RegisterBuffer(const VkDescriptorBufferInfo& bufferInfo);
+        /// @brief Rewrites the array element at index (e.g. after the buffer was recreated)
+        void UpdateBuffer(uint32_t index, const VkDescriptorBufferInfo& bufferInfo);
+        /// @brief Marks the array element at index as free. The descriptor is not accessed by the heap anymore, but stays written until the index is reused
+        void UnregisterBuffer(uint32_t index);
+        /// @brief Registers bufferInfo if index is INVALID_INDEX (and stores the new index), updates the array element at index otherwise
+        void RegisterOrUpdateBuffer(uint32_t& index, const VkDescriptorBufferInfo& bufferInfo);
+
+        virtual void Destroy() override;
+
+        inline operator VkDescriptorSet() const { return mDescriptorSet; }
+
+        FORAY_GETTER_V(ImageCapacity)
+        FORAY_GETTER_V(BufferCapacity)
+        inline uint32_t GetRegisteredImageCount() const { return mImageSlots.Live; }
+        inline uint32_t GetRegisteredBufferCount() const { return mBufferSlots.Live; }
+
+      protected:
+        /// @brief Hands out array indices
+        struct Slots
+        {
+            uint32_t             Capacity = 0;
+            /// @brief Indices below this have been handed out at least once
+            uint32_t             Next = 0;
+            uint32_t             Live = 0;
+            std::deque<uint32_t> Free;
+            std::vector<bool>    Used;
+
+            uint32_t Acquire();
+            void     Release(uint32_t index);
+            bool     IsUsed(uint32_t index) const { return index < Used.size() && Used[index]; }
+        };
+
+        void CreatePool();
+        void WriteImage(uint32_t index, const VkDescriptorImageInfo& imageInfo);
+        void WriteBuffer(uint32_t index, const VkDescriptorBufferInfo& bufferInfo);
+
+        uint32_t mImageCapacity  = 0;
+        uint32_t mBufferCapacity = 0;
+        Slots    mImageSlots;
+        Slots    mBufferSlots;
+    };
+}  // namespace foray::core
@@ -68,6 +68,10 @@ namespace foray::core {
     }
 
     void HostSyncCommandBuffer::Submit()
+    {
+        Submit(nullptr, 0);
+    }
+    void HostSyncCommandBuffer::Submit(VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage)
     {
         if(mIsRecording)
         {
@@ -78,6 +82,12 @@ namespace foray::core {
         submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers    = &mCommandBuffer;
+        if(!!waitSemaphore)
+        {
+            submitInfo.waitSemaphoreCount = 1;
+            submitInfo.pWaitSemaphores    = &waitSemaphore;
+            submitInfo.pWaitDstStageMask  = &waitStage;
+        }
 
         // Submit to the queue
         AssertVkResult(mContext->VkbDispatchTable->queueSubmit(mContext->Queue, 1, &submitInfo, mFence));
@@ -87,6 +97,11 @@ namespace foray::core {
         Submit();
         WaitForCompletion();
     }
+    void HostSyncCommandBuffer::SubmitAndWait(VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage)
+    {
+        Submit(waitSemaphore, waitStage);
+        WaitForCompletion();
+    }
     bool HostSyncCommandBuffer::HasCompleted()
     {
         VkResult result = mContext->VkbDispatchTable->getFenceStatus(mFence);
@@ -187,31 +202,30 @@ namespace foray::core {
             End();
         }
 
-        std::vector<VkSemaphoreSubmitInfo> signalSemaphores;
-        std::vector<VkSemaphoreSubmitInfo> waitSemaphores;
+        // Stored in members, as the submitinfo is used after this function returns
+        mSubmitSignalInfos.clear();
+        mSubmitWaitInfos.clear();
 
-        signalSemaphores.reserve(mSignalSemaphores.size());
         for(const SemaphoreReference& submit : mSignalSemaphores)
         {
-            signalSemaphores.push_back(submit);
+            mSubmitSignalInfos.push_back(submit);
         }
-        waitSemaphores.reserve(mWaitSemaphores.size());
         for(const SemaphoreReference& submit : mWaitSemaphores)
         {
-            waitSemaphores.push_back(submit);
+            mSubmitWaitInfos.push_back(submit);
         }
 
-        VkCommandBufferSubmitInfo bufferSubmitInfo{
+        mSubmitCmdBufferInfo = VkCommandBufferSubmitInfo{
             .sType         = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
             .commandBuffer = mCommandBuffer,
         };
 
         submitInfos.push_back(VkSubmitInfo2{.sType                    = VkStructureType::VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-                                            .waitSemaphoreInfoCount   = (uint32_t)waitSemaphores.size(),
-                                            .pWaitSemaphoreInfos      = waitSemaphores.data(),
+                                            .waitSemaphoreInfoCount   = (uint32_t)mSubmitWaitInfos.size(),
+                                            .pWaitSemaphoreInfos      = mSubmitWaitInfos.data(),
                                             .commandBufferInfoCount   = 1,
-                                            .pCommandBufferInfos      = &bufferSubmitInfo,
-                                            .signalSemaphoreInfoCount = (uint32_t)signalSemaphores.size(),
-                                            .pSignalSemaphoreInfos    = signalSemaphores.data()});
+                                            .pCommandBufferInfos      = &mSubmitCmdBufferInfo,
+                                            .signalSemaphoreInfoCount = (uint32_t)mSubmitSignalInfos.size(),
+                                            .pSignalSemaphoreInfos    = mSubmitSignalInfos.data()});
     }
 }  // namespace foray::core
\ No newline at end of file
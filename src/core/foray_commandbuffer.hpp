@@ -47,6 +47,10 @@ namespace foray::core {
         void Submit();
         /// @brief Submits and waits for the commandbuffer to be completed
         void SubmitAndWait();
+        /// @brief Submits, with execution waiting on the device for waitSemaphore (binary) at waitStage, but doesn't synchronize with the host
+        void Submit(VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage);
+        /// @brief Submits, with execution waiting on the device for waitSemaphore (binary) at waitStage, and waits for the commandbuffer to be completed
+        void SubmitAndWait(VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage);
         /// @brief Checks the fence for completion (non-blocking)
         bool HasCompleted();
         /// @brief Blocks CPU thread until commandbuffer has completed
@@ -102,12 +106,18 @@ namespace foray::core {
         virtual void Submit();
 
         /// @brief Appends a suitable submitinfo to the vector
+        /// @remark The submitinfo references arrays stored in this object. It remains valid until the next call
         virtual void WriteToSubmitInfo(std::vector<VkSubmitInfo2>& submitInfos);
 
       protected:
         std::vector<SemaphoreReference> mWaitSemaphores;
         std::vector<SemaphoreReference> mSignalSemaphores;
         VkFence                         mFence = nullptr;
+
+        /// @brief Storage referenced by the submitinfo written by WriteToSubmitInfo()
+        std::vector<VkSemaphoreSubmitInfo> mSubmitWaitInfos;
+        std::vector<VkSemaphoreSubmitInfo> mSubmitSignalInfos;
+        VkCommandBufferSubmitInfo          mSubmitCmdBufferInfo{};
     };
 
 }  // namespace foray::core
\ No newline at end of file
@@ -38,8 +38,38 @@ namespace foray::core {
         uint32_t QueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         /// @brief Command Pool
         VkCommandPool CommandPool = nullptr;
+        /// @brief Dedicated transfer queue (no graphics capability). nullptr if unavailable, in which case Queue is used for transfers.
+        VkQueue TransferQueue = nullptr;
+        /// @brief Transfer Queue Family Index
+        uint32_t TransferQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        /// @brief Command Pool for the transfer queue family
+        VkCommandPool TransferCommandPool = nullptr;
+        /// @brief Async compute queue (no graphics capability). nullptr if unavailable, in which case Queue is used for compute.
+        VkQueue ComputeQueue = nullptr;
+        /// @brief Compute Queue Family Index
+        uint32_t ComputeQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        /// @brief Command Pool for the compute queue family
+        VkCommandPool ComputeCommandPool = nullptr;
+#ifdef VK_EXT_descriptor_buffer
+        /// @brief Descriptor buffer properties of the physical device. nullptr, if VK_EXT_descriptor_buffer is not enabled. If set, DescriptorSet objects store their descriptors in descriptor buffers
+        const VkPhysicalDeviceDescriptorBufferPropertiesEXT* DescriptorBufferProperties = nullptr;
+#endif
+        /// @brief Vulkan 1.0 features enabled on the device. nullptr, if not published, in which case components treat optional features as disabled
+        const VkPhysicalDeviceFeatures* EnabledFeatures = nullptr;
+        /// @brief Vulkan 1.1 features enabled on the device. nullptr, if not published, in which case components treat optional features as disabled
+        const VkPhysicalDeviceVulkan11Features* EnabledVulkan11Features = nullptr;
+        /// @brief Vulkan 1.2 features enabled on the device. nullptr, if not published, in which case components treat optional features as disabled
+        const VkPhysicalDeviceVulkan12Features* EnabledVulkan12Features = nullptr;
         /// @brief Pipeline Cache
         VkPipelineCache PipelineCache = nullptr;
+        /// @brief Descriptor Pool Allocator. If set, DescriptorSet objects allocate from its shared pools rather than creating a pool each
+        DescriptorPoolAllocator* DescriptorAllocator = nullptr;
+        /// @brief Bindless Heap. If set, scene managers register their textures and buffers with it
+        BindlessHeap* Bindless = nullptr;
+        /// @brief Transient Image Allocator. If set, images created with ManagedImage::CreateInfo::Transient may alias each other's memory
+        TransientImageAllocator* TransientImages = nullptr;
+        /// @brief Frame Timeline. If set, frames signal its timeline semaphore instead of fences, and resources can be destroyed deferred until frames using them have finished
+        FrameTimeline* Timeline = nullptr;
         /// @brief Sampler Collection
         SamplerCollection* SamplerCol = nullptr;
         /// @brief Shader Manager
@@ -55,5 +85,37 @@ namespace foray::core {
         inline VkDevice         Device() const { return VkbDevice->device; }
 
         inline VkExtent2D GetSwapchainSize() const { return Swapchain->extent; }
+
+        /// @brief True, if a transfer queue of a queue family different from QueueFamilyIndex is available
+        inline bool HasDedicatedTransferQueue() const { return !!TransferQueue && !!TransferCommandPool && TransferQueueFamilyIndex != QueueFamilyIndex; }
+        /// @brief True, if a compute queue of a queue family different from QueueFamilyIndex is available
+        inline bool HasAsyncComputeQueue() const { return !!ComputeQueue && !!ComputeCommandPool && ComputeQueueFamilyIndex != QueueFamilyIndex; }
+
+        /// @brief Copy of this context with Queue, QueueFamilyIndex and CommandPool replaced by their transfer counterparts. Unchanged copy if no dedicated transfer queue is available.
+        /// @remark Resources sharing a VK_SHARING_MODE_EXCLUSIVE buffer or image between the queue families require queue family ownership transfers
+        inline Context GetTransferContext() const
+        {
+            Context result = *this;
+            if(HasDedicatedTransferQueue())
+            {
+                result.Queue            = TransferQueue;
+                result.QueueFamilyIndex = TransferQueueFamilyIndex;
+                result.CommandPool      = TransferCommandPool;
+            }
+            return result;
+        }
+        /// @brief Copy of this context with Queue, QueueFamilyIndex and CommandPool replaced by their compute counterparts. Unchanged copy if no async compute queue is available.
+        /// @remark Resources sharing a VK_SHARING_MODE_EXCLUSIVE buffer or image between the queue families require queue family ownership transfers
+        inline Context GetComputeContext() const
+        {
+            Context result = *this;
+            if(HasAsyncComputeQueue())
+            {
+                result.Queue            = ComputeQueue;
+                result.QueueFamilyIndex = ComputeQueueFamilyIndex;
+                result.CommandPool      = ComputeCommandPool;
+            }
+            return result;
+        }
     };
 }  // namespace foray::core
\ No newline at end of file
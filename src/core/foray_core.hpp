@@ -1,12 +1,19 @@
 #pragma once
 
+#include "foray_barrierbatch.hpp"
+#include "foray_bindlessheap.hpp"
 #include "foray_commandbuffer.hpp"
 #include "foray_context.hpp"
+#include "foray_descriptorpoolallocator.hpp"
 #include "foray_descriptorset.hpp"
+#include "foray_frametimeline.hpp"
 #include "foray_imagelayoutcache.hpp"
 #include "foray_managedbuffer.hpp"
 #include "foray_managedimage.hpp"
 #include "foray_managedresource.hpp"
+#include "foray_pipelinecache.hpp"
 #include "foray_shadermanager.hpp"
 #include "foray_shadermodule.hpp"
-#include "foray_swapchainimageinfo.hpp"
\ No newline at end of file
+#include "foray_stagingring.hpp"
+#include "foray_swapchainimageinfo.hpp"
+#include "foray_transientimageallocator.hpp"
\ No newline at end of file
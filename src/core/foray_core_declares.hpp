@@ -5,8 +5,12 @@ namespace foray::core {
     class ManagedResource;
     class ManagedImage;
     class ManagedBuffer;
+    class BarrierBatch;
+    class BindlessHeap;
     class CommandBuffer;
     class DescriptorSet;
+    class DescriptorPoolAllocator;
+    class FrameTimeline;
     class HostSyncCommandBuffer;
     class DeviceSyncCommandBuffer;
     class ImageLayoutCache;
@@ -14,4 +18,8 @@ namespace foray::core {
     class SamplerCollection;
     class ShaderManager;
     class ShaderModule;
+    class PipelineCache;
+    class StagingRing;
+    struct UploadTicket;
+    class TransientImageAllocator;
 }  // namespace foray::core
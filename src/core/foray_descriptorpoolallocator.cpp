@@ -0,0 +1,197 @@
+#include "foray_descriptorpoolallocator.hpp"
+#include "../foray_exception.hpp"
+#include <algorithm>
+
+namespace foray::core {
+    bool DescriptorPoolAllocator::Pool::Fits(const DescriptorCounts& counts) const
+    {
+        if(Exhausted || Allocated >= MaxSets)
+        {
+            return false;
+        }
+        for(const auto& [type, count] : counts)
+        {
+            auto iter = Remaining.find(type);
+            if(iter == Remaining.end() || iter->second < count)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void DescriptorPoolAllocator::Create(Context* context)
+    {
+        Destroy();
+        Assert(!!context, "DescriptorPoolAllocator::Create: context is nullptr");
+        Assert(mInitialSetsPerPool > 0 && mMaxSetsPerPool >= mInitialSetsPerPool, "Invalid descriptor pool set capacities");
+        mContext           = context;
+        mPoolCreationCount = 0;
+        mAllocationCount   = 0;
+    }
+
+    DescriptorPoolAllocator::DescriptorCounts DescriptorPoolAllocator::MakeDescriptorCounts(const std::vector<VkDescriptorPoolSize>& poolSizes)
+    {
+        DescriptorCounts counts;
+        for(const VkDescriptorPoolSize& poolSize : poolSizes)
+        {
+            if(poolSize.descriptorCount == 0)
+            {
+                continue;
+            }
+            auto iter = std::find_if(counts.begin(), counts.end(), [&](const auto& count) { return count.first == poolSize.type; });
+            if(iter != counts.end())
+            {
+                iter->second += poolSize.descriptorCount;
+            }
+            else
+            {
+                counts.push_back(std::make_pair(poolSize.type, poolSize.descriptorCount));
+            }
+        }
+        std::sort(counts.begin(), counts.end());
+        return counts;
+    }
+
+    DescriptorPoolAllocator::Pool& DescriptorPoolAllocator::CreatePool(PoolGroup& group, const DescriptorCounts& counts, bool updateAfterBind)
+    {
+        // Every new pool doubles the set capacity of the previous one
+        uint32_t maxSets = mInitialSetsPerPool;
+        if(group.Pools.size() > 0)
+        {
+            maxSets = std::min(group.Pools.back().MaxSets * 2, mMaxSetsPerPool);
+        }
+        for(const auto& [type, count] : counts)
+        {
+            uint32_t& maxPerSet = group.MaxPerSet[type];
+            maxPerSet           = std::max(maxPerSet, count);
+        }
+
+        // Every type requested so far is reserved for maxSets of the largest set requesting it
+        Pool                              pool{.MaxSets = maxSets};
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        poolSizes.reserve(group.MaxPerSet.size());
+        for(const auto& [type, maxPerSet] : group.MaxPerSet)
+        {
+            pool.Remaining[type] = maxPerSet * maxSets;
+            poolSizes.push_back(VkDescriptorPoolSize{.type = type, .descriptorCount = maxPerSet * maxSets});
+        }
+
+        VkDescriptorPoolCreateInfo poolCi{
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+            .maxSets       = maxSets,
+            .poolSizeCount = (uint32_t)poolSizes.size(),
+            .pPoolSizes    = poolSizes.data(),
+        };
+        if(updateAfterBind)
+        {
+            poolCi.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        }
+
+        AssertVkResult(mContext->VkbDispatchTable->createDescriptorPool(&poolCi, nullptr, &pool.Pool));
+        mPoolCreationCount++;
+        group.Pools.push_back(std::move(pool));
+        return group.Pools.back();
+    }
+
+    bool DescriptorPoolAllocator::TryAllocate(Pool& pool, VkDescriptorSetLayout layout, const DescriptorCounts& counts, VkDescriptorSet& outSet)
+    {
+        VkDescriptorSetAllocateInfo allocInfo{
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool     = pool.Pool,
+            .descriptorSetCount = 1U,
+            .pSetLayouts        = &layout,
+        };
+        VkResult result = mContext->VkbDispatchTable->allocateDescriptorSets(&allocInfo, &outSet);
+        if(result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            pool.Exhausted = true;
+            return false;
+        }
+        AssertVkResult(result);
+        pool.Allocated++;
+        for(const auto& [type, count] : counts)
+        {
+            pool.Remaining[type] -= count;
+        }
+        return true;
+    }
+
+    VkDescriptorSet DescriptorPoolAllocator::Allocate(VkDescriptorSetLayout layout, const std::vector<VkDescriptorPoolSize>& poolSizes, bool updateAfterBind, VkDescriptorPool& outPool)
+    {
+        Assert(Exists(), "DescriptorPoolAllocator used before Create()");
+
+        DescriptorCounts counts = MakeDescriptorCounts(poolSizes);
+        PoolGroup&       group  = mGroups[updateAfterBind ? 1 : 0];
+
+        VkDescriptorSet set  = nullptr;
+        Pool*           from = nullptr;
+        for(Pool& pool : group.Pools)
+        {
+            if(pool.Fits(counts) && TryAllocate(pool, layout, counts, set))
+            {
+                from = &pool;
+                break;
+            }
+        }
+        if(!from)
+        {
+            from           = &CreatePool(group, counts, updateAfterBind);
+            bool allocated = TryAllocate(*from, layout, counts, set);
+            Assert(allocated, "DescriptorPoolAllocator: Allocation from a new pool failed");
+        }
+
+        outPool    = from->Pool;
+        mSets[set] = SetAllocation{.Pool = from->Pool, .UpdateAfterBind = updateAfterBind, .Counts = std::move(counts)};
+        mAllocationCount++;
+        mLiveSetCount++;
+        return set;
+    }
+
+    void DescriptorPoolAllocator::Free(VkDescriptorPool pool, VkDescriptorSet set)
+    {
+        auto allocation = mSets.find(set);
+        if(allocation == mSets.end() || allocation->second.Pool != pool)
+        {
+            return;
+        }
+        for(Pool& candidate : mGroups[allocation->second.UpdateAfterBind ? 1 : 0].Pools)
+        {
+            if(candidate.Pool != pool)
+            {
+                continue;
+            }
+            AssertVkResult(mContext->VkbDispatchTable->freeDescriptorSets(pool, 1U, &set));
+            candidate.Allocated--;
+            candidate.Exhausted = false;
+            for(const auto& [type, count] : allocation->second.Counts)
+            {
+                candidate.Remaining[type] += count;
+            }
+            break;
+        }
+        mSets.erase(allocation);
+        mLiveSetCount--;
+    }
+
+    uint32_t DescriptorPoolAllocator::GetPoolCount() const
+    {
+        return (uint32_t)(mGroups[0].Pools.size() + mGroups[1].Pools.size());
+    }
+
+    void DescriptorPoolAllocator::Destroy()
+    {
+        for(PoolGroup& group : mGroups)
+        {
+            for(Pool& pool : group.Pools)
+            {
+                mContext->VkbDispatchTable->destroyDescriptorPool(pool.Pool, nullptr);
+            }
+            group = PoolGroup();
+        }
+        mSets.clear();
+        mLiveSetCount = 0;
+        mContext      = nullptr;
+    }
+}  // namespace foray::core
@@ -0,0 +1,108 @@
+#pragma once
+#include "../foray_basics.hpp"
+#include "../foray_vulkan.hpp"
+#include "foray_context.hpp"
+#include "foray_managedresource.hpp"
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace foray::core {
+
+    /// @brief Allocates descriptor sets from shared, growable descriptor pools
+    /// @details
+    /// Pools are not dedicated to a set layout. Every pool reserves a capacity per descriptor type, and a set is allocated from the first pool
+    /// with enough remaining descriptors of every type it requires (tracked on the host). Sets of differing shapes therefore share pools.
+    /// When no pool fits, a new one is added with twice the set capacity of the previous one (up to MaxSetsPerPool). It reserves every descriptor
+    /// type requested so far, sized for its set capacity times the largest count a single set requested of that type.
+    /// Pools with and without VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT are kept apart.
+    /// All pools are created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, sets are returned individually via Free().
+    /// @remark Not thread safe
+    class DescriptorPoolAllocator : public VulkanResource<VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_POOL>
+    {
+      public:
+        DescriptorPoolAllocator() = default;
+        inline virtual ~DescriptorPoolAllocator() { Destroy(); }
+
+        /// @brief Prepares for use
+        /// @param context Requires DispatchTable
+        void Create(Context* context);
+
+        /// @brief Allocates a descriptor set
+        /// @param layout Layout of the set
+        /// @param poolSizes Descriptors required by a single set. Entries of equal type are merged, entries with a descriptorCount of zero ignored.
+        /// @param updateAfterBind If true, the set is allocated from a pool created with VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT
+        /// @param outPool Pool the set was allocated from. Required for Free()
+        /// @return Allocated descriptor set
+        VkDescriptorSet Allocate(VkDescriptorSetLayout layout, const std::vector<VkDescriptorPoolSize>& poolSizes, bool updateAfterBind, VkDescriptorPool& outPool);
+        /// @brief Returns a descriptor set to the pool it was allocated from
+        void Free(VkDescriptorPool pool, VkDescriptorSet set);
+
+        /// @brief True between Create() and Destroy(), regardless of whether any pool has been created yet
+        inline virtual bool Exists() const override { return !!mContext; }
+        /// @brief Destroys all pools. Make sure no set allocated from this is used afterwards!
+        virtual void Destroy() override;
+
+        /// @brief Set capacity of the first pool
+        FORAY_PROPERTY_V(InitialSetsPerPool)
+        /// @brief Upper limit for the set capacity of a single pool
+        FORAY_PROPERTY_V(MaxSetsPerPool)
+        /// @brief Number of VkDescriptorPool objects created since Create()
+        FORAY_GETTER_V(PoolCreationCount)
+        /// @brief Number of descriptor sets allocated since Create()
+        FORAY_GETTER_V(AllocationCount)
+        /// @brief Number of descriptor sets currently allocated
+        FORAY_GETTER_V(LiveSetCount)
+        /// @brief Number of VkDescriptorPool objects currently alive
+        uint32_t GetPoolCount() const;
+
+      protected:
+        /// @brief Descriptor counts by type. Sorted by type, types unique
+        using DescriptorCounts = std::vector<std::pair<VkDescriptorType, uint32_t>>;
+
+        struct Pool
+        {
+            VkDescriptorPool Pool      = nullptr;
+            uint32_t         MaxSets   = 0;
+            uint32_t         Allocated = 0;
+            /// @brief Remaining descriptors per type
+            std::map<VkDescriptorType, uint32_t> Remaining;
+            /// @brief Set, if an allocation from this pool failed despite free capacity (fragmentation). Cleared once a set is freed
+            bool Exhausted = false;
+
+            bool Fits(const DescriptorCounts& counts) const;
+        };
+
+        /// @brief Pools sharing the same pool create flags
+        struct PoolGroup
+        {
+            std::vector<Pool> Pools;
+            /// @brief Per type maximum descriptor count of a single set
+            std::map<VkDescriptorType, uint32_t> MaxPerSet;
+        };
+
+        struct SetAllocation
+        {
+            VkDescriptorPool Pool            = nullptr;
+            bool             UpdateAfterBind = false;
+            DescriptorCounts Counts;
+        };
+
+        static DescriptorCounts MakeDescriptorCounts(const std::vector<VkDescriptorPoolSize>& poolSizes);
+        Pool&                   CreatePool(PoolGroup& group, const DescriptorCounts& counts, bool updateAfterBind);
+        /// @brief Tries to allocate from pool, updating its bookkeeping on success
+        bool TryAllocate(Pool& pool, VkDescriptorSetLayout layout, const DescriptorCounts& counts, VkDescriptorSet& outSet);
+
+        Context*                                           mContext = nullptr;
+        /// @brief Indexed by updateAfterBind
+        std::array<PoolGroup, 2>                           mGroups;
+        std::unordered_map<VkDescriptorSet, SetAllocation> mSets;
+
+        uint32_t mInitialSetsPerPool = 4;
+        uint32_t mMaxSetsPerPool     = 64;
+        uint64_t mPoolCreationCount  = 0;
+        uint64_t mAllocationCount    = 0;
+        uint64_t mLiveSetCount       = 0;
+    };
+}  // namespace foray::core
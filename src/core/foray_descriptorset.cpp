@@ -1,40 +1,58 @@
 #include "foray_descriptorset.hpp"
 #include "foray_samplercollection.hpp"
+#include <algorithm>
 
 namespace foray::core {
 
     void DescriptorSet::Create(Context* context, std::string debugName, VkDescriptorSetLayout predefinedLayout, VkDescriptorSetLayoutCreateFlags descriptorSetLayoutCreateFlags)
     {
-        mContext = context;
-        mName    = debugName;
+        mContext                        = context;
+        mName                           = debugName;
+        mDescriptorSetLayoutCreateFlags = descriptorSetLayoutCreateFlags;
 
         if(predefinedLayout)
         {
-            mDescriptorSetLayout = predefinedLayout;
-            mExternalLayout      = true;
+            mDescriptorSetLayout  = predefinedLayout;
+            mExternalLayout       = true;
+            mUsesDescriptorBuffer = false;
         }
         else
         {
+            mUsesDescriptorBuffer = CanUseDescriptorBuffer();
             CreateDescriptorSetLayout(descriptorSetLayoutCreateFlags);
         }
         CreateDescriptorSet();
     }
 
-    void DescriptorSet::Update()
+    void DescriptorSet::Update(bool forceAll)
     {
         std::vector<VkWriteDescriptorSet> descriptorWrites;
 
-        for(const auto& pairBindingDescriptorInfo : mMapBindingToDescriptorInfo)
+        for(auto& pairBindingDescriptorInfo : mMapBindingToDescriptorInfo)
         {
             // get binding and corresponding info
-            uint32_t              binding        = pairBindingDescriptorInfo.first;
-            const DescriptorInfo& descriptorInfo = pairBindingDescriptorInfo.second;
+            uint32_t        binding        = pairBindingDescriptorInfo.first;
+            DescriptorInfo& descriptorInfo = pairBindingDescriptorInfo.second;
 
             if(descriptorInfo.DescriptorCount == 0)
             {
                 continue;
             }
 
+            // skip bindings not set since the last update
+            if(!forceAll && !descriptorInfo.Dirty && !descriptorInfo.pNext)
+            {
+                continue;
+            }
+            descriptorInfo.Dirty = false;
+
+            if(mUsesDescriptorBuffer)
+            {
+                WriteDescriptorBuffer(binding, descriptorInfo);
+                mDescriptorWriteCount++;
+                continue;
+            }
+
             // prepare write
             VkWriteDescriptorSet descriptorWrite{};
             descriptorWrite.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -64,15 +82,110 @@ namespace foray::core {
 
             descriptorWrites.push_back(descriptorWrite);
         }
+        if(descriptorWrites.empty())
+        {
+            return;
+        }
         vkUpdateDescriptorSets(mContext->Device(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+        mDescriptorWriteCount += descriptorWrites.size();
+    }
+
+    void DescriptorSet::CmdBind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t setIndex) const
+    {
+        CmdBindSets(cmdBuffer, bindPoint, pipelineLayout, setIndex, {this});
+    }
+
+    void DescriptorSet::CmdBindSets(
+        VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t firstSet, const std::vector<const DescriptorSet*>& sets)
+    {
+        if(sets.empty())
+        {
+            return;
+        }
+        const Context* context              = sets.front()->mContext;
+        bool           usesDescriptorBuffer = sets.front()->mUsesDescriptorBuffer;
+        for(const DescriptorSet* set : sets)
+        {
+            FORAY_ASSERTFMT(set->mUsesDescriptorBuffer == usesDescriptorBuffer,
+                            "[DescriptorSet::CmdBindSets] Can not bind descriptor buffer backed and pool allocated sets together (set \"{}\")", set->GetName())
+        }
+#ifdef VK_EXT_descriptor_buffer
+        if(usesDescriptorBuffer)
+        {
+            // A single bind call, as every call replaces all descriptor buffers bound before
+            std::vector<VkDescriptorBufferBindingInfoEXT> bindingInfos(sets.size());
+            std::vector<uint32_t>                         bufferIndices(sets.size());
+            std::vector<VkDeviceSize>                     offsets(sets.size(), 0);
+            uint32_t                                      samplerBuffers  = 0;
+            uint32_t                                      resourceBuffers = 0;
+            for(uint32_t i = 0; i < sets.size(); i++)
+            {
+                bindingInfos[i]  = VkDescriptorBufferBindingInfoEXT{.sType   = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                                                                    .address = sets[i]->mDescriptorBufferAddress,
+                                                                    .usage   = sets[i]->mDescriptorBufferUsage};
+                bufferIndices[i] = i;
+                samplerBuffers += (sets[i]->mDescriptorBufferUsage & VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT) > 0 ? 1 : 0;
+                resourceBuffers += (sets[i]->mDescriptorBufferUsage & VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT) > 0 ? 1 : 0;
+            }
+            const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props = *context->DescriptorBufferProperties;
+            FORAY_ASSERTFMT(sets.size() <= props.maxDescriptorBufferBindings && samplerBuffers <= props.maxSamplerDescriptorBufferBindings
+                                && resourceBuffers <= props.maxResourceDescriptorBufferBindings,
+                            "[DescriptorSet::CmdBindSets] {} sets exceed the device's descriptor buffer binding limits", sets.size())
+            context->VkbDispatchTable->cmdBindDescriptorBuffersEXT(cmdBuffer, static_cast<uint32_t>(bindingInfos.size()), bindingInfos.data());
+            context->VkbDispatchTable->cmdSetDescriptorBufferOffsetsEXT(cmdBuffer, bindPoint, pipelineLayout, firstSet, static_cast<uint32_t>(sets.size()),
+                                                                        bufferIndices.data(), offsets.data());
+            return;
+        }
+#endif
+        std::vector<VkDescriptorSet> descriptorSets;
+        descriptorSets.reserve(sets.size());
+        for(const DescriptorSet* set : sets)
+        {
+            descriptorSets.push_back(set->mDescriptorSet);
+        }
+        context->VkbDispatchTable->cmdBindDescriptorSets(cmdBuffer, bindPoint, pipelineLayout, firstSet, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(),
+                                                         0U, nullptr);
+    }
+
+    VkPipelineCreateFlags DescriptorSet::GetPipelineCreateFlags() const
+    {
+#ifdef VK_EXT_descriptor_buffer
+        if(mUsesDescriptorBuffer)
+        {
+            return VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+#endif
+        return 0;
     }
 
     void DescriptorSet::Destroy()
     {
+        if(mUsesDescriptorBuffer)
+        {
+            mMapBindingToDescriptorInfo.clear();
+            mMapBindingToBufferOffset.clear();
+            if(!!mDescriptorBufferMapped)
+            {
+                mDescriptorBuffer.Unmap();
+                mDescriptorBufferMapped = nullptr;
+            }
+            mDescriptorBuffer.Destroy();
+            mDescriptorBufferAddress = 0;
+            mDescriptorBufferUsage   = 0;
+            mUsesDescriptorBuffer    = false;
+        }
         if(mDescriptorPool != VK_NULL_HANDLE)
         {
             mMapBindingToDescriptorInfo.clear();
-            vkDestroyDescriptorPool(mContext->Device(), mDescriptorPool, nullptr);
+            if(!!mAllocator)
+            {
+                mAllocator->Free(mDescriptorPool, mDescriptorSet);
+                mAllocator = nullptr;
+            }
+            else
+            {
+                vkDestroyDescriptorPool(mContext->Device(), mDescriptorPool, nullptr);
+            }
             mDescriptorPool = VK_NULL_HANDLE;
             mDescriptorSet  = VK_NULL_HANDLE;
         }
@@ -216,6 +329,12 @@ namespace foray::core {
 
     void DescriptorSet::CreateDescriptorSet()
     {
+        mDescriptorWriteCount = 0;
+        for(auto& pairBindingDescriptorInfo : mMapBindingToDescriptorInfo)
+        {
+            pairBindingDescriptorInfo.second.Dirty = true;
+        }
+
         uint32_t numSets = 1;
         // --------------------------------------------------------------------------------------------
         // define which descriptors need to be allocated from a descriptor pool, based on the created
@@ -236,27 +355,51 @@ namespace foray::core {
             }
         }
 
-        VkDescriptorPoolCreateInfo poolInfo{};
-        poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.poolSizeCount = poolSizes.size();
-        poolInfo.pPoolSizes    = poolSizes.data();
-        poolInfo.maxSets       = numSets;
+        bool updateAfterBind = (mDescriptorSetLayoutCreateFlags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT) > 0;
 
-        AssertVkResult(vkCreateDescriptorPool(mContext->Device(), &poolInfo, nullptr, &mDescriptorPool));
+        if(mUsesDescriptorBuffer)
+        {
+            // --------------------------------------------------------------------------------------------
+            // descriptors live in a host mapped buffer, no pool required
 
-        // --------------------------------------------------------------------------------------------
-        // allocate descriptor sets by their layout
+            CreateDescriptorBuffer();
+        }
+        else if(!!mContext->DescriptorAllocator)
+        {
+            // --------------------------------------------------------------------------------------------
+            // allocate from the shared pools
+
+            mAllocator     = mContext->DescriptorAllocator;
+            mDescriptorSet = mAllocator->Allocate(mDescriptorSetLayout, poolSizes, updateAfterBind, mDescriptorPool);
+        }
+        else
+        {
+            VkDescriptorPoolCreateInfo poolInfo{};
+            poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            poolInfo.poolSizeCount = poolSizes.size();
+            poolInfo.pPoolSizes    = poolSizes.data();
+            poolInfo.maxSets       = numSets;
+            if(updateAfterBind)
+            {
+                poolInfo.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+            }
+
+            AssertVkResult(vkCreateDescriptorPool(mContext->Device(), &poolInfo, nullptr, &mDescriptorPool));
 
-        std::vector<VkDescriptorSetLayout> layouts(numSets, mDescriptorSetLayout);
-        VkDescriptorSetAllocateInfo        descriptorSetAllocInfo{};
-        descriptorSetAllocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        descriptorSetAllocInfo.descriptorPool     = mDescriptorPool;
-        descriptorSetAllocInfo.descriptorSetCount = numSets;
-        descriptorSetAllocInfo.pSetLayouts        = layouts.data();
+            // --------------------------------------------------------------------------------------------
+            // allocate descriptor sets by their layout
 
-        AssertVkResult(vkAllocateDescriptorSets(mContext->Device(), &descriptorSetAllocInfo, &mDescriptorSet));
+            std::vector<VkDescriptorSetLayout> layouts(numSets, mDescriptorSetLayout);
+            VkDescriptorSetAllocateInfo        descriptorSetAllocInfo{};
+            descriptorSetAllocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            descriptorSetAllocInfo.descriptorPool     = mDescriptorPool;
+            descriptorSetAllocInfo.descriptorSetCount = numSets;
+            descriptorSetAllocInfo.pSetLayouts        = layouts.data();
+
+            AssertVkResult(vkAllocateDescriptorSets(mContext->Device(), &descriptorSetAllocInfo, &mDescriptorSet));
+        }
 
-        if (mName.size() > 0)
+        if (mName.size() > 0 && !!mDescriptorSet)
         {
             SetVulkanObjectName(mContext, VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_SET, mDescriptorSet, mName);
         }
@@ -290,10 +433,229 @@ namespace foray::core {
         layoutInfo.bindingCount = layoutBindings.size();
         layoutInfo.pBindings    = layoutBindings.data();
         layoutInfo.flags        = descriptorSetLayoutCreateFlags;
+#ifdef VK_EXT_descriptor_buffer
+        if(mUsesDescriptorBuffer)
+        {
+            layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+#endif
 
         AssertVkResult(vkCreateDescriptorSetLayout(mContext->Device(), &layoutInfo, nullptr, &mDescriptorSetLayout));
     }
 
+#ifdef VK_EXT_descriptor_buffer
+    /// @brief Size of a single descriptor of type in a descriptor buffer (non-robust, robustBufferAccess is not enabled by VulkanDevice)
+    static size_t lGetDescriptorSize(const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props, VkDescriptorType type)
+    {
+        switch(type)
+        {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+                return props.samplerDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                return props.combinedImageSamplerDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                return props.sampledImageDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                return props.storageImageDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                return props.inputAttachmentDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                return props.uniformBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                return props.storageBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+                return props.accelerationStructureDescriptorSize;
+            default:
+                return 0;
+        }
+    }
+#endif
+
+    bool DescriptorSet::CanUseDescriptorBuffer() const
+    {
+#ifdef VK_EXT_descriptor_buffer
+        if(!mAllowDescriptorBuffer || !mContext->DescriptorBufferProperties)
+        {
+            return false;
+        }
+        // update after bind and push descriptors are pool / command buffer concepts
+        if((mDescriptorSetLayoutCreateFlags & (VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT | VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR)) > 0)
+        {
+            return false;
+        }
+        for(const auto& pairBindingDescriptorInfo : mMapBindingToDescriptorInfo)
+        {
+            const DescriptorInfo& descriptorInfo = pairBindingDescriptorInfo.second;
+            if(lGetDescriptorSize(*mContext->DescriptorBufferProperties, descriptorInfo.DescriptorType) == 0)
+            {
+                return false;
+            }
+            // the only pNext write this class knows how to translate are acceleration structures
+            if(!!descriptorInfo.pNext
+               && reinterpret_cast<const VkBaseInStructure*>(descriptorInfo.pNext)->sType != VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR)
+            {
+                return false;
+            }
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void DescriptorSet::CreateDescriptorBuffer()
+    {
+        std::vector<uint32_t> bindings;
+        bool                  samplers = false;
+        for(const auto& pairBindingDescriptorInfo : mMapBindingToDescriptorInfo)
+        {
+            bindings.push_back(pairBindingDescriptorInfo.first);
+            VkDescriptorType type = pairBindingDescriptorInfo.second.DescriptorType;
+            samplers              = samplers || type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        }
+        CreateDescriptorBuffer(bindings, samplers);
+    }
+
+    void DescriptorSet::CreateDescriptorBuffer(const std::vector<uint32_t>& bindings, bool samplers)
+    {
+#ifdef VK_EXT_descriptor_buffer
+        const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props = *mContext->DescriptorBufferProperties;
+
+        VkDeviceSize layoutSize = 0;
+        mContext->VkbDispatchTable->getDescriptorSetLayoutSizeEXT(mDescriptorSetLayout, &layoutSize);
+
+        mDescriptorBufferUsage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        if(samplers)
+        {
+            mDescriptorBufferUsage |= VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+        mMapBindingToBufferOffset.clear();
+        for(uint32_t binding : bindings)
+        {
+            VkDeviceSize offset = 0;
+            mContext->VkbDispatchTable->getDescriptorSetLayoutBindingOffsetEXT(mDescriptorSetLayout, binding, &offset);
+            mMapBindingToBufferOffset[binding] = offset;
+        }
+
+        // Offsets passed to vkCmdSetDescriptorBufferOffsetsEXT must be aligned, so pad the buffer as if further sets followed
+        VkDeviceSize alignment = std::max<VkDeviceSize>(props.descriptorBufferOffsetAlignment, 1);
+        VkDeviceSize size      = std::max<VkDeviceSize>((layoutSize + alignment - 1) / alignment * alignment, alignment);
+
+        ManagedBuffer::CreateInfo ci(mDescriptorBufferUsage, size, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+                                     mName.size() > 0 ? fmt::format("{} Descriptor Buffer", mName) : "Descriptor Buffer");
+        ci.Alignment = alignment;
+        mDescriptorBuffer.Create(mContext, ci);
+        mDescriptorBuffer.Map(reinterpret_cast<void*&>(mDescriptorBufferMapped));
+        mDescriptorBufferAddress = mDescriptorBuffer.GetDeviceAddress();
+#endif
+    }
+
+    void DescriptorSet::WriteDescriptorBuffer(uint32_t binding, const DescriptorInfo& descriptorInfo)
+    {
+#ifdef VK_EXT_descriptor_buffer
+        const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props = *mContext->DescriptorBufferProperties;
+
+        uint8_t* dst  = mDescriptorBufferMapped + mMapBindingToBufferOffset[binding];
+        size_t   size = lGetDescriptorSize(props, descriptorInfo.DescriptorType);
+
+        VkDescriptorGetInfoEXT getInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = descriptorInfo.DescriptorType};
+
+        switch(descriptorInfo.DescriptorType)
+        {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: {
+                for(uint32_t i = 0; i < descriptorInfo.BufferInfos.size(); i++)
+                {
+                    const VkDescriptorBufferInfo& bufferInfo = descriptorInfo.BufferInfos[i];
+                    FORAY_ASSERTFMT(bufferInfo.range != VK_WHOLE_SIZE, "[DescriptorSet] Binding {} uses VK_WHOLE_SIZE, which descriptor buffers do not support", binding)
+                    VkBufferDeviceAddressInfo addressInfo{.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, .buffer = bufferInfo.buffer};
+                    VkDescriptorAddressInfoEXT descriptorAddress{
+                        .sType   = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                        .address = mContext->VkbDispatchTable->getBufferDeviceAddress(&addressInfo) + bufferInfo.offset,
+                        .range   = bufferInfo.range,
+                        .format  = VK_FORMAT_UNDEFINED,
+                    };
+                    if(descriptorInfo.DescriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+                    {
+                        getInfo.data.pUniformBuffer = &descriptorAddress;
+                    }
+                    else
+                    {
+                        getInfo.data.pStorageBuffer = &descriptorAddress;
+                    }
+                    mContext->VkbDispatchTable->getDescriptorEXT(&getInfo, size, dst + i * size);
+                }
+                break;
+            }
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
+                uint32_t count = descriptorInfo.ImageInfos.size();
+                if(props.combinedImageSamplerDescriptorSingleArray || count == 1)
+                {
+                    for(uint32_t i = 0; i < count; i++)
+                    {
+                        getInfo.data.pCombinedImageSampler = &descriptorInfo.ImageInfos[i];
+                        mContext->VkbDispatchTable->getDescriptorEXT(&getInfo, size, dst + i * size);
+                    }
+                }
+                else
+                {
+                    // Arrays are laid out as all image descriptors, followed by all sampler descriptors
+                    VkDescriptorGetInfoEXT imageGetInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE};
+                    VkDescriptorGetInfoEXT samplerGetInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = VK_DESCRIPTOR_TYPE_SAMPLER};
+                    for(uint32_t i = 0; i < count; i++)
+                    {
+                        imageGetInfo.data.pSampledImage = &descriptorInfo.ImageInfos[i];
+                        mContext->VkbDispatchTable->getDescriptorEXT(&imageGetInfo, props.sampledImageDescriptorSize, dst + i * props.sampledImageDescriptorSize);
+                        samplerGetInfo.data.pSampler = &descriptorInfo.ImageInfos[i].sampler;
+                        mContext->VkbDispatchTable->getDescriptorEXT(&samplerGetInfo, props.samplerDescriptorSize,
+                                                                    dst + count * props.sampledImageDescriptorSize + i * props.samplerDescriptorSize);
+                    }
+                }
+                break;
+            }
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            case VK_DESCRIPTOR_TYPE_SAMPLER: {
+                for(uint32_t i = 0; i < descriptorInfo.ImageInfos.size(); i++)
+                {
+                    const VkDescriptorImageInfo* imageInfo = &descriptorInfo.ImageInfos[i];
+                    switch(descriptorInfo.DescriptorType)
+                    {
+                        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                            getInfo.data.pSampledImage = imageInfo;
+                            break;
+                        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                            getInfo.data.pStorageImage = imageInfo;
+                            break;
+                        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                            getInfo.data.pInputAttachmentImage = imageInfo;
+                            break;
+                        default:
+                            getInfo.data.pSampler = &imageInfo->sampler;
+                            break;
+                    }
+                    mContext->VkbDispatchTable->getDescriptorEXT(&getInfo, size, dst + i * size);
+                }
+                break;
+            }
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: {
+                const auto* asWrite = reinterpret_cast<const VkWriteDescriptorSetAccelerationStructureKHR*>(descriptorInfo.pNext);
+                for(uint32_t i = 0; i < asWrite->accelerationStructureCount; i++)
+                {
+                    VkAccelerationStructureDeviceAddressInfoKHR addressInfo{.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR,
+                                                                            .accelerationStructure = asWrite->pAccelerationStructures[i]};
+                    getInfo.data.accelerationStructure = mContext->VkbDispatchTable->getAccelerationStructureDeviceAddressKHR(&addressInfo);
+                    mContext->VkbDispatchTable->getDescriptorEXT(&getInfo, size, dst + i * size);
+                }
+                break;
+            }
+            default:
+                FORAY_THROWFMT("[DescriptorSet] Descriptor type {} of binding {} is not supported by the descriptor buffer backend", (uint32_t)descriptorInfo.DescriptorType, binding)
+        }
+#endif
+    }
+
     void DescriptorSet::AssertBindingInUse(uint32_t binding)
     {
 #ifdef FORAY_DEBUG
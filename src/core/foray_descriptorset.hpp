@@ -1,4 +1,5 @@
 #pragma once
+#include "foray_descriptorpoolallocator.hpp"
 #include "foray_managedbuffer.hpp"
 #include "foray_managedimage.hpp"
 #include "foray_managedresource.hpp"
@@ -8,6 +9,9 @@ namespace foray::core {
 
     /// @brief Helps with the creation of a VkDescriptorSetLayout and VkDescriptorSet.
     /// @details
+    /// If the device has VK_EXT_descriptor_buffer enabled (Context::DescriptorBufferProperties), descriptors are written directly into a host mapped
+    /// descriptor buffer instead of a pool allocated set. Use CmdBind() (or CmdBindSets() for multiple sets) to bind either kind, and create pipelines with GetPipelineCreateFlags().
+    /// Sets with a predefined layout, update after bind layouts or custom pNext bindings other than acceleration structures always use descriptor pools.
     /// Not supported:
     /// - immutable samplers
     /// - descriptorSetLayout pNext
@@ -15,16 +19,27 @@ namespace foray::core {
     {
       public:
         /// @brief Creates the VkDescriptorSet
-        /// @param context Requires Device, DispatchTable
+        /// @param context Requires Device, DispatchTable. If DescriptorAllocator is set, the set is allocated from its shared pools
         /// @param debugName Debug object name
         /// @param predefinedLayout Allows reusing an already defined layout
-        /// @param descriptorSetLayoutCreateFlags flags
+        /// @param descriptorSetLayoutCreateFlags flags. Also selects a pool supporting update after bind, if VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT is set
         void Create(Context*                         context,
                     std::string                      debugName,
                     VkDescriptorSetLayout            predefinedLayout               = VK_NULL_HANDLE,
                     VkDescriptorSetLayoutCreateFlags descriptorSetLayoutCreateFlags = 0);
-        /// @brief Rather than reallocating the descriptorset, rewrites all bindings to the descriptor set
-        void Update();
+        /// @brief Rather than reallocating the descriptorset, writes all bindings set via SetDescriptorAt() since the last update
+        /// @param forceAll If true, rewrites all bindings
+        /// @remark Bindings set via pNext are always rewritten, as changes to the structure pointed to can not be detected
+        void Update(bool forceAll = false);
+        /// @brief Binds the set (vkCmdBindDescriptorSets, or vkCmdBindDescriptorBuffersEXT and vkCmdSetDescriptorBufferOffsetsEXT for descriptor buffers)
+        /// @remark Binding a descriptor buffer replaces all descriptor buffers bound to the command buffer. Pipelines using more than one set must bind them via CmdBindSets()
+        void CmdBind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t setIndex = 0) const;
+        /// @brief Binds sets to consecutive set indices starting at firstSet. Descriptor buffer backed sets are bound with a single vkCmdBindDescriptorBuffersEXT call
+        /// @remark All sets must use the same backend (see GetUsesDescriptorBuffer()), as pipelines created with VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT can not bind pool allocated sets
+        static void CmdBindSets(
+            VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t firstSet, const std::vector<const DescriptorSet*>& sets);
+        /// @brief Flags pipelines using the layout of this set must be created with (VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT for descriptor buffers, 0 otherwise)
+        VkPipelineCreateFlags GetPipelineCreateFlags() const;
         /// @brief Destroys descriptorset and layout (latter only if also allocated by this object)
         virtual void Destroy() override;
         ~DescriptorSet() { Destroy(); }
@@ -98,10 +113,16 @@ namespace foray::core {
         /// @param layout ImageLayout
         void SetDescriptorAt(uint32_t binding, const std::vector<const CombinedImageSampler*>& sampledImages, VkImageLayout layout, VkDescriptorType descriptorType, VkShaderStageFlags shaderStageFlags);
 
-        bool Exists() const override { return mDescriptorSet != VK_NULL_HANDLE; }
+        bool Exists() const override { return mDescriptorSet != VK_NULL_HANDLE || mUsesDescriptorBuffer; }
 
         FORAY_GETTER_V(DescriptorSet)
         FORAY_GETTER_V(DescriptorSetLayout)
+        /// @brief Number of bindings written by Update() since Create()
+        FORAY_GETTER_V(DescriptorWriteCount)
+        /// @brief If false, descriptor pools are used even if descriptor buffers are available. Set before Create()
+        FORAY_PROPERTY_V(AllowDescriptorBuffer)
+        /// @brief True, if descriptors are stored in a descriptor buffer rather than a pool allocated descriptor set
+        FORAY_GETTER_V(UsesDescriptorBuffer)
 
       protected:
         struct DescriptorInfo
@@ -112,17 +133,41 @@ namespace foray::core {
             VkDescriptorType                    DescriptorType;
             uint32_t                            DescriptorCount;
             VkShaderStageFlags                  ShaderStageFlags;
+            /// @brief Set by every SetDescriptorAt() call, cleared once Update() wrote the binding. Handles are not compared, as
+            /// recreated buffers and image views may reuse the handle values of destroyed ones
+            bool Dirty = true;
         };
 
         std::unordered_map<uint32_t, DescriptorInfo> mMapBindingToDescriptorInfo;
         Context*                                     mContext{};
+        /// @brief Allocator the set was allocated from. nullptr: mDescriptorPool is owned by this object
+        DescriptorPoolAllocator*                     mAllocator{};
         VkDescriptorPool                             mDescriptorPool{};
         VkDescriptorSetLayout                        mDescriptorSetLayout{};
+        VkDescriptorSetLayoutCreateFlags             mDescriptorSetLayoutCreateFlags{};
         bool                                         mExternalLayout = false;
         VkDescriptorSet                              mDescriptorSet{};
+        uint64_t                                     mDescriptorWriteCount = 0;
+
+        bool mAllowDescriptorBuffer = true;
+        bool mUsesDescriptorBuffer  = false;
+        /// @brief Host mapped buffer holding the descriptors, if mUsesDescriptorBuffer is set
+        ManagedBuffer                              mDescriptorBuffer;
+        uint8_t*                                   mDescriptorBufferMapped  = nullptr;
+        VkDeviceAddress                            mDescriptorBufferAddress = 0;
+        VkBufferUsageFlags                         mDescriptorBufferUsage   = 0;
+        std::unordered_map<uint32_t, VkDeviceSize> mMapBindingToBufferOffset;
 
         void CreateDescriptorSet();
         void CreateDescriptorSetLayout(VkDescriptorSetLayoutCreateFlags descriptorSetLayoutCreateFlags);
+        /// @brief True, if descriptor buffers are available and every binding can be written to one
+        bool CanUseDescriptorBuffer() const;
+        void CreateDescriptorBuffer();
+        /// @brief Creates and maps the descriptor buffer for mDescriptorSetLayout and queries the buffer offsets of bindings
+        /// @param samplers True, if any binding holds sampler descriptors (adds VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT)
+        void CreateDescriptorBuffer(const std::vector<uint32_t>& bindings, bool samplers);
+        /// @brief Writes all descriptors of a binding to the descriptor buffer
+        void WriteDescriptorBuffer(uint32_t binding, const DescriptorInfo& descriptorInfo);
 
         void AssertBindingInUse(uint32_t binding);
         void AssertHandleNotNull(void* handle, uint32_t binding);
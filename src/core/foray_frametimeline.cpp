@@ -0,0 +1,91 @@
+#include "foray_frametimeline.hpp"
+#include "../foray_exception.hpp"
+
+namespace foray::core {
+    void FrameTimeline::Create(Context* context, std::string_view name)
+    {
+        Assert(!Exists(), "FrameTimeline::Create called on existing timeline");
+        mContext = context;
+
+        VkSemaphoreTypeCreateInfo timelineSemaphoreCi{
+            .sType         = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VkSemaphoreType::VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue  = 0,
+        };
+        VkSemaphoreCreateInfo semaphoreCi{.sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &timelineSemaphoreCi};
+        AssertVkResult(mContext->VkbDispatchTable->createSemaphore(&semaphoreCi, nullptr, &mSemaphore));
+        SetVulkanObjectName(mContext, VkObjectType::VK_OBJECT_TYPE_SEMAPHORE, mSemaphore, name);
+
+        mSubmittedValue = 0;
+    }
+
+    uint64_t FrameTimeline::Advance()
+    {
+        return ++mSubmittedValue;
+    }
+
+    uint64_t FrameTimeline::GetCompletedValue() const
+    {
+        uint64_t value = 0;
+        AssertVkResult(mContext->VkbDispatchTable->getSemaphoreCounterValue(mSemaphore, &value));
+        return value;
+    }
+
+    bool FrameTimeline::HasCompleted(uint64_t value) const
+    {
+        if(value == 0)
+        {
+            return true;
+        }
+        return GetCompletedValue() >= value;
+    }
+
+    void FrameTimeline::Wait(uint64_t value) const
+    {
+        if(value == 0)
+        {
+            return;
+        }
+        Assert(value <= mSubmittedValue, "FrameTimeline::Wait called for a value never assigned to a frame");
+        VkSemaphoreWaitInfo waitInfo{.sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO, .semaphoreCount = 1, .pSemaphores = &mSemaphore, .pValues = &value};
+        AssertVkResult(mContext->VkbDispatchTable->waitSemaphores(&waitInfo, UINT64_MAX));
+    }
+
+    void FrameTimeline::Defer(std::function<void()> destroy)
+    {
+        mDeferred.push_back(Deferred{.Value = mSubmittedValue, .Destroy = std::move(destroy)});
+    }
+
+    void FrameTimeline::Collect()
+    {
+        if(mDeferred.empty())
+        {
+            return;
+        }
+        uint64_t completed = GetCompletedValue();
+        while(!mDeferred.empty() && mDeferred.front().Value <= completed)
+        {
+            // Pop before invoking, callbacks may defer again
+            std::function<void()> destroy = std::move(mDeferred.front().Destroy);
+            mDeferred.pop_front();
+            destroy();
+        }
+    }
+
+    void FrameTimeline::Destroy()
+    {
+        while(!mDeferred.empty())
+        {
+            std::function<void()> destroy = std::move(mDeferred.front().Destroy);
+            mDeferred.pop_front();
+            destroy();
+        }
+        if(!!mSemaphore)
+        {
+            mContext->VkbDispatchTable->destroySemaphore(mSemaphore, nullptr);
+            mSemaphore = nullptr;
+        }
+        mSubmittedValue = 0;
+        mContext        = nullptr;
+    }
+}  // namespace foray::core
@@ -0,0 +1,70 @@
+#pragma once
+#include "../foray_basics.hpp"
+#include "../foray_vulkan.hpp"
+#include "foray_context.hpp"
+#include <deque>
+#include <functional>
+
+namespace foray::core {
+
+    /// @brief Timeline semaphore counting rendered frames, shared by all in flight frames
+    /// @details
+    /// Every frame is assigned the next value via Advance() and signals it once its primary command buffer has finished executing (see base::InFlightFrame).
+    /// Values are signalled in submission order, so a reached value implies all frames before it have finished too.
+    /// Host side resource recycling can therefore check or wait for a single value instead of per frame fences:
+    /// - HasCompleted() / Wait() for a value obtained via GetSubmittedValue() (e.g. before reusing a DualBuffer staging buffer)
+    /// - Defer() to run a destroy callback once all frames recorded so far have finished, executed by Collect()
+    /// @remark A value of zero is always complete. Not thread safe
+    class FrameTimeline : public NoMoveDefaults
+    {
+      public:
+        FrameTimeline() = default;
+        inline virtual ~FrameTimeline() { Destroy(); }
+
+        /// @brief Creates the timeline semaphore
+        /// @param context Requires DispatchTable. Device must have the timelineSemaphore feature enabled
+        void Create(Context* context, std::string_view name = "Frame Timeline");
+
+        /// @brief Assigns the next value to a frame
+        /// @return Value the frame has to signal after execution
+        uint64_t Advance();
+
+        /// @brief Value the device has signalled most recently (non-blocking)
+        uint64_t GetCompletedValue() const;
+        /// @brief Checks whether the frame assigned value has finished executing (non-blocking)
+        bool HasCompleted(uint64_t value) const;
+        /// @brief Blocks until the frame assigned value has finished executing
+        void Wait(uint64_t value) const;
+
+        /// @brief Queues destroy to be run by Collect() once the frame assigned the current value (GetSubmittedValue()) has finished executing
+        void Defer(std::function<void()> destroy);
+        /// @brief Runs all deferred callbacks whose frames have finished executing
+        void Collect();
+
+        /// @brief Runs all deferred callbacks and destroys the semaphore. Requires the device to be idle
+        void Destroy();
+
+        inline bool Exists() const { return !!mSemaphore; }
+
+        FORAY_GETTER_V(Semaphore)
+        /// @brief Value assigned to the most recent frame
+        FORAY_GETTER_V(SubmittedValue)
+        /// @brief Number of deferred callbacks waiting for their frames
+        inline size_t GetDeferredCount() const { return mDeferred.size(); }
+
+      protected:
+        struct Deferred
+        {
+            uint64_t              Value = 0;
+            std::function<void()> Destroy;
+        };
+
+        Context*    mContext   = nullptr;
+        VkSemaphore mSemaphore = nullptr;
+        /// @brief Value assigned by the last Advance() call
+        uint64_t mSubmittedValue = 0;
+
+        /// @brief Deferred callbacks, ordered by value
+        std::deque<Deferred> mDeferred;
+    };
+}  // namespace foray::core
@@ -1,15 +1,68 @@
 #include "foray_imagelayoutcache.hpp"
 #include "foray_managedimage.hpp"
+#include <algorithm>
 // #include "../foray_logger.hpp"
 // #include <nameof/nameof.hpp>
 
 namespace foray::core {
+    VkImageLayout ImageLayoutCache::ImageState::Get(uint32_t mip, uint32_t layer) const
+    {
+        for(auto iter = Overrides.crbegin(); iter != Overrides.crend(); ++iter)
+        {
+            if(iter->Contains(mip, layer))
+            {
+                return iter->Layout;
+            }
+        }
+        return Layout;
+    }
+
+    ImageLayoutCache::SubresourceLayout ImageLayoutCache::ImageState::Clamp(SubresourceLayout bounds) const
+    {
+        bounds.MipEnd   = std::min(bounds.MipEnd, MipCount);
+        bounds.LayerEnd = std::min(bounds.LayerEnd, LayerCount);
+        return bounds;
+    }
+
+    bool ImageLayoutCache::ImageState::CoversAll(const SubresourceLayout& bounds) const
+    {
+        return bounds.MipBegin == 0 && bounds.MipEnd >= MipCount && bounds.LayerBegin == 0 && bounds.LayerEnd >= LayerCount;
+    }
+
+    void ImageLayoutCache::ImageState::Set(const SubresourceLayout& layout)
+    {
+        SubresourceLayout bounds = Clamp(layout);
+        if(CoversAll(bounds))
+        {
+            Layout = bounds.Layout;
+            Overrides.clear();
+            return;
+        }
+        if(bounds.MipBegin >= bounds.MipEnd || bounds.LayerBegin >= bounds.LayerEnd)
+        {
+            return;  // Outside of the image
+        }
+        // Drop overrides which are completely hidden by the new one
+        std::erase_if(Overrides, [&](const SubresourceLayout& other) {
+            return other.MipBegin >= bounds.MipBegin && other.MipEnd <= bounds.MipEnd && other.LayerBegin >= bounds.LayerBegin && other.LayerEnd <= bounds.LayerEnd;
+        });
+        Overrides.push_back(bounds);
+    }
+
+    ImageLayoutCache::SubresourceLayout ImageLayoutCache::sToBounds(const VkImageSubresourceRange& range)
+    {
+        return SubresourceLayout{.MipBegin   = range.baseMipLevel,
+                                 .MipEnd     = range.levelCount == VK_REMAINING_MIP_LEVELS ? UINT32_MAX : range.baseMipLevel + range.levelCount,
+                                 .LayerBegin = range.baseArrayLayer,
+                                 .LayerEnd   = range.layerCount == VK_REMAINING_ARRAY_LAYERS ? UINT32_MAX : range.baseArrayLayer + range.layerCount};
+    }
+
     VkImageLayout ImageLayoutCache::Get(VkImage image) const
     {
         const auto  iter = mLayoutCache.find(image);
         if(iter != mLayoutCache.cend())
         {
-            return iter->second;
+            return iter->second.Get(0, 0);
         }
         return VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
     }
@@ -17,7 +70,194 @@ namespace foray::core {
     void ImageLayoutCache::Set(VkImage image, VkImageLayout layout)
     {
         Assert(!!image, "Cannot track imagelayout for nullptr!");
-        mLayoutCache[image] = layout;
+        ImageState& state = mLayoutCache[image];
+        state.Layout      = layout;
+        state.Overrides.clear();
+    }
+
+    VkImageLayout ImageLayoutCache::Get(VkImage image, const VkImageSubresourceRange& range) const
+    {
+        const auto iter = mLayoutCache.find(image);
+        if(iter != mLayoutCache.cend())
+        {
+            return iter->second.Get(range.baseMipLevel, range.baseArrayLayer);
+        }
+        return VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+    void ImageLayoutCache::Set(VkImage image, VkImageLayout layout, const VkImageSubresourceRange& range)
+    {
+        Assert(!!image, "Cannot track imagelayout for nullptr!");
+        SubresourceLayout bounds = sToBounds(range);
+        bounds.Layout            = layout;
+        mLayoutCache[image].Set(bounds);
+    }
+
+    void ImageLayoutCache::SetSubresourceCounts(VkImage image, uint32_t mipLevelCount, uint32_t arrayLayerCount)
+    {
+        Assert(!!image, "Cannot track imagelayout for nullptr!");
+        ImageState& state = mLayoutCache[image];
+        if(state.MipCount == mipLevelCount && state.LayerCount == arrayLayerCount)
+        {
+            return;
+        }
+        state.MipCount   = mipLevelCount;
+        state.LayerCount = arrayLayerCount;
+        // Reapply overrides recorded without the counts. Overrides which now cover the whole image reset it
+        std::vector<SubresourceLayout> overrides = std::move(state.Overrides);
+        state.Overrides.clear();
+        for(const SubresourceLayout& bounds : overrides)
+        {
+            state.Set(bounds);
+        }
+    }
+
+    void ImageLayoutCache::SetSubresourceCounts(const ManagedImage& image)
+    {
+        SetSubresourceCounts(image.GetImage(), image.GetCreateInfo().ImageCI.mipLevels, image.GetCreateInfo().ImageCI.arrayLayers);
+    }
+
+    void ImageLayoutCache::SetSubresourceCounts(const ManagedImage* image)
+    {
+        SetSubresourceCounts(*image);
+    }
+
+    VkImageLayout ImageLayoutCache::Get(const ManagedImage& image, const VkImageSubresourceRange& range) const
+    {
+        return Get(image.GetImage(), range);
+    }
+
+    VkImageLayout ImageLayoutCache::Get(const ManagedImage* image, const VkImageSubresourceRange& range) const
+    {
+        return Get(image->GetImage(), range);
+    }
+
+    void ImageLayoutCache::Set(const ManagedImage& image, VkImageLayout layout, const VkImageSubresourceRange& range)
+    {
+        SetSubresourceCounts(image);
+        Set(image.GetImage(), layout, range);
+    }
+
+    void ImageLayoutCache::Set(const ManagedImage* image, VkImageLayout layout, const VkImageSubresourceRange& range)
+    {
+        Set(*image, layout, range);
+    }
+
+    void ImageLayoutCache::ForEachLayout(VkImage                                                                   image,
+                                         const VkImageSubresourceRange&                                            range,
+                                         const std::function<void(const VkImageSubresourceRange&, VkImageLayout)>& callback) const
+    {
+        const auto iter = mLayoutCache.find(image);
+        if(iter == mLayoutCache.cend())
+        {
+            callback(range, VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED);
+            return;
+        }
+        const ImageState& state  = iter->second;
+        SubresourceLayout bounds = state.Clamp(sToBounds(range));
+        if(bounds.MipBegin >= bounds.MipEnd || bounds.LayerBegin >= bounds.LayerEnd)
+        {
+            return;
+        }
+        auto toRange = [&](const SubresourceLayout& cell) {
+            return VkImageSubresourceRange{.aspectMask     = range.aspectMask,
+                                           .baseMipLevel   = cell.MipBegin,
+                                           .levelCount     = cell.MipEnd == UINT32_MAX ? VK_REMAINING_MIP_LEVELS : cell.MipEnd - cell.MipBegin,
+                                           .baseArrayLayer = cell.LayerBegin,
+                                           .layerCount     = cell.LayerEnd == UINT32_MAX ? VK_REMAINING_ARRAY_LAYERS : cell.LayerEnd - cell.LayerBegin};
+        };
+        if(state.Overrides.empty())
+        {
+            callback(toRange(bounds), state.Layout);
+            return;
+        }
+
+        // Split the range into a grid along all override borders, each cell then has a uniform layout
+        std::vector<uint32_t> mipSplits{bounds.MipBegin, bounds.MipEnd};
+        std::vector<uint32_t> layerSplits{bounds.LayerBegin, bounds.LayerEnd};
+        for(const SubresourceLayout& other : state.Overrides)
+        {
+            for(uint32_t mip : {other.MipBegin, other.MipEnd})
+            {
+                if(mip > bounds.MipBegin && mip < bounds.MipEnd)
+                {
+                    mipSplits.push_back(mip);
+                }
+            }
+            for(uint32_t layer : {other.LayerBegin, other.LayerEnd})
+            {
+                if(layer > bounds.LayerBegin && layer < bounds.LayerEnd)
+                {
+                    layerSplits.push_back(layer);
+                }
+            }
+        }
+        std::sort(mipSplits.begin(), mipSplits.end());
+        mipSplits.erase(std::unique(mipSplits.begin(), mipSplits.end()), mipSplits.end());
+        std::sort(layerSplits.begin(), layerSplits.end());
+        layerSplits.erase(std::unique(layerSplits.begin(), layerSplits.end()), layerSplits.end());
+
+        // Per row of mip levels, merge neighbouring layer cells of equal layout. Then merge identical neighbouring rows
+        using Row = std::vector<SubresourceLayout>;
+        auto buildRow = [&](size_t mipIndex) {
+            Row row;
+            for(size_t layerIndex = 0; layerIndex + 1 < layerSplits.size(); layerIndex++)
+            {
+                VkImageLayout layout = state.Get(mipSplits[mipIndex], layerSplits[layerIndex]);
+                if(row.size() > 0 && row.back().Layout == layout)
+                {
+                    row.back().LayerEnd = layerSplits[layerIndex + 1];
+                }
+                else
+                {
+                    row.push_back(SubresourceLayout{.MipBegin   = mipSplits[mipIndex],
+                                                    .MipEnd     = mipSplits[mipIndex + 1],
+                                                    .LayerBegin = layerSplits[layerIndex],
+                                                    .LayerEnd   = layerSplits[layerIndex + 1],
+                                                    .Layout     = layout});
+                }
+            }
+            return row;
+        };
+        auto sameLayouts = [](const Row& a, const Row& b) {
+            if(a.size() != b.size())
+            {
+                return false;
+            }
+            for(size_t i = 0; i < a.size(); i++)
+            {
+                if(a[i].Layout != b[i].Layout || a[i].LayerBegin != b[i].LayerBegin || a[i].LayerEnd != b[i].LayerEnd)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+        auto emitRow = [&](const Row& row) {
+            for(const SubresourceLayout& cell : row)
+            {
+                callback(toRange(cell), cell.Layout);
+            }
+        };
+
+        Row current = buildRow(0);
+        for(size_t mipIndex = 1; mipIndex + 1 < mipSplits.size(); mipIndex++)
+        {
+            Row next = buildRow(mipIndex);
+            if(sameLayouts(current, next))
+            {
+                for(SubresourceLayout& cell : current)
+                {
+                    cell.MipEnd = next.front().MipEnd;
+                }
+            }
+            else
+            {
+                emitRow(current);
+                current = std::move(next);
+            }
+        }
+        emitRow(current);
     }
 
     VkImageLayout ImageLayoutCache::Get(const ManagedImage& image) const
@@ -42,8 +282,8 @@ namespace foray::core {
 
     VkImageMemoryBarrier ImageLayoutCache::MakeBarrier(VkImage image, const Barrier& barrier)
     {
-        VkImageLayout oldLayout = Get(image);
-        Set(image, barrier.NewLayout);
+        VkImageLayout oldLayout = Get(image, barrier.SubresourceRange);
+        Set(image, barrier.NewLayout, barrier.SubresourceRange);
         return VkImageMemoryBarrier{.sType               = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
                                     .srcAccessMask       = barrier.SrcAccessMask,
                                     .dstAccessMask       = barrier.DstAccessMask,
@@ -57,18 +297,20 @@ namespace foray::core {
 
     VkImageMemoryBarrier ImageLayoutCache::MakeBarrier(const ManagedImage* image, const Barrier& barrier)
     {
+        SetSubresourceCounts(image);
         return MakeBarrier(image->GetImage(), barrier);
     }
 
     VkImageMemoryBarrier ImageLayoutCache::MakeBarrier(const ManagedImage& image, const Barrier& barrier)
     {
+        SetSubresourceCounts(image);
         return MakeBarrier(image.GetImage(), barrier);
     }
 
     VkImageMemoryBarrier2 ImageLayoutCache::MakeBarrier(VkImage image, const Barrier2& barrier)
     {
-        VkImageLayout oldLayout = Get(image);
-        Set(image, barrier.NewLayout);
+        VkImageLayout oldLayout = Get(image, barrier.SubresourceRange);
+        Set(image, barrier.NewLayout, barrier.SubresourceRange);
         return VkImageMemoryBarrier2{.sType               = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
                                      .srcStageMask        = barrier.SrcStageMask,
                                      .srcAccessMask       = barrier.SrcAccessMask,
@@ -84,14 +326,47 @@ namespace foray::core {
 
     VkImageMemoryBarrier2 ImageLayoutCache::MakeBarrier(const ManagedImage* image, const Barrier2& barrier)
     {
+        SetSubresourceCounts(image);
         return MakeBarrier(image->GetImage(), barrier);
     }
 
     VkImageMemoryBarrier2 ImageLayoutCache::MakeBarrier(const ManagedImage& image, const Barrier2& barrier)
     {
+        SetSubresourceCounts(image);
         return MakeBarrier(image.GetImage(), barrier);
     }
 
+    uint32_t ImageLayoutCache::MakeBarriers(VkImage image, const Barrier2& barrier, std::vector<VkImageMemoryBarrier2>& out)
+    {
+        size_t before = out.size();
+        ForEachLayout(image, barrier.SubresourceRange, [&](const VkImageSubresourceRange& subrange, VkImageLayout oldLayout) {
+            out.push_back(VkImageMemoryBarrier2{.sType               = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                                                .srcStageMask        = barrier.SrcStageMask,
+                                                .srcAccessMask       = barrier.SrcAccessMask,
+                                                .dstStageMask        = barrier.DstStageMask,
+                                                .dstAccessMask       = barrier.DstAccessMask,
+                                                .oldLayout           = oldLayout,
+                                                .newLayout           = barrier.NewLayout,
+                                                .srcQueueFamilyIndex = barrier.SrcQueueFamilyIndex,
+                                                .dstQueueFamilyIndex = barrier.DstQueueFamilyIndex,
+                                                .image               = image,
+                                                .subresourceRange    = subrange});
+        });
+        Set(image, barrier.NewLayout, barrier.SubresourceRange);
+        return (uint32_t)(out.size() - before);
+    }
+
+    uint32_t ImageLayoutCache::MakeBarriers(const ManagedImage* image, const Barrier2& barrier, std::vector<VkImageMemoryBarrier2>& out)
+    {
+        return MakeBarriers(*image, barrier, out);
+    }
+
+    uint32_t ImageLayoutCache::MakeBarriers(const ManagedImage& image, const Barrier2& barrier, std::vector<VkImageMemoryBarrier2>& out)
+    {
+        SetSubresourceCounts(image);
+        return MakeBarriers(image.GetImage(), barrier, out);
+    }
+
     void ImageLayoutCache::CmdBarrier(VkCommandBuffer      cmdBuffer,
                                       VkImage              image,
                                       const Barrier&       barrier,
@@ -124,22 +399,24 @@ namespace foray::core {
     }
     void ImageLayoutCache::CmdBarrier(VkCommandBuffer cmdBuffer, VkImage image, const Barrier2& barrier, VkDependencyFlags depFlags)
     {
-        VkImageMemoryBarrier2 vkBarrier = MakeBarrier(image, barrier);
+        std::vector<VkImageMemoryBarrier2> vkBarriers;
+        MakeBarriers(image, barrier, vkBarriers);
         VkDependencyInfo      depInfo
         {
             .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
             .dependencyFlags = depFlags,
-            .imageMemoryBarrierCount = 1U,
-            .pImageMemoryBarriers = &vkBarrier
+            .imageMemoryBarrierCount = (uint32_t)vkBarriers.size(),
+            .pImageMemoryBarriers = vkBarriers.data()
         };
         vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
     }
     void ImageLayoutCache::CmdBarrier(VkCommandBuffer cmdBuffer, const ManagedImage* image, const Barrier2& barrier, VkDependencyFlags depFlags)
     {
-        CmdBarrier(cmdBuffer, image->GetImage(), barrier, depFlags);
+        CmdBarrier(cmdBuffer, *image, barrier, depFlags);
     }
     void ImageLayoutCache::CmdBarrier(VkCommandBuffer cmdBuffer, const ManagedImage& image, const Barrier2& barrier, VkDependencyFlags depFlags)
     {
+        SetSubresourceCounts(image);
         CmdBarrier(cmdBuffer, image.GetImage(), barrier, depFlags);
     }
 
@@ -1,13 +1,19 @@
 #pragma once
 #include "../foray_vulkan.hpp"
 #include "foray_core_declares.hpp"
+#include <functional>
 #include <unordered_map>
+#include <vector>
 
 namespace foray::core {
     /// @brief Tracks ImageLayouts over the course of a frame rendering process
     /// @details
     /// - Why is the use of this necessary: If passing VkImageLayout::UNDEFINED as the old image layout in a layout transition, the driver is free to decide wether it wants to transition the old data or simply discard it instead.
-    /// - Individual array layers and mip map levels can be in differing layouts, this requires manual setup, as this class only tracks layout of a complete image
+    /// - Layouts are tracked per mip level and array layer range. Aspects are not tracked separately.
+    /// - Methods without a subresource range refer to the complete image (Set) or its first subresource (Get).
+    /// - MakeBarrier() assumes a uniform layout across the barriers subresource range. Use MakeBarriers() or BarrierBatch if the range may contain differing layouts.
+    /// - Ranges are clamped to the images mip level and array layer counts, ranges covering all subresources reset the image to a uniform layout. ManagedImage overloads
+    ///   declare the counts automatically, use SetSubresourceCounts() for raw images. Without known counts, only VK_REMAINING_* ranges are known to cover the whole image.
     /// - The FrameRenderInfo's Image Layout Cache is a new object every frame. Frame Buffers from the previous frame which need to be read in the current frame must be manually set in the new object.
     class ImageLayoutCache
     {
@@ -26,6 +32,31 @@ namespace foray::core {
         /// @brief Set the cached layout of image
         void Set(const ManagedImage* image, VkImageLayout layout);
 
+        /// @brief Get the currently cached layout of the first subresource (base mip level, base array layer) of range
+        VkImageLayout Get(VkImage image, const VkImageSubresourceRange& range) const;
+        /// @brief Get the currently cached layout of the first subresource (base mip level, base array layer) of range
+        VkImageLayout Get(const ManagedImage& image, const VkImageSubresourceRange& range) const;
+        /// @brief Get the currently cached layout of the first subresource (base mip level, base array layer) of range
+        VkImageLayout Get(const ManagedImage* image, const VkImageSubresourceRange& range) const;
+
+        /// @brief Set the cached layout of the mip levels and array layers of range
+        void Set(VkImage image, VkImageLayout layout, const VkImageSubresourceRange& range);
+        /// @brief Set the cached layout of the mip levels and array layers of range
+        void Set(const ManagedImage& image, VkImageLayout layout, const VkImageSubresourceRange& range);
+        /// @brief Set the cached layout of the mip levels and array layers of range
+        void Set(const ManagedImage* image, VkImageLayout layout, const VkImageSubresourceRange& range);
+
+        /// @brief Declares the number of mip levels and array layers of image, so ranges can be clamped and whole image ranges detected
+        void SetSubresourceCounts(VkImage image, uint32_t mipLevelCount, uint32_t arrayLayerCount);
+        /// @brief Declares the number of mip levels and array layers of image as per its create info
+        void SetSubresourceCounts(const ManagedImage& image);
+        /// @brief Declares the number of mip levels and array layers of image as per its create info
+        void SetSubresourceCounts(const ManagedImage* image);
+
+        /// @brief Invokes callback for every subrange of range with uniform cached layout
+        /// @param callback Parameters are the subrange (aspect mask copied from range) and its layout
+        void ForEachLayout(VkImage image, const VkImageSubresourceRange& range, const std::function<void(const VkImageSubresourceRange&, VkImageLayout)>& callback) const;
+
         /// @brief See VkImageMemoryBarrier
         struct Barrier
         {
@@ -77,6 +108,25 @@ namespace foray::core {
         /// @param barrier Layout Transition Barrier2 information
         VkImageMemoryBarrier2 MakeBarrier(const ManagedImage& image, const Barrier2& barrier);
 
+        /// @brief Constructs VkImageMemoryBarrier2 structs (one per subrange with differing old layout) and updates the stored layouts
+        /// @param image Image
+        /// @param barrier Layout Transition Barrier2 information
+        /// @param out Barriers are appended to this vector
+        /// @return Number of barriers appended
+        uint32_t MakeBarriers(VkImage image, const Barrier2& barrier, std::vector<VkImageMemoryBarrier2>& out);
+        /// @brief Constructs VkImageMemoryBarrier2 structs (one per subrange with differing old layout) and updates the stored layouts
+        /// @param image Image
+        /// @param barrier Layout Transition Barrier2 information
+        /// @param out Barriers are appended to this vector
+        /// @return Number of barriers appended
+        uint32_t MakeBarriers(const ManagedImage* image, const Barrier2& barrier, std::vector<VkImageMemoryBarrier2>& out);
+        /// @brief Constructs VkImageMemoryBarrier2 structs (one per subrange with differing old layout) and updates the stored layouts
+        /// @param image Image
+        /// @param barrier Layout Transition Barrier2 information
+        /// @param out Barriers are appended to this vector
+        /// @return Number of barriers appended
+        uint32_t MakeBarriers(const ManagedImage& image, const Barrier2& barrier, std::vector<VkImageMemoryBarrier2>& out);
+
         /// @brief Writes a dedicated vkCmdPipelineBarrier command
         /// @param cmdBuffer Command Buffer
         /// @param name Name of the image
@@ -138,6 +188,41 @@ namespace foray::core {
         void CmdBarrier(VkCommandBuffer cmdBuffer, const ManagedImage& image, const Barrier2& barrier, VkDependencyFlags depFlags = 0);
 
       protected:
-        std::unordered_map<VkImage, VkImageLayout> mLayoutCache;
+        /// @brief Layout of a rectangular range of mip levels and array layers. End values are exclusive, UINT32_MAX meaning 'remaining'
+        struct SubresourceLayout
+        {
+            uint32_t      MipBegin   = 0;
+            uint32_t      MipEnd     = UINT32_MAX;
+            uint32_t      LayerBegin = 0;
+            uint32_t      LayerEnd   = UINT32_MAX;
+            VkImageLayout Layout     = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
+
+            inline bool Contains(uint32_t mip, uint32_t layer) const { return mip >= MipBegin && mip < MipEnd && layer >= LayerBegin && layer < LayerEnd; }
+        };
+
+        /// @brief Layout state of an image
+        struct ImageState
+        {
+            /// @brief Layout of all subresources not covered by Overrides
+            VkImageLayout Layout = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
+            /// @brief Subresource ranges in differing layouts. Later entries take precedence
+            std::vector<SubresourceLayout> Overrides;
+            /// @brief Number of mip levels, UINT32_MAX if unknown
+            uint32_t MipCount = UINT32_MAX;
+            /// @brief Number of array layers, UINT32_MAX if unknown
+            uint32_t LayerCount = UINT32_MAX;
+
+            VkImageLayout Get(uint32_t mip, uint32_t layer) const;
+            /// @brief Limits bounds to the known mip level and array layer counts
+            SubresourceLayout Clamp(SubresourceLayout bounds) const;
+            /// @brief True if bounds include all subresources of the image
+            bool CoversAll(const SubresourceLayout& bounds) const;
+            /// @brief Sets the layout of the bounds, resetting to a uniform layout if they cover all subresources
+            void Set(const SubresourceLayout& bounds);
+        };
+
+        static SubresourceLayout sToBounds(const VkImageSubresourceRange& range);
+
+        std::unordered_map<VkImage, ImageState> mLayoutCache;
     };
 }  // namespace foray::core
@@ -2,6 +2,7 @@
 #include "../foray_logger.hpp"
 #include "../util/foray_fmtutilities.hpp"
 #include "foray_commandbuffer.hpp"
+#include "foray_stagingring.hpp"
 #include <spdlog/fmt/fmt.h>
 
 namespace foray::core {
@@ -18,14 +19,24 @@ namespace foray::core {
         mContext   = context;
         mSize      = createInfo.BufferCreateInfo.size;
         mAlignment = createInfo.Alignment;
+
+        VkBufferCreateInfo bufferCi = createInfo.BufferCreateInfo;
+#ifdef VK_EXT_descriptor_buffer
+        // Buffer descriptors in descriptor buffers reference the buffer by device address
+        const VkBufferUsageFlags descriptorUsages = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+                                                    | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT;
+        if(!!mContext->DescriptorBufferProperties && (bufferCi.usage & descriptorUsages) > 0)
+        {
+            bufferCi.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        }
+#endif
         if(mAlignment > 1)
         {
-            AssertVkResult(vmaCreateBufferWithAlignment(mContext->Allocator, &createInfo.BufferCreateInfo, &createInfo.AllocationCreateInfo, mAlignment, &mBuffer, &mAllocation,
-                                                        &mAllocationInfo));
+            AssertVkResult(vmaCreateBufferWithAlignment(mContext->Allocator, &bufferCi, &createInfo.AllocationCreateInfo, mAlignment, &mBuffer, &mAllocation, &mAllocationInfo));
         }
         else
         {
-            AssertVkResult(vmaCreateBuffer(mContext->Allocator, &createInfo.BufferCreateInfo, &createInfo.AllocationCreateInfo, &mBuffer, &mAllocation, &mAllocationInfo));
+            AssertVkResult(vmaCreateBuffer(mContext->Allocator, &bufferCi, &createInfo.AllocationCreateInfo, &mBuffer, &mAllocation, &mAllocationInfo));
         }
         if(createInfo.Name.size())
         {
@@ -148,10 +159,57 @@ namespace foray::core {
 
     void ManagedBuffer::WriteDataDeviceLocal(const void* data, VkDeviceSize size, VkDeviceSize offsetDstBuffer)
     {
+        if(mContext->HasDedicatedTransferQueue())
+        {
+            WriteDataDeviceLocalViaTransferQueue(data, size, offsetDstBuffer);
+            return;
+        }
         HostSyncCommandBuffer cmdBuffer;
         cmdBuffer.Create(mContext);
         WriteDataDeviceLocal(cmdBuffer, data, size, offsetDstBuffer);
     }
+    void ManagedBuffer::WriteDataDeviceLocalViaTransferQueue(const void* data, VkDeviceSize size, VkDeviceSize offsetDstBuffer)
+    {
+        Assert(size + offsetDstBuffer <= mAllocationInfo.size, "Attempt to write data to device local buffer failed. Size + offsets needs to fit into buffer allocation!");
+
+        ManagedBuffer stagingBuffer;
+        stagingBuffer.CreateForStaging(mContext, size, data, fmt::format("Staging for {}", GetName()));
+
+        // The buffer is owned by the main queue family. Copy on the transfer queue, then release ownership there and acquire it on the main queue.
+        VkBufferMemoryBarrier ownershipBarrier{.sType               = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                                               .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                               .dstAccessMask       = 0,
+                                               .srcQueueFamilyIndex = mContext->TransferQueueFamilyIndex,
+                                               .dstQueueFamilyIndex = mContext->QueueFamilyIndex,
+                                               .buffer              = mBuffer,
+                                               .offset              = offsetDstBuffer,
+                                               .size                = size};
+
+        Context                 transferContext = mContext->GetTransferContext();
+        DeviceSyncCommandBuffer transferCmdBuffer;
+        transferCmdBuffer.Create(&transferContext);
+        transferCmdBuffer.Begin();
+
+        VkBufferCopy copy{.srcOffset = 0, .dstOffset = offsetDstBuffer, .size = size};
+        vkCmdCopyBuffer(transferCmdBuffer, stagingBuffer.GetBuffer(), mBuffer, 1, &copy);
+        vkCmdPipelineBarrier(transferCmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &ownershipBarrier, 0, nullptr);
+        // The acquire submission waits for the transfer on the device, so the host blocks only once
+        VkSemaphore           transferSemaphore = nullptr;
+        VkSemaphoreCreateInfo semaphoreCi{.sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        AssertVkResult(mContext->VkbDispatchTable->createSemaphore(&semaphoreCi, nullptr, &transferSemaphore));
+        transferCmdBuffer.AddSignalSemaphore(SemaphoreReference::Binary(transferSemaphore));
+        transferCmdBuffer.Submit();
+
+        ownershipBarrier.srcAccessMask = 0;
+        ownershipBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+        HostSyncCommandBuffer acquireCmdBuffer;
+        acquireCmdBuffer.Create(mContext);
+        acquireCmdBuffer.Begin();
+        vkCmdPipelineBarrier(acquireCmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &ownershipBarrier, 0, nullptr);
+        acquireCmdBuffer.SubmitAndWait(transferSemaphore, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        mContext->VkbDispatchTable->destroySemaphore(transferSemaphore, nullptr);
+    }
     void ManagedBuffer::WriteDataDeviceLocal(HostSyncCommandBuffer& cmdBuffer, const void* data, VkDeviceSize size, VkDeviceSize offsetDstBuffer)
     {
         Assert(size + offsetDstBuffer <= mAllocationInfo.size, "Attempt to write data to device local buffer failed. Size + offsets needs to fit into buffer allocation!");
@@ -169,4 +227,10 @@ namespace foray::core {
         vkCmdCopyBuffer(cmdBuffer, stagingBuffer.GetBuffer(), mBuffer, 1, &copy);
         cmdBuffer.SubmitAndWait();
     }
+    UploadTicket ManagedBuffer::WriteDataDeviceLocal(StagingRing& ring, const void* data, VkDeviceSize size, VkDeviceSize offsetDstBuffer)
+    {
+        Assert(size + offsetDstBuffer <= mAllocationInfo.size, "Attempt to write data to device local buffer failed. Size + offsets needs to fit into buffer allocation!");
+
+        return ring.Upload(mBuffer, offsetDstBuffer, data, size);
+    }
 }  // namespace foray::core
\ No newline at end of file
@@ -47,6 +47,7 @@ namespace foray::core {
         virtual bool Exists() const override { return !!mAllocation; }
 
         /// @brief Employ a staging buffer to upload data
+        /// @details Uses the dedicated transfer queue, if available (see Context::HasDedicatedTransferQueue())
         /// @param data data
         /// @param size size
         /// @param offset write offset into buffer
@@ -57,6 +58,13 @@ namespace foray::core {
         /// @param size size
         /// @param offset write offset into buffer
         void WriteDataDeviceLocal(HostSyncCommandBuffer& cmdBuffer, const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+        /// @brief Queue data for upload via a staging ring (non-blocking)
+        /// @param ring Staging ring to sub-allocate staging memory from. The copy executes once the ring is flushed.
+        /// @param data data. Copied immediately, may be freed after this call returns
+        /// @param size size
+        /// @param offset write offset into buffer
+        /// @return Ticket to check for / wait on completion via the ring
+        UploadTicket WriteDataDeviceLocal(StagingRing& ring, const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
 
         /// @brief Maps the buffer to memory address data
         void Map(void*& data);
@@ -104,6 +112,8 @@ namespace foray::core {
         bool              mIsMapped  = false;
 
         void UpdateDebugNames();
+        /// @brief Copy on the transfer queue, followed by a queue family ownership transfer back to the main queue family
+        void WriteDataDeviceLocalViaTransferQueue(const void* data, VkDeviceSize size, VkDeviceSize offset);
     };
 
 }  // namespace foray::core
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "../util/foray_fmtutilities.hpp"
 #include "foray_commandbuffer.hpp"
 #include "foray_managedbuffer.hpp"
+#include "foray_transientimageallocator.hpp"
 
 namespace foray::core {
     ManagedImage::CreateInfo::CreateInfo()
@@ -39,8 +40,22 @@ namespace foray::core {
 
         CheckImageFormatSupport(mCreateInfo);
 
+        if(mCreateInfo.Transient && !!mContext->TransientImages)
+        {
+            mTransientAllocator = mContext->TransientImages;
+            mTransientAllocator->Register(this);
+            mAliased = mTransientAllocator->CreateAliasingImage(this, mCreateInfo.ImageCI, mImage, mAllocation);
+        }
+
         // create image
-        AssertVkResult(vmaCreateImage(mContext->Allocator, &mCreateInfo.ImageCI, &mCreateInfo.AllocCI, &mImage, &mAllocation, &mAllocInfo));
+        if(mAliased)
+        {
+            vmaGetAllocationInfo(mContext->Allocator, mAllocation, &mAllocInfo);
+        }
+        else
+        {
+            AssertVkResult(vmaCreateImage(mContext->Allocator, &mCreateInfo.ImageCI, &mCreateInfo.AllocCI, &mImage, &mAllocation, &mAllocInfo));
+        }
         mSize = mAllocInfo.size;
 
         if(mCreateInfo.CreateImageView)
@@ -112,6 +127,11 @@ namespace foray::core {
 
     void ManagedImage::WriteDeviceLocalData(const void* data, size_t size, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy)
     {
+        if(mContext->HasDedicatedTransferQueue())
+        {
+            WriteDeviceLocalDataViaTransferQueue(data, size, layoutAfterWrite, imageCopy);
+            return;
+        }
         HostSyncCommandBuffer cmdBuffer;
         cmdBuffer.Create(mContext);
         WriteDeviceLocalData(cmdBuffer, data, size, layoutAfterWrite, imageCopy);
@@ -149,13 +169,70 @@ namespace foray::core {
         cmdBuffer.SubmitAndWait();
     }
 
+    void ManagedImage::WriteDeviceLocalDataViaTransferQueue(const void* data, size_t size, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy)
+    {
+        ManagedBuffer stagingBuffer;
+        stagingBuffer.CreateForStaging(mContext, size, data, fmt::format("Staging for {}", GetName()));
+
+        Context                 transferContext = mContext->GetTransferContext();
+        DeviceSyncCommandBuffer transferCmdBuffer;
+        transferCmdBuffer.Create(&transferContext);
+        transferCmdBuffer.Begin();
+
+        // Previous contents are discarded (old layout undefined), so the transfer queue family may take the image without an ownership transfer
+        QuickTransition transition{.SrcStageMask  = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                   .DstStageMask  = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                   .DstAccessMask = VkAccessFlagBits::VK_ACCESS_TRANSFER_WRITE_BIT,
+                                   .NewLayout     = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   .AspectMask    = imageCopy.imageSubresource.aspectMask};
+        TransitionLayout(transition, transferCmdBuffer);
+
+        vkCmdCopyBufferToImage(transferCmdBuffer, stagingBuffer.GetBuffer(), mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+
+        // Release to the main queue family. The layout transition to layoutAfterWrite is part of the ownership transfer.
+        VkImageMemoryBarrier ownershipBarrier{
+            .sType               = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask       = VkAccessFlagBits::VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask       = 0,
+            .oldLayout           = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout           = !!layoutAfterWrite ? layoutAfterWrite : VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .srcQueueFamilyIndex = mContext->TransferQueueFamilyIndex,
+            .dstQueueFamilyIndex = mContext->QueueFamilyIndex,
+            .image               = mImage,
+            .subresourceRange    = VkImageSubresourceRange{
+                   .aspectMask = imageCopy.imageSubresource.aspectMask, .levelCount = VK_REMAINING_MIP_LEVELS, .layerCount = VK_REMAINING_ARRAY_LAYERS}};
+        vkCmdPipelineBarrier(transferCmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1U, &ownershipBarrier);
+        // The acquire submission waits for the transfer on the device, so the host blocks only once
+        VkSemaphore           transferSemaphore = nullptr;
+        VkSemaphoreCreateInfo semaphoreCi{.sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        AssertVkResult(mContext->VkbDispatchTable->createSemaphore(&semaphoreCi, nullptr, &transferSemaphore));
+        transferCmdBuffer.AddSignalSemaphore(SemaphoreReference::Binary(transferSemaphore));
+        transferCmdBuffer.Submit();
+
+        // Acquire on the main queue family
+        ownershipBarrier.srcAccessMask = 0;
+        ownershipBarrier.dstAccessMask = VkAccessFlagBits::VK_ACCESS_MEMORY_READ_BIT | VkAccessFlagBits::VK_ACCESS_MEMORY_WRITE_BIT;
+
+        HostSyncCommandBuffer acquireCmdBuffer;
+        acquireCmdBuffer.Create(mContext);
+        acquireCmdBuffer.Begin();
+        vkCmdPipelineBarrier(acquireCmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1U, &ownershipBarrier);
+        acquireCmdBuffer.SubmitAndWait(transferSemaphore, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        mContext->VkbDispatchTable->destroySemaphore(transferSemaphore, nullptr);
+    }
+
     void ManagedImage::WriteDeviceLocalData(const void* data, size_t size, VkImageLayout layoutAfterWrite)
     {
-        HostSyncCommandBuffer cmdBuffer;
-        cmdBuffer.Create(mContext);
-        WriteDeviceLocalData(cmdBuffer, data, size, layoutAfterWrite);
+        VkBufferImageCopy region = MakeDefaultImageCopy();
+        WriteDeviceLocalData(data, size, layoutAfterWrite, region);
     }
     void ManagedImage::WriteDeviceLocalData(HostSyncCommandBuffer& cmdBuffer, const void* data, size_t size, VkImageLayout layoutAfterWrite)
+    {
+        VkBufferImageCopy region = MakeDefaultImageCopy();
+        WriteDeviceLocalData(cmdBuffer, data, size, layoutAfterWrite, region);
+    }
+
+    VkBufferImageCopy ManagedImage::MakeDefaultImageCopy() const
     {
         // specify default copy region
         VkBufferImageCopy region{};
@@ -168,7 +245,7 @@ namespace foray::core {
         region.imageSubresource.layerCount     = 1;
         region.imageOffset                     = {0, 0, 0};
         region.imageExtent                     = mExtent3D;
-        WriteDeviceLocalData(cmdBuffer, data, size, layoutAfterWrite, region);
+        return region;
     }
 
     void ManagedImage::Destroy()
@@ -180,11 +257,25 @@ namespace foray::core {
                 mContext->VkbDispatchTable->destroyImageView(mImageView, nullptr);
                 mImageView = nullptr;
             }
-            vmaDestroyImage(mContext->Allocator, mImage, mAllocation);
+            if(mAliased)
+            {
+                // The memory block is owned by the transient image allocator
+                mContext->VkbDispatchTable->destroyImage(mImage, nullptr);
+                mAliased = false;
+            }
+            else
+            {
+                vmaDestroyImage(mContext->Allocator, mImage, mAllocation);
+            }
             mImage      = nullptr;
             mAllocation = nullptr;
             mAllocInfo  = VmaAllocationInfo{};
         }
+        if(!!mTransientAllocator)
+        {
+            mTransientAllocator->Unregister(this);
+            mTransientAllocator = nullptr;
+        }
     }
 
     void ManagedImage::CheckImageFormatSupport(const CreateInfo& createInfo)
@@ -211,7 +302,10 @@ namespace foray::core {
         {  // Image
             std::string debugName = fmt::format("ManImg \"{}\" ({})", mName, util::PrintSize(mSize));
             SetObjectName(mContext, mImage, debugName, false);
-            vmaSetAllocationName(mContext->Allocator, mAllocation, debugName.c_str());
+            if(!mAliased)
+            {
+                vmaSetAllocationName(mContext->Allocator, mAllocation, debugName.c_str());
+            }
         }
         if (!!mImageView) {  // Image View
             std::string debugName = fmt::format("ManImgView \"{}\"", mName);
@@ -28,6 +28,9 @@ namespace foray::core {
             VmaAllocationCreateInfo AllocCI{};
             /// @brief Debug object name
             std::string Name{"Unnamed Image"};
+            /// @brief If set and Context::TransientImages is set, the image may share memory with other transient images whose lifetimes within a frame do not overlap.
+            /// Contents are undefined at the first use in a frame. See TransientImageAllocator
+            bool Transient = false;
 
             /// @brief Initiliazes .sType fields, chooses common defaults for everything else
             CreateInfo();
@@ -74,6 +77,7 @@ namespace foray::core {
         /// @param size Size of the image
         /// @param layoutAfterWrite The layout that the image is transitioned to after it has been written.
         /// @param imageCopy Specify how exactly the image is copied.
+        /// @remark Overloads without command buffer use the dedicated transfer queue, if available (see Context::HasDedicatedTransferQueue())
         void WriteDeviceLocalData(const void* data, size_t size, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy);
         void WriteDeviceLocalData(HostSyncCommandBuffer& cmdBuffer, const void* data, size_t size, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy);
 
@@ -92,6 +96,8 @@ namespace foray::core {
         FORAY_GETTER_CR(AllocInfo)
         FORAY_GETTER_V(Format)
         FORAY_GETTER_CR(Extent3D)
+        /// @brief True, if the image aliases a memory block of the TransientImageAllocator
+        FORAY_GETTER_V(Aliased)
         inline VkExtent2D GetExtent2D() const { return VkExtent2D{mExtent3D.width, mExtent3D.height}; }
 
         virtual void SetName(std::string_view name) override;
@@ -108,8 +114,15 @@ namespace foray::core {
         VmaAllocationInfo mAllocInfo{};
         VkDeviceSize      mSize{};
         VkExtent3D        mExtent3D{};
+        /// @brief Set, if the image is registered as transient image
+        TransientImageAllocator* mTransientAllocator = nullptr;
+        bool                     mAliased            = false;
 
         void CheckImageFormatSupport(const CreateInfo& createInfo);
         void UpdateDebugNames();
+        /// @brief Copy region covering mip level 0, layer 0 entirely
+        VkBufferImageCopy MakeDefaultImageCopy() const;
+        /// @brief Copy on the transfer queue, followed by a queue family ownership transfer back to the main queue family
+        void WriteDeviceLocalDataViaTransferQueue(const void* data, size_t size, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy);
     };
 }  // namespace foray::core
\ No newline at end of file
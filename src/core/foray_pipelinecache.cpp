@@ -0,0 +1,178 @@
+#include "foray_pipelinecache.hpp"
+#include "../bench/foray_hostbenchmark.hpp"
+#include "../foray_exception.hpp"
+#include "../foray_logger.hpp"
+#include "../osi/foray_env.hpp"
+#include <cstring>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+
+namespace fs = std::filesystem;
+
+namespace foray::core {
+    void PipelineCache::Create(Context* context, std::string_view directory, bench::HostBenchmark* benchmark)
+    {
+        Destroy();
+        mContext = context;
+
+        vkGetPhysicalDeviceProperties(mContext->PhysicalDevice(), &mDeviceProperties);
+
+        std::string uuid;
+        for(uint32_t i = 0; i < VK_UUID_SIZE; i++)
+        {
+            uuid += fmt::format("{:02x}", mDeviceProperties.pipelineCacheUUID[i]);
+        }
+        std::string fileName = fmt::format("foray_pipelinecache_{}_{:x}.bin", uuid, mDeviceProperties.driverVersion);
+        osi::Utf8Path dirPath  = directory.size() > 0 ? osi::Utf8Path(directory) : osi::Utf8Path(osi::CurrentWorkingDirectory());
+        SetName(fileName);
+        mFilePath              = (const std::string&)(dirPath / osi::Utf8Path(fileName));
+
+        if(!!benchmark)
+        {
+            benchmark->Begin();
+        }
+
+        std::vector<uint8_t> data;
+        mLoadedFromFile = LoadFile(data);
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_LOAD);
+        }
+
+        VkPipelineCacheCreateInfo ci{.sType           = VkStructureType::VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+                                     .initialDataSize = mLoadedFromFile ? data.size() : 0,
+                                     .pInitialData    = mLoadedFromFile ? data.data() : nullptr};
+        AssertVkResult(mContext->VkbDispatchTable->createPipelineCache(&ci, nullptr, &mPipelineCache));
+
+        if(!!benchmark)
+        {
+            benchmark->LogTimestamp(BENCH_CREATE);
+            benchmark->LogValue(BENCH_HIT, mLoadedFromFile ? 1.0 : 0.0);
+            benchmark->LogValue(BENCH_LOADEDSIZE, mLoadedFromFile ? (fp64_t)data.size() : 0.0);
+            benchmark->End();
+        }
+
+        if(mLoadedFromFile)
+        {
+            logger()->info("Pipeline cache loaded from \"{}\" ({} bytes)", mFilePath, data.size());
+        }
+        else
+        {
+            logger()->info("No matching pipeline cache found at \"{}\", starting empty", mFilePath);
+        }
+    }
+
+    PipelineCache::FileHeader PipelineCache::MakeFileHeader() const
+    {
+        FileHeader header{.Magic         = FILE_MAGIC,
+                          .FormatVersion = FILE_FORMAT_VERSION,
+                          .VendorId      = mDeviceProperties.vendorID,
+                          .DeviceId      = mDeviceProperties.deviceID,
+                          .DriverVersion = mDeviceProperties.driverVersion};
+        memcpy(header.CacheUuid, mDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+        return header;
+    }
+
+    bool PipelineCache::LoadFile(std::vector<uint8_t>& data) const
+    {
+        std::ifstream file((fs::path)osi::Utf8Path(mFilePath), std::ios::binary | std::ios::in);
+        if(!file.is_open())
+        {
+            return false;
+        }
+
+        FileHeader expected = MakeFileHeader();
+        FileHeader header;
+        if(!file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader)))
+        {
+            return false;
+        }
+        if(header.Magic != expected.Magic || header.FormatVersion != expected.FormatVersion || header.VendorId != expected.VendorId || header.DeviceId != expected.DeviceId
+           || header.DriverVersion != expected.DriverVersion || memcmp(header.CacheUuid, expected.CacheUuid, VK_UUID_SIZE) != 0)
+        {
+            logger()->warn("Pipeline cache file \"{}\" was written for a different device or driver, ignoring", mFilePath);
+            return false;
+        }
+
+        // A truncated or otherwise corrupt file must not cause a huge allocation
+        std::error_code error;
+        uintmax_t       fileSize = fs::file_size((fs::path)osi::Utf8Path(mFilePath), error);
+        if(error || fileSize < sizeof(FileHeader) || header.DataSize != fileSize - sizeof(FileHeader))
+        {
+            logger()->warn("Pipeline cache file \"{}\" is corrupt (data size mismatch), ignoring", mFilePath);
+            return false;
+        }
+
+        data.resize(header.DataSize);
+        if(!file.read(reinterpret_cast<char*>(data.data()), header.DataSize))
+        {
+            return false;
+        }
+
+        // Validate the Vulkan pipeline cache header aswell, drivers may reject mismatching data only with undefined results
+        VkPipelineCacheHeaderVersionOne vkHeader;
+        if(data.size() < sizeof(vkHeader))
+        {
+            return false;
+        }
+        memcpy(&vkHeader, data.data(), sizeof(vkHeader));
+        return vkHeader.headerVersion == VkPipelineCacheHeaderVersion::VK_PIPELINE_CACHE_HEADER_VERSION_ONE && vkHeader.vendorID == expected.VendorId
+               && vkHeader.deviceID == expected.DeviceId && memcmp(vkHeader.pipelineCacheUUID, expected.CacheUuid, VK_UUID_SIZE) == 0;
+    }
+
+    bool PipelineCache::Save()
+    {
+        if(!mPipelineCache)
+        {
+            return false;
+        }
+
+        size_t size = 0;
+        AssertVkResult(mContext->VkbDispatchTable->getPipelineCacheData(mPipelineCache, &size, nullptr));
+        std::vector<uint8_t> data(size);
+        AssertVkResult(mContext->VkbDispatchTable->getPipelineCacheData(mPipelineCache, &size, data.data()));
+        data.resize(size);
+
+        FileHeader header = MakeFileHeader();
+        header.DataSize   = size;
+
+        // Write to a temporary file first, so an interrupted write never leaves a corrupt cache behind
+        osi::Utf8Path path(mFilePath);
+        fs::path      tempPath = (fs::path)path;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            if(!file.is_open())
+            {
+                logger()->warn("Failed to open \"{}\" for writing the pipeline cache", osi::ToUtf8Path(tempPath));
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+            file.write(reinterpret_cast<const char*>(data.data()), size);
+            if(!file)
+            {
+                return false;
+            }
+        }
+        std::error_code error;
+        fs::rename(tempPath, (fs::path)path, error);
+        if(error)
+        {
+            logger()->warn("Failed to write pipeline cache \"{}\": {}", mFilePath, error.message());
+            return false;
+        }
+        logger()->info("Pipeline cache saved to \"{}\" ({} bytes)", mFilePath, size);
+        return true;
+    }
+
+    void PipelineCache::Destroy()
+    {
+        if(!!mPipelineCache)
+        {
+            mContext->VkbDispatchTable->destroyPipelineCache(mPipelineCache, nullptr);
+            mPipelineCache = nullptr;
+        }
+        mLoadedFromFile = false;
+    }
+}  // namespace foray::core
@@ -0,0 +1,78 @@
+#pragma once
+#include "../bench/foray_bench_declares.hpp"
+#include "../foray_basics.hpp"
+#include "../foray_vulkan.hpp"
+#include "foray_context.hpp"
+#include "foray_managedresource.hpp"
+#include <string>
+
+namespace foray::core {
+
+    /// @brief VkPipelineCache persisted to disk between application runs
+    /// @details
+    /// The cache file name is derived from the physical devices pipelineCacheUUID, vendor and device id and driver version, so caches of different
+    /// devices or drivers live side by side and a driver update starts with an empty cache.
+    /// The file begins with a small header (magic, format version, device identification), which is validated together with the Vulkan pipeline cache header before loading.
+    /// Invalid, truncated or mismatching files are ignored (treated as a cache miss).
+    class PipelineCache : public VulkanResource<VkObjectType::VK_OBJECT_TYPE_PIPELINE_CACHE>
+    {
+      public:
+        inline static const char* BENCH_LOAD   = "Load";
+        inline static const char* BENCH_CREATE = "Create";
+        /// @brief 1 if cache data was loaded from disk, 0 otherwise
+        inline static const char* BENCH_HIT = "Cache Hit";
+        /// @brief Bytes of cache data loaded from disk
+        inline static const char* BENCH_LOADEDSIZE = "Loaded Bytes";
+
+        /// @brief Increment whenever the file header layout changes
+        inline static constexpr uint32_t FILE_FORMAT_VERSION = 1;
+
+        PipelineCache() = default;
+        inline virtual ~PipelineCache() { Destroy(); }
+
+        /// @brief Creates the pipeline cache, initialized from the cache file in directory if one exists and matches the device
+        /// @param context Requires DispatchTable and PhysicalDevice
+        /// @param directory Directory to store the cache file in. Empty: current working directory
+        /// @param benchmark Optional benchmark timing load and creation. See static BENCH_... members
+        void Create(Context* context, std::string_view directory = "", bench::HostBenchmark* benchmark = nullptr);
+
+        /// @brief Writes the current cache data to the cache file
+        /// @return True, if the file was written
+        bool Save();
+
+        virtual bool Exists() const override { return !!mPipelineCache; }
+        virtual void Destroy() override;
+
+        inline operator VkPipelineCache() const { return mPipelineCache; }
+
+        FORAY_GETTER_V(PipelineCache)
+        FORAY_GETTER_CR(FilePath)
+        /// @brief True, if Create() initialized the cache from a matching cache file
+        FORAY_GETTER_V(LoadedFromFile)
+
+      protected:
+        /// @brief Identifies the physical device and driver a cache file was written for
+        struct FileHeader
+        {
+            uint32_t Magic         = 0;
+            uint32_t FormatVersion = 0;
+            uint32_t VendorId      = 0;
+            uint32_t DeviceId      = 0;
+            uint32_t DriverVersion = 0;
+            uint8_t  CacheUuid[VK_UUID_SIZE]{};
+            uint64_t DataSize = 0;
+        };
+
+        inline static constexpr uint32_t FILE_MAGIC = 0x43504F46;  // "FOPC"
+
+        FileHeader MakeFileHeader() const;
+        /// @brief Reads the cache file. Returns false, if it does not exist or does not match the device
+        bool LoadFile(std::vector<uint8_t>& data) const;
+
+        Context*                   mContext       = nullptr;
+        VkPipelineCache            mPipelineCache = nullptr;
+        VkPhysicalDeviceProperties mDeviceProperties{};
+        std::string                mFilePath;
+        bool                       mLoadedFromFile = false;
+    };
+}  // namespace foray::core
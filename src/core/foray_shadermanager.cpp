@@ -3,10 +3,17 @@
 #include "../foray_logger.hpp"
 #include "../util/foray_hash.hpp"
 #include "foray_shadermodule.hpp"
+#include <algorithm>
+#include <array>
 #include <codecvt>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 
+#ifdef FORAY_SHADERC
+#include <shaderc/shaderc.hpp>
+#endif
+
 namespace foray::core {
 
     namespace fs = std::filesystem;
@@ -69,6 +76,141 @@ constexpr std::string_view OPTIMIZE = " -O";
         return writeTime;
     }
 
+    /// @brief Hashes source code with comments, leading and trailing whitespace and blank lines removed
+    uint64_t lHashNormalizedSource(std::string_view source)
+    {
+        std::string normalized;
+        normalized.reserve(source.size());
+        std::string line;
+
+        auto finishLine = [&]() {
+            size_t first = line.find_first_not_of(" \t\r");
+            if(first != std::string::npos)
+            {
+                size_t last = line.find_last_not_of(" \t\r");
+                normalized.append(line, first, last - first + 1);
+                normalized.push_back('\n');
+            }
+            line.clear();
+        };
+
+        bool lineComment  = false;
+        bool blockComment = false;
+        bool stringLit    = false;
+        for(size_t i = 0; i < source.size(); i++)
+        {
+            char c    = source[i];
+            char next = i + 1 < source.size() ? source[i + 1] : '\0';
+            if(blockComment)
+            {
+                if(c == '*' && next == '/')
+                {
+                    blockComment = false;
+                    i++;
+                }
+                else if(c == '\n')
+                {
+                    finishLine();
+                }
+                continue;
+            }
+            if(c == '\n')
+            {
+                lineComment = false;
+                stringLit   = false;
+                finishLine();
+                continue;
+            }
+            if(lineComment)
+            {
+                continue;
+            }
+            if(stringLit)
+            {
+                stringLit = c != '"';
+                line.push_back(c);
+                continue;
+            }
+            if(c == '/' && next == '/')
+            {
+                lineComment = true;
+                continue;
+            }
+            if(c == '/' && next == '*')
+            {
+                blockComment = true;
+                line.push_back(' ');  // Comments separate tokens
+                i++;
+                continue;
+            }
+            stringLit = c == '"';
+            line.push_back(c);
+        }
+        finishLine();
+
+        size_t hash = 0;
+        util::AccumulateHash(hash, std::string_view(normalized));
+        return (uint64_t)hash;
+    }
+
+    bool ShaderManager::GetFileContentHash(const osi::Utf8Path& path, WriteTimeLookup& writeTimeLookup, uint64_t& out_hash)
+    {
+        fs::file_time_type writeTime = GetWriteTime(path, writeTimeLookup);
+        if(writeTime == fs::file_time_type::min())
+        {
+            return false;
+        }
+        FileContentHash& entry = mFileHashes[path];
+        if(entry.WriteTime != writeTime)
+        {
+            std::ifstream file((fs::path)path, std::ios::binary | std::ios::in);
+            if(!file.is_open())
+            {
+                mFileHashes.erase(path);
+                return false;
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            entry.Hash      = lHashNormalizedSource(buffer.str());
+            entry.WriteTime = writeTime;
+        }
+        out_hash = entry.Hash;
+        return true;
+    }
+
+    osi::Utf8Path ShaderManager::MakeSpvPath(const osi::Utf8Path& sourcePath, uint64_t compilationHash, uint64_t contentHash) const
+    {
+        if(((const std::string&)mCacheDirectory).empty())
+        {
+            return fmt::format("{}.{:016x}.{:016x}.spv", sourcePath, compilationHash, contentHash);
+        }
+        osi::Utf8Path directory = mCacheDirectory.IsRelative() ? mCacheDirectory.MakeAbsolute() : mCacheDirectory;
+        std::error_code error;
+        fs::create_directories((fs::path)directory, error);
+        return directory / osi::Utf8Path(fmt::format("{:016x}.spv", contentHash));
+    }
+
+    void ShaderManager::PruneStaleSpvFiles(const osi::Utf8Path& sourcePath, uint64_t compilationHash, const osi::Utf8Path& keep) const
+    {
+        if(!((const std::string&)mCacheDirectory).empty())
+        {
+            return;  // Cache directory entries are keyed by content only and may be shared
+        }
+        // "{source}.{compilationHash}.{contentHash}.spv" files of previous content states
+        fs::path        source = (fs::path)sourcePath;
+        std::string     prefix = fmt::format("{}.{:016x}.", osi::ToUtf8Path(source.filename()), compilationHash);
+        std::error_code error;
+        for(const fs::directory_entry& entry : fs::directory_iterator(source.parent_path(), error))
+        {
+            std::string name = osi::ToUtf8Path(entry.path().filename());
+            if(name.size() == prefix.size() + 16 + 4 && name.starts_with(prefix) && name.ends_with(".spv") && entry.path() != (fs::path)keep)
+            {
+                std::error_code removeError;
+                fs::remove(entry.path(), removeError);
+            }
+        }
+    }
+
 #pragma endregion
 #pragma region Compile Shader
 
@@ -77,43 +219,99 @@ constexpr std::string_view OPTIMIZE = " -O";
         return CompileShader(sourceFilePath, *shaderModule, compileOptions, context);
     }
     uint64_t ShaderManager::CompileShader(osi::Utf8Path sourceFilePath, ShaderModule& shaderModule, const ShaderCompilerConfig& compileOptions, core::Context* context)
+    {
+        return CompileShaders({ShaderCompileRequest{.SourceFilePath = sourceFilePath, .Module = &shaderModule, .Config = compileOptions}}, context).front();
+    }
+
+    std::vector<uint64_t> ShaderManager::CompileShaders(const std::vector<ShaderCompileRequest>& requests, core::Context* context, std::vector<ShaderCompileResult>* out_results)
     {
         context = !context ? mContext : context;
-        if(sourceFilePath.IsRelative())
+
+        std::vector<uint64_t>           keys(requests.size());
+        std::vector<ShaderCompilation*> compilations(requests.size());
+        std::vector<ShaderCompilation*> toCompile;
+
+        // Register compilations and check which require compiling. Touches the tracking maps, so runs serially.
+        WriteTimeLookup lookup;
+        for(size_t i = 0; i < requests.size(); i++)
         {
-            sourceFilePath = sourceFilePath.MakeAbsolute();
-        }
+            osi::Utf8Path sourceFilePath = requests[i].SourceFilePath;
+            if(sourceFilePath.IsRelative())
+            {
+                sourceFilePath = sourceFilePath.MakeAbsolute();
+            }
 
+            bool exists = fs::exists((fs::path)sourceFilePath);
+            bool isFile = !fs::is_directory((fs::path)sourceFilePath);
+            FORAY_ASSERTFMT(exists && isFile, "[ShaderManager::GetShaderBinary] Shader source file \"{}\" does not exist or is not a file!", (const std::string&)sourceFilePath);
 
-        bool exists = fs::exists((fs::path)sourceFilePath);
-        bool isFile = !fs::is_directory((fs::path)sourceFilePath);
-        FORAY_ASSERTFMT(exists && isFile, "[ShaderManager::GetShaderBinary] Shader source file \"{}\" does not exist or is not a file!", (const std::string&)sourceFilePath);
+            uint64_t compileHash = MakeHash((const std::string&)sourceFilePath, requests[i].Config);
+            keys[i]              = compileHash;
+
+            auto iter = mTrackedCompilations.find(compileHash);
+            if(iter != mTrackedCompilations.end())
+            {
+                compilations[i] = iter->second.get();
+                continue;
+            }
 
-        uint64_t compileHash = MakeHash((const std::string&)sourceFilePath, compileOptions);
+            std::unique_ptr<ShaderCompilation>& compilation = mTrackedCompilations[compileHash] =
+                std::make_unique<ShaderCompilation>(this, sourceFilePath, requests[i].Config, compileHash);
+            compilations[i] = compilation.get();
 
-        auto iter = mTrackedCompilations.find(compileHash);
-        if(iter != mTrackedCompilations.end())
-        {
-            const osi::Utf8Path& spvPath = iter->second->SpvPath;
-            shaderModule.LoadFromFile(context, spvPath);
-            return iter->second->Hash;
+            compilation->FindIncludes();
+            ECompileCheckResult checkResult = compilation->NeedsCompile(lookup);
+            Assert(checkResult != ECompileCheckResult::MissingInput, "Missing Input file");
+            if(checkResult == ECompileCheckResult::NeedsRecompile)
+            {
+                toCompile.push_back(compilation.get());
+            }
+            // ECompileCheckResult::CacheHit: Spirv has been loaded from the cache directory
         }
 
-        std::unique_ptr<ShaderCompilation>& compilation = mTrackedCompilations[compileHash] =
-            std::make_unique<ShaderCompilation>(this, sourceFilePath, compileOptions, compileHash);
+        std::vector<uint8_t> success;
+        CompileBatch(toCompile, success);
 
-        compilation->FindIncludes();
-        WriteTimeLookup     lookup;
-        ECompileCheckResult checkResult = compilation->NeedsCompile(lookup);
-        if(checkResult == ECompileCheckResult::NeedsRecompile)
+        if(!!out_results)
         {
-            compilation->Compile();
+            std::unordered_map<ShaderCompilation*, bool> compiled;
+            for(size_t i = 0; i < toCompile.size(); i++)
+            {
+                compiled[toCompile[i]] = !!success[i];
+            }
+            out_results->resize(requests.size());
+            for(size_t i = 0; i < requests.size(); i++)
+            {
+                auto iter             = compiled.find(compilations[i]);
+                bool wasCompiled      = iter != compiled.end();
+                (*out_results)[i]     = ShaderCompileResult{.Key            = keys[i],
+                                                            .Success        = !wasCompiled || iter->second,
+                                                            .CompilerOutput = wasCompiled ? compilations[i]->CompilerOutput : std::string()};
+            }
         }
-        Assert(checkResult != ECompileCheckResult::MissingInput, "Missing Input file");
 
-        const osi::Utf8Path& spvPath = compilation->SpvPath;
-        shaderModule.LoadFromFile(context, spvPath);
-        return compileHash;
+        for(size_t i = 0; i < requests.size(); i++)
+        {
+            if(!!requests[i].Module)
+            {
+                compilations[i]->LoadModule(context, *requests[i].Module);
+            }
+        }
+        return keys;
+    }
+
+    void ShaderManager::CompileBatch(const std::vector<ShaderCompilation*>& compilations, std::vector<uint8_t>& out_success)
+    {
+        out_success.resize(compilations.size());
+        if(compilations.size() > 1 && !mCompilerPool.Exists())
+        {
+            mCompilerPool.Create();
+        }
+        mCompilerPool.ParallelFor(compilations.size(), [&](size_t i) { out_success[i] = compilations[i]->Compile() ? 1 : 0; });
+        for(ShaderCompilation* compilation : compilations)
+        {
+            RegisterResolvedIncludes(compilation);
+        }
     }
 
 #pragma endregion
@@ -131,7 +329,7 @@ constexpr std::string_view OPTIMIZE = " -O";
 
     // @brief calls the glslc.exe on windows and passes the shader file path
     // returns false if the compilation failed
-    bool ShaderManager::CallGlslCompiler(std::string_view args)
+    bool ShaderManager::CallGlslCompiler(std::string_view args, std::string& out_output)
     {
         // convert paths to wstring
         std::wstring argsW = lConvertToWide(args);
@@ -145,28 +343,82 @@ constexpr std::string_view OPTIMIZE = " -O";
         {
             return false;
         }
+
+        // pipe for capturing the compilers stdout and stderr
+        SECURITY_ATTRIBUTES sa;
+        ZeroMemory(&sa, sizeof(sa));
+        sa.nLength        = sizeof(sa);
+        sa.bInheritHandle = TRUE;
+        HANDLE readPipe   = NULL;
+        HANDLE writePipe  = NULL;
+        if(!CreatePipe(&readPipe, &writePipe, &sa, 0))
+        {
+            out_output = "Failed to create output pipe for glslc";
+            return false;
+        }
+        SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+
+        // Restrict inheritance to the write end of this calls pipe. With bInheritHandles = TRUE alone, a concurrently launched compiler
+        // would inherit the pipe handles of other calls, keeping their pipes open (ReadFile blocks until every copy of the write end is closed)
+        SIZE_T attributeListSize = 0;
+        InitializeProcThreadAttributeList(NULL, 1, 0, &attributeListSize);
+        std::vector<uint8_t>         attributeListBuffer(attributeListSize);
+        LPPROC_THREAD_ATTRIBUTE_LIST attributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributeListBuffer.data());
+        if(!InitializeProcThreadAttributeList(attributeList, 1, 0, &attributeListSize)
+           || !UpdateProcThreadAttribute(attributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, &writePipe, sizeof(HANDLE), NULL, NULL))
+        {
+            CloseHandle(writePipe);
+            CloseHandle(readPipe);
+            out_output = "Failed to restrict handle inheritance for glslc";
+            return false;
+        }
+
         // additional information
-        STARTUPINFOW        si;
+        STARTUPINFOEXW      si;
         PROCESS_INFORMATION pi;
 
         // set the size of the structures
         ZeroMemory(&si, sizeof(si));
-        si.cb = sizeof(si);
+        si.StartupInfo.cb         = sizeof(si);
+        si.StartupInfo.dwFlags    = STARTF_USESTDHANDLES;
+        si.StartupInfo.hStdOutput = writePipe;
+        si.StartupInfo.hStdError  = writePipe;
+        si.StartupInfo.hStdInput  = NULL;  // glslc does not read stdin, and all inherited handles must be in the handle list
+        si.lpAttributeList        = attributeList;
         ZeroMemory(&pi, sizeof(pi));
 
         std::wstring commandLine = std::wstring(lpApplicationName) + L" --target-spv=spv1.5" + argsW;
         // start the program up
-        CreateProcessW(lpApplicationName,            // the path
-                       (LPWSTR)commandLine.c_str(),  // Command line
-                       NULL,                         // Process handle not inheritable
-                       NULL,                         // Thread handle not inheritable
-                       FALSE,                        // Set handle inheritance to FALSE
-                       0,                            // No creation flags
-                       NULL,                         // Use parent's environment block
-                       NULL,                         // Use parent's starting directory
-                       &si,                          // Pointer to STARTUPINFO structure
-                       &pi                           // Pointer to PROCESS_INFORMATION structure (removed extra parentheses)
+        BOOL started = CreateProcessW(lpApplicationName,              // the path
+                                      (LPWSTR)commandLine.c_str(),    // Command line
+                                      NULL,                           // Process handle not inheritable
+                                      NULL,                           // Thread handle not inheritable
+                                      TRUE,                           // Inherit the handles in the handle list
+                                      EXTENDED_STARTUPINFO_PRESENT,   // si is a STARTUPINFOEXW
+                                      NULL,                           // Use parent's environment block
+                                      NULL,                           // Use parent's starting directory
+                                      &si.StartupInfo,                // Pointer to STARTUPINFO structure
+                                      &pi                             // Pointer to PROCESS_INFORMATION structure (removed extra parentheses)
         );
+        DeleteProcThreadAttributeList(attributeList);
+
+        // close our copy of the write end, so ReadFile returns once the compiler exits
+        CloseHandle(writePipe);
+        if(!started)
+        {
+            CloseHandle(readPipe);
+            out_output = "Failed to launch glslc.exe";
+            return false;
+        }
+
+        // read output until the compiler closes the pipe
+        std::array<char, 256> buffer;
+        DWORD                 read = 0;
+        while(ReadFile(readPipe, buffer.data(), (DWORD)buffer.size(), &read, NULL) && read > 0)
+        {
+            out_output.append(buffer.data(), read);
+        }
+        CloseHandle(readPipe);
 
         // wait for compilation to finish
         WaitForSingleObject(pi.hProcess, INFINITE);
@@ -184,29 +436,151 @@ constexpr std::string_view OPTIMIZE = " -O";
 #else
 
     // returns false if compilation fails
-    bool ShaderManager::CallGlslCompiler(std::string_view args)
+    bool ShaderManager::CallGlslCompiler(std::string_view args, std::string& out_output)
     {
-        std::string command     = fmt::format("/bin/glslc --target-env=vulkan1.3 --target-spv=spv1.5{}", args);
-        int         returnvalue = std::system(command.c_str());
+        std::string command = fmt::format("/bin/glslc --target-env=vulkan1.3 --target-spv=spv1.5{} 2>&1", args);
+        FILE*       pipe    = popen(command.c_str(), "r");
+        if(!pipe)
+        {
+            out_output = "Failed to launch glslc";
+            return false;
+        }
+        std::array<char, 256> buffer;
+        size_t                read = 0;
+        while((read = fread(buffer.data(), 1, buffer.size(), pipe)) > 0)
+        {
+            out_output.append(buffer.data(), read);
+        }
+        int returnvalue = pclose(pipe);
         return returnvalue == 0;
     }
 #endif
 
+    bool ShaderManager::CallGlslCompiler(std::string_view args)
+    {
+        std::string output;
+        bool        success = CallGlslCompiler(args, output);
+        if(output.size() > 0)
+        {
+            logger()->info("glslc output:\n{}", output);
+        }
+        return success;
+    }
+
 #pragma endregion
 #pragma region ShaderCompilation
 
     ShaderManager::ShaderCompilation::ShaderCompilation(ShaderManager* manager, const osi::Utf8Path& source, const ShaderCompilerConfig& options, uint64_t hash)
         : Manager(manager), SourcePath(source), Config(options), Hash(hash)
     {
-        SpvPath = fmt::format("{}.{:x}.spv", source, hash);
-        WriteTimeLookup lookup;
-        LastCompile = GetWriteTime(SpvPath, lookup);
+    }
+
+    /// @brief Checks the spirv header and instruction stream. A complete module ends with the OpFunctionEnd of its last function
+    bool lIsCompleteSpirv(const std::vector<uint32_t>& spirv)
+    {
+        const uint32_t spirvMagic       = 0x07230203;
+        const size_t   spirvHeaderWords = 5;
+        const uint32_t opFunctionEnd    = 56;
+        if(spirv.size() <= spirvHeaderWords || spirv[0] != spirvMagic)
+        {
+            return false;
+        }
+        uint32_t lastOpcode = 0;
+        for(size_t offset = spirvHeaderWords; offset < spirv.size();)
+        {
+            uint32_t wordCount = spirv[offset] >> 16;
+            if(wordCount == 0 || offset + wordCount > spirv.size())
+            {
+                return false;
+            }
+            lastOpcode = spirv[offset] & 0xFFFF;
+            offset += wordCount;
+        }
+        return lastOpcode == opFunctionEnd;
+    }
+
+    /// @brief Reads a spirv file. Fails for files which are not a complete spirv module (truncated or empty), so they are recompiled instead of loaded
+    bool lReadSpirvFile(const osi::Utf8Path& path, std::vector<uint32_t>& out_spirv)
+    {
+        const size_t spirvHeaderSize = 5 * sizeof(uint32_t);
+
+        std::ifstream file((fs::path)path, std::ios::binary | std::ios::in | std::ios::ate);
+        if(!file.is_open())
+        {
+            return false;
+        }
+        size_t fileSize = (size_t)file.tellg();
+        if(fileSize < spirvHeaderSize || fileSize % sizeof(uint32_t) != 0)
+        {
+            return false;
+        }
+        std::vector<uint32_t> spirv(fileSize / sizeof(uint32_t));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(spirv.data()), static_cast<std::streamsize>(fileSize));
+        if(!file || !lIsCompleteSpirv(spirv))
+        {
+            return false;
+        }
+        out_spirv = std::move(spirv);
+        return true;
+    }
+
+    /// @brief Temporary output path. Spirv is written there first and renamed once complete, so an interrupted write never leaves a truncated spirv file
+    osi::Utf8Path lMakeTempSpvPath(const osi::Utf8Path& spvPath, uint64_t compilationHash)
+    {
+        return fmt::format("{}.{:016x}.tmp", spvPath, compilationHash);
+    }
+
+    /// @brief Moves a completely written temporary spirv file to its final path
+    bool lCommitSpvFile(const osi::Utf8Path& tempPath, const osi::Utf8Path& spvPath)
+    {
+        std::error_code error;
+        fs::rename((fs::path)tempPath, (fs::path)spvPath, error);
+        if(!!error)
+        {
+            fs::remove((fs::path)tempPath, error);
+            return false;
+        }
+        return true;
     }
 
     bool ShaderManager::ShaderCompilation::Compile()
     {
         logger()->info("Beginning compilation of \033[1m{}\033[m (\033[\033[2m0x{:x}\033[m)", SourcePath, Hash);
-        std::string args;
+        CompilerOutput.clear();
+        ResolvedIncludes.clear();
+
+        bool success = false;
+#ifdef FORAY_SHADERC
+        if(Manager->mBackend == EShaderCompilerBackend::Shaderc && Config.AdditionalOptions.empty())
+        {
+            success = CompileShaderc();
+        }
+        else
+#endif
+        {
+            success = CompileGlslc();
+        }
+
+        if(CompilerOutput.size() > 0)
+        {
+            logger()->info("Compiler output for \033[1m{}\033[m (\033[\033[2m0x{:x}\033[m):\n{}", SourcePath, Hash, CompilerOutput);
+        }
+        if(success)
+        {
+            Manager->PruneStaleSpvFiles(SourcePath, Hash, SpvPath);
+            logger()->info("\033[32mSUCCESS\033[m compiling \033[1m{}\033[m (\033[\033[2m0x{:x}\033[m)", SourcePath, Hash);
+            return true;
+        }
+        logger()->info("\033[31mFAILURE\033[m compiling \033[1m{}\033[m (\033[\033[2m0x{:x}\033[m).", SourcePath, Hash);
+        FailedContentHash = ContentHash;
+        return false;
+    }
+
+    bool ShaderManager::ShaderCompilation::CompileGlslc()
+    {
+        const osi::Utf8Path tempPath = lMakeTempSpvPath(SpvPath, Hash);
+        std::string         args;
         {
             std::stringstream strbuilder;
             strbuilder << OPTIMIZE;
@@ -218,60 +592,288 @@ constexpr std::string_view OPTIMIZE = " -O";
             {
                 strbuilder << " -D" << definition;
             }
+            if(Config.EntryPoint.size() > 0)
+            {
+                strbuilder << " -fentry-point=" << Config.EntryPoint;
+            }
             for(const std::string& option : Config.AdditionalOptions)
             {
                 strbuilder << " " << option;
             }
-            strbuilder << " -o \"" << SpvPath << "\"";
+            strbuilder << " -o \"" << tempPath << "\"";
             strbuilder << " \"" << SourcePath << "\"";
 
             args = strbuilder.str();
         }
-        if(Manager->CallGlslCompiler(args))
+        std::error_code error;
+        if(!Manager->CallGlslCompiler(args, CompilerOutput))
         {
-            // Check output file
-            fs::path        path   = SpvPath;
-            fs::file_status status = fs::status(path);
-            bool            exists = status.type() == fs::file_type::regular;
-            if(exists)
+            fs::remove((fs::path)tempPath, error);
+            return false;
+        }
+        // Read back the output file
+        std::vector<uint32_t> spirv;
+        if(!lReadSpirvFile(tempPath, spirv))
+        {
+            fs::remove((fs::path)tempPath, error);
+            return false;
+        }
+        if(!lCommitSpvFile(tempPath, SpvPath))
+        {
+            logger()->warn("[ShaderManager] Unable to write spirv file \"{}\"", SpvPath);
+        }
+        Spirv = std::move(spirv);
+        return true;
+    }
+
+#ifdef FORAY_SHADERC
+
+    /// @brief Resolves #include directives for shaderc the same way glslc does: relative includes first next to the including file, then in the include dirs
+    class lShadercIncluder : public shaderc::CompileOptions::IncluderInterface
+    {
+      public:
+        lShadercIncluder(const std::vector<osi::Utf8Path>& includeDirs, std::vector<osi::Utf8Path>& resolved) : mIncludeDirs(includeDirs), mResolved(resolved) {}
+
+        virtual shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t includeDepth) override
+        {
+            std::vector<osi::Utf8Path> searchDirs;
+            if(type == shaderc_include_type::shaderc_include_type_relative)
             {
-                logger()->info("\033[32mSUCCESS\033[m compiling \033[1m{}\033[m (\033[\033[2m0x{:x}\033[m)", SourcePath, Hash);
-                LastCompile = fs::last_write_time(path);
-                return true;
+                searchDirs.push_back(osi::ToUtf8Path(osi::FromUtf8Path(requestingSource).remove_filename()));
             }
+            searchDirs.insert(searchDirs.end(), mIncludeDirs.cbegin(), mIncludeDirs.cend());
+
+            Include* include = new Include();
+            for(const osi::Utf8Path& dir : searchDirs)
+            {
+                osi::Utf8Path path;
+                try
+                {
+                    path = dir / osi::Utf8Path(std::string_view(requestedSource));
+                }
+                catch(const std::exception& e)
+                {
+                    continue;  // There might be includePaths which can yield illegal paths (navigating above root directory)
+                }
+                std::ifstream file((fs::path)path);
+                if(!file.is_open())
+                {
+                    continue;
+                }
+                std::stringstream buffer;
+                buffer << file.rdbuf();
+                include->Name    = (const std::string&)path;
+                include->Content = buffer.str();
+                mResolved.push_back(path);
+                break;
+            }
+            if(include->Name.empty())
+            {
+                // shaderc reports an empty source name as failure, with the content as error message
+                include->Content = fmt::format("Unable to resolve include \"{}\"", requestedSource);
+            }
+            include->Result = shaderc_include_result{.source_name        = include->Name.c_str(),
+                                                     .source_name_length = include->Name.size(),
+                                                     .content            = include->Content.c_str(),
+                                                     .content_length     = include->Content.size(),
+                                                     .user_data          = include};
+            return &include->Result;
         }
-        logger()->info("\033[31mFAILURE\033[m compiling \033[1m{}\033[m (\033[\033[2m0x{:x}\033[m).", SourcePath, Hash);
-        LastFailedCompile = fs::file_time_type::clock::now();
-        return false;
+
+        virtual void ReleaseInclude(shaderc_include_result* data) override { delete reinterpret_cast<Include*>(data->user_data); }
+
+      protected:
+        struct Include
+        {
+            std::string            Name;
+            std::string            Content;
+            shaderc_include_result Result;
+        };
+
+        const std::vector<osi::Utf8Path>& mIncludeDirs;
+        std::vector<osi::Utf8Path>&       mResolved;
+    };
+
+    shaderc_shader_kind lGetShaderKind(const osi::Utf8Path& path)
+    {
+        static const std::unordered_map<std::string, shaderc_shader_kind> kinds{
+            {".vert", shaderc_glsl_vertex_shader},         {".frag", shaderc_glsl_fragment_shader},       {".comp", shaderc_glsl_compute_shader},
+            {".geom", shaderc_glsl_geometry_shader},       {".tesc", shaderc_glsl_tess_control_shader},   {".tese", shaderc_glsl_tess_evaluation_shader},
+            {".rgen", shaderc_glsl_raygen_shader},         {".rint", shaderc_glsl_intersection_shader},   {".rahit", shaderc_glsl_anyhit_shader},
+            {".rchit", shaderc_glsl_closesthit_shader},    {".rmiss", shaderc_glsl_miss_shader},          {".rcall", shaderc_glsl_callable_shader},
+            {".mesh", shaderc_glsl_mesh_shader},           {".task", shaderc_glsl_task_shader},
+        };
+        std::string extension = osi::ToUtf8Path(((fs::path)path).extension());
+        auto        iter      = kinds.find(extension);
+        return iter != kinds.end() ? iter->second : shaderc_glsl_infer_from_source;
     }
 
-    ShaderManager::ECompileCheckResult ShaderManager::ShaderCompilation::NeedsCompile(WriteTimeLookup& writeTimeLookup)
+    bool ShaderManager::ShaderCompilation::CompileShaderc()
     {
-        // Update last compile
-        fs::file_time_type lastCompile = std::max({LastCompile, LastFailedCompile, GetWriteTime(SpvPath, writeTimeLookup)});
+        std::string source;
+        {
+            std::ifstream file((fs::path)SourcePath);
+            if(!file.is_open())
+            {
+                CompilerOutput = fmt::format("Unable to open source file \"{}\"", SourcePath);
+                return false;
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            source = buffer.str();
+        }
+
+        shaderc::CompileOptions options;
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+        options.SetTargetSpirv(shaderc_spirv_version_1_5);
+#ifdef FORAY_DEBUG
+        options.SetOptimizationLevel(shaderc_optimization_level_zero);
+#else
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+#endif
+        if(((fs::path)SourcePath).extension() == ".hlsl")
+        {
+            options.SetSourceLanguage(shaderc_source_language_hlsl);
+        }
+        for(const std::string& definition : Config.Definitions)
+        {
+            // glslc syntax: NAME or NAME=VALUE
+            size_t separator = definition.find('=');
+            if(separator == std::string::npos)
+            {
+                options.AddMacroDefinition(definition);
+            }
+            else
+            {
+                options.AddMacroDefinition(definition.substr(0, separator), definition.substr(separator + 1));
+            }
+        }
+        options.SetIncluder(std::make_unique<lShadercIncluder>(Config.IncludeDirs, ResolvedIncludes));
 
-        bool outOfDate = false;
+        shaderc::Compiler             compiler;
+        const char*                   entryPoint = Config.EntryPoint.size() > 0 ? Config.EntryPoint.c_str() : "main";
+        shaderc::SpvCompilationResult result =
+            compiler.CompileGlslToSpv(source, lGetShaderKind(SourcePath), ((const std::string&)SourcePath).c_str(), entryPoint, options);
 
-        {  // Check shader file
-            fs::file_time_type lastWriteTime = GetWriteTime(SourcePath, writeTimeLookup);
+        CompilerOutput = result.GetErrorMessage();
+        if(result.GetCompilationStatus() != shaderc_compilation_status_success)
+        {
+            return false;
+        }
+
+        std::vector<uint32_t> spirv(result.cbegin(), result.cend());
+
+        // Keep the spirv file up to date, it serves as the persistent cache across application runs
+        const osi::Utf8Path tempPath = lMakeTempSpvPath(SpvPath, Hash);
+        bool                written  = false;
+        {
+            std::ofstream file((fs::path)tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+            written = !!file;
+        }
+        if(!written || !lCommitSpvFile(tempPath, SpvPath))
+        {
+            std::error_code error;
+            fs::remove((fs::path)tempPath, error);
+            CompilerOutput += fmt::format("Unable to write spirv file \"{}\"", SpvPath);
+            return false;
+        }
+        Spirv = std::move(spirv);
+        return true;
+    }
+
+#endif
+
+    void ShaderManager::ShaderCompilation::LoadModule(core::Context* context, ShaderModule& shaderModule)
+    {
+        if(Spirv.empty())
+        {
+            FORAY_ASSERTFMT(lReadSpirvFile(SpvPath, Spirv), "Could not open spirv file: \"{}\"", (const std::string&)SpvPath);
+        }
+        shaderModule.LoadFromBinary(context, Spirv);
+    }
+
+    ShaderManager::ECompileCheckResult ShaderManager::ShaderCompilation::NeedsCompile(WriteTimeLookup& writeTimeLookup)
+    {
+        // Make sure all inputs still exist. Unless any of them has been written to since the last check, the content hash is still valid
+        fs::file_time_type newestWrite = GetWriteTime(SourcePath, writeTimeLookup);
+        if(newestWrite == fs::file_time_type::min())
+        {
+            return ECompileCheckResult::MissingInput;
+        }
+        for(IncludeFile* include : Includes)
+        {
+            fs::file_time_type lastWriteTime = GetWriteTime(include->Path, writeTimeLookup);
             if(lastWriteTime == fs::file_time_type::min())
             {
                 return ECompileCheckResult::MissingInput;
             }
-            outOfDate = outOfDate || lastWriteTime > lastCompile;
+            newestWrite = std::max(newestWrite, lastWriteTime);
+        }
+        if(ContentHash != 0 && newestWrite <= LastChecked)
+        {
+            return ECompileCheckResult::UpToDate;
         }
 
-        // Check all includes to make sure they still exist and haven't been updated
+        // Content hash: compiler configuration, source and includes. Deliberately excludes absolute paths, so caches can be shared across machines
+        size_t hash = {};
+        {
+            std::set<std::string_view> definitions(Config.Definitions.cbegin(), Config.Definitions.cend());
+            std::set<std::string_view> additionalOptions(Config.AdditionalOptions.cbegin(), Config.AdditionalOptions.cend());
+            util::AccumulateHash(hash, OPTIMIZE);
+            util::AccumulateHash(hash, osi::ToUtf8Path(((fs::path)SourcePath).extension()));
+            for(std::string_view def : definitions)
+            {
+                util::AccumulateHash(hash, def);
+            }
+            util::AccumulateHash(hash, Config.EntryPoint);
+            for(std::string_view option : additionalOptions)
+            {
+                util::AccumulateHash(hash, option);
+            }
+        }
+        uint64_t sourceHash = 0;
+        if(!Manager->GetFileContentHash(SourcePath, writeTimeLookup, sourceHash))
+        {
+            return ECompileCheckResult::MissingInput;
+        }
+        util::AccumulateHash(hash, sourceHash);
+        std::vector<uint64_t> includeHashes;
+        includeHashes.reserve(Includes.size());
         for(IncludeFile* include : Includes)
         {
-            fs::file_time_type lastWriteTime = GetWriteTime(include->Path, writeTimeLookup);
-            if(lastWriteTime == fs::file_time_type::min())
+            uint64_t includeHash = 0;
+            if(!Manager->GetFileContentHash(include->Path, writeTimeLookup, includeHash))
             {
                 return ECompileCheckResult::MissingInput;
             }
-            outOfDate = outOfDate || lastWriteTime > lastCompile;
+            includeHashes.push_back(includeHash);
         }
-        return outOfDate ? ECompileCheckResult::NeedsRecompile : ECompileCheckResult::UpToDate;
+        // Includes are stored in a set, sort for a consistent order
+        std::sort(includeHashes.begin(), includeHashes.end());
+        for(uint64_t includeHash : includeHashes)
+        {
+            util::AccumulateHash(hash, includeHash);
+        }
+
+        LastChecked = newestWrite;
+        if(hash == ContentHash || hash == FailedContentHash)
+        {
+            return ECompileCheckResult::UpToDate;
+        }
+
+        ContentHash = hash;
+        SpvPath     = Manager->MakeSpvPath(SourcePath, Hash, ContentHash);
+
+        std::vector<uint32_t> spirv;
+        if(lReadSpirvFile(SpvPath, spirv))
+        {
+            Spirv = std::move(spirv);
+            Manager->PruneStaleSpvFiles(SourcePath, Hash, SpvPath);
+            return ECompileCheckResult::CacheHit;
+        }
+        // Stale files are pruned by Compile() on success. If the new content fails to compile, the previous spirv files are kept
+        return ECompileCheckResult::NeedsRecompile;
     }
 
 #pragma endregion
@@ -358,6 +960,23 @@ constexpr std::string_view OPTIMIZE = " -O";
         return include;
     }
 
+    void ShaderManager::RegisterResolvedIncludes(ShaderCompilation* compilation)
+    {
+        for(const osi::Utf8Path& path : compilation->ResolvedIncludes)
+        {
+            IncludeFile* include = RecursivelyProcessInclude(path, compilation->Config.IncludeDirs);
+            if(compilation->Includes.emplace(include).second)
+            {
+                include->GetIncludesRecursively(compilation->Includes);
+            }
+        }
+        for(IncludeFile* include : compilation->Includes)
+        {
+            include->Includers.emplace(compilation);
+        }
+        compilation->ResolvedIncludes.clear();
+    }
+
     void ShaderManager::ShaderCompilation::FindIncludes()
     {
         // Find include directives
@@ -407,22 +1026,47 @@ constexpr std::string_view OPTIMIZE = " -O";
 #pragma endregion
 #pragma region Check and Update
 
-    bool ShaderManager::CheckAndUpdateShaders(std::unordered_set<uint64_t>& out_recompiled)
+    bool ShaderManager::CheckAndUpdateShaders(std::unordered_set<uint64_t>& out_recompiled, std::vector<ShaderCompileResult>* out_results)
     {
-        bool result = false;
-
-        WriteTimeLookup lookup;
+        WriteTimeLookup                 lookup;
+        std::vector<ShaderCompilation*> toCompile;
+        std::vector<ShaderCompilation*> cacheHits;
         for(auto& entry : mTrackedCompilations)
         {
             ShaderCompilation*  compilation = entry.second.get();
             ECompileCheckResult check       = compilation->NeedsCompile(lookup);
             if(check == ECompileCheckResult::NeedsRecompile)
             {
-                if(compilation->Compile())
-                {
-                    out_recompiled.emplace(compilation->Hash);
-                    result = true;
-                }
+                toCompile.push_back(compilation);
+            }
+            else if(check == ECompileCheckResult::CacheHit)
+            {
+                cacheHits.push_back(compilation);
+            }
+        }
+
+        std::vector<uint8_t> success;
+        CompileBatch(toCompile, success);
+
+        bool result = cacheHits.size() > 0;
+        for(ShaderCompilation* compilation : cacheHits)
+        {
+            out_recompiled.emplace(compilation->Hash);
+            if(!!out_results)
+            {
+                out_results->push_back(ShaderCompileResult{.Key = compilation->Hash, .Success = true});
+            }
+        }
+        for(size_t i = 0; i < toCompile.size(); i++)
+        {
+            if(!!success[i])
+            {
+                out_recompiled.emplace(toCompile[i]->Hash);
+                result = true;
+            }
+            if(!!out_results)
+            {
+                out_results->push_back(ShaderCompileResult{.Key = toCompile[i]->Hash, .Success = !!success[i], .CompilerOutput = toCompile[i]->CompilerOutput});
             }
         }
 
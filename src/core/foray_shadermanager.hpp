@@ -1,5 +1,6 @@
 #pragma once
 #include "../osi/foray_env.hpp"
+#include "../util/foray_workerpool.hpp"
 #include "foray_core_declares.hpp"
 #include <set>
 #include <unordered_map>
@@ -21,6 +22,37 @@ namespace foray::core {
         std::vector<std::string> AdditionalOptions = {};
     };
 
+    /// @brief Backend used by the ShaderManager to translate shader sources to spirv
+    enum class EShaderCompilerBackend
+    {
+        /// @brief Invokes the glslc executable and reads back the spirv file it writes
+        Glslc,
+        /// @brief Compiles in process via libshaderc. Only available if built with FORAY_SHADERC, otherwise glslc is used
+        Shaderc
+    };
+
+    /// @brief A single shader compilation as requested from ShaderManager::CompileShaders()
+    struct ShaderCompileRequest
+    {
+        /// @brief Path to the shader source file
+        osi::Utf8Path SourceFilePath = {};
+        /// @brief Output shadermodule to initialize. May be nullptr to only compile
+        ShaderModule* Module = nullptr;
+        /// @brief Configure compilation parameters
+        ShaderCompilerConfig Config = {};
+    };
+
+    /// @brief Outcome of a single shader compilation
+    struct ShaderCompileResult
+    {
+        /// @brief Shader compilation key
+        uint64_t Key = 0;
+        /// @brief True, if the compiler was invoked and succeeded, or the existing spirv file was up to date
+        bool Success = false;
+        /// @brief Output (warnings and errors) of the shader compiler. Empty if the compiler was not invoked
+        std::string CompilerOutput = {};
+    };
+
 
     /// @brief Shader manager maintains a structure of shader compilations
     /// @details
@@ -28,6 +60,12 @@ namespace foray::core {
     ///  - The shader compilation action is saved and tracked via a key
     ///  - Any changes to the shader source file or files included via #include directives in the shader (recursively resolved) cause attempt of recompiling the shader.
     ///  - CheckAndUpdate function checks files as described and returns set of successfully recompiled shader compilation keys.
+    ///  - Compiled spirv is keyed by a content hash of the source and all includes (comments and blank lines ignored) plus the compiler config.
+    ///    Spirv files are stored in the cache directory, so unchanged sources load without compiling across runs (and machines sharing the cache directory).
+    ///    Spirv files are written to a temporary file first and renamed when complete. Cached files which are not a complete spirv module are recompiled.
+    ///  - File write times only serve as a cheap filter for rehashing, touching a file does not cause recompilation.
+    ///  - The spirv of every compilation is kept in memory, so repeated requests for the same key do not touch the filesystem.
+    /// Compilations with ShaderCompilerConfig::AdditionalOptions always use glslc, as those options are glslc command line arguments.
     class ShaderManager
     {
       public:
@@ -48,20 +86,39 @@ namespace foray::core {
         /// @param context Context for initialization of ShaderModule. If set to nullptr, will use ShaderManager context
         /// @return Returns the key to this unique shader compilation
         uint64_t CompileShader(osi::Utf8Path sourceFilePath, ShaderModule* shaderModule, const ShaderCompilerConfig& config = {}, core::Context* context = nullptr);
+        /// @brief Compiles a batch of shaders concurrently (bounded by hardware concurrency), then loads the shader modules
+        /// @param requests Shader compilations to process
+        /// @param context Context for initialization of ShaderModules. If set to nullptr, will use ShaderManager context
+        /// @param out_results If set, receives one result per request (in request order)
+        /// @return Returns the keys of the shader compilations (in request order)
+        std::vector<uint64_t> CompileShaders(const std::vector<ShaderCompileRequest>& requests, core::Context* context = nullptr, std::vector<ShaderCompileResult>* out_results = nullptr);
 
         /// @brief Checks and updates shader compilations for source code changes
-        /// @details Will check all tracked shader files for modifications and recompile the shader compilations accordingly
+        /// @details Will check all tracked shader files for modifications and recompile the shader compilations concurrently
         /// @param out_recompiled Output set for shader compilation keys which have been recompiled
+        /// @param out_results If set, receives a result for every compilation which was attempted
         /// @return Returns true if any shader was updated
-        virtual bool CheckAndUpdateShaders(std::unordered_set<uint64_t>& out_recompiled);
+        virtual bool CheckAndUpdateShaders(std::unordered_set<uint64_t>& out_recompiled, std::vector<ShaderCompileResult>* out_results = nullptr);
 
         ShaderManager() = default;
 
         /// @brief Calls glslc in path on linux, glslc.exe (derived from VULKAN_SDK environment variable) on windows
         /// @param args Arguments are passed as follows: GLSLC_EXECUTABLE --target-spv=spv1.5 OPTIMIZE ARGS
         /// (OPTIMIZE = -O0 for DEBUG, -O for RELEASE CMake targets)
+        /// @param out_output Receives the compilers console output (stdout and stderr)
         /// @return True if glslc compiler exe returns 0 (indicating success), false otherwise
-        virtual bool CallGlslCompiler(std::string_view args);
+        /// @remark Called concurrently from multiple threads when compiling batches
+        virtual bool CallGlslCompiler(std::string_view args, std::string& out_output);
+        /// @brief Calls CallGlslCompiler(args, out_output) and logs the compilers console output
+        /// @remark Kept for existing callers. Not virtual: Overrides must implement CallGlslCompiler(args, out_output), which compilation invokes
+        bool CallGlslCompiler(std::string_view args);
+
+        /// @brief Select the compiler backend. Defaults to Shaderc if built with FORAY_SHADERC, Glslc otherwise
+        FORAY_PROPERTY_V(Backend)
+        /// @brief Directory compiled spirv files are stored in. If empty, spirv files are stored next to their source file
+        /// ("{source}.{compilation}.{content}.spv"), and files of outdated content states are deleted.
+        /// @remark Set before compiling any shaders
+        FORAY_PROPERTY_R(CacheDirectory)
 
       protected:
         /// @brief maps files to last write times
@@ -70,6 +127,13 @@ namespace foray::core {
         /// @brief Context used for initialization of shader modules
         core::Context* mContext = nullptr;
 
+#ifdef FORAY_SHADERC
+        EShaderCompilerBackend mBackend = EShaderCompilerBackend::Shaderc;
+#else
+        EShaderCompilerBackend mBackend = EShaderCompilerBackend::Glslc;
+#endif
+        osi::Utf8Path mCacheDirectory;
+
         /// @brief Calculates a unique hash based on source file path and config
         virtual uint64_t MakeHash(std::string_view absoluteUniqueSourceFilePath, const ShaderCompilerConfig& config);
 
@@ -79,13 +143,32 @@ namespace foray::core {
         /// @return Lookup table result / std::filesystem::file_time_type::min() if not found, last write time otherwise
         static std::filesystem::file_time_type GetWriteTime(const osi::Utf8Path& path, WriteTimeLookup& writeTimeLookup);
 
+        /// @brief Content hash of a file, together with the write time it was calculated at
+        struct FileContentHash
+        {
+            std::filesystem::file_time_type WriteTime = std::filesystem::file_time_type::min();
+            uint64_t                        Hash      = 0;
+        };
+        /// @brief Maps files to their content hash. Files are only rehashed if their write time changed
+        std::unordered_map<osi::Utf8Path, FileContentHash> mFileHashes;
+
+        /// @brief Get the content hash of a file, ignoring comments, trailing whitespace and blank lines
+        /// @return False, if the file could not be read
+        bool GetFileContentHash(const osi::Utf8Path& path, WriteTimeLookup& writeTimeLookup, uint64_t& out_hash);
+        /// @brief Spirv file path for a compilation with given content hash
+        virtual osi::Utf8Path MakeSpvPath(const osi::Utf8Path& sourcePath, uint64_t compilationHash, uint64_t contentHash) const;
+        /// @brief Without cache directory, deletes spirv files next to the source written by the compilation for previous content states (except keep)
+        virtual void PruneStaleSpvFiles(const osi::Utf8Path& sourcePath, uint64_t compilationHash, const osi::Utf8Path& keep) const;
+
         struct IncludeFile;
 
         enum class ECompileCheckResult
         {
             UpToDate,
             MissingInput,
-            NeedsRecompile
+            NeedsRecompile,
+            /// @brief Sources changed, but spirv matching the new content hash was found in the cache and loaded
+            CacheHit
         };
 
         /// @brief Represents a unique shader compilation (input source path + config => Spirv file)
@@ -95,29 +178,45 @@ namespace foray::core {
             ShaderManager* Manager = nullptr;
             /// @brief Source path
             osi::Utf8Path SourcePath = {};
-            /// @brief Output path
+            /// @brief Output path. Depends on ContentHash
             osi::Utf8Path SpvPath = {};
-            /// @brief Last successful compile time
-            std::filesystem::file_time_type LastCompile = std::filesystem::file_time_type::min();
-            /// @brief Time of last failed compile
-            std::filesystem::file_time_type LastFailedCompile = std::filesystem::file_time_type::min();
+            /// @brief Hash of source and include file contents plus config, as of the last check
+            uint64_t ContentHash = 0;
+            /// @brief ContentHash of the last failed compile. Not retried until sources change again
+            uint64_t FailedContentHash = 0;
+            /// @brief Newest write time of the source and include files when ContentHash was calculated
+            std::filesystem::file_time_type LastChecked = std::filesystem::file_time_type::min();
             /// @brief List of includes
             std::unordered_set<IncludeFile*> Includes = {};
             /// @brief Configuration of the shader compiler
             ShaderCompilerConfig Config = {};
             /// @brief Hash identifying the compilation
             uint64_t Hash = 0;
-            /// @brief Sets SpvPath and updates LastCompile
             /// @param source Absolute source file path
             /// @param config Compiler configuration
             /// @param hash compilation hash
             ShaderCompilation(ShaderManager* manager, const osi::Utf8Path& source, const ShaderCompilerConfig& config, uint64_t hash);
             /// @brief Finds all includes and configures them in the watch of the shader manager
             void FindIncludes();
+            /// @brief Output of the last compiler invocation
+            std::string CompilerOutput = {};
+            /// @brief In-memory copy of the spirv file. Empty until first compiled or loaded
+            std::vector<uint32_t> Spirv = {};
+            /// @brief Include files reported by the in process compiler during the last compilation. Registered by the manager after compilation
+            std::vector<osi::Utf8Path> ResolvedIncludes = {};
             /// @brief Invokes the shader compiler
             /// @return True, if compilation was successful
+            /// @remark Only touches this compilation, so distinct compilations may be compiled concurrently
             bool Compile();
-            /// @brief Checks for need to recompile
+            /// @brief Compiles via glslc executable
+            bool CompileGlslc();
+#ifdef FORAY_SHADERC
+            /// @brief Compiles in process via libshaderc, writes the spirv file
+            bool CompileShaderc();
+#endif
+            /// @brief Initializes shaderModule from Spirv, reading the spirv file first if necessary
+            void LoadModule(core::Context* context, ShaderModule& shaderModule);
+            /// @brief Checks for need to recompile by comparing content hashes. Loads spirv from the cache directory if available
             /// @param compileTimeLookup Lookup for writetimes of already checked files
             ECompileCheckResult NeedsCompile(WriteTimeLookup& compileTimeLookup);
         };
@@ -143,6 +242,17 @@ namespace foray::core {
         /// @brief Map of include file paths to include file structs
         std::unordered_map<osi::Utf8Path, std::unique_ptr<IncludeFile>> mTrackedIncludeFiles;
 
+        /// @brief Pool running batch compilations. Created on first use
+        util::WorkerPool mCompilerPool;
+
+        /// @brief Compiles all compilations concurrently
+        /// @param compilations Compilations to compile. Must be distinct
+        /// @param out_success Receives compilation success per compilation
+        void CompileBatch(const std::vector<ShaderCompilation*>& compilations, std::vector<uint8_t>& out_success);
+
+        /// @brief Registers ResolvedIncludes of a compilation with the include file tracking
+        void RegisterResolvedIncludes(ShaderCompilation* compilation);
+
         /// @brief Discover and register all includes for a shader compilation
         void DiscoverIncludes(ShaderCompilation* compilation);
         /// @brief Create or return an include file. Recursively processes #include directives to resolve nested includes
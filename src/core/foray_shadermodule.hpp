@@ -76,7 +76,7 @@ namespace foray::core {
 
     void ShaderModule::LoadFromBinary(Context* context, const std::vector<uint32_t>& binaryBuffer)
     {
-        return LoadFromBinary(context, binaryBuffer.data(), binaryBuffer.size());
+        return LoadFromBinary(context, binaryBuffer.data(), binaryBuffer.size() * sizeof(uint32_t));
     }
 
     template <size_t ARR_SIZE>
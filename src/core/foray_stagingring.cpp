@@ -0,0 +1,384 @@
+#include "foray_stagingring.hpp"
+#include "../foray_exception.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace foray::core {
+
+    void StagingRing::Create(Context* context, VkDeviceSize capacity, std::string_view name)
+    {
+        Assert(!Exists(), "StagingRing::Create called on existing ring");
+        Assert(capacity > 0, "StagingRing::Create requires non-zero capacity");
+        mContext  = context;
+        mCapacity = capacity;
+
+        ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, capacity, VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+                                     VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT, name);
+        mBuffer.Create(mContext, ci);
+        mMapped = reinterpret_cast<uint8_t*>(mBuffer.GetAllocationInfo().pMappedData);
+        Assert(!!mMapped, "StagingRing: Failed to persistently map ring buffer");
+
+        VkSemaphoreTypeCreateInfo timelineSemaphoreCi{
+            .sType         = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VkSemaphoreType::VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue  = 0,
+        };
+        VkSemaphoreCreateInfo semaphoreCi{.sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &timelineSemaphoreCi};
+        AssertVkResult(mContext->VkbDispatchTable->createSemaphore(&semaphoreCi, nullptr, &mSemaphore));
+
+        mUseTransferQueue = mContext->HasDedicatedTransferQueue();
+        mTransferContext  = mContext->GetTransferContext();
+        if(mUseTransferQueue)
+        {
+            AssertVkResult(mContext->VkbDispatchTable->createSemaphore(&semaphoreCi, nullptr, &mTransferSemaphore));
+        }
+
+        mSubmittedValue = 0;
+        mHead           = 0;
+        mTail           = 0;
+        mInUse          = 0;
+        mPendingBytes   = 0;
+    }
+
+    UploadTicket StagingRing::Upload(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
+    {
+        Assert(Exists(), "StagingRing::Upload called on uninitialized ring");
+        if(size == 0)
+        {
+            return UploadTicket{};
+        }
+
+        if(size > mCapacity)
+        {
+            // Does not fit the ring at all. Submit what is queued (maintaining order on the queue), then upload blocking via a temporary staging buffer
+            Flush();
+            ManagedBuffer stagingBuffer;
+            stagingBuffer.CreateForStaging(mContext, size, data, "Staging Ring Overflow");
+
+            HostSyncCommandBuffer cmdBuffer;
+            cmdBuffer.Create(mContext);
+            cmdBuffer.Begin();
+            VkBufferCopy copy{.srcOffset = 0, .dstOffset = dstOffset, .size = size};
+            vkCmdCopyBuffer(cmdBuffer, stagingBuffer.GetBuffer(), dstBuffer, 1, &copy);
+            cmdBuffer.SubmitAndWait();
+            return UploadTicket{};
+        }
+
+        RetireCompleted();
+
+        VkDeviceSize offset = 0;
+        while(!TryAllocate(size, offset))
+        {
+            // Out of space: Submit the current batch if that is what holds the memory, then wait for the oldest batch to free its region
+            if(mInFlight.empty())
+            {
+                Flush();
+            }
+            RetireOldest();
+        }
+
+        memcpy(mMapped + offset, data, size);
+        AssertVkResult(vmaFlushAllocation(mContext->Allocator, mBuffer.GetAllocation(), offset, size));
+
+        // Consecutive copies into the same buffer are merged into one vkCmdCopyBuffer call on Flush()
+        mPendingCopies.push_back(Copy{.DstBuffer = dstBuffer, .Region = VkBufferCopy{.srcOffset = offset, .dstOffset = dstOffset, .size = size}});
+        return UploadTicket{.TimelineValue = mSubmittedValue + 1};
+    }
+
+    bool StagingRing::TryAllocate(VkDeviceSize size, VkDeviceSize& offset)
+    {
+        if(mInUse == 0)
+        {
+            // Nothing is queued or executing, restart at the beginning
+            mHead = 0;
+            mTail = 0;
+        }
+
+        VkDeviceSize aligned = ((mHead + (mAlignment - 1)) / mAlignment) * mAlignment;
+        VkDeviceSize used    = 0;
+
+        if(mHead > mTail || mInUse == 0)
+        {
+            // Free regions are [mHead, mCapacity) and [0, mTail)
+            if(aligned + size <= mCapacity)
+            {
+                offset = aligned;
+                used   = aligned + size - mHead;
+            }
+            else if(size <= mTail)
+            {
+                // Wrap around, the remainder of the ring becomes padding
+                offset = 0;
+                used   = mCapacity - mHead + size;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if(mHead < mTail)
+        {
+            // Free region is [mHead, mTail)
+            if(aligned + size > mTail)
+            {
+                return false;
+            }
+            offset = aligned;
+            used   = aligned + size - mHead;
+        }
+        else
+        {
+            // mHead == mTail with memory in use: Ring is full
+            return false;
+        }
+
+        mHead = offset + size;
+        mInUse += used;
+        mPendingBytes += used;
+        return true;
+    }
+
+    std::unique_ptr<DeviceSyncCommandBuffer> StagingRing::GetCmdBuffer(std::vector<std::unique_ptr<DeviceSyncCommandBuffer>>& freeList, Context* context)
+    {
+        if(!freeList.empty())
+        {
+            std::unique_ptr<DeviceSyncCommandBuffer> cmdBuffer = std::move(freeList.back());
+            freeList.pop_back();
+            return cmdBuffer;
+        }
+        std::unique_ptr<DeviceSyncCommandBuffer> cmdBuffer = std::make_unique<DeviceSyncCommandBuffer>();
+        cmdBuffer->Create(context);
+        cmdBuffer->SetName("Staging Ring CmdBuffer");
+        return cmdBuffer;
+    }
+
+    bool StagingRing::OverlapsAny(const std::vector<VkBufferCopy>& regions, const VkBufferCopy& region)
+    {
+        for(const VkBufferCopy& other : regions)
+        {
+            if(region.dstOffset < other.dstOffset + other.size && other.dstOffset < region.dstOffset + region.size)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    UploadTicket StagingRing::Flush()
+    {
+        if(mPendingCopies.empty())
+        {
+            return UploadTicket{.TimelineValue = mSubmittedValue};
+        }
+
+        uint64_t timelineValue = mSubmittedValue + 1;
+
+        std::unique_ptr<DeviceSyncCommandBuffer> cmdBuffer = GetCmdBuffer(mFreeCmdBuffers, &mTransferContext);
+        cmdBuffer->Begin();
+
+        // Consecutive copies into the same buffer are merged into one vkCmdCopyBuffer call, and one ownership barrier covering all written ranges.
+        // Regions of a single copy command must not overlap, so a write overlapping an earlier one starts a new command, ordered after the previous by a barrier.
+        std::vector<VkBufferCopy>                               regions;
+        std::vector<VkBufferMemoryBarrier>                      ownershipBarriers;
+        std::unordered_map<VkBuffer, std::vector<VkBufferCopy>> writtenRegions;
+        for(size_t begin = 0; begin < mPendingCopies.size();)
+        {
+            VkBuffer     dstBuffer = mPendingCopies[begin].DstBuffer;
+            VkDeviceSize rangeMin  = mPendingCopies[begin].Region.dstOffset;
+            VkDeviceSize rangeMax  = rangeMin;
+            regions.clear();
+            size_t end = begin;
+            for(; end < mPendingCopies.size() && mPendingCopies[end].DstBuffer == dstBuffer; end++)
+            {
+                const VkBufferCopy& region = mPendingCopies[end].Region;
+                if(regions.size() > 0 && region.dstOffset < rangeMax && region.dstOffset + region.size > rangeMin && OverlapsAny(regions, region))
+                {
+                    break;
+                }
+                regions.push_back(region);
+                rangeMin = std::min(rangeMin, region.dstOffset);
+                rangeMax = std::max(rangeMax, region.dstOffset + region.size);
+            }
+            std::vector<VkBufferCopy>& previousRegions  = writtenRegions[dstBuffer];
+            bool                       overlapsPrevious = false;
+            for(const VkBufferCopy& region : regions)
+            {
+                overlapsPrevious |= OverlapsAny(previousRegions, region);
+            }
+            previousRegions.insert(previousRegions.end(), regions.begin(), regions.end());
+            if(overlapsPrevious)
+            {
+                // Order the writes of previous copy commands before this one's
+                VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                vkCmdPipelineBarrier(*cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+            }
+            vkCmdCopyBuffer(*cmdBuffer, mBuffer.GetBuffer(), dstBuffer, static_cast<uint32_t>(regions.size()), regions.data());
+            if(mUseTransferQueue)
+            {
+                ownershipBarriers.push_back(VkBufferMemoryBarrier{.sType               = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                                                                  .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                                  .dstAccessMask       = 0,
+                                                                  .srcQueueFamilyIndex = mContext->TransferQueueFamilyIndex,
+                                                                  .dstQueueFamilyIndex = mContext->QueueFamilyIndex,
+                                                                  .buffer              = dstBuffer,
+                                                                  .offset              = rangeMin,
+                                                                  .size                = rangeMax - rangeMin});
+            }
+            begin = end;
+        }
+
+        std::unique_ptr<DeviceSyncCommandBuffer> acquireCmdBuffer;
+        if(mUseTransferQueue)
+        {
+            // Release on the transfer queue ...
+            vkCmdPipelineBarrier(*cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                                 static_cast<uint32_t>(ownershipBarriers.size()), ownershipBarriers.data(), 0, nullptr);
+            cmdBuffer->GetSignalSemaphores().clear();
+            cmdBuffer->AddSignalSemaphore(SemaphoreReference::Timeline(mTransferSemaphore, timelineValue));
+            cmdBuffer->Submit();
+
+            // ... acquire on the main queue, which makes the writes visible to all later commands submitted to it
+            for(VkBufferMemoryBarrier& barrier : ownershipBarriers)
+            {
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            }
+            acquireCmdBuffer = GetCmdBuffer(mFreeAcquireCmdBuffers, mContext);
+            acquireCmdBuffer->Begin();
+            vkCmdPipelineBarrier(*acquireCmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+                                 static_cast<uint32_t>(ownershipBarriers.size()), ownershipBarriers.data(), 0, nullptr);
+            acquireCmdBuffer->GetWaitSemaphores().clear();
+            acquireCmdBuffer->GetSignalSemaphores().clear();
+            acquireCmdBuffer->AddWaitSemaphore(SemaphoreReference::Timeline(mTransferSemaphore, timelineValue));
+            acquireCmdBuffer->AddSignalSemaphore(SemaphoreReference::Timeline(mSemaphore, timelineValue));
+            acquireCmdBuffer->Submit();
+        }
+        else
+        {
+            // Make the writes visible to all later commands submitted to this queue
+            VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            vkCmdPipelineBarrier(*cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+            cmdBuffer->GetSignalSemaphores().clear();
+            cmdBuffer->AddSignalSemaphore(SemaphoreReference::Timeline(mSemaphore, timelineValue));
+            cmdBuffer->Submit();
+        }
+        mSubmittedValue = timelineValue;
+
+        mInFlight.push_back(Batch{.CmdBuffer        = std::move(cmdBuffer),
+                                  .AcquireCmdBuffer = std::move(acquireCmdBuffer),
+                                  .TimelineValue    = timelineValue,
+                                  .RingEnd          = mHead,
+                                  .UsedBytes        = mPendingBytes});
+        mPendingCopies.clear();
+        mPendingBytes = 0;
+
+        return UploadTicket{.TimelineValue = timelineValue};
+    }
+
+    bool StagingRing::HasCompleted(UploadTicket ticket)
+    {
+        if(ticket.TimelineValue > mSubmittedValue)
+        {
+            // Part of the batch currently being recorded
+            return false;
+        }
+        uint64_t value = 0;
+        AssertVkResult(mContext->VkbDispatchTable->getSemaphoreCounterValue(mSemaphore, &value));
+        return value >= ticket.TimelineValue;
+    }
+
+    void StagingRing::Wait(UploadTicket ticket)
+    {
+        if(ticket.TimelineValue == 0)
+        {
+            return;
+        }
+        if(ticket.TimelineValue > mSubmittedValue)
+        {
+            Flush();
+        }
+        VkSemaphoreWaitInfo waitInfo{
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO, .semaphoreCount = 1, .pSemaphores = &mSemaphore, .pValues = &ticket.TimelineValue};
+        AssertVkResult(mContext->VkbDispatchTable->waitSemaphores(&waitInfo, UINT64_MAX));
+        RetireCompleted();
+    }
+
+    void StagingRing::WaitIdle()
+    {
+        if(!Exists())
+        {
+            return;
+        }
+        Wait(Flush());
+    }
+
+    void StagingRing::RetireCompleted()
+    {
+        if(mInFlight.empty())
+        {
+            return;
+        }
+        uint64_t value = 0;
+        AssertVkResult(mContext->VkbDispatchTable->getSemaphoreCounterValue(mSemaphore, &value));
+        while(!mInFlight.empty() && mInFlight.front().TimelineValue <= value)
+        {
+            RetireBatch(mInFlight.front());
+            mInFlight.pop_front();
+        }
+    }
+
+    void StagingRing::RetireOldest()
+    {
+        Assert(!mInFlight.empty(), "StagingRing: No batch in flight to retire");
+        Batch&              batch = mInFlight.front();
+        VkSemaphoreWaitInfo waitInfo{
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO, .semaphoreCount = 1, .pSemaphores = &mSemaphore, .pValues = &batch.TimelineValue};
+        AssertVkResult(mContext->VkbDispatchTable->waitSemaphores(&waitInfo, UINT64_MAX));
+        RetireBatch(batch);
+        mInFlight.pop_front();
+    }
+
+    void StagingRing::RetireBatch(Batch& batch)
+    {
+        mTail = batch.RingEnd;
+        mInUse -= batch.UsedBytes;
+        mFreeCmdBuffers.push_back(std::move(batch.CmdBuffer));
+        if(!!batch.AcquireCmdBuffer)
+        {
+            mFreeAcquireCmdBuffers.push_back(std::move(batch.AcquireCmdBuffer));
+        }
+    }
+
+    void StagingRing::Destroy()
+    {
+        if(!Exists())
+        {
+            return;
+        }
+        WaitIdle();
+        mInFlight.clear();
+        mFreeCmdBuffers.clear();
+        mFreeAcquireCmdBuffers.clear();
+        mPendingCopies.clear();
+        mContext->VkbDispatchTable->destroySemaphore(mSemaphore, nullptr);
+        mSemaphore = nullptr;
+        if(!!mTransferSemaphore)
+        {
+            mContext->VkbDispatchTable->destroySemaphore(mTransferSemaphore, nullptr);
+            mTransferSemaphore = nullptr;
+        }
+        mUseTransferQueue = false;
+        mBuffer.Destroy();
+        mMapped   = nullptr;
+        mCapacity = 0;
+        mHead     = 0;
+        mTail     = 0;
+        mInUse    = 0;
+    }
+}  // namespace foray::core
@@ -0,0 +1,139 @@
+#pragma once
+#include "../foray_basics.hpp"
+#include "../foray_vulkan.hpp"
+#include "foray_commandbuffer.hpp"
+#include "foray_context.hpp"
+#include "foray_managedbuffer.hpp"
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace foray::core {
+
+    /// @brief Identifies an upload issued via a StagingRing
+    /// @details The upload has completed once the rings timeline semaphore has reached TimelineValue. A zero value is always complete.
+    struct UploadTicket
+    {
+        uint64_t TimelineValue = 0;
+    };
+
+    /// @brief Persistently mapped ring buffer for batched, non-blocking uploads to device local buffers
+    /// @details
+    /// ManagedBuffer::WriteDataDeviceLocal(data, size, offset) creates a staging buffer and a command buffer and waits for the upload for every call.
+    /// A StagingRing instead sub-allocates staging memory from one persistently mapped buffer. Copies are collected into a batch,
+    /// which is recorded into a single command buffer and submitted on Flush() (or whenever the ring runs out of space).
+    /// Every batch signals the rings timeline semaphore with its own value, which is used to retire the batch and reclaim its ring memory.
+    /// Uploads larger than the ring capacity fall back to the blocking path.
+    /// Copies are followed by a memory barrier, so later submissions to the same queue observe the uploaded data.
+    /// If the context has a dedicated transfer queue, copies execute there. Each batch then releases ownership of the written buffer ranges,
+    /// and a second submission to the main queue (waiting on the transfer submission) acquires them, before the batch's timeline value is signalled.
+    /// Not thread safe.
+    class StagingRing : public NoMoveDefaults
+    {
+      public:
+        inline static constexpr VkDeviceSize DEFAULT_CAPACITY = 64ULL * 1024ULL * 1024ULL;
+
+        StagingRing() = default;
+        inline virtual ~StagingRing() { Destroy(); }
+
+        /// @brief Creates the ring buffer and timeline semaphore
+        /// @param context Requires Allocator, DispatchTable, CommandPool, Queue, optionally TransferQueue. Device must have the timelineSemaphore feature enabled.
+        /// @param capacity Size of the ring buffer in bytes
+        void Create(Context* context, VkDeviceSize capacity = DEFAULT_CAPACITY, std::string_view name = "Staging Ring");
+
+        /// @brief Copies data into the ring and queues a copy to dstBuffer. Non-blocking, unless the ring has to wait for an older batch to free memory.
+        /// @param dstBuffer Buffer to write to. Requires VK_BUFFER_USAGE_TRANSFER_DST_BIT
+        /// @param dstOffset Write offset into dstBuffer
+        /// @param data Data to upload. Copied immediately, may be freed after this call returns
+        /// @param size Number of bytes to upload
+        /// @return Ticket which completes once the copy has executed on the device. Requires Flush() (or Wait()) to be submitted.
+        UploadTicket Upload(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+
+        /// @brief Submits all queued copies. Does nothing if no copies are queued.
+        /// @return Ticket which completes once all copies queued so far have executed
+        UploadTicket Flush();
+
+        /// @brief Checks whether the upload identified by ticket has finished executing (non-blocking)
+        bool HasCompleted(UploadTicket ticket);
+        /// @brief Blocks until the upload identified by ticket has finished executing. Flushes if ticket refers to the batch currently being recorded.
+        void Wait(UploadTicket ticket);
+        /// @brief Flushes and blocks until all uploads have finished executing
+        void WaitIdle();
+
+        /// @brief Waits for all uploads and destroys all resources
+        void Destroy();
+
+        inline bool Exists() const { return !!mSemaphore; }
+
+        FORAY_GETTER_V(Capacity)
+        FORAY_GETTER_V(Semaphore)
+        /// @brief True, if copies are executed on the dedicated transfer queue
+        FORAY_GETTER_V(UseTransferQueue)
+        /// @brief Bytes of the ring currently occupied by queued or executing uploads
+        FORAY_GETTER_V(InUse)
+        /// @brief Alignment of sub-allocations in the ring
+        FORAY_PROPERTY_V(Alignment)
+
+      protected:
+        struct Copy
+        {
+            VkBuffer     DstBuffer = nullptr;
+            VkBufferCopy Region    = {};
+        };
+
+        struct Batch
+        {
+            std::unique_ptr<DeviceSyncCommandBuffer> CmdBuffer;
+            /// @brief Main queue command buffer acquiring ownership (dedicated transfer queue only)
+            std::unique_ptr<DeviceSyncCommandBuffer> AcquireCmdBuffer;
+            /// @brief Value the timeline semaphore is signalled with once this batch has finished
+            uint64_t TimelineValue = 0;
+            /// @brief Ring head at the time of submission. Becomes the ring tail once retired
+            VkDeviceSize RingEnd = 0;
+            /// @brief Ring bytes (including alignment and wrap padding) consumed by this batch
+            VkDeviceSize UsedBytes = 0;
+        };
+
+        /// @brief Attempts to reserve size bytes in the ring
+        /// @return True if successful, offset is set to the start of the reserved region
+        bool TryAllocate(VkDeviceSize size, VkDeviceSize& offset);
+        /// @brief Pops all batches from the front of the in flight queue which have finished executing
+        void RetireCompleted();
+        /// @brief Blocks until the oldest in flight batch has finished and retires it
+        void RetireOldest();
+        void RetireBatch(Batch& batch);
+        /// @brief Checks whether the destination range of region overlaps the destination range of any of regions
+        static bool OverlapsAny(const std::vector<VkBufferCopy>& regions, const VkBufferCopy& region);
+        /// @brief Takes a command buffer from freeList, or creates a new one
+        std::unique_ptr<DeviceSyncCommandBuffer> GetCmdBuffer(std::vector<std::unique_ptr<DeviceSyncCommandBuffer>>& freeList, Context* context);
+
+        Context* mContext = nullptr;
+        /// @brief Copy of the context with the transfer queue as main queue, referenced by transfer command buffers
+        Context mTransferContext;
+        bool    mUseTransferQueue = false;
+
+        ManagedBuffer mBuffer;
+        uint8_t*      mMapped    = nullptr;
+        VkDeviceSize  mCapacity  = 0;
+        VkDeviceSize  mAlignment = 16;
+
+        VkSemaphore mSemaphore = nullptr;
+        /// @brief Signalled by transfer queue submissions, waited on by the matching acquire submissions (dedicated transfer queue only)
+        VkSemaphore mTransferSemaphore = nullptr;
+        /// @brief Timeline value of the most recently submitted batch
+        uint64_t mSubmittedValue = 0;
+
+        VkDeviceSize mHead  = 0;
+        VkDeviceSize mTail  = 0;
+        VkDeviceSize mInUse = 0;
+
+        /// @brief Copies queued for the next batch
+        std::vector<Copy> mPendingCopies;
+        /// @brief Ring bytes consumed by the next batch
+        VkDeviceSize mPendingBytes = 0;
+
+        std::deque<Batch>                                     mInFlight;
+        std::vector<std::unique_ptr<DeviceSyncCommandBuffer>> mFreeCmdBuffers;
+        std::vector<std::unique_ptr<DeviceSyncCommandBuffer>> mFreeAcquireCmdBuffers;
+    };
+}  // namespace foray::core
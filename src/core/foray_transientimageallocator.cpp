@@ -0,0 +1,265 @@
+#include "foray_transientimageallocator.hpp"
+#include "../foray_exception.hpp"
+#include "../foray_logger.hpp"
+#include "../util/foray_fmtutilities.hpp"
+#include "foray_managedimage.hpp"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace foray::core {
+    void TransientImageAllocator::Create(Context* context)
+    {
+        Destroy();
+        mContext = context;
+    }
+
+    std::vector<uint32_t> TransientImageAllocator::AssignBlocks(const std::vector<Request>& requests, std::vector<Block>& outBlocks)
+    {
+        outBlocks.clear();
+        std::vector<uint32_t> assignment(requests.size(), 0);
+
+        // Largest first, so smaller requests fill up blocks sized by larger ones
+        std::vector<uint32_t> order(requests.size());
+        std::iota(order.begin(), order.end(), 0U);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return requests[a].Size > requests[b].Size; });
+
+        for(uint32_t requestIndex : order)
+        {
+            const Request& request = requests[requestIndex];
+
+            // Best fit: the compatible block growing the least, ties broken by the smallest block
+            int32_t      bestBlock  = -1;
+            VkDeviceSize bestGrowth = 0;
+            for(uint32_t blockIndex = 0; blockIndex < outBlocks.size(); blockIndex++)
+            {
+                const Block& block = outBlocks[blockIndex];
+                if((block.MemoryTypeBits & request.MemoryTypeBits) == 0)
+                {
+                    continue;
+                }
+                bool overlaps = false;
+                for(uint32_t member : block.Members)
+                {
+                    overlaps |= requests[member].Life.Overlaps(request.Life);
+                }
+                if(overlaps)
+                {
+                    continue;
+                }
+                VkDeviceSize growth = request.Size > block.Size ? request.Size - block.Size : 0;
+                if(bestBlock < 0 || growth < bestGrowth || (growth == bestGrowth && block.Size < outBlocks[bestBlock].Size))
+                {
+                    bestBlock  = (int32_t)blockIndex;
+                    bestGrowth = growth;
+                }
+            }
+
+            if(bestBlock < 0)
+            {
+                outBlocks.push_back(Block{});
+                bestBlock = (int32_t)outBlocks.size() - 1;
+            }
+
+            Block& block         = outBlocks[bestBlock];
+            block.Size           = std::max(block.Size, request.Size);
+            block.Alignment      = std::max(block.Alignment, request.Alignment);
+            block.MemoryTypeBits = block.MemoryTypeBits & request.MemoryTypeBits;
+            block.Members.push_back(requestIndex);
+            assignment[requestIndex] = (uint32_t)bestBlock;
+        }
+        return assignment;
+    }
+
+    void TransientImageAllocator::Build(const std::unordered_map<const ManagedImage*, Lifetime>& lifetimes)
+    {
+        Assert(!!mContext, "TransientImageAllocator used before Create()");
+        if(&lifetimes != &mLifetimes)
+        {
+            mLifetimes = lifetimes;
+        }
+
+        std::vector<ManagedImage*> images(mRegistered.begin(), mRegistered.end());
+
+        std::vector<Request> requests;
+        requests.reserve(images.size());
+        mUnaliasedBytes = 0;
+        for(ManagedImage* image : images)
+        {
+            VkMemoryRequirements requirements = GetMemoryRequirements(image->GetCreateInfo().ImageCI);
+            Request              request{.Size = requirements.size, .Alignment = requirements.alignment, .MemoryTypeBits = requirements.memoryTypeBits};
+            auto                 iter = mLifetimes.find(image);
+            if(iter != mLifetimes.end())
+            {
+                request.Life = iter->second;
+            }
+            requests.push_back(request);
+            mUnaliasedBytes += requirements.size;
+        }
+
+        std::vector<Block>    layouts;
+        std::vector<uint32_t> assignment = AssignBlocks(requests, layouts);
+
+        mVmaBytesBefore = GetVmaAllocationBytes();
+
+        // Old blocks stay alive until the images aliasing them have been recreated
+        std::move(mBlocks.begin(), mBlocks.end(), std::back_inserter(mRetiredBlocks));
+        mBlocks.clear();
+        mAssignment.clear();
+        mAliasedBytes = 0;
+        for(const Block& layout : layouts)
+        {
+            VkMemoryRequirements requirements{.size = layout.Size, .alignment = layout.Alignment, .memoryTypeBits = layout.MemoryTypeBits};
+            VmaAllocationCreateInfo allocCi{.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
+
+            AllocatedBlock block{.Layout = layout};
+            AssertVkResult(vmaAllocateMemory(mContext->Allocator, &requirements, &allocCi, &block.Allocation, nullptr));
+            vmaSetAllocationName(mContext->Allocator, block.Allocation, fmt::format("Transient Image Block #{}", mBlocks.size()).c_str());
+            mBlocks.push_back(block);
+            mAliasedBytes += layout.Size;
+        }
+        for(size_t i = 0; i < images.size(); i++)
+        {
+            mAssignment[images[i]] = assignment[i];
+        }
+        mBuilt = true;
+        mDirty = false;
+        FreeRetiredBlocks();
+
+        logger()->info("[TransientImageAllocator] {} images in {} blocks, {} instead of {} unaliased", images.size(), mBlocks.size(), util::PrintSize(mAliasedBytes),
+                       util::PrintSize(mUnaliasedBytes));
+    }
+
+    void TransientImageAllocator::Rebuild()
+    {
+        Build(mLifetimes);
+    }
+
+    uint32_t TransientImageAllocator::RecreateStale()
+    {
+        std::vector<ManagedImage*> stale;
+        for(ManagedImage* image : mRegistered)
+        {
+            auto assigned = mAssignment.find(image);
+            if(assigned == mAssignment.end())
+            {
+                continue;
+            }
+            auto aliasing = mAliasing.find(image);
+            if(aliasing == mAliasing.end() || aliasing->second != mBlocks[assigned->second].Allocation)
+            {
+                stale.push_back(image);
+            }
+        }
+        // Recreating unregisters and registers the image again
+        for(ManagedImage* image : stale)
+        {
+            image->Resize(image->GetExtent3D());
+        }
+        return (uint32_t)stale.size();
+    }
+
+    void TransientImageAllocator::Register(ManagedImage* image)
+    {
+        mRegistered.emplace(image);
+    }
+
+    void TransientImageAllocator::Unregister(ManagedImage* image)
+    {
+        mRegistered.erase(image);
+        if(mAliasing.erase(image) > 0 && !mRetiredBlocks.empty())
+        {
+            FreeRetiredBlocks();
+        }
+    }
+
+    bool TransientImageAllocator::CreateAliasingImage(const ManagedImage* image, const VkImageCreateInfo& imageCi, VkImage& outImage, VmaAllocation& outAllocation)
+    {
+        if(!mBuilt)
+        {
+            return false;
+        }
+        auto iter = mAssignment.find(image);
+        if(iter == mAssignment.end())
+        {
+            mDirty = true;
+            return false;
+        }
+        const AllocatedBlock& block        = mBlocks[iter->second];
+        VkMemoryRequirements  requirements = GetMemoryRequirements(imageCi);
+        VmaAllocationInfo     allocInfo{};
+        vmaGetAllocationInfo(mContext->Allocator, block.Allocation, &allocInfo);
+        if(requirements.size > block.Layout.Size || (block.Layout.Alignment % requirements.alignment) != 0 || (requirements.memoryTypeBits & (1U << allocInfo.memoryType)) == 0)
+        {
+            // e.g. grown on resize
+            mDirty = true;
+            return false;
+        }
+        AssertVkResult(vmaCreateAliasingImage(mContext->Allocator, block.Allocation, &imageCi, &outImage));
+        outAllocation    = block.Allocation;
+        mAliasing[image] = block.Allocation;
+        return true;
+    }
+
+    VkMemoryRequirements TransientImageAllocator::GetMemoryRequirements(const VkImageCreateInfo& imageCi) const
+    {
+        VkDeviceImageMemoryRequirements info{.sType = VkStructureType::VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS, .pCreateInfo = &imageCi};
+        VkMemoryRequirements2           requirements{.sType = VkStructureType::VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+        mContext->VkbDispatchTable->getDeviceImageMemoryRequirements(&info, &requirements);
+        return requirements.memoryRequirements;
+    }
+
+    VkDeviceSize TransientImageAllocator::GetVmaAllocationBytes() const
+    {
+        VmaTotalStatistics statistics{};
+        vmaCalculateStatistics(mContext->Allocator, &statistics);
+        return statistics.total.statistics.allocationBytes;
+    }
+
+    void TransientImageAllocator::FreeBlocks(std::vector<AllocatedBlock>& blocks)
+    {
+        for(AllocatedBlock& block : blocks)
+        {
+            vmaFreeMemory(mContext->Allocator, block.Allocation);
+        }
+        blocks.clear();
+    }
+
+    void TransientImageAllocator::FreeRetiredBlocks()
+    {
+        size_t retiredCount = mRetiredBlocks.size();
+        std::erase_if(mRetiredBlocks, [&](const AllocatedBlock& block) {
+            for(const auto& [image, allocation] : mAliasing)
+            {
+                if(allocation == block.Allocation)
+                {
+                    return false;
+                }
+            }
+            vmaFreeMemory(mContext->Allocator, block.Allocation);
+            return true;
+        });
+        if(mRetiredBlocks.empty() && retiredCount > 0)
+        {
+            mVmaBytesAfter = GetVmaAllocationBytes();
+            logger()->info("[TransientImageAllocator] Freed previous blocks. VMA allocations {} -> {}", util::PrintSize(mVmaBytesBefore), util::PrintSize(mVmaBytesAfter));
+        }
+    }
+
+    void TransientImageAllocator::Destroy()
+    {
+        if(!mContext)
+        {
+            return;
+        }
+        FreeBlocks(mBlocks);
+        FreeBlocks(mRetiredBlocks);
+        mAssignment.clear();
+        mAliasing.clear();
+        mLifetimes.clear();
+        mRegistered.clear();
+        mBuilt   = false;
+        mDirty   = false;
+        mContext = nullptr;
+    }
+}  // namespace foray::core
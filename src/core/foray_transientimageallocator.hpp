@@ -0,0 +1,130 @@
+#pragma once
+#include "../foray_basics.hpp"
+#include "../foray_vma.hpp"
+#include "../foray_vulkan.hpp"
+#include "foray_context.hpp"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace foray::core {
+
+    /// @brief Places transient images (ManagedImage::CreateInfo::Transient) with non overlapping lifetimes in shared memory blocks
+    /// @details
+    /// Transient images register themselves on creation. Until Build() has been called, they are allocated regularly.
+    /// Build() takes the lifetimes of the images within a frame (e.g. stages::RenderGraph::GetImageLifetimes()), assigns images which are never alive
+    /// at the same time to the same memory block and allocates the blocks. Images are placed in their block via vmaCreateAliasingImage once they are recreated,
+    /// which is left to their owners (e.g. resizing the render stages, see base::DefaultAppBase::BuildTransientImages()), so every image is recreated once
+    /// and descriptor sets referencing it are updated along the way. RecreateStale() recreates the images their owners did not.
+    /// Blocks of a previous Build() are freed once no image aliases them anymore.
+    /// Images recreated later (e.g. on resize) are placed in their block again if they still fit. Otherwise they are allocated regularly and GetDirty() returns true.
+    /// @remark Contents of transient images are undefined at their first use in a frame. Their first access must write (from layout undefined),
+    /// after a barrier waiting for all prior accesses of the memory block (stages::RenderGraph emits such barriers for the first access of every image).
+    /// @remark Not thread safe
+    class TransientImageAllocator
+    {
+      public:
+        /// @brief Range of passes (in execution order) an image is accessed in. Inclusive
+        struct Lifetime
+        {
+            uint32_t FirstUse = 0;
+            uint32_t LastUse  = ~0U;
+
+            inline bool Overlaps(const Lifetime& other) const { return FirstUse <= other.LastUse && other.FirstUse <= LastUse; }
+        };
+
+        /// @brief Memory requirements and lifetime of a single image, input to AssignBlocks()
+        struct Request
+        {
+            VkDeviceSize Size           = 0;
+            VkDeviceSize Alignment      = 1;
+            uint32_t     MemoryTypeBits = ~0U;
+            Lifetime     Life;
+        };
+
+        /// @brief Memory block shared by requests with non overlapping lifetimes, output of AssignBlocks()
+        struct Block
+        {
+            VkDeviceSize          Size           = 0;
+            VkDeviceSize          Alignment      = 1;
+            uint32_t              MemoryTypeBits = ~0U;
+            std::vector<uint32_t> Members;
+        };
+
+        TransientImageAllocator() = default;
+        inline virtual ~TransientImageAllocator() { Destroy(); }
+
+        /// @param context Requires Allocator, DispatchTable
+        void Create(Context* context);
+
+        /// @brief Assigns blocks to all registered images and allocates the blocks. Images are placed in them when recreated next
+        /// @param lifetimes Lifetime per image. Images without an entry are considered alive for the entire frame
+        /// @remark Requires the device to be idle until the images have been recreated
+        void Build(const std::unordered_map<const ManagedImage*, Lifetime>& lifetimes);
+        /// @brief Build() with the lifetimes of the last Build()
+        void Rebuild();
+        /// @brief Recreates registered images not yet placed in their assigned block (e.g. images not owned by a render stage)
+        /// @return Number of images recreated
+        uint32_t RecreateStale();
+
+        /// @brief Assigns requests to blocks. Requests in the same block never have overlapping lifetimes and share a memory type
+        /// @return Block index per request
+        static std::vector<uint32_t> AssignBlocks(const std::vector<Request>& requests, std::vector<Block>& outBlocks);
+
+        /// @brief [Internal] Called by ManagedImage::Create() for transient images
+        void Register(ManagedImage* image);
+        /// @brief [Internal] Called by ManagedImage::Destroy() for transient images
+        void Unregister(ManagedImage* image);
+        /// @brief [Internal] Creates the image aliasing its assigned block, if Build() assigned one and it fits
+        /// @return False, if the image has to be allocated regularly
+        bool CreateAliasingImage(const ManagedImage* image, const VkImageCreateInfo& imageCi, VkImage& outImage, VmaAllocation& outAllocation);
+
+        /// @brief True, if images were registered or recreated since the last Build() which could not be placed in a block
+        FORAY_GETTER_V(Dirty)
+        /// @brief Number of memory blocks allocated by the last Build()
+        inline uint32_t GetBlockCount() const { return (uint32_t)mBlocks.size(); }
+        /// @brief Number of blocks of previous builds still aliased by images which have not been recreated since
+        inline uint32_t GetRetiredBlockCount() const { return (uint32_t)mRetiredBlocks.size(); }
+        /// @brief Sum of the memory requirements of all transient images in the last Build()
+        FORAY_GETTER_V(UnaliasedBytes)
+        /// @brief Sum of the sizes of all blocks allocated by the last Build()
+        FORAY_GETTER_V(AliasedBytes)
+        /// @brief Total bytes allocated through VMA (vmaCalculateStatistics) before the last Build()
+        FORAY_GETTER_V(VmaBytesBefore)
+        /// @brief Total bytes allocated through VMA (vmaCalculateStatistics) once the blocks of the previous Build() have been freed
+        FORAY_GETTER_V(VmaBytesAfter)
+
+        inline bool  Exists() const { return !!mContext; }
+        virtual void Destroy();
+
+      protected:
+        struct AllocatedBlock
+        {
+            VmaAllocation Allocation = nullptr;
+            Block         Layout;
+        };
+
+        VkMemoryRequirements GetMemoryRequirements(const VkImageCreateInfo& imageCi) const;
+        VkDeviceSize         GetVmaAllocationBytes() const;
+        void                 FreeBlocks(std::vector<AllocatedBlock>& blocks);
+        /// @brief Frees retired blocks no image aliases anymore
+        void                 FreeRetiredBlocks();
+
+        Context*                                               mContext = nullptr;
+        std::unordered_set<ManagedImage*>                      mRegistered;
+        std::vector<AllocatedBlock>                            mBlocks;
+        /// @brief Blocks of previous builds, freed once no image aliases them
+        std::vector<AllocatedBlock>                            mRetiredBlocks;
+        std::unordered_map<const ManagedImage*, uint32_t>      mAssignment;
+        std::unordered_map<const ManagedImage*, Lifetime>      mLifetimes;
+        /// @brief Block allocation each aliasing image currently lives in
+        std::unordered_map<const ManagedImage*, VmaAllocation> mAliasing;
+
+        bool         mBuilt          = false;
+        bool         mDirty          = false;
+        VkDeviceSize mUnaliasedBytes = 0;
+        VkDeviceSize mAliasedBytes   = 0;
+        VkDeviceSize mVmaBytesBefore = 0;
+        VkDeviceSize mVmaBytesAfter  = 0;
+    };
+}  // namespace foray::core
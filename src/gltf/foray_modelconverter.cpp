@@ -118,6 +118,7 @@ namespace foray::gltf {
         logger()->info("Model Load: Uploading textures ...");
 
         LoadTextures();
+        mTextures.RegisterBindless();
 
         mBenchmark.LogTimestamp("Textures");
 
@@ -345,6 +346,7 @@ namespace foray::gltf {
             node->GetTransform()->RecalculateIfDirty(true);
         }
 
+        mScene->GetComponent<scene::gcomp::TransformSystem>()->InitOrUpdate();
         mScene->GetComponent<scene::gcomp::DrawDirector>()->InitOrUpdate();
         mScene->GetComponent<scene::gcomp::CameraManager>()->RefreshCameraList();
 
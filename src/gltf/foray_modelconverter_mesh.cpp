@@ -1,3 +1,4 @@
+#include "../as/foray_blasbatchbuilder.hpp"
 #include "../foray_logger.hpp"
 #include "../scene/globalcomponents/foray_geometrymanager.hpp"
 #include "foray_modelconverter.hpp"
@@ -36,10 +37,12 @@ namespace foray::gltf {
 
         mGeo.InitOrUpdate();
 #if !FORAY_DISABLE_RT
+        as::BlasBatchBuilder blasBuilder;
         for(auto& mesh : mIndexBindings.Meshes)
         {
-            mesh->BuildAccelerationStructure(mContext, &mGeo);
+            mesh->BuildAccelerationStructure(mContext, &mGeo, blasBuilder);
         }
+        blasBuilder.Build(mContext, &mGeo);
 #endif
     }
 
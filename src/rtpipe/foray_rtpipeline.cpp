@@ -54,6 +54,7 @@ namespace foray::rtpipe {
         // Create the ray tracing pipeline
         VkRayTracingPipelineCreateInfoKHR raytracingPipelineCreateInfo{
             .sType                        = VkStructureType::VK_STRUCTURE_TYPE_RAY_TRACING_PIPELINE_CREATE_INFO_KHR,
+            .flags                        = mPipelineCreateFlags,
             .stageCount                   = static_cast<uint32_t>(mShaderCollection.GetShaderStageCis().size()),
             .pStages                      = mShaderCollection.GetShaderStageCis().data(),
             .groupCount                   = static_cast<uint32_t>(shaderGroupCis.size()),
@@ -62,7 +63,7 @@ namespace foray::rtpipe {
             .layout                       = mPipelineLayout,
         };
 
-        AssertVkResult(mContext->VkbDispatchTable->createRayTracingPipelinesKHR(nullptr, nullptr, 1, &raytracingPipelineCreateInfo, nullptr, &mPipeline));
+        AssertVkResult(mContext->VkbDispatchTable->createRayTracingPipelinesKHR(nullptr, mContext->PipelineCache, 1, &raytracingPipelineCreateInfo, nullptr, &mPipeline));
 
 
         /// STEP # 4    Get shader handles, build SBTs
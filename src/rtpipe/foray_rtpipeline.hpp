@@ -22,6 +22,8 @@ namespace foray::rtpipe {
         FORAY_GETTER_R(CallablesSbt)
         FORAY_GETTER_V(Pipeline)
         FORAY_PROPERTY_V(PipelineLayout)
+        /// @brief Assigned to VkRayTracingPipelineCreateInfoKHR::flags (e.g. core::DescriptorSet::GetPipelineCreateFlags())
+        FORAY_PROPERTY_V(PipelineCreateFlags)
 
         /// @brief Builds RtPipeline with shaders and shadergroups as defined in Sbt wrappers and builds Sbts.
         void Build(core::Context* context, VkPipelineLayout pipelineLayout);
@@ -44,6 +46,8 @@ namespace foray::rtpipe {
         VkPipelineLayout mPipelineLayout = nullptr;
         VkPipeline       mPipeline       = nullptr;
 
+        VkPipelineCreateFlags mPipelineCreateFlags = 0;
+
         core::Context* mContext = nullptr;
     };
 }  // namespace foray::rtpipe
\ No newline at end of file
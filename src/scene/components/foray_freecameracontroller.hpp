@@ -22,6 +22,9 @@ namespace foray::scene::ncomp {
 
         virtual void           Update(SceneUpdateInfo&) override;
         inline virtual int32_t GetOrder() const override { return 0; }
+        inline virtual uint32_t GetUpdateReads() const override { return DATA_CAMERAS; }
+        inline virtual uint32_t GetUpdateWrites() const override { return DATA_TRANSFORMS; }
+        inline virtual bool     GetUpdateRecordsCommands() const override { return false; }
 
         FORAY_PROPERTY_V(InvertYAxis)
         FORAY_PROPERTY_V(InvertAll)
@@ -8,6 +8,9 @@ namespace foray::scene::ncomp {
     class Transform : public NodeComponent
     {
       public:
+        friend gcomp::TransformSystem;
+        friend Node;
+
         inline Transform() {}
 
         FORAY_GETTER_R(Translation)
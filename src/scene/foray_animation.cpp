@@ -1,6 +1,7 @@
 #include "foray_animation.hpp"
 #include "components/foray_transform.hpp"
 #include "foray_node.hpp"
+#include <algorithm>
 
 namespace foray::scene {
 
@@ -80,26 +81,42 @@ namespace foray::scene {
 
     void AnimationSampler::SelectKeyframe(float time, const AnimationKeyframe*& lower, const AnimationKeyframe*& upper) const
     {
-        int32_t lowerIndex = 0;
-        int32_t upperIndex = Keyframes.size() - 1;
+        const size_t count = Keyframes.size();
 
-        while(true)
+        // Lower keyframe is the last keyframe with Time <= time (or the first keyframe, if time precedes all keyframes)
+        auto lIsLower = [&](size_t index) {
+            bool beginsBefore = index == 0 || Keyframes[index].Time <= time;
+            bool endsAfter    = index + 1 >= count || Keyframes[index + 1].Time > time;
+            return beginsBefore && endsAfter;
+        };
+
+        size_t lowerIndex = mKeyframeCursor;
+        if(lowerIndex >= count || !lIsLower(lowerIndex))
         {
-            int32_t nextIndex = lowerIndex + 1;
-            if(nextIndex >= (int32_t)Keyframes.size() || Keyframes[nextIndex].Time > time)
+            if(lowerIndex + 1 < count && lIsLower(lowerIndex + 1))
             {
-                break;
+                lowerIndex++;
             }
-            lowerIndex++;
-        }
-        while(true)
-        {
-            int32_t nextIndex = upperIndex - 1;
-            if(nextIndex < 0 || Keyframes[nextIndex].Time < time)
+            else
             {
-                break;
+                auto iter  = std::upper_bound(Keyframes.begin(), Keyframes.end(), time, [](float time, const AnimationKeyframe& keyframe) { return time < keyframe.Time; });
+                lowerIndex = iter == Keyframes.begin() ? 0 : (size_t)(iter - Keyframes.begin()) - 1;
             }
-            upperIndex--;
+        }
+        mKeyframeCursor = lowerIndex;
+
+        // Upper keyframe is the first keyframe with Time >= time (or the last keyframe, if time exceeds all keyframes)
+        size_t upperIndex = lowerIndex;
+        if(Keyframes[lowerIndex].Time < time)
+        {
+            upperIndex = std::min(lowerIndex + 1, count - 1);
+        }
+        else if(Keyframes[lowerIndex].Time == time)
+        {
+            // Preceding keyframes may share the same time
+            auto iter = std::lower_bound(Keyframes.begin(), Keyframes.begin() + lowerIndex, time,
+                                         [](const AnimationKeyframe& keyframe, float time) { return keyframe.Time < time; });
+            upperIndex = (size_t)(iter - Keyframes.begin());
         }
 
         lower = &Keyframes[lowerIndex];
@@ -145,42 +162,56 @@ namespace foray::scene {
 
     void Animation::Update(const base::FrameRenderInfo& updateInfo)
     {
-        if(mPlaybackConfig.Enable)
+        Advance(updateInfo);
+        Sample();
+        Apply();
+    }
+
+    void Animation::Advance(const base::FrameRenderInfo& updateInfo)
+    {
+        if(!mPlaybackConfig.Enable)
         {
+            return;
+        }
 
-            float delta = mPlaybackConfig.PlaybackSpeed;
-            if(mPlaybackConfig.ConstantDelta != 0.f)
-            {
-                delta *= mPlaybackConfig.ConstantDelta;
-            }
-            else
+        float delta = mPlaybackConfig.PlaybackSpeed;
+        if(mPlaybackConfig.ConstantDelta != 0.f)
+        {
+            delta *= mPlaybackConfig.ConstantDelta;
+        }
+        else
+        {
+            delta *= updateInfo.GetFrameTime();
+        }
+        float newCursor = mPlaybackConfig.Cursor + delta;
+        if(mPlaybackConfig.Loop)
+        {
+            float duration = mEnd - mStart;
+            while(newCursor < mStart)
             {
-                delta *= updateInfo.GetFrameTime();
+                newCursor += duration;
             }
-            float newCursor = mPlaybackConfig.Cursor + delta;
-            if(mPlaybackConfig.Loop)
+            while(newCursor > mEnd)
             {
-                float duration = mEnd - mStart;
-                while(newCursor < mStart)
-                {
-                    newCursor += duration;
-                }
-                while(newCursor > mEnd)
-                {
-                    newCursor -= duration;
-                }
+                newCursor -= duration;
             }
-            mPlaybackConfig.Cursor = newCursor;
         }
-        for(auto& channel : mChannels)
-        {
-            auto  transform = channel.Target->GetTransform();
-            auto& sampler   = mSamplers[channel.SamplerIndex];
+        mPlaybackConfig.Cursor = newCursor;
+    }
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
 #define isnanf _isnanf
 #endif
 
+    void Animation::Sample()
+    {
+        mSampledValues.resize(mChannels.size());
+        for(size_t i = 0; i < mChannels.size(); i++)
+        {
+            const AnimationChannel& channel = mChannels[i];
+            const AnimationSampler& sampler = mSamplers[channel.SamplerIndex];
+            glm::vec4&              value   = mSampledValues[i];
+
             switch(channel.TargetPath)
             {
                 case EAnimationTargetPath::Translation: {
@@ -189,7 +220,7 @@ namespace foray::scene {
                     {
                         FORAY_THROWFMT("NAN: ({}|{}|{}) \"{}\"", translation.x, translation.y, translation.z, "Translation");
                     }
-                    transform->SetTranslation(translation);
+                    value = glm::vec4(translation, 0.f);
                     break;
                 }
                 case EAnimationTargetPath::Rotation: {
@@ -198,7 +229,7 @@ namespace foray::scene {
                     {
                         FORAY_THROWFMT("NAN: ({}|{}|{}|{}) \"{}\"", quat.x, quat.y, quat.z, quat.w, "Rotation");
                     }
-                    transform->SetRotation(quat);
+                    value = glm::vec4(quat.x, quat.y, quat.z, quat.w);
                     break;
                 }
                 case EAnimationTargetPath::Scale: {
@@ -207,7 +238,7 @@ namespace foray::scene {
                     {
                         FORAY_THROWFMT("NAN: ({}|{}|{}) \"{}\"", scale.x, scale.y, scale.z, "Scale");
                     }
-                    transform->SetScale(scale);
+                    value = glm::vec4(scale, 0.f);
                     break;
                 }
                 default:
@@ -215,4 +246,29 @@ namespace foray::scene {
             }
         }
     }
-}  // namespace foray::scene
\ No newline at end of file
+
+    void Animation::Apply()
+    {
+        for(size_t i = 0; i < mChannels.size() && i < mSampledValues.size(); i++)
+        {
+            const AnimationChannel& channel   = mChannels[i];
+            auto                    transform = channel.Target->GetTransform();
+            const glm::vec4&        value     = mSampledValues[i];
+
+            switch(channel.TargetPath)
+            {
+                case EAnimationTargetPath::Translation:
+                    transform->SetTranslation(glm::vec3(value));
+                    break;
+                case EAnimationTargetPath::Rotation:
+                    transform->SetRotation(glm::quat(value.w, value.x, value.y, value.z));
+                    break;
+                case EAnimationTargetPath::Scale:
+                    transform->SetScale(glm::vec3(value));
+                    break;
+                default:
+                    continue;
+            }
+        }
+    }
+}  // namespace foray::scene
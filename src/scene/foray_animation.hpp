@@ -40,6 +40,7 @@ namespace foray::scene {
     };
 
     /// @brief A collection of keyframes
+    /// @remark Keyframes must be sorted by time. Sampling caches the last used keyframe index, so a sampler must not be sampled from multiple threads at once
     struct AnimationSampler
     {
       public:
@@ -62,7 +63,12 @@ namespace foray::scene {
         std::vector<AnimationKeyframe> Keyframes     = {};
 
       protected:
+        /// @brief Selects the last keyframe with Time <= time as lower, and the first keyframe with Time >= time as upper (clamped to the first/last keyframe)
+        /// @details Checks the cached keyframe and its successor first (amortized O(1) during playback), binary searches otherwise (seeks, loops)
         void SelectKeyframe(float time, const AnimationKeyframe*& lower, const AnimationKeyframe*& upper) const;
+
+        /// @brief Lower keyframe index of the most recent SelectKeyframe() call
+        mutable size_t mKeyframeCursor = 0;
     };
 
     /// @brief A channel is the animation of a single node property
@@ -100,9 +106,17 @@ namespace foray::scene {
         FORAY_PROPERTY_V(End)
         FORAY_PROPERTY_R(PlaybackConfig)
 
-        /// @brief Applies current playback state
+        /// @brief Applies current playback state (Advance(), Sample() and Apply() in one)
         void Update(const base::FrameRenderInfo&);
 
+        /// @brief Advances the playback cursor
+        void Advance(const base::FrameRenderInfo&);
+        /// @brief Samples all channels at the playback cursor into a per-channel staging array. Does not modify any node
+        /// @remark Safe to call for different animations concurrently, as long as they do not share samplers
+        void Sample();
+        /// @brief Writes the staged channel values to the target transforms
+        void Apply();
+
       protected:
         /// @brief Animation name
         std::string mName;
@@ -116,6 +130,8 @@ namespace foray::scene {
         float mEnd = {};
         /// @brief Configuration representing current playback state
         PlaybackConfig mPlaybackConfig;
+        /// @brief Sampled value per channel (xyz: translation or scale, xyzw: rotation quaternion)
+        std::vector<glm::vec4> mSampledValues;
     };
 
 }  // namespace foray::scene
\ No newline at end of file
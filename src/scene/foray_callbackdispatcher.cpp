@@ -1,8 +1,18 @@
 #include "foray_callbackdispatcher.hpp"
+#include "../core/foray_context.hpp"
+#include "../foray_exception.hpp"
+#include "../foray_vulkan.hpp"
+#include "../util/foray_workerpool.hpp"
+#include <algorithm>
 
 namespace foray::scene {
     void CallbackDispatcher::InvokeUpdate(SceneUpdateInfo& updateInfo)
     {
+        if(!!mUpdateWorkerPool)
+        {
+            InvokeUpdateParallel(updateInfo);
+            return;
+        }
         mUpdate.Invoke(updateInfo);
     }
     void CallbackDispatcher::InvokeDraw(SceneDrawInfo& drawInfo)
@@ -17,4 +27,191 @@ namespace foray::scene {
     {
         mOnResized.Invoke(extent);
     }
-}  // namespace foray
\ No newline at end of file
+
+    void CallbackDispatcher::EnableParallelUpdate(core::Context* context, util::WorkerPool* workerPool)
+    {
+        Assert(!!context && !!workerPool, "CallbackDispatcher::EnableParallelUpdate: Context and worker pool required");
+        mParallelUpdateContext = context;
+        mUpdateWorkerPool      = workerPool;
+    }
+
+    void CallbackDispatcher::DisableParallelUpdate()
+    {
+        bool anySlots = false;
+        for(const std::vector<SecondaryCommandSlot>& slots : mSecondaryCommandSlots)
+        {
+            anySlots |= slots.size() > 0;
+        }
+        if(anySlots)
+        {
+            // Secondary command buffers of the last INFLIGHT_FRAME_COUNT frames may still be executing
+            AssertVkResult(mParallelUpdateContext->VkbDispatchTable->deviceWaitIdle());
+        }
+        for(std::vector<SecondaryCommandSlot>& slots : mSecondaryCommandSlots)
+        {
+            for(SecondaryCommandSlot& slot : slots)
+            {
+                // Destroying the pool frees its command buffer
+                mParallelUpdateContext->VkbDispatchTable->destroyCommandPool(slot.Pool, nullptr);
+            }
+            slots.clear();
+        }
+        mUpdateWorkerPool      = nullptr;
+        mParallelUpdateContext = nullptr;
+    }
+
+    const std::vector<std::vector<Component::UpdateCallback*>>& CallbackDispatcher::GetUpdateWaves()
+    {
+        if(mUpdateWavesVersion == mUpdate.Version)
+        {
+            return mUpdateWaves;
+        }
+
+        // Per data category, the latest wave reading and the latest wave writing it (-1: none)
+        const uint32_t                     categoryCount = 32;
+        std::array<int32_t, categoryCount> lastRead;
+        std::array<int32_t, categoryCount> lastWrite;
+        lastRead.fill(-1);
+        lastWrite.fill(-1);
+
+        mUpdateWaves.clear();
+        for(auto& pair : mUpdate.Listeners)
+        {
+            Component::UpdateCallback* callback = pair.second;
+            const uint32_t             reads    = callback->GetUpdateReads();
+            const uint32_t             writes   = callback->GetUpdateWrites();
+
+            // Reads must follow writes, writes must follow reads and writes
+            int32_t wave = 0;
+            for(uint32_t category = 0; category < categoryCount; category++)
+            {
+                const uint32_t bit = 1U << category;
+                if((reads & bit) > 0)
+                {
+                    wave = std::max(wave, lastWrite[category] + 1);
+                }
+                if((writes & bit) > 0)
+                {
+                    wave = std::max(wave, std::max(lastRead[category], lastWrite[category]) + 1);
+                }
+            }
+            for(uint32_t category = 0; category < categoryCount; category++)
+            {
+                const uint32_t bit = 1U << category;
+                if((reads & bit) > 0)
+                {
+                    lastRead[category] = std::max(lastRead[category], wave);
+                }
+                if((writes & bit) > 0)
+                {
+                    lastWrite[category] = wave;
+                }
+            }
+
+            if(wave >= (int32_t)mUpdateWaves.size())
+            {
+                mUpdateWaves.resize(wave + 1);
+            }
+            mUpdateWaves[wave].push_back(callback);
+        }
+
+        mUpdateWavesVersion = mUpdate.Version;
+        return mUpdateWaves;
+    }
+
+    void CallbackDispatcher::InvokeUpdateParallel(SceneUpdateInfo& updateInfo)
+    {
+        const std::vector<std::vector<Component::UpdateCallback*>>& waves = GetUpdateWaves();
+
+        // The secondary command buffers of this frame in flight were last submitted INFLIGHT_FRAME_COUNT frames ago, and have finished executing
+        const uint32_t                     frameIndex = (uint32_t)(updateInfo.RenderInfo.GetFrameNumber() % INFLIGHT_FRAME_COUNT);
+        std::vector<SecondaryCommandSlot>& slots      = mSecondaryCommandSlots[frameIndex];
+        for(SecondaryCommandSlot& slot : slots)
+        {
+            AssertVkResult(mParallelUpdateContext->VkbDispatchTable->resetCommandPool(slot.Pool, 0));
+        }
+        size_t nextSlot = 0;
+
+        std::vector<SceneUpdateInfo>  secondaryInfos;
+        std::vector<VkCommandBuffer>  secondaryCmdBuffers;
+        std::vector<SceneUpdateInfo*> waveInfos;
+
+        for(const std::vector<Component::UpdateCallback*>& wave : waves)
+        {
+            if(wave.size() == 1)
+            {
+                wave.front()->Invoke(updateInfo);
+                continue;
+            }
+
+            uint32_t reads = 0;
+            for(Component::UpdateCallback* callback : wave)
+            {
+                reads |= callback->GetUpdateReads();
+            }
+            PrepareConcurrentReads(reads);
+
+            // The first callback recording commands uses the primary command buffer, all following ones a secondary command buffer each
+            secondaryInfos.clear();
+            secondaryInfos.reserve(wave.size());
+            secondaryCmdBuffers.clear();
+            waveInfos.resize(wave.size());
+            bool primaryAssigned = false;
+            for(size_t i = 0; i < wave.size(); i++)
+            {
+                waveInfos[i] = &updateInfo;
+                if(!wave[i]->GetUpdateRecordsCommands())
+                {
+                    continue;
+                }
+                if(!primaryAssigned)
+                {
+                    primaryAssigned = true;
+                    continue;
+                }
+                VkCommandBuffer cmdBuffer = BeginSecondaryCommandBuffer(frameIndex, nextSlot++);
+                secondaryCmdBuffers.push_back(cmdBuffer);
+                secondaryInfos.emplace_back(updateInfo.RenderInfo, cmdBuffer);
+                waveInfos[i] = &secondaryInfos.back();
+            }
+
+            mUpdateWorkerPool->ParallelFor(wave.size(), [&](size_t index) { wave[index]->Invoke(*waveInfos[index]); });
+
+            if(secondaryCmdBuffers.size() > 0)
+            {
+                for(VkCommandBuffer cmdBuffer : secondaryCmdBuffers)
+                {
+                    AssertVkResult(mParallelUpdateContext->VkbDispatchTable->endCommandBuffer(cmdBuffer));
+                }
+                mParallelUpdateContext->VkbDispatchTable->cmdExecuteCommands(updateInfo.CmdBuffer, (uint32_t)secondaryCmdBuffers.size(), secondaryCmdBuffers.data());
+            }
+        }
+    }
+
+    VkCommandBuffer CallbackDispatcher::BeginSecondaryCommandBuffer(uint32_t frameIndex, size_t slotIndex)
+    {
+        std::vector<SecondaryCommandSlot>& slots = mSecondaryCommandSlots[frameIndex];
+        if(slotIndex >= slots.size())
+        {
+            SecondaryCommandSlot    slot;
+            VkCommandPoolCreateInfo poolCi{.sType            = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                                           .flags            = VkCommandPoolCreateFlagBits::VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                           .queueFamilyIndex = mParallelUpdateContext->QueueFamilyIndex};
+            AssertVkResult(mParallelUpdateContext->VkbDispatchTable->createCommandPool(&poolCi, nullptr, &slot.Pool));
+            VkCommandBufferAllocateInfo allocInfo{.sType              = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                                  .commandPool        = slot.Pool,
+                                                  .level              = VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                                                  .commandBufferCount = 1U};
+            AssertVkResult(mParallelUpdateContext->VkbDispatchTable->allocateCommandBuffers(&allocInfo, &slot.CmdBuffer));
+            slots.push_back(slot);
+        }
+
+        VkCommandBuffer                cmdBuffer = slots[slotIndex].CmdBuffer;
+        VkCommandBufferInheritanceInfo inheritanceInfo{.sType = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+        VkCommandBufferBeginInfo       beginInfo{.sType            = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                                 .flags            = VkCommandBufferUsageFlagBits::VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                                                 .pInheritanceInfo = &inheritanceInfo};
+        AssertVkResult(mParallelUpdateContext->VkbDispatchTable->beginCommandBuffer(cmdBuffer, &beginInfo));
+        return cmdBuffer;
+    }
+}  // namespace foray::scene
@@ -2,12 +2,23 @@
 #include "../base/foray_framerenderinfo.hpp"
 #include "../foray_logger.hpp"
 #include "../osi/foray_osi_declares.hpp"
+#include "../util/foray_util_declares.hpp"
 #include "foray_component.hpp"
+#include <array>
 #include <map>
 #include <vector>
 
 namespace foray::scene {
     /// @brief Type maintaining callback lists for event distribution
+    /// @details
+    /// # Parallel update
+    /// After EnableParallelUpdate(), update callbacks are grouped into waves based on the data categories they declare (UpdateCallback::GetUpdateReads(),
+    /// UpdateCallback::GetUpdateWrites()). A callback is placed in the wave after the latest wave containing a conflicting callback of lower or equal order
+    /// (write/write or read/write on a shared category), so conflicting callbacks keep executing in GetOrder() sequence. Callbacks within a wave run concurrently on the worker pool.
+    /// Of the callbacks in a wave recording commands, the first records into SceneUpdateInfo::CmdBuffer, all others into secondary command buffers, which are
+    /// executed on SceneUpdateInfo::CmdBuffer after the wave has finished.
+    /// Before a wave of concurrent callbacks runs, PrepareConcurrentReads() is invoked with the data categories the wave reads. Scene uses it to recalculate
+    /// dirty global matrices, as Transform::GetGlobalMatrix() would otherwise write them lazily from multiple threads.
     class CallbackDispatcher
     {
       public:
@@ -18,6 +29,18 @@ namespace foray::scene {
         virtual void InvokeOnEvent(const osi::Event* event);
         virtual void InvokeOnResized(VkExtent2D event);
 
+        /// @brief Executes independent update callbacks concurrently
+        /// @param context Context used to create command pools for secondary command buffers (queue family QueueFamilyIndex)
+        /// @param workerPool Worker pool executing the callbacks. Not owned
+        void EnableParallelUpdate(core::Context* context, util::WorkerPool* workerPool);
+        /// @brief Reverts to sequential update callback execution and destroys secondary command buffers. Waits for the device to be idle, if any were created
+        void DisableParallelUpdate();
+
+        /// @brief Update callbacks grouped into waves of concurrently executable callbacks (rebuilt on demand)
+        const std::vector<std::vector<Component::UpdateCallback*>>& GetUpdateWaves();
+
+        inline virtual ~CallbackDispatcher() { DisableParallelUpdate(); }
+
       protected:
         template <typename TCallback, bool Ordered = TCallback::ORDERED_EXECUTION>
         struct CallbackVector
@@ -33,6 +56,8 @@ namespace foray::scene {
         struct CallbackVector<TCallback, true>
         {
             std::multimap<int32_t, TCallback*> Listeners = {};
+            /// @brief Incremented on every change to Listeners
+            uint64_t Version = 0;
 
             inline void Invoke(typename TCallback::TArg arg);
             inline void Add(TCallback* callback);
@@ -43,6 +68,30 @@ namespace foray::scene {
         CallbackVector<Component::UpdateCallback>    mUpdate    = {};
         CallbackVector<Component::DrawCallback>      mDraw      = {};
         CallbackVector<Component::OnResizedCallback> mOnResized = {};
+
+        /// @brief Invokes update callbacks wave by wave on the worker pool
+        void InvokeUpdateParallel(SceneUpdateInfo& updateInfo);
+        /// @brief Invoked on the calling thread before a wave of concurrently executing callbacks
+        /// @param reads Data categories read by any callback of the wave. Lazily computed data of these categories must be made up to date here
+        virtual void PrepareConcurrentReads(uint32_t reads) {}
+        /// @brief Returns a begun secondary command buffer of the slot, creating pool and buffer if necessary
+        VkCommandBuffer BeginSecondaryCommandBuffer(uint32_t frameIndex, size_t slot);
+
+        std::vector<std::vector<Component::UpdateCallback*>> mUpdateWaves;
+        /// @brief mUpdate.Version mUpdateWaves was built for
+        uint64_t mUpdateWavesVersion = ~0ULL;
+
+        core::Context*    mParallelUpdateContext = nullptr;
+        util::WorkerPool* mUpdateWorkerPool      = nullptr;
+
+        /// @brief Command pool with a single secondary command buffer. Pools are not shared between threads
+        struct SecondaryCommandSlot
+        {
+            VkCommandPool   Pool      = nullptr;
+            VkCommandBuffer CmdBuffer = nullptr;
+        };
+        /// @brief Secondary command buffer slots per frame in flight
+        std::array<std::vector<SecondaryCommandSlot>, INFLIGHT_FRAME_COUNT> mSecondaryCommandSlots;
     };
 
     template <typename TCallback, bool Ordered>
@@ -85,6 +134,7 @@ namespace foray::scene {
     void CallbackDispatcher::CallbackVector<TCallback, true>::Add(TCallback* callback)
     {
         Listeners.emplace(callback->GetOrder(), callback);
+        Version++;
     }
 
     template <typename TCallback>
@@ -96,6 +146,7 @@ namespace foray::scene {
             if(iter->second == callback)
             {
                 Listeners.erase(iter);
+                Version++;
                 return true;
             }
         }
@@ -25,10 +25,35 @@ namespace foray::scene {
             inline virtual void Update(TArg updateInfo) = 0;
             inline void         Invoke(TArg updateInfo) { Update(updateInfo); }
 
+            /// @brief World matrix calculation, after animations and controllers changed local transforms
+            static const int32_t ORDER_HIERARCHY    = 50;
             static const int32_t ORDER_TRANSFORM    = 100;
             static const int32_t ORDER_DEVICEUPLOAD = 200;
 
             virtual inline int32_t GetOrder() const { return 0; }
+
+            /// @brief Scene data categories accessed by update callbacks. Used to schedule independent callbacks concurrently (see CallbackDispatcher::EnableParallelUpdate())
+            static const uint32_t DATA_NONE       = 0U;
+            /// @brief Node transforms (translation, rotation, scale, local and global matrices)
+            static const uint32_t DATA_TRANSFORMS = 1U << 0;
+            /// @brief Animation playback state
+            static const uint32_t DATA_ANIMATIONS = 1U << 1;
+            /// @brief Camera components and the camera ubo
+            static const uint32_t DATA_CAMERAS    = 1U << 2;
+            /// @brief Punctual light components and the light buffer
+            static const uint32_t DATA_LIGHTS     = 1U << 3;
+            /// @brief DrawDirector transform and draw buffers
+            static const uint32_t DATA_DRAWDATA   = 1U << 4;
+            /// @brief Tlas instances and buffers
+            static const uint32_t DATA_TLAS       = 1U << 5;
+            static const uint32_t DATA_ALL        = ~0U;
+
+            /// @brief Data categories read by Update(). Callbacks not overriding this conflict with all others
+            virtual inline uint32_t GetUpdateReads() const { return DATA_ALL; }
+            /// @brief Data categories written by Update(). Callbacks not overriding this conflict with all others
+            virtual inline uint32_t GetUpdateWrites() const { return DATA_ALL; }
+            /// @brief If true, Update() records commands into SceneUpdateInfo::CmdBuffer
+            virtual inline bool GetUpdateRecordsCommands() const { return true; }
         };
 
         /// @brief Base class for implementing the draw callback
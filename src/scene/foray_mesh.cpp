@@ -1,4 +1,5 @@
 #include "foray_mesh.hpp"
+#include "../as/foray_blasbatchbuilder.hpp"
 #include "foray_scenedrawing.hpp"
 
 namespace foray::scene {
@@ -54,4 +55,9 @@ namespace foray::scene {
             }
         }
     }
+
+    void Mesh::BuildAccelerationStructure(core::Context* context, gcomp::GeometryStore* store, as::BlasBatchBuilder& batch)
+    {
+        batch.Add(this);
+    }
 }  // namespace foray
\ No newline at end of file
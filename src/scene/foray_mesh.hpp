@@ -1,4 +1,5 @@
 #pragma once
+#include "../as/foray_as_declares.hpp"
 #include "../as/foray_blas.hpp"
 #include "../foray_basics.hpp"
 #include "../scene/foray_geo.hpp"
@@ -55,15 +56,25 @@ namespace foray::scene {
         virtual void CmdDraw(SceneDrawInfo& drawInfo);
         virtual void CmdDrawInstanced(SceneDrawInfo& drawInfo, uint32_t instanceCount);
 
+        /// @brief Builds the Blas, synchronizing with the host
         virtual void BuildAccelerationStructure(core::Context* context, gcomp::GeometryStore* store) { mBlas.CreateOrUpdate(context, this, store); }
+        /// @brief Queues the Blas build into batch, which builds all queued Blas with a single submission (used by ModelConverter).
+        /// Subclasses customizing the Blas build should override both variants.
+        virtual void BuildAccelerationStructure(core::Context* context, gcomp::GeometryStore* store, as::BlasBatchBuilder& batch);
 
         FORAY_PROPERTY_R(Primitives)
         FORAY_GETTER_MR(Blas)
         FORAY_PROPERTY_R(Name)
+        /// @brief Model space bounding sphere. xyz: Center, w: Radius. Computed by GeometryStore::InitOrUpdate()
+        FORAY_PROPERTY_V(BoundingSphere)
+        /// @brief Index into the GeometryStore mesh bounds table
+        FORAY_PROPERTY_V(BoundsIndex)
 
       protected:
         std::vector<Primitive> mPrimitives;
         as::Blas               mBlas;
-        std::string            mName = "";
+        std::string            mName           = "";
+        glm::vec4              mBoundingSphere = glm::vec4(0.f);
+        uint32_t               mBoundsIndex    = 0;
     };
 }  // namespace foray::scene
\ No newline at end of file
@@ -3,13 +3,31 @@
 #include "foray_scene.hpp"
 
 namespace foray::scene {
-    ncomp::Transform* Node::GetTransform()
+    void Node::SetParent(Node* parent)
     {
-        return GetComponent<ncomp::Transform>();
+        if(parent == mParent)
+        {
+            return;
+        }
+        for(Node* ancestor = parent; !!ancestor; ancestor = ancestor->GetParent())
+        {
+            Assert(ancestor != this, "Node::SetParent: Cannot attach a node to itself or one of its descendants");
+        }
+        Scene* scene = dynamic_cast<Scene*>(GetCallbackDispatcher());
+        Assert(!!scene, "Node::SetParent: Node is not part of a scene");
+
+        std::vector<Node*>& oldSiblings = !!mParent ? mParent->mChildren : scene->mRootNodes;
+        std::erase(oldSiblings, this);
+        std::vector<Node*>& newSiblings = !!parent ? parent->mChildren : scene->mRootNodes;
+        newSiblings.push_back(this);
+        mParent = parent;
+
+        GetTransform()->SetDirtyRecursively();
+        scene->MarkHierarchyChanged();
     }
 
     Node::Node(Scene* scene, Node* parent) : Registry(scene), mParent(parent)
     {
-        MakeComponent<ncomp::Transform>();
+        mTransform = MakeComponent<ncomp::Transform>();
     }
 }  // namespace foray
\ No newline at end of file
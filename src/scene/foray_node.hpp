@@ -9,11 +9,16 @@ namespace foray::scene {
       public:
         Node(Scene* scene, Node* parent = nullptr);
 
-        FORAY_PROPERTY_V(Parent);
+        FORAY_GETTER_V(Parent);
+        /// @brief Moves the node to the children of parent (or the scenes root nodes, if parent is nullptr)
+        /// @details Marks the transforms of the node and all its descendants dirty and bumps the scenes hierarchy version
+        void SetParent(Node* parent);
         FORAY_PROPERTY_R(Children);
         FORAY_PROPERTY_R(Name);
 
-        ncomp::Transform* GetTransform();
+        /// @brief The nodes transform component, created with the node. Does not use the registry lookup, so it is safe to call concurrently
+        /// @remark The transform component must not be removed from the node
+        inline ncomp::Transform* GetTransform() { return mTransform; }
 
         template <typename TComponent>
         inline int32_t FindChildrenWithComponent(std::vector<Node*>& outnodes);
@@ -27,6 +32,7 @@ namespace foray::scene {
         Node*              mParent   = nullptr;
         std::vector<Node*> mChildren = {};
         std::string mName = "";
+        ncomp::Transform*  mTransform = nullptr;
     };
 
 
@@ -1,11 +1,19 @@
 #include "foray_registry.hpp"
 #include "foray_callbackdispatcher.hpp"
+#include <atomic>
 
 namespace foray::scene {
 
+    uint32_t impl::NextComponentTypeSlot()
+    {
+        static std::atomic<uint32_t> sNextSlot = 0;
+        return sNextSlot.fetch_add(1U);
+    }
+
     void Registry::Register(Component* component)
     {
         mComponents.push_back(component);
+        mTypeSlots.clear();
         RegisterToRoot(component);
         component->mRegistry = this;
     }
@@ -17,6 +25,7 @@ namespace foray::scene {
             if(component == *iter)
             {
                 mComponents.erase(iter);
+                mTypeSlots.clear();
                 UnregisterFromRoot(component);
                 component->mRegistry = nullptr;
                 return true;
@@ -80,6 +89,7 @@ namespace foray::scene {
             delete component;
         }
         mComponents.resize(0);
+        mTypeSlots.clear();
     }
 
 }  // namespace foray
\ No newline at end of file
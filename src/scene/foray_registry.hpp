@@ -3,11 +3,36 @@
 #include "../foray_exception.hpp"
 #include "foray_component.hpp"
 // #include "foray_rootregistry.hpp"
+#include <type_traits>
 #include <vector>
 
 namespace foray::scene {
+    namespace impl {
+        /// @brief Hands out consecutive slot indices, see GetComponentTypeSlot()
+        uint32_t NextComponentTypeSlot();
+    }  // namespace impl
+
+    /// @brief Dense index identifying a component type without RTTI. Assigned on first use (thread safe), const and non-const types share a slot
+    template <typename TComponent>
+    inline uint32_t GetComponentTypeSlot()
+    {
+        if constexpr(!std::is_same_v<TComponent, std::remove_cv_t<TComponent>>)
+        {
+            return GetComponentTypeSlot<std::remove_cv_t<TComponent>>();
+        }
+        else
+        {
+            static const uint32_t slot = impl::NextComponentTypeSlot();
+            return slot;
+        }
+    }
+
     /// @brief Manages a type identified list of components
     /// @remark This class manages lifetime of the attached components
+    /// @details
+    /// GetComponent() results are cached in a table indexed by the queried types slot (GetComponentTypeSlot()), so repeated lookups skip the dynamic_cast scan over all components.
+    /// The table is cleared whenever a component is added or removed. Only the non-const GetComponent() fills the table, the const overload reads it and
+    /// falls back to the scan on a miss, so const lookups may run concurrently.
     class Registry : public NoMoveDefaults
     {
       public:
@@ -66,6 +91,24 @@ namespace foray::scene {
         CallbackDispatcher*     mCallbackDispatcher = nullptr;
         std::vector<Component*> mComponents         = {};
 
+        struct TypeSlot
+        {
+            bool Resolved = false;
+            /// @brief Result of dynamic_cast<TComponent*> (may be nullptr)
+            void* Instance = nullptr;
+        };
+
+        /// @brief GetComponent() results indexed by GetComponentTypeSlot()
+        std::vector<TypeSlot> mTypeSlots = {};
+
+        /// @brief Returns the cached result for TComponent, if resolved
+        template <typename TComponent>
+        inline bool FindCachedComponent(TComponent*& out) const;
+
+        /// @brief Gets first component that can be cast to TComponent type by scanning all components
+        template <typename TComponent>
+        inline TComponent* ScanComponent() const;
+
         void Register(Component* component);
         bool Unregister(Component* component);
 
@@ -114,31 +157,58 @@ namespace foray::scene {
     }
 
     template <typename TComponent>
-    inline TComponent* Registry::GetComponent()
+    inline bool Registry::FindCachedComponent(TComponent*& out) const
+    {
+        const uint32_t slot = GetComponentTypeSlot<TComponent>();
+        if(slot < mTypeSlots.size() && mTypeSlots[slot].Resolved)
+        {
+            out = static_cast<TComponent*>(mTypeSlots[slot].Instance);
+            return true;
+        }
+        return false;
+    }
+
+    template <typename TComponent>
+    inline TComponent* Registry::ScanComponent() const
     {
         for(Component* component : mComponents)
         {
-            auto cast = dynamic_cast<TComponent*>(component);
-            if(cast)
+            TComponent* result = dynamic_cast<TComponent*>(component);
+            if(result)
             {
-                return cast;
+                return result;
             }
         }
         return nullptr;
     }
 
+    template <typename TComponent>
+    inline TComponent* Registry::GetComponent()
+    {
+        TComponent* result = nullptr;
+        if(FindCachedComponent(result))
+        {
+            return result;
+        }
+        result              = ScanComponent<TComponent>();
+        const uint32_t slot = GetComponentTypeSlot<TComponent>();
+        if(slot >= mTypeSlots.size())
+        {
+            mTypeSlots.resize(slot + 1);
+        }
+        mTypeSlots[slot] = TypeSlot{.Resolved = true, .Instance = result};
+        return result;
+    }
+
     template <typename TComponent>
     inline const TComponent* Registry::GetComponent() const
     {
-        for(const Component* component : mComponents)
+        const TComponent* result = nullptr;
+        if(FindCachedComponent(result))
         {
-            auto cast = dynamic_cast<const TComponent*>(component);
-            if(cast)
-            {
-                return cast;
-            }
+            return result;
         }
-        return nullptr;
+        return ScanComponent<const TComponent>();
     }
 
     template <typename TComponent>
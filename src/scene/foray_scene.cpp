@@ -12,9 +12,16 @@ namespace foray::scene {
 
     void Scene::InitDefaultGlobals()
     {
+        if(!mContext)
+        {
+            // Host only scene (node hierarchy and transforms), no device resources
+            MakeComponent<gcomp::TransformSystem>();
+            return;
+        }
         MakeComponent<gcomp::MaterialManager>(mContext);
         MakeComponent<gcomp::GeometryStore>();
         MakeComponent<gcomp::TextureManager>();
+        MakeComponent<gcomp::TransformSystem>();
         MakeComponent<gcomp::DrawDirector>();
         MakeComponent<gcomp::CameraManager>(mContext);
     }
@@ -60,6 +67,7 @@ namespace foray::scene {
         {
             parent->GetChildren().push_back(node);
         }
+        MarkHierarchyChanged();
         return node;
     }
 
@@ -97,6 +105,19 @@ namespace foray::scene {
         lightManager->CreateOrUpdate();
     }
 
+    void Scene::PrepareConcurrentReads(uint32_t reads)
+    {
+        if((reads & Component::UpdateCallback::DATA_TRANSFORMS) == 0)
+        {
+            return;
+        }
+        // Concurrent readers must not trigger the lazy recalculation in Transform::GetGlobalMatrix(). Cheap if the TransformSystem already ran
+        for(Node* rootnode : mRootNodes)
+        {
+            rootnode->GetTransform()->RecalculateIfDirty(true);
+        }
+    }
+
     void Scene::Destroy()
     {
         // Clear Nodes (automatically clears attached components via Node deconstructor, called by the deconstructing unique_ptr)
@@ -105,6 +126,8 @@ namespace foray::scene {
 
         // Clear global components
         Registry::Destroy();
+
+        DisableParallelUpdate();
     }
 
 
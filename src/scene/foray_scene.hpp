@@ -18,6 +18,7 @@ namespace foray::scene {
       public:
         friend Node;
 
+        /// @param context If nullptr, only host side global components (TransformSystem) are created
         explicit Scene(core::Context* context);
 
         /// @brief Generates a new node and attaches it to the parent if it is set, root otherwise
@@ -41,6 +42,10 @@ namespace foray::scene {
         FORAY_PROPERTY_R(NodeBuffer)
         FORAY_PROPERTY_R(RootNodes)
         FORAY_PROPERTY_V(Context)
+        /// @brief Incremented whenever nodes are added or reparented. Used by TransformSystem to detect a stale flattened hierarchy
+        FORAY_GETTER_V(HierarchyVersion)
+        /// @brief Call after modifying GetRootNodes() or Node::GetChildren() directly
+        inline void MarkHierarchyChanged() { mHierarchyVersion++; }
 
         template <typename TComponent>
         int32_t FindComponents(std::vector<TComponent*>& outcomponents);
@@ -63,8 +68,12 @@ namespace foray::scene {
 
         /// @brief All nodes directly attached to the root
         std::vector<Node*> mRootNodes;
+        uint64_t           mHierarchyVersion = 0;
 
         void InitDefaultGlobals();
+
+        /// @brief Recalculates all dirty global matrices if the wave reads DATA_TRANSFORMS
+        virtual void PrepareConcurrentReads(uint32_t reads) override;
     };
 
     template <typename TComponent>
@@ -18,6 +18,7 @@ namespace foray::scene {
         class MaterialManager;
         class TextureManager;
         class AnimationManager;
+        class TransformSystem;
     }  // namespace gcomp
     struct SceneDrawInfo;
     class Animation;
@@ -13,12 +13,20 @@ namespace foray::scene {
       public:
         uint32_t TransformBufferOffset = 0;
         int32_t  MaterialIndex         = -1;
+        /// @brief If non-zero, shaders read the material index from the draw material buffer (indexed by gl_DrawID) instead of MaterialIndex
+        uint32_t IndirectDraw = 0;
+        /// @brief Index of the first matrix of the current frames transform set in the transform buffer
+        uint32_t CurrentTransformBase = 0;
+        /// @brief Index of the first matrix of the previous frames transform set in the transform buffer
+        uint32_t PreviousTransformBase = 0;
 
         inline static VkShaderStageFlags  GetShaderStageFlags();
         inline static VkPushConstantRange GetPushConstantRange();
 
         inline void CmdPushConstant_TransformBufferOffset(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t transformBufferOffset);
         inline void CmdPushConstant_MaterialIndex(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int32_t materialIndex);
+        inline void CmdPushConstant_IndirectDraw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, bool indirectDraw);
+        inline void CmdPushConstant_TransformBases(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentBase, uint32_t previousBase);
     };
 
     inline VkShaderStageFlags DrawPushConstant::GetShaderStageFlags()
@@ -43,6 +51,18 @@ namespace foray::scene {
         vkCmdPushConstants(commandBuffer, pipelineLayout, DrawPushConstant::GetShaderStageFlags(), offsetof(DrawPushConstant, MaterialIndex), sizeof(MaterialIndex),
                            &MaterialIndex);
     }
+    inline void DrawPushConstant::CmdPushConstant_IndirectDraw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, bool indirectDraw)
+    {
+        IndirectDraw = indirectDraw ? 1U : 0U;
+        vkCmdPushConstants(commandBuffer, pipelineLayout, DrawPushConstant::GetShaderStageFlags(), offsetof(DrawPushConstant, IndirectDraw), sizeof(IndirectDraw), &IndirectDraw);
+    }
+    inline void DrawPushConstant::CmdPushConstant_TransformBases(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentBase, uint32_t previousBase)
+    {
+        CurrentTransformBase  = currentBase;
+        PreviousTransformBase = previousBase;
+        vkCmdPushConstants(commandBuffer, pipelineLayout, DrawPushConstant::GetShaderStageFlags(), offsetof(DrawPushConstant, CurrentTransformBase),
+                           sizeof(CurrentTransformBase) + sizeof(PreviousTransformBase), &CurrentTransformBase);
+    }
 
     /// @brief Temporary type passed to components when updating the scene
     struct SceneUpdateInfo
@@ -72,6 +92,8 @@ namespace foray::scene {
 
         inline void CmdPushConstant_TransformBufferOffset(uint32_t transformBufferOffset);
         inline void CmdPushConstant_MaterialIndex(int32_t materialIndex);
+        inline void CmdPushConstant_IndirectDraw(bool indirectDraw);
+        inline void CmdPushConstant_TransformBases(uint32_t currentBase, uint32_t previousBase);
     };
 
     void SceneDrawInfo::CmdPushConstant_TransformBufferOffset(uint32_t transformBufferOffset)
@@ -84,12 +106,24 @@ namespace foray::scene {
         PushConstantState.CmdPushConstant_MaterialIndex(CmdBuffer, PipelineLayout, materialIndex);
     }
 
+    void SceneDrawInfo::CmdPushConstant_IndirectDraw(bool indirectDraw)
+    {
+        PushConstantState.CmdPushConstant_IndirectDraw(CmdBuffer, PipelineLayout, indirectDraw);
+    }
+
+    void SceneDrawInfo::CmdPushConstant_TransformBases(uint32_t currentBase, uint32_t previousBase)
+    {
+        PushConstantState.CmdPushConstant_TransformBases(CmdBuffer, PipelineLayout, currentBase, previousBase);
+    }
+
     SceneDrawInfo::SceneDrawInfo(const base::FrameRenderInfo& renderInfo, VkPipelineLayout pipelineLayout, base::CmdBufferIndex index)
 
         : RenderInfo(renderInfo), CmdBuffer(renderInfo.GetCommandBuffer(index)), PipelineLayout(pipelineLayout), PushConstantState()
     {
         CmdPushConstant_TransformBufferOffset(0);
         CmdPushConstant_MaterialIndex(-1);
+        CmdPushConstant_IndirectDraw(false);
+        CmdPushConstant_TransformBases(0, 0);
     }
 
     SceneDrawInfo::SceneDrawInfo(const base::FrameRenderInfo& renderInfo, VkPipelineLayout pipelineLayout, VkCommandBuffer cmdBuffer)
@@ -98,5 +132,7 @@ namespace foray::scene {
     {
         CmdPushConstant_TransformBufferOffset(0);
         CmdPushConstant_MaterialIndex(-1);
+        CmdPushConstant_IndirectDraw(false);
+        CmdPushConstant_TransformBases(0, 0);
     }
 }  // namespace foray::scene
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "foray_animationmanager.hpp"
+#include "../../util/foray_workerpool.hpp"
 
 namespace foray::scene::gcomp {
     void AnimationManager::Update(SceneUpdateInfo& updateInfo)
@@ -8,9 +9,24 @@ namespace foray::scene::gcomp {
             base::FrameRenderInfo animationUpdateInfo(updateInfo.RenderInfo);
             animationUpdateInfo.SetFrameTime(animationUpdateInfo.GetFrameTime() * mPlaybackConfig.PlaybackSpeed);
 
-            for(auto& animation : mAnimations)
+            if(!!mWorkerPool && mAnimations.size() > 1)
             {
-                animation.Update(animationUpdateInfo);
+                mWorkerPool->ParallelFor(mAnimations.size(), [&](size_t index) {
+                    Animation& animation = mAnimations[index];
+                    animation.Advance(animationUpdateInfo);
+                    animation.Sample();
+                });
+                for(auto& animation : mAnimations)
+                {
+                    animation.Apply();
+                }
+            }
+            else
+            {
+                for(auto& animation : mAnimations)
+                {
+                    animation.Update(animationUpdateInfo);
+                }
             }
         }
     }
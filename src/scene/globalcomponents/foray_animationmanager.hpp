@@ -1,5 +1,6 @@
 #pragma once
 #include "../../foray_glm.hpp"
+#include "../../util/foray_util_declares.hpp"
 #include "../foray_animation.hpp"
 #include "../foray_component.hpp"
 #include <vector>
@@ -7,18 +8,27 @@
 namespace foray::scene::gcomp {
 
     /// @brief Handles storage and playback of animations
+    /// @details
+    /// If a WorkerPool is set, animations are advanced and sampled in parallel (one animation per task). Sampled values are staged per animation and
+    /// applied to the transforms in a single serial pass afterwards, so transform dirty flags are only ever written by the calling thread.
     class AnimationManager : public GlobalComponent, public Component::UpdateCallback
     {
       public:
         FORAY_PROPERTY_R(Animations)
         FORAY_PROPERTY_R(PlaybackConfig)
+        /// @brief Optional worker pool for evaluating animations in parallel. Not owned
+        FORAY_PROPERTY_V(WorkerPool)
 
         virtual void Update(SceneUpdateInfo&) override;
 
         virtual int32_t GetOrder() const override { return 0; }
+        virtual uint32_t GetUpdateReads() const override { return DATA_ANIMATIONS; }
+        virtual uint32_t GetUpdateWrites() const override { return DATA_ANIMATIONS | DATA_TRANSFORMS; }
+        virtual bool     GetUpdateRecordsCommands() const override { return false; }
 
       protected:
         std::vector<Animation> mAnimations;
         PlaybackConfig         mPlaybackConfig;
+        util::WorkerPool*      mWorkerPool = nullptr;
     };
 }  // namespace foray
\ No newline at end of file
@@ -2,13 +2,18 @@
 #include "../components/foray_camera.hpp"
 #include "../components/foray_meshinstance.hpp"
 #include "../components/foray_transform.hpp"
+#include "../foray_mesh.hpp"
 #include "../foray_node.hpp"
 #include "../foray_scene.hpp"
 #include "../globalcomponents/foray_geometrymanager.hpp"
+#include "../../bench/foray_hostbenchmark.hpp"
+#include <algorithm>
 #include <map>
 #include <spdlog/fmt/fmt.h>
 
 namespace foray::scene::gcomp {
+    static_assert(sizeof(DrawDirector::TransformBufferHeader) == sizeof(glm::mat4), "Transform buffer header must match the header in transformbuffer.glsl");
+
     void DrawDirector::InitOrUpdate()
     {
         auto scene = GetScene();
@@ -46,88 +51,268 @@ namespace foray::scene::gcomp {
             mDrawOps.push_back(std::move(drawop));
         }
 
-        VkDeviceSize maxcount = mCurrentTransformBuffer.GetDeviceBuffer().GetSize() / sizeof(glm::mat4);
-
-        if(maxcount < mTotalCount)
+        if(mTransformCapacity < mTotalCount)
         {
             DestroyBuffers();
             CreateBuffers(mTotalCount);
         }
+
+        CacheTransforms();
+        UpdateIndirectBuffers();
+    }
+
+    void DrawDirector::UpdateIndirectBuffers()
+    {
+        std::vector<VkDrawIndexedIndirectCommand> commands;
+        std::vector<int32_t>                      materialIndices;
+        mHasNonIndexedPrimitives = false;
+
+        for(const DrawOp& drawop : mDrawOps)
+        {
+            for(const Primitive& primitive : drawop.Target->GetPrimitives())
+            {
+                if(!primitive.IsValid())
+                {
+                    continue;
+                }
+                if(primitive.Type != Primitive::EType::Index)
+                {
+                    mHasNonIndexedPrimitives = true;
+                    continue;
+                }
+                commands.push_back(VkDrawIndexedIndirectCommand{.indexCount    = primitive.VertexOrIndexCount,
+                                                                .instanceCount = (uint32_t)drawop.Instances.size(),
+                                                                .firstIndex    = primitive.First,
+                                                                .vertexOffset  = 0,
+                                                                .firstInstance = drawop.TransformOffset});
+                materialIndices.push_back(primitive.MaterialIndex);
+            }
+        }
+
+        mIndirectDrawCount = (uint32_t)commands.size();
+
+        // Buffers are always created (at least one element), as descriptor sets reference the draw material buffer in both draw modes
+        size_t capacity = mDrawMaterialBuffer.Exists() ? mDrawMaterialBuffer.GetSize() / sizeof(int32_t) : 0;
+        if(capacity < std::max<size_t>(commands.size(), 1))
+        {
+            size_t count = std::max<size_t>(commands.size(), 1);
+            count += count / 4;  // Add a bit of extra capacity
+
+            mIndirectCommandBuffer.Destroy();
+            mDrawMaterialBuffer.Destroy();
+            // Transfer source: GPU culling results may be read back for inspection
+            core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                                                   | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                               count * sizeof(VkDrawIndexedIndirectCommand), VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Indirect Draw Commands");
+            mIndirectCommandBuffer.Create(GetContext(), ci);
+            ci = core::ManagedBuffer::CreateInfo(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, count * sizeof(int32_t),
+                                                 VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Draw Material Indices");
+            mDrawMaterialBuffer.Create(GetContext(), ci);
+        }
+        if(!mIndirectCountBuffer.Exists())
+        {
+            core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, sizeof(uint32_t),
+                                               VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Indirect Draw Count");
+            mIndirectCountBuffer.Create(GetContext(), ci);
+        }
+
+        // Per instance data: Identity transform mapping, and bounds + draw op for culling
+        std::vector<uint32_t>         drawInstances(mTotalCount);
+        std::vector<InstanceCullInfo> cullInfos(mTotalCount);
+        for(const DrawOp& drawop : mDrawOps)
+        {
+            for(uint32_t i = 0; i < drawop.Instances.size(); i++)
+            {
+                uint32_t transformIndex       = drawop.TransformOffset + i;
+                drawInstances[transformIndex] = transformIndex;
+                cullInfos[transformIndex]     = InstanceCullInfo{.BoundsIndex = drawop.Target->GetBoundsIndex(), .FirstInstance = drawop.TransformOffset};
+            }
+        }
+
+        size_t instanceCapacity = mDrawInstanceBuffer.Exists() ? mDrawInstanceBuffer.GetSize() / sizeof(uint32_t) : 0;
+        if(instanceCapacity < std::max<size_t>(mTotalCount, 1))
+        {
+            size_t count = std::max<size_t>(mTotalCount, 1);
+            count += count / 4;  // Add a bit of extra capacity
+
+            mDrawInstanceBuffer.Destroy();
+            mInstanceCullInfoBuffer.Destroy();
+            core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, count * sizeof(uint32_t),
+                                               VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Draw Instances");
+            mDrawInstanceBuffer.Create(GetContext(), ci);
+            ci = core::ManagedBuffer::CreateInfo(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, count * sizeof(InstanceCullInfo),
+                                                 VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Instance Cull Infos");
+            mInstanceCullInfoBuffer.Create(GetContext(), ci);
+        }
+
+        if(mTotalCount > 0)
+        {
+            mDrawInstanceBuffer.WriteDataDeviceLocal(drawInstances.data(), drawInstances.size() * sizeof(uint32_t));
+            mInstanceCullInfoBuffer.WriteDataDeviceLocal(cullInfos.data(), cullInfos.size() * sizeof(InstanceCullInfo));
+        }
+        if(commands.size() > 0)
+        {
+            mIndirectCommandBuffer.WriteDataDeviceLocal(commands.data(), commands.size() * sizeof(VkDrawIndexedIndirectCommand));
+            mDrawMaterialBuffer.WriteDataDeviceLocal(materialIndices.data(), materialIndices.size() * sizeof(int32_t));
+        }
+        mIndirectCountBuffer.WriteDataDeviceLocal(&mIndirectDrawCount, sizeof(uint32_t));
+    }
+
+    void DrawDirector::CacheTransforms()
+    {
+        mTransformStates.resize(mTotalCount);
+        mOutdatedSets.assign(mTotalCount, 0);
+        mDynamicTransforms.clear();
+        mDynamicIndices.clear();
+        for(std::vector<uint32_t>& outdated : mOutdatedIndices)
+        {
+            outdated.clear();
+            outdated.reserve(mTotalCount);
+        }
+
+        for(const DrawOp& drawop : mDrawOps)
+        {
+            for(uint32_t i = 0; i < drawop.Instances.size(); i++)
+            {
+                uint32_t          transformIndex = drawop.TransformOffset + i;
+                Node*             node           = drawop.Instances[i]->GetNode();
+                ncomp::Transform* transform      = node->GetTransform();
+
+                mTransformStates[transformIndex] = transform->GetGlobalMatrix();
+                MarkOutdated(transformIndex);
+
+                // A static transform may still move with a non-static ancestor
+                bool isStatic = true;
+                for(Node* ancestor = node; !!ancestor && isStatic; ancestor = ancestor->GetParent())
+                {
+                    isStatic = ancestor->GetTransform()->GetStatic();
+                }
+                if(!isStatic)
+                {
+                    mDynamicTransforms.push_back(transform);
+                    mDynamicIndices.push_back(transformIndex);
+                }
+            }
+        }
+    }
+
+    void DrawDirector::MarkOutdated(uint32_t transformIndex)
+    {
+        for(uint32_t set = 0; set < 2; set++)
+        {
+            uint8_t bit = (uint8_t)(1U << set);
+            if((mOutdatedSets[transformIndex] & bit) == 0)
+            {
+                mOutdatedSets[transformIndex] |= bit;
+                mOutdatedIndices[set].push_back(transformIndex);
+            }
+        }
     }
 
     void DrawDirector::CreateBuffers(size_t transformCount)
     {
-        VkDeviceSize size = transformCount * sizeof(glm::mat4);
-        size += size / 4;  // Add a bit of extra capacity
+        mTransformCapacity = (uint32_t)(transformCount + transformCount / 4);  // Add a bit of extra capacity
 
         core::ManagedBuffer::CreateInfo ci(VkBufferUsageFlagBits::VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_DST_BIT
-                                                            | VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                                        size, VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Current Transforms");
-        mCurrentTransformBuffer.Create(GetContext(), ci);
-        ci.Name = "Previous Transforms";
-        mPreviousTransformBuffer.Create(GetContext(), ci);
+                                               | VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                           sizeof(TransformBufferHeader) + std::max<VkDeviceSize>(mTransformCapacity, 1) * 2 * sizeof(glm::mat4),
+                                           VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0,
+                                           "Transforms");
+        mTransformBuffer.Create(GetContext(), ci);
     }
     void DrawDirector::DestroyBuffers()
     {
-        mCurrentTransformBuffer.Destroy();
-        mPreviousTransformBuffer.Destroy();
+        mTransformBuffer.Destroy();
+        mTransformCapacity = 0;
     }
 
     void DrawDirector::Update(SceneUpdateInfo& updateInfo)
     {
-        VkCommandBuffer cmdBuffer = updateInfo.CmdBuffer;
-
-        VkDeviceSize bufferSize = sizeof(glm::mat4) * mTotalCount;
-
-        // Transfer previous frames transform buffer state to mPreviousTransformBuffer
-        VkBufferMemoryBarrier prevTransformBufferBarrier{.sType               = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-                                                         .srcAccessMask       = VkAccessFlagBits::VK_ACCESS_SHADER_READ_BIT,
-                                                         .dstAccessMask       = VkAccessFlagBits::VK_ACCESS_TRANSFER_WRITE_BIT,
-                                                         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                                         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                                         .buffer              = mPreviousTransformBuffer.GetBuffer(),
-                                                         .offset              = 0,
-                                                         .size                = bufferSize};
-        VkBufferMemoryBarrier currTransformBufferBarrier{.sType               = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-                                                         .srcAccessMask       = VkAccessFlagBits::VK_ACCESS_SHADER_READ_BIT,
-                                                         .dstAccessMask       = VkAccessFlagBits::VK_ACCESS_TRANSFER_READ_BIT,
-                                                         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                                         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                                         .buffer              = mPreviousTransformBuffer.GetBuffer(),
-                                                         .offset              = 0,
-                                                         .size                = bufferSize};
+        if(!!mBenchmark)
+        {
+            mBenchmark->Begin();
+        }
 
-        std::vector<VkBufferMemoryBarrier> memBarriers{prevTransformBufferBarrier, currTransformBufferBarrier};
+        // The set written two frames ago becomes current, last frames set becomes previous
+        mCurrentTransformSet ^= 1U;
 
-        vkCmdPipelineBarrier(cmdBuffer, VkPipelineStageFlagBits::VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VkDependencyFlagBits::VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, memBarriers.size(), memBarriers.data(), 0, nullptr);
+        // STEP #1    Detect changed matrices. Changed matrices are outdated in both sets
 
-        VkBufferCopy copyRegion{.srcOffset = 0, .dstOffset = 0, .size = bufferSize};
-        vkCmdCopyBuffer(cmdBuffer, mCurrentTransformBuffer.GetDeviceBuffer().GetBuffer(), mPreviousTransformBuffer.GetBuffer(), 1, &copyRegion);
+        for(size_t i = 0; i < mDynamicIndices.size(); i++)
+        {
+            uint32_t         transformIndex = mDynamicIndices[i];
+            const glm::mat4& matrix         = mDynamicTransforms[i]->GetGlobalMatrix();
+            if(matrix != mTransformStates[transformIndex])
+            {
+                mTransformStates[transformIndex] = matrix;
+                MarkOutdated(transformIndex);
+            }
+        }
 
-        prevTransformBufferBarrier.srcAccessMask = VkAccessFlagBits::VK_ACCESS_TRANSFER_WRITE_BIT;
-        prevTransformBufferBarrier.dstAccessMask = VkAccessFlagBits::VK_ACCESS_SHADER_READ_BIT;
+        if(!!mBenchmark)
+        {
+            mBenchmark->LogTimestamp(BENCH_DETECT);
+        }
 
-        vkCmdPipelineBarrier(cmdBuffer, VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TRANSFER_BIT, VkPipelineStageFlagBits::VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
-                             VkDependencyFlagBits::VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 1, &prevTransformBufferBarrier, 0, nullptr);
+        // STEP #2    Stage the header and outdated matrices of the current set, merging consecutive transform indices into a single section
 
-        // Get transform state, upload
+        std::vector<uint32_t>& outdated   = mOutdatedIndices[mCurrentTransformSet];
+        const uint8_t          setBit     = (uint8_t)(1U << mCurrentTransformSet);
+        const uint32_t         frameIndex = (uint32_t)updateInfo.RenderInfo.GetFrameNumber();
+        const uint32_t         setBase    = GetCurrentTransformBase();
+        const size_t           uploadCount = outdated.size();
 
-        std::vector<glm::mat4> transformStates(mTotalCount);
+        TransformBufferHeader header{.CurrentTransformBase = setBase, .PreviousTransformBase = GetPreviousTransformBase()};
+        mTransformBuffer.StageSection(frameIndex, &header, 0, sizeof(header));
 
-        for(auto& drawop : mDrawOps)
+        std::sort(outdated.begin(), outdated.end());
+        for(size_t begin = 0; begin < outdated.size();)
         {
-            for(uint32_t i = 0; i < drawop.Instances.size(); i++)
+            size_t end = begin + 1;
+            while(end < outdated.size() && outdated[end] == outdated[end - 1] + 1)
             {
-                auto& transformState = transformStates[drawop.TransformOffset + i];
-                auto  transform      = drawop.Instances[i]->GetNode()->GetComponent<ncomp::Transform>();
-                transformState       = transform->GetGlobalMatrix();
+                end++;
             }
+            uint32_t first = outdated[begin];
+            mTransformBuffer.StageSection(frameIndex, &mTransformStates[first], sizeof(TransformBufferHeader) + (setBase + first) * sizeof(glm::mat4),
+                                          (end - begin) * sizeof(glm::mat4));
+            begin = end;
+        }
+        for(uint32_t transformIndex : outdated)
+        {
+            mOutdatedSets[transformIndex] &= ~setBit;
+        }
+        outdated.clear();
+
+        if(!!mBenchmark)
+        {
+            mBenchmark->LogTimestamp(BENCH_STAGE);
+        }
+
+        // STEP #3    Record the copy
+
+        mTransformBuffer.CmdCopyToDevice(frameIndex, updateInfo.CmdBuffer);
+
+        if(!!mBenchmark)
+        {
+            mBenchmark->LogTimestamp(BENCH_RECORD);
+            mBenchmark->LogValue(BENCH_UPLOADCOUNT, (fp64_t)uploadCount);
+            mBenchmark->End();
         }
+    }
 
-        mCurrentTransformBuffer.StageSection(updateInfo.RenderInfo.GetFrameNumber(), transformStates.data(), 0, transformStates.size() * sizeof(glm::mat4));
+    bool DrawDirector::IsIndirectDrawSupported(const core::Context* context)
+    {
+        if(!context->EnabledVulkan11Features || !context->EnabledVulkan11Features->shaderDrawParameters)
+        {
+            return false;
+        }
+        return IsIndirectDrawCountSupported(context) || (!!context->EnabledFeatures && context->EnabledFeatures->multiDrawIndirect);
+    }
 
-        mCurrentTransformBuffer.CmdCopyToDevice(updateInfo.RenderInfo.GetFrameNumber(), cmdBuffer);
+    bool DrawDirector::IsIndirectDrawCountSupported(const core::Context* context)
+    {
+        return !!context->EnabledVulkan12Features && context->EnabledVulkan12Features->drawIndirectCount;
     }
 
     void DrawDirector::Draw(SceneDrawInfo& drawInfo)
@@ -138,10 +323,51 @@ namespace foray::scene::gcomp {
             mGeo->CmdBindBuffers(drawInfo.CmdBuffer);
         }
 
-        for(auto& drawop : mDrawOps)
+        drawInfo.CmdPushConstant_TransformBases(GetCurrentTransformBase(), GetPreviousTransformBase());
+
+        if(!mUseIndirectDraw || !IsIndirectDrawSupported(GetContext()))
+        {
+            for(auto& drawop : mDrawOps)
+            {
+                drawInfo.CmdPushConstant_TransformBufferOffset(drawop.TransformOffset);
+                drawop.Target->CmdDrawInstanced(drawInfo, drawop.Instances.size());
+            }
+            return;
+        }
+
+        if(mIndirectDrawCount > 0)
+        {
+            // Transform offsets are encoded in firstInstance
+            drawInfo.CmdPushConstant_TransformBufferOffset(0);
+            drawInfo.CmdPushConstant_IndirectDraw(true);
+            if(IsIndirectDrawCountSupported(GetContext()))
+            {
+                GetContext()->VkbDispatchTable->cmdDrawIndexedIndirectCount(drawInfo.CmdBuffer, mIndirectCommandBuffer.GetBuffer(), 0, mIndirectCountBuffer.GetBuffer(), 0,
+                                                                            mIndirectDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+            }
+            else
+            {
+                // The command count is known on the host, the count buffer is only a GPU side copy of it
+                GetContext()->VkbDispatchTable->cmdDrawIndexedIndirect(drawInfo.CmdBuffer, mIndirectCommandBuffer.GetBuffer(), 0, mIndirectDrawCount,
+                                                                       sizeof(VkDrawIndexedIndirectCommand));
+            }
+            drawInfo.CmdPushConstant_IndirectDraw(false);
+        }
+
+        if(mHasNonIndexedPrimitives)
         {
-            drawInfo.CmdPushConstant_TransformBufferOffset(drawop.TransformOffset);
-            drawop.Target->CmdDrawInstanced(drawInfo, drawop.Instances.size());
+            for(auto& drawop : mDrawOps)
+            {
+                drawInfo.CmdPushConstant_TransformBufferOffset(drawop.TransformOffset);
+                for(Primitive& primitive : drawop.Target->GetPrimitives())
+                {
+                    if(primitive.Type == Primitive::EType::Vertex)
+                    {
+                        drawInfo.CmdPushConstant_MaterialIndex(primitive.MaterialIndex);
+                        primitive.CmdDrawInstanced(drawInfo.CmdBuffer, drawop.Instances.size());
+                    }
+                }
+            }
         }
     }
 }  // namespace foray::scene::gcomp
\ No newline at end of file
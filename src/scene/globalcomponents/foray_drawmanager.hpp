@@ -1,6 +1,8 @@
 #pragma once
+#include "../../bench/foray_bench_declares.hpp"
 #include "../../util/foray_dualbuffer.hpp"
 #include "../foray_component.hpp"
+#include <array>
 
 namespace foray::scene::gcomp {
 
@@ -15,42 +17,154 @@ namespace foray::scene::gcomp {
     };
 
     /// @brief Manages a collection of mesh instances, current and previous model matrices
+    /// @details
+    /// Current and previous model matrices are stored in two sets (halves) of a single transform buffer. Every Update() swaps which set is current,
+    /// so the previous frames matrices remain in place instead of being copied. Shaders index the buffer with Get(Current|Previous)TransformBase() + transform index
+    /// (passed via DrawPushConstant by Draw()). Both bases are also written to a header at the start of the buffer (TransformBufferHeader), which
+    /// GetCurrentTransform() / GetPreviousTransform() in common/transformbuffer.glsl read, so shaders outside of Draw() (ray tracing, custom stages) need no push constant.
+    /// Only matrices which changed since a set was last written are staged and uploaded. Instances whose transform and all ancestor transforms are static are never checked again after InitOrUpdate().
     class DrawDirector : public GlobalComponent, public Component::UpdateCallback, public Component::DrawCallback
     {
       public:
+        inline static const char* BENCH_DETECT      = "Detect Changes";
+        inline static const char* BENCH_STAGE       = "Stage";
+        inline static const char* BENCH_RECORD      = "Record";
+        inline static const char* BENCH_UPLOADCOUNT = "Uploaded Transforms";
+
         inline DrawDirector() {}
 
         /// @brief Collects mesh instances and rebuilds transform buffers
         void InitOrUpdate();
 
         virtual int32_t GetOrder() const override { return ORDER_TRANSFORM; }
+        virtual uint32_t GetUpdateReads() const override { return DATA_TRANSFORMS; }
+        virtual uint32_t GetUpdateWrites() const override { return DATA_DRAWDATA; }
 
-        /// @brief Updates and uploads transform buffers
+        /// @brief Swaps current and previous transform set, uploads changed transforms to the current set
         virtual void Update(SceneUpdateInfo&) override;
         /// @brief Draws the scene using the currently bound pipeline and renderpass. Vertex and Index buffers must be bound
+        /// @details If UseIndirectDraw is set and supported, all indexed primitives are drawn with a single vkCmdDrawIndexedIndirectCount call.
+        /// Without the drawIndirectCount feature, vkCmdDrawIndexedIndirect with multiDrawIndirect is used instead. If neither is enabled (or shaderDrawParameters is not),
+        /// Draw() falls back to one draw per primitive from the CPU.
         virtual void Draw(SceneDrawInfo&) override;
 
-        FORAY_GETTER_CR(CurrentTransformBuffer)
-        FORAY_GETTER_CR(PreviousTransformBuffer)
+        /// @brief Header at the start of the transform buffer, padded to the size of one matrix. Matrices follow it
+        struct TransformBufferHeader
+        {
+            uint32_t CurrentTransformBase  = 0;
+            uint32_t PreviousTransformBase = 0;
+            uint32_t Padding[14]           = {};
+        };
+
+        FORAY_GETTER_CR(TransformBuffer)
+
+        /// @brief Transform buffer, containing the header and both current and previous transform sets
+        inline VkDescriptorBufferInfo GetTransformsDescriptorInfo() const { return mTransformBuffer.GetDeviceBuffer().GetVkDescriptorBufferInfo(); }
+        inline VkBuffer               GetTransformsVkBuffer() const { return mTransformBuffer.GetDeviceBuffer().GetBuffer(); }
 
-        inline VkDescriptorBufferInfo GetCurrentTransformsDescriptorInfo() const { return mCurrentTransformBuffer.GetDeviceBuffer().GetVkDescriptorBufferInfo(); }
-        inline VkDescriptorBufferInfo GetPreviousTransformsDescriptorInfo() const { return mPreviousTransformBuffer.GetVkDescriptorBufferInfo(); }
-        inline VkBuffer               GetCurrentTransformsVkBuffer() const { return mCurrentTransformBuffer.GetDeviceBuffer().GetBuffer(); }
-        inline VkBuffer               GetPreviousTransformsVkBuffer() const { return mPreviousTransformBuffer.GetBuffer(); }
+        /// @brief Former separate current / previous transform buffers. Both now refer to the shared transform buffer, which transformbuffer.glsl resolves via its header
+        /// (BIND_TRANSFORMBUFFER_CURRENT / _PREVIOUS and GetCurrentTransform() / GetPreviousTransform() remain available)
+        inline const util::DualBuffer&    GetCurrentTransformBuffer() const { return mTransformBuffer; }
+        inline const core::ManagedBuffer& GetPreviousTransformBuffer() const { return mTransformBuffer.GetDeviceBuffer(); }
+        inline VkDescriptorBufferInfo     GetCurrentTransformsDescriptorInfo() const { return GetTransformsDescriptorInfo(); }
+        inline VkDescriptorBufferInfo     GetPreviousTransformsDescriptorInfo() const { return GetTransformsDescriptorInfo(); }
+        inline VkBuffer                   GetCurrentTransformsVkBuffer() const { return GetTransformsVkBuffer(); }
+        inline VkBuffer                   GetPreviousTransformsVkBuffer() const { return GetTransformsVkBuffer(); }
+        /// @brief Index of the first matrix of the current frames transform set
+        inline uint32_t GetCurrentTransformBase() const { return mCurrentTransformSet * mTransformCapacity; }
+        /// @brief Index of the first matrix of the previous frames transform set
+        inline uint32_t GetPreviousTransformBase() const { return (mCurrentTransformSet ^ 1U) * mTransformCapacity; }
 
         FORAY_GETTER_V(TotalCount)
+        /// @brief Draw ops of the most recent InitOrUpdate(). Instance i of a draw op uses transform index TransformOffset + i
+        FORAY_GETTER_CR(DrawOps)
+
+        /// @brief If set, Draw() uses the indirect command buffer instead of issuing one draw per primitive from the CPU
+        /// @details The transform buffer offset is passed via firstInstance. Shaders resolve the transform index via the draw instance buffer (indexed by gl_InstanceIndex),
+        /// the material index via the draw material buffer indexed by gl_DrawID (both signalled by DrawPushConstant::IndirectDraw).
+        FORAY_PROPERTY_V(UseIndirectDraw)
+        /// @brief True, if the device features required by indirect draws (shaderDrawParameters, and drawIndirectCount or multiDrawIndirect) are enabled in the context
+        static bool IsIndirectDrawSupported(const core::Context* context);
+        /// @brief True, if the drawIndirectCount feature is enabled in the context
+        static bool IsIndirectDrawCountSupported(const core::Context* context);
+        FORAY_GETTER_CR(IndirectCommandBuffer)
+        FORAY_GETTER_CR(IndirectCountBuffer)
+        /// @brief Number of commands in the indirect command buffer
+        FORAY_GETTER_V(IndirectDrawCount)
+
+        /// @brief Optional benchmark timing Update(). See static BENCH_... members for timestamps
+        FORAY_PROPERTY_V(Benchmark)
+
+        FORAY_GETTER_CR(DrawInstanceBuffer)
+        FORAY_GETTER_CR(InstanceCullInfoBuffer)
+
+        /// @brief Material index (int32) per indirect draw command
+        inline VkDescriptorBufferInfo GetDrawMaterialIndicesDescriptorInfo() const { return mDrawMaterialBuffer.GetVkDescriptorBufferInfo(); }
+        /// @brief Transform index (uint32) per instance slot of indirect draws
+        inline VkDescriptorBufferInfo GetDrawInstancesDescriptorInfo() const { return mDrawInstanceBuffer.GetVkDescriptorBufferInfo(); }
+        /// @brief InstanceCullInfo per transform
+        inline VkDescriptorBufferInfo GetInstanceCullInfoDescriptorInfo() const { return mInstanceCullInfoBuffer.GetVkDescriptorBufferInfo(); }
+        inline VkDescriptorBufferInfo GetIndirectCommandsDescriptorInfo() const { return mIndirectCommandBuffer.GetVkDescriptorBufferInfo(); }
+
+        /// @brief Per transform input to GPU culling (see stages::FrustumCullingStage)
+        struct InstanceCullInfo
+        {
+            /// @brief Index into the GeometryStore mesh bounds table
+            uint32_t BoundsIndex = 0;
+            /// @brief TransformOffset of the draw op the instance belongs to (= firstInstance of its indirect draw commands)
+            uint32_t FirstInstance = 0;
+        };
 
       protected:
-        util::DualBuffer    mCurrentTransformBuffer;
-        core::ManagedBuffer mPreviousTransformBuffer;
+        /// @brief Two sets of mTransformCapacity matrices each
+        util::DualBuffer mTransformBuffer;
+        /// @brief Matrices per transform set
+        uint32_t mTransformCapacity = 0;
+        /// @brief Set (0 or 1) written by the most recent Update()
+        uint32_t mCurrentTransformSet = 0;
+
+        /// @brief Host side copy of the most recent global matrix per transform index
+        std::vector<glm::mat4> mTransformStates;
+        /// @brief Transforms of instances which may change (not static up to the root), parallel to mDynamicIndices
+        std::vector<ncomp::Transform*> mDynamicTransforms;
+        /// @brief Transform indices of instances which may change, ascending
+        std::vector<uint32_t> mDynamicIndices;
+        /// @brief Per transform index bitmask of transform sets which hold an outdated matrix
+        std::vector<uint8_t> mOutdatedSets;
+        /// @brief Per transform set list of transform indices with an outdated matrix
+        std::array<std::vector<uint32_t>, 2> mOutdatedIndices;
+
+        bench::HostBenchmark* mBenchmark = nullptr;
+
+        /// @brief VkDrawIndexedIndirectCommand per indexed primitive of all draw ops
+        core::ManagedBuffer mIndirectCommandBuffer;
+        /// @brief Single uint32 draw count, consumed by vkCmdDrawIndexedIndirectCount
+        core::ManagedBuffer mIndirectCountBuffer;
+        /// @brief int32 material index per indirect draw command
+        core::ManagedBuffer mDrawMaterialBuffer;
+        /// @brief uint32 transform index per instance slot. Identity unless rewritten by GPU culling, which compacts visible instances of each draw op to its front
+        core::ManagedBuffer mDrawInstanceBuffer;
+        /// @brief InstanceCullInfo per transform
+        core::ManagedBuffer mInstanceCullInfoBuffer;
 
         void CreateBuffers(size_t transformCount);
         void DestroyBuffers();
+        /// @brief Caches transform pointers and matrices of all instances, marks all matrices outdated in both sets
+        void CacheTransforms();
+        /// @brief Marks a transform index outdated in both sets
+        void MarkOutdated(uint32_t transformIndex);
+        /// @brief Builds the indirect draw commands from mDrawOps and uploads them
+        void UpdateIndirectBuffers();
 
         /// @brief Draw Op structs store draw operation
         std::vector<DrawOp> mDrawOps    = {};
         bool                mFirstSetup = true;
         GeometryStore*      mGeo        = nullptr;
         uint32_t            mTotalCount = 0;
+
+        bool     mUseIndirectDraw   = false;
+        uint32_t mIndirectDrawCount = 0;
+        /// @brief Set if any draw op contains non-indexed primitives, which are not covered by the indirect command buffer
+        bool mHasNonIndexedPrimitives = false;
     };
 }  // namespace foray::scene::gcomp
\ No newline at end of file
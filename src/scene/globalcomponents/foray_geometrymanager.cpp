@@ -1,5 +1,7 @@
 #include "foray_geometrymanager.hpp"
 #include "../foray_scene.hpp"
+#include <initializer_list>
+#include <limits>
 
 namespace foray::scene::gcomp {
 
@@ -23,6 +25,7 @@ namespace foray::scene::gcomp {
     {
         mIndicesBuffer.SetName("Indices");
         mVerticesBuffer.SetName("Vertices");
+        mMeshBoundsBuffer.SetName("Mesh Bounds");
     }
 
     void GeometryStore::InitOrUpdate()
@@ -47,6 +50,97 @@ namespace foray::scene::gcomp {
         }
         mVerticesBuffer.WriteDataDeviceLocal(mVertices.data(), verticesSize);
         mIndicesBuffer.WriteDataDeviceLocal(mIndices.data(), indicesSize);
+
+        UpdateMeshBounds();
+        UpdateBindless();
+    }
+
+    void GeometryStore::UpdateBindless()
+    {
+        if(!mBindlessHeap)
+        {
+            mBindlessHeap = GetContext()->Bindless;
+        }
+        if(!mBindlessHeap || !mBindlessHeap->Exists())
+        {
+            return;
+        }
+        if(mVerticesBuffer.Exists())
+        {
+            mBindlessHeap->RegisterOrUpdateBuffer(mVerticesBindlessIndex, GetVertexBufferDescriptorInfo());
+        }
+        if(mIndicesBuffer.Exists())
+        {
+            mBindlessHeap->RegisterOrUpdateBuffer(mIndicesBindlessIndex, GetIndexBufferDescriptorInfo());
+        }
+        mBindlessHeap->RegisterOrUpdateBuffer(mMeshBoundsBindlessIndex, GetMeshBoundsDescriptorInfo());
+    }
+
+    glm::vec4 GeometryStore::ComputeBoundingSphere(const Mesh* mesh) const
+    {
+        // Center of the axis aligned bounding box, radius as the maximum distance to any referenced vertex.
+        // Not minimal, but conservative and cheap to compute.
+        glm::vec3 min(std::numeric_limits<fp32_t>::max());
+        glm::vec3 max(std::numeric_limits<fp32_t>::lowest());
+        bool      any = false;
+
+        auto lForEachVertex = [&](auto&& func) {
+            for(const Primitive& primitive : mesh->GetPrimitives())
+            {
+                if(!primitive.IsValid())
+                {
+                    continue;
+                }
+                for(uint32_t i = primitive.First; i < primitive.First + primitive.VertexOrIndexCount; i++)
+                {
+                    uint32_t vertexIndex = primitive.Type == Primitive::EType::Index ? mIndices[i] : i;
+                    func(mVertices[vertexIndex].Pos);
+                }
+            }
+        };
+
+        lForEachVertex([&](const glm::vec3& pos) {
+            min = glm::min(min, pos);
+            max = glm::max(max, pos);
+            any = true;
+        });
+
+        if(!any)
+        {
+            return glm::vec4(0.f);
+        }
+
+        glm::vec3 center   = (min + max) * 0.5f;
+        fp32_t    radiusSq = 0.f;
+        lForEachVertex([&](const glm::vec3& pos) {
+            glm::vec3 offset = pos - center;
+            radiusSq         = std::max(radiusSq, glm::dot(offset, offset));
+        });
+        return glm::vec4(center, std::sqrt(radiusSq));
+    }
+
+    void GeometryStore::UpdateMeshBounds()
+    {
+        mMeshBounds.resize(mMeshes.size());
+        for(size_t i = 0; i < mMeshes.size(); i++)
+        {
+            Mesh* mesh = mMeshes[i].get();
+            mesh->SetBoundingSphere(ComputeBoundingSphere(mesh));
+            mesh->SetBoundsIndex((uint32_t)i);
+            mMeshBounds[i] = mesh->GetBoundingSphere();
+        }
+
+        // Always at least one element, so the buffer can be bound to descriptor sets for empty scenes
+        VkDeviceSize boundsSize = std::max<size_t>(mMeshBounds.size(), 1) * sizeof(glm::vec4);
+        if(boundsSize > mMeshBoundsBuffer.GetSize())
+        {
+            mMeshBoundsBuffer.Destroy();
+            mMeshBoundsBuffer.Create(GetContext(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, boundsSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        }
+        if(mMeshBounds.size() > 0)
+        {
+            mMeshBoundsBuffer.WriteDataDeviceLocal(mMeshBounds.data(), mMeshBounds.size() * sizeof(glm::vec4));
+        }
     }
 
     void GeometryStore::Destroy()
@@ -54,7 +148,22 @@ namespace foray::scene::gcomp {
         mMeshes.clear();
         mIndices.clear();
         mVertices.clear();
+        mMeshBounds.clear();
+        if(!!mBindlessHeap && mBindlessHeap->Exists())
+        {
+            for(uint32_t* index : {&mVerticesBindlessIndex, &mIndicesBindlessIndex, &mMeshBoundsBindlessIndex})
+            {
+                if(*index != core::BindlessHeap::INVALID_INDEX)
+                {
+                    mBindlessHeap->UnregisterBuffer(*index);
+                }
+            }
+        }
+        mVerticesBindlessIndex   = core::BindlessHeap::INVALID_INDEX;
+        mIndicesBindlessIndex    = core::BindlessHeap::INVALID_INDEX;
+        mMeshBoundsBindlessIndex = core::BindlessHeap::INVALID_INDEX;
         mVerticesBuffer.Destroy();
         mIndicesBuffer.Destroy();
+        mMeshBoundsBuffer.Destroy();
     }
 }  // namespace foray::scene
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "../../core/foray_bindlessheap.hpp"
 #include "../../core/foray_managedbuffer.hpp"
 #include "../foray_component.hpp"
 #include "../foray_geo.hpp"
@@ -13,7 +14,8 @@ namespace foray::scene::gcomp {
       public:
         GeometryStore();
 
-        /// @brief Rewrites Indices and Vertices from CPU side storage to the GPU buffers
+        /// @brief Rewrites Indices and Vertices from CPU side storage to the GPU buffers, recomputes the mesh bounds table.
+        /// Registers the buffers with the contexts bindless heap (if set), keeping their indices stable.
         void InitOrUpdate();
 
         void Destroy();
@@ -22,6 +24,13 @@ namespace foray::scene::gcomp {
         FORAY_PROPERTY_R(Vertices)
         FORAY_PROPERTY_R(IndicesBuffer)
         FORAY_PROPERTY_R(VerticesBuffer)
+        /// @brief Model space bounding sphere (xyz: Center, w: Radius) per mesh, indexed by Mesh::GetBoundsIndex()
+        FORAY_GETTER_CR(MeshBounds)
+        FORAY_GETTER_CR(MeshBoundsBuffer)
+        /// @brief Indices into the bindless heaps buffer array. core::BindlessHeap::INVALID_INDEX if not registered
+        FORAY_GETTER_V(VerticesBindlessIndex)
+        FORAY_GETTER_V(IndicesBindlessIndex)
+        FORAY_GETTER_V(MeshBoundsBindlessIndex)
 
         virtual ~GeometryStore() { Destroy(); }
 
@@ -30,6 +39,7 @@ namespace foray::scene::gcomp {
         bool                   CmdBindBuffers(VkCommandBuffer commandBuffer);
         VkDescriptorBufferInfo GetVertexBufferDescriptorInfo() const { return mVerticesBuffer.GetVkDescriptorBufferInfo(); }
         VkDescriptorBufferInfo GetIndexBufferDescriptorInfo() const { return mIndicesBuffer.GetVkDescriptorBufferInfo(); }
+        VkDescriptorBufferInfo GetMeshBoundsDescriptorInfo() const { return mMeshBoundsBuffer.GetVkDescriptorBufferInfo(); }
 
       protected:
         core::ManagedBuffer   mIndicesBuffer;
@@ -37,6 +47,21 @@ namespace foray::scene::gcomp {
         std::vector<Vertex>   mVertices;
         std::vector<uint32_t> mIndices;
 
+        core::ManagedBuffer    mMeshBoundsBuffer;
+        std::vector<glm::vec4> mMeshBounds;
+
+        /// @brief Computes a bounding sphere enclosing all vertices referenced by the meshes primitives
+        glm::vec4 ComputeBoundingSphere(const Mesh* mesh) const;
+        /// @brief Recomputes bounding spheres and bounds indices of all meshes and uploads the bounds table
+        void UpdateMeshBounds();
+        /// @brief Registers or updates the buffers in the bindless heap
+        void UpdateBindless();
+
+        core::BindlessHeap* mBindlessHeap            = nullptr;
+        uint32_t            mVerticesBindlessIndex   = core::BindlessHeap::INVALID_INDEX;
+        uint32_t            mIndicesBindlessIndex    = core::BindlessHeap::INVALID_INDEX;
+        uint32_t            mMeshBoundsBindlessIndex = core::BindlessHeap::INVALID_INDEX;
+
         std::vector<std::unique_ptr<Mesh>> mMeshes;
     };
 }  // namespace foray::scene
\ No newline at end of file
@@ -5,4 +5,5 @@
 #include "foray_materialmanager.hpp"
 #include "foray_lightmanager.hpp"
 #include "foray_texturemanager.hpp"
-#include "foray_tlasmanager.hpp"
\ No newline at end of file
+#include "foray_tlasmanager.hpp"
+#include "foray_transformsystem.hpp"
\ No newline at end of file
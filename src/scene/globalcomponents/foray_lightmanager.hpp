@@ -16,6 +16,8 @@ namespace foray::scene::gcomp {
         virtual void Update(SceneUpdateInfo& updateInfo) override;
 
         virtual int32_t GetOrder() const override { return ORDER_DEVICEUPLOAD; }
+        virtual uint32_t GetUpdateReads() const override { return DATA_TRANSFORMS | DATA_LIGHTS; }
+        virtual uint32_t GetUpdateWrites() const override { return DATA_LIGHTS; }
 
         FORAY_PROPERTY_R(Buffer)
 
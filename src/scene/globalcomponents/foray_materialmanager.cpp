@@ -1,4 +1,5 @@
 #include "foray_materialmanager.hpp"
+#include "../../core/foray_context.hpp"
 
 namespace foray::scene::gcomp {
     MaterialManager::MaterialManager(core::Context* context) : mBuffer(context, false)
@@ -13,9 +14,22 @@ namespace foray::scene::gcomp {
             mBuffer.GetVector().push_back(Material{});
         }
         mBuffer.InitOrUpdate();
+        if(!mBindlessHeap)
+        {
+            mBindlessHeap = GetContext()->Bindless;
+        }
+        if(!!mBindlessHeap && mBindlessHeap->Exists())
+        {
+            mBindlessHeap->RegisterOrUpdateBuffer(mBindlessIndex, GetVkDescriptorInfo());
+        }
     }
     void MaterialManager::Destroy()
     {
+        if(mBindlessIndex != core::BindlessHeap::INVALID_INDEX && mBindlessHeap->Exists())
+        {
+            mBindlessHeap->UnregisterBuffer(mBindlessIndex);
+        }
+        mBindlessIndex = core::BindlessHeap::INVALID_INDEX;
         mBuffer.Destroy();
     }
 }  // namespace foray
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "../../core/foray_bindlessheap.hpp"
 #include "../../util/foray_managedvectorbuffer.hpp"
 #include "../foray_component.hpp"
 #include "../foray_material.hpp"
@@ -13,13 +14,15 @@ namespace foray::scene::gcomp {
 
         std::vector<Material>& GetVector() { return mBuffer.GetVector(); }
 
-        /// @brief Apply changes made to the cpu local buffer to the device local buffer
+        /// @brief Apply changes made to the cpu local buffer to the device local buffer. Registers the buffer with the contexts bindless heap (if set), keeping its index stable.
         void UpdateDeviceLocal();
         void Destroy();
 
         inline virtual ~MaterialManager() { Destroy(); }
 
         FORAY_GETTER_CR(Buffer)
+        /// @brief Index into the bindless heaps buffer array. core::BindlessHeap::INVALID_INDEX if not registered
+        FORAY_GETTER_V(BindlessIndex)
 
         inline VkDescriptorBufferInfo GetVkDescriptorInfo() const { return mBuffer.GetBuffer().GetVkDescriptorBufferInfo(); }
         inline VkBuffer               GetVkBuffer() const { return mBuffer.GetBuffer().GetBuffer(); }
@@ -27,5 +30,7 @@ namespace foray::scene::gcomp {
 
       protected:
         util::ManagedVectorBuffer<Material> mBuffer = {};
+        core::BindlessHeap*                 mBindlessHeap  = nullptr;
+        uint32_t                            mBindlessIndex = core::BindlessHeap::INVALID_INDEX;
     };
 }  // namespace foray::scene
\ No newline at end of file
@@ -1,24 +1,175 @@
 #include "foray_texturemanager.hpp"
+#include "../../core/foray_context.hpp"
+#include "../../core/foray_frametimeline.hpp"
 #include "../../foray_vulkan.hpp"
 #include "../../util/foray_hash.hpp"
+#include <algorithm>
 #include <functional>
+#include <memory>
 #include <spdlog/fmt/fmt.h>
 
 namespace foray::scene::gcomp {
     void TextureManager::Destroy()
     {
+        for(auto& [texId, texture] : mTextures)
+        {
+            UnregisterBindless(texture);
+        }
         mTextures.clear();
+        mBindlessHeap = nullptr;
+        mBindlessTable.reset();
     }
 
     std::vector<VkDescriptorImageInfo> TextureManager::GetDescriptorInfos(VkImageLayout layout)
     {
-        std::vector<VkDescriptorImageInfo> imageInfos(mTextures.size());
-        for(size_t i = 0; i < mTextures.size(); i++)
+        int32_t maxTexId = -1;
+        for(const auto& [texId, texture] : mTextures)
+        {
+            maxTexId = std::max(maxTexId, texId);
+        }
+        std::vector<VkDescriptorImageInfo> imageInfos(maxTexId + 1);
+        if(maxTexId < 0)
         {
-            imageInfos[i] = mTextures[i].GetDescriptorImageInfo(layout);
+            return imageInfos;
+        }
+        auto fallback = mTextures.find(0);
+        if(fallback == mTextures.end())
+        {
+            fallback = mTextures.begin();
+        }
+        for(int32_t i = 0; i <= maxTexId; i++)
+        {
+            auto iter     = mTextures.find(i);
+            imageInfos[i] = (iter != mTextures.end() ? iter->second : fallback->second).GetDescriptorImageInfo(layout);
         }
         return imageInfos;
     }
 
+    void TextureManager::RegisterBindless()
+    {
+        core::BindlessHeap* heap = GetContext()->Bindless;
+        if(!heap || !heap->Exists())
+        {
+            return;
+        }
+        Assert(!mBindlessHeap || mBindlessHeap == heap, "[TextureManager::RegisterBindless] Textures are registered with a different bindless heap");
+        mBindlessHeap = heap;
+        for(auto& [texId, texture] : mTextures)
+        {
+            if(texture.mBindlessIndex != core::BindlessHeap::INVALID_INDEX || !texture.mImage.Exists())
+            {
+                continue;
+            }
+            texture.mBindlessIndex = heap->RegisterImage(texture.GetDescriptorImageInfo());
+        }
+        WriteBindlessTable();
+    }
+
+    VkDescriptorBufferInfo TextureManager::GetBindlessTableDescriptorInfo()
+    {
+        if(!mBindlessTable)
+        {
+            WriteBindlessTable();
+        }
+        return mBindlessTable->GetVkDescriptorBufferInfo();
+    }
+
+    void TextureManager::RemoveTexture(int32_t texId)
+    {
+        auto iter = mTextures.find(texId);
+        if(iter == mTextures.end())
+        {
+            return;
+        }
+        mTexturesVersion++;
+
+        // In flight frames may still sample the texture. Extracting the node keeps the texture alive until the deferred destroy
+        auto node    = std::make_shared<decltype(mTextures)::node_type>(mTextures.extract(iter));
+        auto destroy = [node, heap = mBindlessHeap]() {
+            Texture& texture = node->mapped();
+            if(texture.mBindlessIndex != core::BindlessHeap::INVALID_INDEX && !!heap && heap->Exists())
+            {
+                heap->UnregisterImage(texture.mBindlessIndex);
+            }
+            texture.mBindlessIndex = core::BindlessHeap::INVALID_INDEX;
+            texture.mImage.Destroy();
+        };
+        if(!!mBindlessTable)
+        {
+            // Redirects the removed id to the fallback texture. Frames in flight may read either index, both stay valid until the deferred destroy
+            WriteBindlessTable();
+        }
+        DestroyDeferred(std::move(destroy));
+    }
+
+    void TextureManager::DestroyDeferred(std::function<void()> destroy)
+    {
+        core::FrameTimeline* timeline = GetContext()->Timeline;
+        if(!!timeline && timeline->Exists())
+        {
+            timeline->Defer(std::move(destroy));
+            return;
+        }
+        AssertVkResult(GetContext()->VkbDispatchTable->deviceWaitIdle());
+        destroy();
+    }
+
+    void TextureManager::WriteBindlessTable()
+    {
+        int32_t  maxTexId      = -1;
+        int32_t  fallbackTexId = -1;
+        uint32_t fallback      = 0;
+        for(const auto& [texId, texture] : mTextures)
+        {
+            maxTexId = std::max(maxTexId, texId);
+            if(texture.mBindlessIndex != core::BindlessHeap::INVALID_INDEX && texId >= 0 && (fallbackTexId < 0 || texId < fallbackTexId))
+            {
+                fallbackTexId = texId;
+                fallback      = texture.mBindlessIndex;
+            }
+        }
+
+        size_t capacity = !!mBindlessTable ? (size_t)(mBindlessTable->GetSize() / sizeof(uint32_t)) : 0;
+        if(!mBindlessTable || capacity < (size_t)(maxTexId + 1))
+        {
+            capacity = std::max<size_t>(capacity, 64);
+            while(capacity < (size_t)(maxTexId + 1))
+            {
+                capacity *= 2;
+            }
+            if(!!mBindlessTable)
+            {
+                // In flight frames may still read the old table
+                DestroyDeferred([table = mBindlessTable]() { table->Destroy(); });
+            }
+            mBindlessTable = std::make_shared<core::ManagedBuffer>();
+            mBindlessTable->Create(GetContext(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, capacity * sizeof(uint32_t), VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                                   VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT, "Bindless Texture Table");
+            mBindlessTableVersion++;
+        }
+
+        std::vector<uint32_t> table(capacity, fallback);
+        for(const auto& [texId, texture] : mTextures)
+        {
+            if(texId >= 0 && texture.mBindlessIndex != core::BindlessHeap::INVALID_INDEX)
+            {
+                table[texId] = texture.mBindlessIndex;
+            }
+        }
+        mBindlessTable->MapAndWrite(table.data(), table.size() * sizeof(uint32_t));
+    }
+
+    void TextureManager::UnregisterBindless(Texture& texture)
+    {
+        if(texture.mBindlessIndex == core::BindlessHeap::INVALID_INDEX)
+        {
+            return;
+        }
+        if(!!mBindlessHeap && mBindlessHeap->Exists())
+        {
+            mBindlessHeap->UnregisterImage(texture.mBindlessIndex);
+        }
+        texture.mBindlessIndex = core::BindlessHeap::INVALID_INDEX;
+    }
 
 }  // namespace foray::scene
\ No newline at end of file
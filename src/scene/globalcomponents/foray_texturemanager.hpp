@@ -1,7 +1,11 @@
 #pragma once
+#include "../../core/foray_bindlessheap.hpp"
+#include "../../core/foray_managedbuffer.hpp"
 #include "../../core/foray_managedimage.hpp"
 #include "../../core/foray_samplercollection.hpp"
 #include "../foray_component.hpp"
+#include <functional>
+#include <memory>
 #include <unordered_map>
 
 namespace foray::scene::gcomp {
@@ -28,24 +32,61 @@ namespace foray::scene::gcomp {
             }
 
             FORAY_PROPERTY_R(Sampler)
+            /// @brief Index into the bindless heaps image array. core::BindlessHeap::INVALID_INDEX if not registered
+            FORAY_GETTER_V(BindlessIndex)
 
           protected:
+            friend TextureManager;
+
             core::ManagedImage         mImage;
             core::CombinedImageSampler mSampler;
+            uint32_t                   mBindlessIndex = core::BindlessHeap::INVALID_INDEX;
         };
 
         FORAY_GETTER_CR(Textures)
         FORAY_GETTER_MR(Textures)
 
+        /// @brief Builds a descriptor info per texture id, from 0 to the highest texture id. Ids of removed textures are filled with the first texture.
         std::vector<VkDescriptorImageInfo> GetDescriptorInfos(VkImageLayout layout = VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
+        /// @brief Registers all textures not yet registered with the contexts bindless heap and rewrites the bindless table. Does nothing if Context::Bindless is not set.
+        /// @details Indices of textures already registered do not change.
+        void RegisterBindless();
+        /// @brief Storage buffer holding the bindless heap image index per texture id (uint[]), for shaders sampling material textures through the heap
+        /// (see BIND_TEXTURE_TABLE in shaders/common/materialbuffer.glsl). Ids of removed or unregistered textures map to the lowest registered texture id.
+        /// Creates the table if necessary
+        /// @remark The buffer is recreated (with the old one destroyed deferred) if a texture id exceeds its size, see BindlessTableVersion
+        VkDescriptorBufferInfo GetBindlessTableDescriptorInfo();
+        /// @brief Removes the texture. Unregistering it from the bindless heap and destroying it is deferred until frames recorded so far have finished
+        /// (see core::FrameTimeline::Defer()). Without Context::Timeline, waits for the device to become idle instead.
+        /// @remark Stages binding GetDescriptorInfos() rewrite their descriptors once they notice the changed TexturesVersion
+        void RemoveTexture(int32_t texId);
+
         inline Texture& PrepareTexture(int32_t texId)
         {
             Assert(!mTextures.contains(texId));
+            mTexturesVersion++;
             return mTextures[texId];
         }
 
+        /// @brief Incremented whenever textures are added or removed. Stages compare it to decide whether to rewrite their texture descriptors
+        FORAY_GETTER_V(TexturesVersion)
+        /// @brief Incremented whenever the bindless table buffer is recreated. Stages compare it to decide whether to rewrite their table descriptor
+        FORAY_GETTER_V(BindlessTableVersion)
+
       protected:
+        void UnregisterBindless(Texture& texture);
+        /// @brief Writes the bindless heap index of every texture id to the table, growing it if necessary
+        void WriteBindlessTable();
+        /// @brief Defers destroy via Context::Timeline, or waits for the device to become idle and calls it immediately
+        void DestroyDeferred(std::function<void()> destroy);
+
         std::unordered_map<int32_t, Texture> mTextures;
+        uint64_t                             mTexturesVersion = 0;
+        /// @brief Heap textures were registered with
+        core::BindlessHeap* mBindlessHeap = nullptr;
+        /// @brief Host written table mapping texture ids to bindless heap image indices. Shared, so a replaced table can be kept alive until in flight frames finished
+        std::shared_ptr<core::ManagedBuffer> mBindlessTable;
+        uint64_t                             mBindlessTableVersion = 0;
     };
 }  // namespace foray::scene
\ No newline at end of file
@@ -17,6 +17,8 @@ namespace foray::scene::gcomp {
         virtual void Update(SceneUpdateInfo& updateInfo) override;
 
         virtual int32_t GetOrder() const override { return ORDER_DEVICEUPLOAD; }
+        virtual uint32_t GetUpdateReads() const override { return DATA_TRANSFORMS | DATA_TLAS; }
+        virtual uint32_t GetUpdateWrites() const override { return DATA_TLAS; }
 
         FORAY_GETTER_CR(Tlas)
         FORAY_GETTER_CR(MeshInstances)
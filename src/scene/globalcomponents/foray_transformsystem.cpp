@@ -0,0 +1,146 @@
+#include "foray_transformsystem.hpp"
+#include "../../bench/foray_hostbenchmark.hpp"
+#include "../components/foray_transform.hpp"
+#include "../foray_node.hpp"
+#include "../foray_scene.hpp"
+
+namespace foray::scene::gcomp {
+    void TransformSystem::InitOrUpdate()
+    {
+        mTransforms.clear();
+        mParents.clear();
+        mHierarchyVersion = GetScene()->GetHierarchyVersion();
+
+        // Breadth first traversal stores every parent before its children
+        std::vector<Node*> nodes(GetScene()->GetRootNodes().begin(), GetScene()->GetRootNodes().end());
+        mParents.assign(nodes.size(), -1);
+        for(size_t i = 0; i < nodes.size(); i++)
+        {
+            for(Node* child : nodes[i]->GetChildren())
+            {
+                nodes.push_back(child);
+                mParents.push_back((int32_t)i);
+            }
+        }
+
+        size_t count = nodes.size();
+        mTransforms.resize(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            mTransforms[i] = nodes[i]->GetTransform();
+        }
+
+        mTranslations.resize(count);
+        mRotations.resize(count);
+        mScales.resize(count);
+        mLocalMatrixFixed.resize(count);
+        mDirty.resize(count);
+        mLocalMatrices.resize(count);
+        mWorldMatrices.resize(count);
+    }
+
+    void TransformSystem::Update(SceneUpdateInfo& updateInfo)
+    {
+        if(mHierarchyVersion != GetScene()->GetHierarchyVersion())
+        {
+            InitOrUpdate();
+        }
+
+        if(!!mBenchmark)
+        {
+            mBenchmark->Begin();
+        }
+
+        const size_t count      = mTransforms.size();
+        size_t       dirtyCount = 0;
+
+        // STEP #1    Gather TRS of dirty transforms. Clean transforms provide their world matrix for their children
+
+        for(size_t i = 0; i < count; i++)
+        {
+            ncomp::Transform* transform = mTransforms[i];
+            mDirty[i]                   = transform->mDirty ? 1 : 0;
+            if(!transform->mDirty)
+            {
+                mWorldMatrices[i] = transform->mGlobalMatrix;
+                continue;
+            }
+            dirtyCount++;
+            mLocalMatrixFixed[i] = transform->mLocalMatrixFixed ? 1 : 0;
+            if(transform->mLocalMatrixFixed)
+            {
+                mLocalMatrices[i] = transform->mLocalMatrix;
+            }
+            else
+            {
+                mTranslations[i] = transform->mTranslation;
+                mRotations[i]    = transform->mRotation;
+                mScales[i]       = transform->mScale;
+            }
+        }
+
+        if(!!mBenchmark)
+        {
+            mBenchmark->LogTimestamp(BENCH_GATHER);
+        }
+
+        // STEP #2    Compose local matrices (T * R * S)
+
+        for(size_t i = 0; i < count; i++)
+        {
+            if(!mDirty[i] || mLocalMatrixFixed[i])
+            {
+                continue;
+            }
+            glm::mat3  rotation = glm::mat3_cast(mRotations[i]);
+            glm::mat4& local    = mLocalMatrices[i];
+            local[0]            = glm::vec4(rotation[0] * mScales[i].x, 0.f);
+            local[1]            = glm::vec4(rotation[1] * mScales[i].y, 0.f);
+            local[2]            = glm::vec4(rotation[2] * mScales[i].z, 0.f);
+            local[3]            = glm::vec4(mTranslations[i], 1.f);
+        }
+
+        if(!!mBenchmark)
+        {
+            mBenchmark->LogTimestamp(BENCH_LOCAL);
+        }
+
+        // STEP #3    World matrices in hierarchy order. Dirty flags propagate to children, so a recalculated parent always has dirty children
+
+        for(size_t i = 0; i < count; i++)
+        {
+            if(!mDirty[i])
+            {
+                continue;
+            }
+            int32_t parent    = mParents[i];
+            mWorldMatrices[i] = parent >= 0 ? mWorldMatrices[parent] * mLocalMatrices[i] : mLocalMatrices[i];
+        }
+
+        if(!!mBenchmark)
+        {
+            mBenchmark->LogTimestamp(BENCH_WORLD);
+        }
+
+        // STEP #4    Write back
+
+        for(size_t i = 0; i < count; i++)
+        {
+            if(!mDirty[i])
+            {
+                continue;
+            }
+            ncomp::Transform* transform = mTransforms[i];
+            transform->mLocalMatrix     = mLocalMatrices[i];
+            transform->mGlobalMatrix    = mWorldMatrices[i];
+            transform->mDirty           = false;
+        }
+
+        if(!!mBenchmark)
+        {
+            mBenchmark->LogTimestamp(BENCH_SCATTER);
+            mBenchmark->LogValue(BENCH_NODES, (fp64_t)dirtyCount);
+            mBenchmark->End();
+        }
+    }
+}  // namespace foray::scene::gcomp
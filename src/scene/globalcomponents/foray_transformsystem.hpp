@@ -0,0 +1,65 @@
+#pragma once
+#include "../../bench/foray_bench_declares.hpp"
+#include "../../foray_glm.hpp"
+#include "../foray_component.hpp"
+#include <vector>
+
+namespace foray::scene::gcomp {
+
+    /// @brief Computes world matrices of all node transforms in batched, linear passes
+    /// @details
+    /// InitOrUpdate() flattens the node hierarchy breadth first, so every parent is stored before its children (sorted by depth).
+    /// Local translation, rotation and scale are kept in structure-of-arrays form. Update() then
+    ///  1. gathers the TRS of dirty transforms into the arrays (clean transforms provide their global matrix),
+    ///  2. composes all dirty local matrices in one tight loop,
+    ///  3. multiplies parent world and local matrices in a single pass in hierarchy order, visiting each parent once,
+    ///  4. writes local and world matrices back to the Transform components, clearing their dirty flags.
+    /// Update() flattens the hierarchy again whenever the scenes hierarchy version changed (nodes made via Scene::MakeNode() or moved via Node::SetParent()).
+    class TransformSystem : public GlobalComponent, public Component::UpdateCallback
+    {
+      public:
+        inline static const char* BENCH_GATHER  = "Gather";
+        inline static const char* BENCH_LOCAL   = "Local Matrices";
+        inline static const char* BENCH_WORLD   = "World Matrices";
+        inline static const char* BENCH_SCATTER = "Scatter";
+        inline static const char* BENCH_NODES   = "Dirty Transforms";
+
+        /// @brief Flattens the node hierarchy. Called by Update() if the scenes hierarchy version changed
+        void InitOrUpdate();
+
+        virtual int32_t GetOrder() const override { return ORDER_HIERARCHY; }
+        virtual uint32_t GetUpdateReads() const override { return DATA_TRANSFORMS; }
+        virtual uint32_t GetUpdateWrites() const override { return DATA_TRANSFORMS; }
+        virtual bool     GetUpdateRecordsCommands() const override { return false; }
+
+        /// @brief Recalculates world matrices of all dirty transforms
+        virtual void Update(SceneUpdateInfo&) override;
+
+        /// @brief Number of transforms managed
+        inline size_t GetCount() const { return mTransforms.size(); }
+
+        /// @brief Optional benchmark timing Update(). See static BENCH_... members for timestamps
+        FORAY_PROPERTY_V(Benchmark)
+
+      protected:
+        /// @brief Transform components, parents stored before their children
+        std::vector<ncomp::Transform*> mTransforms;
+        /// @brief Index of the parents transform, or -1 for root nodes
+        std::vector<int32_t> mParents;
+        /// @brief Scene::GetHierarchyVersion() at the time of flattening
+        uint64_t mHierarchyVersion = UINT64_MAX;
+
+        std::vector<glm::vec3> mTranslations;
+        std::vector<glm::quat> mRotations;
+        std::vector<glm::vec3> mScales;
+        /// @brief If set, mLocalMatrices is provided by the Transform instead of composed from TRS
+        std::vector<uint8_t> mLocalMatrixFixed;
+        /// @brief If set, local and world matrix are recalculated this update
+        std::vector<uint8_t> mDirty;
+
+        std::vector<glm::mat4> mLocalMatrices;
+        std::vector<glm::mat4> mWorldMatrices;
+
+        bench::HostBenchmark* mBenchmark = nullptr;
+    };
+}  // namespace foray::scene::gcomp
@@ -0,0 +1,35 @@
+/*
+    common/bindless.glsl
+
+    Declares the arrays of core::BindlessHeap. Define SET_BINDLESS to the set index the heap is bound to.
+    Indices are obtained from TextureManager::Texture::GetBindlessIndex(), MaterialManager::GetBindlessIndex() and GeometryStore::Get...BindlessIndex().
+    Including shaders must enable GL_EXT_nonuniform_qualifier.
+*/
+
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+#ifndef SET_BINDLESS
+#define SET_BINDLESS 1
+#endif  // SET_BINDLESS
+
+// Must match core::BindlessHeap::BINDING_SAMPLED_IMAGES and core::BindlessHeap::BINDING_STORAGE_BUFFERS
+#define BIND_BINDLESS_SAMPLED_IMAGES 0
+#define BIND_BINDLESS_STORAGE_BUFFERS 1
+
+/// @brief Combined image samplers registered with the bindless heap
+layout(set = SET_BINDLESS, binding = BIND_BINDLESS_SAMPLED_IMAGES) uniform sampler2D BindlessTextures[];
+
+/// @brief Storage buffers registered with the bindless heap, viewed as raw 32 bit words
+layout(set = SET_BINDLESS, binding = BIND_BINDLESS_STORAGE_BUFFERS, std430) buffer readonly BindlessBuffer
+{
+    uint Words[];
+}
+BindlessBuffers[];
+
+vec4 SampleBindlessTexture(in uint index, in vec2 uv)
+{
+    return texture(BindlessTextures[nonuniformEXT(index)], uv);
+}
+
+#endif  // BINDLESS_GLSL
@@ -0,0 +1,26 @@
+/*
+    common/drawinstancebuffer.glsl
+
+    Layout macros for the draw instance buffer. Maps instance slots of indirect draws (gl_InstanceIndex, including firstInstance) to transform buffer indices.
+    Identity mapping, unless compacted by GPU culling.
+
+    C++: src/scene/globalcomponents/foray_drawmanager.hpp
+*/
+
+#ifdef BIND_DRAWINSTANCEBUFFER
+#ifndef SET_DRAWINSTANCEBUFFER
+#define SET_DRAWINSTANCEBUFFER 0
+#endif
+/// @brief Transform buffer index per instance slot
+layout(set = SET_DRAWINSTANCEBUFFER, binding = BIND_DRAWINSTANCEBUFFER, std430) readonly buffer DrawInstanceBuffer_T
+{
+    uint Array[];
+}
+DrawInstanceBuffer;
+
+uint GetDrawInstanceTransformIndex(in uint instanceSlot)
+{
+    return DrawInstanceBuffer.Array[instanceSlot];
+}
+
+#endif
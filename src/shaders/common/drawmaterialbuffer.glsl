@@ -0,0 +1,25 @@
+/*
+    common/drawmaterialbuffer.glsl
+
+    Layout macros for the draw material buffer. Contains the material index per indirect draw command, indexed by gl_DrawID
+
+    C++: src/scene/globalcomponents/foray_drawmanager.hpp
+*/
+
+#ifdef BIND_DRAWMATERIALBUFFER
+#ifndef SET_DRAWMATERIALBUFFER
+#define SET_DRAWMATERIALBUFFER 0
+#endif
+/// @brief Material index per indirect draw command
+layout(set = SET_DRAWMATERIALBUFFER, binding = BIND_DRAWMATERIALBUFFER, std430) readonly buffer DrawMaterialBuffer_T
+{
+    int Array[];
+}
+DrawMaterialBuffer;
+
+int GetDrawMaterialIndex(in uint drawId)
+{
+    return DrawMaterialBuffer.Array[drawId];
+}
+
+#endif
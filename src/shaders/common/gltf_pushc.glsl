@@ -12,6 +12,9 @@ layout(push_constant) uniform PushConstantBlock
 {
     uint TransformBufferOffset;
     int  MaterialIndex;
+    uint IndirectDraw;  // If non-zero, material and transform indices are read from the draw material and draw instance buffers (see common/drawmaterialbuffer.glsl, common/drawinstancebuffer.glsl)
+    uint CurrentTransformBase;   // Index of the current frames transform set in the transform buffer (see common/transformbuffer.glsl)
+    uint PreviousTransformBase;  // Index of the previous frames transform set in the transform buffer
 }
 PushConstant;
 #endif
\ No newline at end of file
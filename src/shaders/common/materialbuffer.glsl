@@ -33,6 +33,25 @@ vec4 SampleTexture(nonuniformEXT in int index, in vec2 uv)
 
 #endif  // BIND_TEXTURES_ARRAY
 
+#ifdef BIND_TEXTURE_TABLE
+#ifndef SET_TEXTURE_TABLE
+#define SET_TEXTURE_TABLE 0
+#endif  // SET_TEXTURE_TABLE
+#include "bindless.glsl"
+/// @brief Bindless heap image index per texture id (TextureManager::GetBindlessTableDescriptorInfo()). Alternative to BIND_TEXTURES_ARRAY
+layout(set = SET_TEXTURE_TABLE, binding = BIND_TEXTURE_TABLE, std430) buffer readonly TextureTableBuffer
+{
+    uint BindlessIndices[];
+}
+TextureTable;
+
+vec4 SampleTexture(nonuniformEXT in int index, in vec2 uv)
+{
+    return SampleBindlessTexture(TextureTable.BindlessIndices[index], uv);
+}
+
+#endif  // BIND_TEXTURE_TABLE
+
 #ifndef MATERIALBUFFER_GLSL
 #define MATERIALBUFFER_GLSL
 
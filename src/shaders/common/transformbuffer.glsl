@@ -1,40 +1,76 @@
 /*
     common/transformbuffer.glsl
 
-    Layout macros for transform buffer access. Transformbuffer contains model -> world transformation matrices per meshinstance
+    Layout macros for transform buffer access. Transformbuffer contains model -> world transformation matrices per meshinstance.
+    The buffer holds two transform sets (current and previous frame), which swap every frame. A header stores the base index of both sets,
+    so GetCurrentTransform() / GetPreviousTransform() work in any shader binding the buffer (e.g. ray tracing hit shaders).
+    Draw shaders may instead add the bases passed via push constant (see common/gltf_pushc.glsl) and use GetTransform().
+
+    Shaders written against the former separate buffers keep working: BIND_TRANSFORMBUFFER_CURRENT / BIND_TRANSFORMBUFFER_PREVIOUS (and their SET_ macros)
+    are accepted in place of BIND_TRANSFORMBUFFER, and DrawDirector::GetCurrent/PreviousTransformsDescriptorInfo() both describe the whole buffer.
+
+    C++: src/scene/globalcomponents/foray_drawmanager.hpp
 */
 
-#ifdef BIND_TRANSFORMBUFFER_CURRENT
-#ifndef SET_TRANSFORMBUFFER_CURRENT
-#define SET_TRANSFORMBUFFER_CURRENT 0
+#if defined(BIND_TRANSFORMBUFFER_CURRENT) && !defined(BIND_TRANSFORMBUFFER)
+#define BIND_TRANSFORMBUFFER BIND_TRANSFORMBUFFER_CURRENT
+#ifdef SET_TRANSFORMBUFFER_CURRENT
+#define SET_TRANSFORMBUFFER SET_TRANSFORMBUFFER_CURRENT
 #endif
-/// @brief Current frames model -> worldspace transformations
-layout(set = SET_TRANSFORMBUFFER_CURRENT, binding = BIND_TRANSFORMBUFFER_CURRENT, std430) readonly buffer TransformBufferCurrent_T
+#endif
+
+#ifdef BIND_TRANSFORMBUFFER
+#ifndef SET_TRANSFORMBUFFER
+#define SET_TRANSFORMBUFFER 0
+#endif
+/// @brief Current and previous frames model -> worldspace transformations
+layout(set = SET_TRANSFORMBUFFER, binding = BIND_TRANSFORMBUFFER, std430) readonly buffer TransformBuffer_T
+{
+    uint  CurrentTransformBase;   // Index of the first matrix of the current frames set
+    uint  PreviousTransformBase;  // Index of the first matrix of the previous frames set
+    uvec2 HeaderPadding0;
+    uvec4 HeaderPadding1[3];  // Header occupies one matrix
+    mat4  Array[];
+}
+TransformBuffer;
+
+mat4 GetTransform(in uint transformSetBase, in uint transformBufferIndex)
 {
-    mat4 Array[];
+    return TransformBuffer.Array[transformSetBase + transformBufferIndex];
 }
-TransformBufferCurrent;
 
+/// @brief Current frames model -> worldspace transformation
 mat4 GetCurrentTransform(in uint transformBufferIndex)
 {
-    return TransformBufferCurrent.Array[transformBufferIndex];
+    return TransformBuffer.Array[TransformBuffer.CurrentTransformBase + transformBufferIndex];
 }
 
-#endif
-#ifdef BIND_TRANSFORMBUFFER_PREVIOUS
+#if defined(BIND_TRANSFORMBUFFER_PREVIOUS) && BIND_TRANSFORMBUFFER_PREVIOUS != BIND_TRANSFORMBUFFER
 #ifndef SET_TRANSFORMBUFFER_PREVIOUS
 #define SET_TRANSFORMBUFFER_PREVIOUS 0
 #endif
-/// @brief Previous frames model -> worldspace transformations
+/// @brief Same buffer, bound a second time by shaders using the former separate previous transforms binding
 layout(set = SET_TRANSFORMBUFFER_PREVIOUS, binding = BIND_TRANSFORMBUFFER_PREVIOUS, std430) readonly buffer TransformBufferPrevious_T
 {
-    mat4 Array[];
+    uint  CurrentTransformBase;
+    uint  PreviousTransformBase;
+    uvec2 HeaderPadding0;
+    uvec4 HeaderPadding1[3];
+    mat4  Array[];
 }
 TransformBufferPrevious;
 
+/// @brief Previous frames model -> worldspace transformation
 mat4 GetPreviousTransform(in uint transformBufferIndex)
 {
-    return TransformBufferPrevious.Array[transformBufferIndex];
+    return TransformBufferPrevious.Array[TransformBufferPrevious.PreviousTransformBase + transformBufferIndex];
 }
+#else
+/// @brief Previous frames model -> worldspace transformation
+mat4 GetPreviousTransform(in uint transformBufferIndex)
+{
+    return TransformBuffer.Array[TransformBuffer.PreviousTransformBase + transformBufferIndex];
+}
+#endif
 
-#endif
\ No newline at end of file
+#endif
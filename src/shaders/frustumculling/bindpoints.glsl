@@ -0,0 +1,31 @@
+/*
+    frustumculling/bindpoints.glsl
+
+    Frustum culling bindpoints, shared by the instance and command passes
+*/
+
+// Camera Ubo
+#define SET_CAMERA_UBO 0
+#define BIND_CAMERA_UBO 0
+
+// Current and previous frames transforms
+#define SET_TRANSFORMBUFFER 0
+#define BIND_TRANSFORMBUFFER 1
+
+// Model space bounding sphere per mesh
+#define BIND_MESHBOUNDS 2
+
+// Bounds index and draw op first instance per transform
+#define BIND_INSTANCECULLINFOS 3
+
+// Visible instance counter per draw op (indexed by the draw ops first instance)
+#define BIND_VISIBLECOUNTS 4
+
+// Compacted transform indices per instance slot (output)
+#define BIND_DRAWINSTANCES 5
+
+// Indirect draw commands (instanceCount is rewritten)
+#define BIND_INDIRECTCOMMANDS 6
+
+// Visible/culled totals
+#define BIND_STATISTICS 7
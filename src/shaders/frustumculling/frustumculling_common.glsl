@@ -0,0 +1,66 @@
+/*
+    frustumculling/frustumculling_common.glsl
+
+    Buffer layouts and push constant shared by the frustum culling passes
+
+    C++: src/stages/foray_frustumcullingstage.hpp
+*/
+
+#include "bindpoints.glsl"
+
+layout(set = 0, binding = BIND_MESHBOUNDS, std430) readonly buffer MeshBounds_T
+{
+    vec4 Array[];  // xyz: Center (model space), w: Radius
+}
+MeshBounds;
+
+layout(set = 0, binding = BIND_INSTANCECULLINFOS, std430) readonly buffer InstanceCullInfos_T
+{
+    uvec2 Array[];  // x: Bounds index, y: First instance of the draw op
+}
+InstanceCullInfos;
+
+layout(set = 0, binding = BIND_VISIBLECOUNTS, std430) buffer VisibleCounts_T
+{
+    uint Array[];
+}
+VisibleCounts;
+
+layout(set = 0, binding = BIND_DRAWINSTANCES, std430) writeonly buffer DrawInstances_T
+{
+    uint Array[];
+}
+DrawInstances;
+
+struct DrawIndexedIndirectCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int  VertexOffset;
+    uint FirstInstance;
+};
+
+layout(set = 0, binding = BIND_INDIRECTCOMMANDS, std430) buffer IndirectCommands_T
+{
+    DrawIndexedIndirectCommand Array[];
+}
+IndirectCommands;
+
+layout(set = 0, binding = BIND_STATISTICS, std430) buffer Statistics_T
+{
+    uint VisibleInstances;
+    uint CulledInstances;
+    uint VisibleDraws;
+    uint CulledDraws;
+}
+Statistics;
+
+layout(push_constant) uniform PushConstant_T
+{
+    uint InstanceCount;
+    uint CommandCount;
+    uint CullingEnabled;  // If zero, all instances are considered visible
+    uint TransformBase;   // Index of the current frames transform set in the transform buffer
+}
+PushConstant;
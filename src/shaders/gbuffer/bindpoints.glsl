@@ -8,21 +8,28 @@
 #define SET_MATERIAL_BUFFER 0
 #define BIND_MATERIAL_BUFFER 0
 
-// Texture Array
-#define SET_TEXTURES_ARRAY 0
-#define BIND_TEXTURES_ARRAY 1
+// Texture id to bindless heap index table
+#define SET_TEXTURE_TABLE 0
+#define BIND_TEXTURE_TABLE 1
 
 // Camera Ubo
 #define SET_CAMERA_UBO 0
 #define BIND_CAMERA_UBO 2
 
-// Current frames transforms
-#define SET_TRANSFORMBUFFER_CURRENT 0
-#define BIND_TRANSFORMBUFFER_CURRENT 3
+// Current and previous frames transforms
+#define SET_TRANSFORMBUFFER 0
+#define BIND_TRANSFORMBUFFER 3
 
-// Previous frames transforms
-#define SET_TRANSFORMBUFFER_PREVIOUS 0
-#define BIND_TRANSFORMBUFFER_PREVIOUS 4
+// Material index per indirect draw
+#define SET_DRAWMATERIALBUFFER 0
+#define BIND_DRAWMATERIALBUFFER 4
+
+// Transform index per indirect draw instance slot
+#define SET_DRAWINSTANCEBUFFER 0
+#define BIND_DRAWINSTANCEBUFFER 5
+
+// Bindless heap (core::BindlessHeap), holds the textures
+#define SET_BINDLESS 1
 
 // Push Constants
 #define BIND_PUSHC
@@ -9,6 +9,7 @@ layout(location = 3) in vec3 inNormal;               // Normal in world space
 layout(location = 4) in vec3 inTangent;              // Tangent in world space
 layout(location = 5) in vec2 inUV;                   // UV coordinates
 layout(location = 6) flat in uint inMeshInstanceId;  // Mesh Instance Id
+layout(location = 7) flat in int inMaterialIndex;    // Material Index
 
 layout(location = 0) out vec4 outPosition;        // Fragment position in world spcae
 layout(location = 1) out vec4 outNormal;          // Fragment normal in world space
@@ -29,9 +30,9 @@ void main()
     outMeshInstanceId = inMeshInstanceId;
     outPosition       = vec4(inWorldPos, 1.0);
 
-    outMaterialIndex = PushConstant.MaterialIndex;
+    outMaterialIndex = inMaterialIndex;
 
-    MaterialBufferObject material = GetMaterialOrFallback(PushConstant.MaterialIndex);
+    MaterialBufferObject material = GetMaterialOrFallback(inMaterialIndex);
 
     MaterialProbe probe = ProbeMaterial(material, inUV);
 
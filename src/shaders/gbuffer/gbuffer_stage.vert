@@ -1,5 +1,6 @@
 #version 450
 #extension GL_GOOGLE_include_directive : enable
+#extension GL_ARB_shader_draw_parameters : enable
 
 layout(location = 0) in vec3 inPos;           // Vertex position in model space
 layout(location = 1) in vec3 inNormal;        // Vertex normal
@@ -13,20 +14,26 @@ layout(location = 3) out vec3 outNormal;               // Normal in world space
 layout(location = 4) out vec3 outTangent;              // Tangent in world space
 layout(location = 5) out vec2 outUV;                   // UV coordinates
 layout(location = 6) flat out uint outMeshInstanceId;  // Mesh Instance Id
+layout(location = 7) flat out int outMaterialIndex;    // Material Index
 
 #include "bindpoints.glsl"
 #include "../common/gltf_pushc.glsl"
 #include "../common/camera.glsl"
 #include "../common/transformbuffer.glsl"
+#include "../common/drawmaterialbuffer.glsl"
+#include "../common/drawinstancebuffer.glsl"
 
 void main()
 {
+    // Indirect draws pass the transform offset via firstInstance (included in gl_InstanceIndex). The draw instance buffer maps to the transform index (compacted by culling)
+    uint transformIndex = PushConstant.IndirectDraw != 0 ? GetDrawInstanceTransformIndex(gl_InstanceIndex) : PushConstant.TransformBufferOffset + gl_InstanceIndex;
+
     mat4 ProjMat      = Camera.ProjectionMatrix;
     mat4 ViewMat      = Camera.ViewMatrix;
-    mat4 ModelMat     = GetCurrentTransform(PushConstant.TransformBufferOffset + gl_InstanceIndex);
+    mat4 ModelMat     = GetTransform(PushConstant.CurrentTransformBase, transformIndex);
     mat4 ProjMatPrev  = Camera.PreviousProjectionMatrix;
     mat4 ViewMatPrev  = Camera.PreviousViewMatrix;
-    mat4 ModelMatPrev = GetPreviousTransform(PushConstant.TransformBufferOffset + gl_InstanceIndex);
+    mat4 ModelMatPrev = GetTransform(PushConstant.PreviousTransformBase, transformIndex);
 
     // Get transformations out of the way
     outWorldPos     = (ModelMat * vec4(inPos, 1.f)).xyz;
@@ -41,5 +48,8 @@ void main()
     outNormal    = mNormal * normalize(inNormal);
     outTangent   = mNormal * normalize(inTangent);
 
-    outMeshInstanceId = PushConstant.TransformBufferOffset + gl_InstanceIndex;
+    outMeshInstanceId = transformIndex;
+
+    // Indirect draws pass the material index via the draw material buffer
+    outMaterialIndex = PushConstant.IndirectDraw != 0 ? GetDrawMaterialIndex(gl_DrawIDARB) : PushConstant.MaterialIndex;
 }
@@ -28,9 +28,9 @@
 #define SET_MATERIAL_BUFFER 0
 #define BIND_MATERIAL_BUFFER 5
 
-// Textures Array
-#define SET_TEXTURES_ARRAY 0
-#define BIND_TEXTURES_ARRAY 6
+// Texture id to bindless heap index table
+#define SET_TEXTURE_TABLE 0
+#define BIND_TEXTURE_TABLE 6
 
 // Geometry Meta
 #define SET_GEOMETRYMETA 0
@@ -45,4 +45,7 @@
 
 // Noise Source Texture
 #define SET_NOISETEX 0
-#define BIND_NOISETEX 10
\ No newline at end of file
+#define BIND_NOISETEX 10
+
+// Bindless heap (core::BindlessHeap), holds the textures
+#define SET_BINDLESS 1
\ No newline at end of file
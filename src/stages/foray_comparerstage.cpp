@@ -1,4 +1,5 @@
 #include "foray_comparerstage.hpp"
+#include "../core/foray_barrierbatch.hpp"
 #include "../osi/foray_event.hpp"
 #include "../osi/foray_inputdevice.hpp"
 #include "../osi/foray_osmanager.hpp"
@@ -88,7 +89,7 @@ namespace foray::stages {
             }
         }
         {  // Pipeline Layout
-            substage.PipelineLayout.AddDescriptorSetLayout(substage.DescriptorSet.GetDescriptorSetLayout());
+            substage.PipelineLayout.AddDescriptorSetLayout(substage.DescriptorSet);
             substage.PipelineLayout.AddPushConstantRange<PushConstant>(VkShaderStageFlagBits::VK_SHADER_STAGE_COMPUTE_BIT);
             substage.PipelineLayout.Build(mContext);
         }
@@ -100,11 +101,12 @@ namespace foray::stages {
 
             VkComputePipelineCreateInfo pipelineCi{
                 .sType  = VkStructureType::VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                .flags  = substage.DescriptorSet.GetPipelineCreateFlags(),
                 .stage  = shaderStageCi,
                 .layout = substage.PipelineLayout,
             };
 
-            AssertVkResult(mContext->VkbDispatchTable->createComputePipelines(nullptr, 1U, &pipelineCi, nullptr, &substage.Pipeline));
+            AssertVkResult(mContext->VkbDispatchTable->createComputePipelines(mContext->PipelineCache, 1U, &pipelineCi, nullptr, &substage.Pipeline));
         }
     }
 
@@ -201,6 +203,38 @@ namespace foray::stages {
         {  // Get Pipette value (which might be very much out of date, but since it's for UI purposes only this is fine)
             memcpy(&mPipetteValue, mPipetteMap, sizeof(mPipetteValue));
         }
+        {  // Barriers for both substages in one command. The substages write disjoint halves of the output, so no barrier is required between them
+            core::BarrierBatch barriers(renderInfo.GetImageLayoutCache());
+            for(SubStage& substage : mSubStages)
+            {
+                if(!substage.Input.Image)
+                {
+                    continue;
+                }
+                if(substage.Index > 0 && substage.Input.Image == mSubStages[0].Input.Image && substage.Input.Aspect == mSubStages[0].Input.Aspect)
+                {
+                    continue;  // Both substages sample the same input, it is already transitioned
+                }
+                barriers.AddImage(substage.Input.Image,
+                                  core::ImageLayoutCache::Barrier2{.SrcStageMask     = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                                   .SrcAccessMask    = VK_ACCESS_2_MEMORY_WRITE_BIT,
+                                                                   .DstStageMask     = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                                   .DstAccessMask    = VK_ACCESS_2_SHADER_READ_BIT,
+                                                                   .NewLayout        = VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                                   .SubresourceRange = VkImageSubresourceRange{.aspectMask = substage.Input.Aspect, .levelCount = 1, .layerCount = 1}});
+            }
+            if(!barriers.IsEmpty())
+            {
+                barriers.AddImage(mOutput, core::ImageLayoutCache::Barrier2{
+                                               .SrcStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                               .SrcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT | VK_ACCESS_2_MEMORY_READ_BIT,
+                                               .DstStageMask  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                               .DstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                               .NewLayout     = VkImageLayout::VK_IMAGE_LAYOUT_GENERAL,
+                                           });
+            }
+            barriers.CmdFlush(mContext, cmdBuffer);
+        }
         if(!!mSubStages[0].Input.Image)
         {
             DispatchSubStage(mSubStages[0], cmdBuffer, renderInfo);
@@ -213,43 +247,10 @@ namespace foray::stages {
 
     void ComparerStage::DispatchSubStage(SubStage& substage, VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)
     {
-        {  // Barriers
-            std::array<VkImageMemoryBarrier2, 2> vkBarriers;
-
-            uint32_t index = 0;
-
-            {
-                core::ImageLayoutCache::Barrier2 barrier{.SrcStageMask     = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
-                                                         .SrcAccessMask    = VK_ACCESS_2_MEMORY_WRITE_BIT,
-                                                         .DstStageMask     = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-                                                         .DstAccessMask    = VK_ACCESS_2_SHADER_READ_BIT,
-                                                         .NewLayout        = VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                                         .SubresourceRange = VkImageSubresourceRange{.aspectMask = substage.Input.Aspect, .levelCount = 1, .layerCount = 1}};
-                vkBarriers[index++] = (renderInfo.GetImageLayoutCache().MakeBarrier(substage.Input.Image, barrier));
-            }
-            {
-                core::ImageLayoutCache::Barrier2 barrier{
-                    .SrcStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
-                    .SrcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT | VK_ACCESS_2_MEMORY_READ_BIT,
-                    .DstStageMask  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-                    .DstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
-                    .NewLayout     = VkImageLayout::VK_IMAGE_LAYOUT_GENERAL,
-                };
-                vkBarriers[index++] = (renderInfo.GetImageLayoutCache().MakeBarrier(mOutput, barrier));
-            }
-
-            VkDependencyInfo depInfo{
-                .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO, .imageMemoryBarrierCount = (uint32_t)vkBarriers.size(), .pImageMemoryBarriers = vkBarriers.data()};
-
-            vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
-        }
         {  // Bind
             mContext->VkbDispatchTable->cmdBindPipeline(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, substage.Pipeline);
 
-            VkDescriptorSet descriptorSet = substage.DescriptorSet.GetDescriptorSet();
-
-            mContext->VkbDispatchTable->cmdBindDescriptorSets(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, substage.PipelineLayout, 0U, 1U, &descriptorSet, 0U,
-                                                              nullptr);
+            substage.DescriptorSet.CmdBind(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, substage.PipelineLayout, 0U);
         }
         glm::uvec2 groupSize;
         uint32_t   writeOffset;
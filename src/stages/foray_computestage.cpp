@@ -17,9 +17,7 @@ namespace foray::stages {
 
         mContext->VkbDispatchTable->cmdBindPipeline(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, mPipeline);
 
-        VkDescriptorSet descriptorSet = mDescriptorSet.GetDescriptorSet();
-
-        mContext->VkbDispatchTable->cmdBindDescriptorSets(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0U, 1U, &descriptorSet, 0U, nullptr);
+        mDescriptorSet.CmdBind(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0U);
 
         glm::uvec3 groupSize;
         ApiBeforeDispatch(cmdBuffer, renderInfo, groupSize);
@@ -37,11 +35,12 @@ namespace foray::stages {
         VkComputePipelineCreateInfo pipelineCi
         {
             .sType = VkStructureType::VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .flags = mDescriptorSet.GetPipelineCreateFlags(),
             .stage = shaderStageCi,
             .layout = mPipelineLayout,
         };
 
-        AssertVkResult(mContext->VkbDispatchTable->createComputePipelines(nullptr, 1U, &pipelineCi, nullptr, &mPipeline));
+        AssertVkResult(mContext->VkbDispatchTable->createComputePipelines(mContext->PipelineCache, 1U, &pipelineCi, nullptr, &mPipeline));
     }
     void ComputeStageBase::ReloadShaders()
     {
@@ -1,4 +1,5 @@
 #include "foray_defaultraytracingstage.hpp"
+#include "../core/foray_bindlessheap.hpp"
 #include "../core/foray_samplercollection.hpp"
 #include "../core/foray_shadermanager.hpp"
 #include "../core/foray_shadermodule.hpp"
@@ -21,14 +22,17 @@ namespace foray::stages {
         mEnvironmentMap = envMap;
         mNoiseTexture   = noiseImage;
         mContext = context;
+        Assert(!!mContext->Bindless && mContext->Bindless->Exists(), "[DefaultRaytracingStageBase::Init] Textures are sampled through the bindless heap, Context::Bindless is required");
         ApiCustomObjectsCreate();
         CreateOutputImages();
         CreateOrUpdateDescriptors();
         CreatePipelineLayout();
+        mPipeline.SetPipelineCreateFlags(mPipelineLayout.GetPipelineCreateFlags());
         ApiCreateRtPipeline();
     }
     void DefaultRaytracingStageBase::RecordFrame(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)
     {
+        UpdateTextureDescriptors();
         RecordFramePrepare(cmdBuffer, renderInfo);
         RecordFrameBind(cmdBuffer, renderInfo);
         RecordFrameTraceRays(cmdBuffer, renderInfo);
@@ -60,7 +64,8 @@ namespace foray::stages {
     }
     void DefaultRaytracingStageBase::CreatePipelineLayout()
     {
-        mPipelineLayout.AddDescriptorSetLayout(mDescriptorSet.GetDescriptorSetLayout());
+        mPipelineLayout.AddDescriptorSetLayout(mDescriptorSet);
+        mPipelineLayout.AddDescriptorSetLayout(*mContext->Bindless);
         if(mRngSeedPushCOffset != ~0U)
         {
             mPipelineLayout.AddPushConstantRange<uint32_t>(RTSTAGEFLAGS, mRngSeedPushCOffset);
@@ -90,7 +95,8 @@ namespace foray::stages {
         mDescriptorSet.SetDescriptorAt(BIND_VERTICES, geometryStore->GetVerticesBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, RTSTAGEFLAGS);
         mDescriptorSet.SetDescriptorAt(BIND_INDICES, geometryStore->GetIndicesBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, RTSTAGEFLAGS);
         mDescriptorSet.SetDescriptorAt(BIND_MATERIAL_BUFFER, materialBuffer->GetVkDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, RTSTAGEFLAGS);
-        mDescriptorSet.SetDescriptorAt(BIND_TEXTURES_ARRAY, textureStore->GetDescriptorInfos(), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, RTSTAGEFLAGS);
+        mDescriptorSet.SetDescriptorAt(BIND_TEXTURE_TABLE, textureStore->GetBindlessTableDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, RTSTAGEFLAGS);
+        mBindlessTableVersion = textureStore->GetBindlessTableVersion();
         mDescriptorSet.SetDescriptorAt(BIND_GEOMETRYMETA, metaBuffer.GetVkDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, RTSTAGEFLAGS);
 
         if(!!mEnvironmentMap)
@@ -108,6 +114,8 @@ namespace foray::stages {
         }
         else
         {
+            // Pipelines can not mix descriptor buffer backed and pool allocated sets
+            mDescriptorSet.SetAllowDescriptorBuffer(mContext->Bindless->GetUsesDescriptorBuffer());
             mDescriptorSet.Create(mContext, "RaytracingStageDescriptorSet");
         }
     }
@@ -115,6 +123,17 @@ namespace foray::stages {
     {
         mDescriptorSet.Destroy();
     }
+    void DefaultRaytracingStageBase::UpdateTextureDescriptors()
+    {
+        // Textures added or removed only change heap elements and table entries, the table binding is rewritten if the table was recreated
+        auto textureStore = mScene->GetComponent<scene::gcomp::TextureManager>();
+        if(textureStore->GetBindlessTableVersion() == mBindlessTableVersion)
+        {
+            return;
+        }
+        WaitForPreviousFrames();
+        CreateOrUpdateDescriptors();
+    }
     void DefaultRaytracingStageBase::RecordFramePrepare(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)
     {
         std::vector<VkImageMemoryBarrier2>  imageBarriers;
@@ -149,9 +168,7 @@ namespace foray::stages {
     {
         mPipeline.CmdBindPipeline(cmdBuffer);
 
-        VkDescriptorSet descriptorSet = mDescriptorSet.GetDescriptorSet();
-
-        vkCmdBindDescriptorSets(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, mPipelineLayout, 0U, 1U, &descriptorSet, 0U, nullptr);
+        core::DescriptorSet::CmdBindSets(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, mPipelineLayout, 0U, {&mDescriptorSet, mContext->Bindless});
     }
     void DefaultRaytracingStageBase::RecordFrameTraceRays(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)
     {
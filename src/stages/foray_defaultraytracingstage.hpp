@@ -10,6 +10,7 @@ namespace foray::stages {
     /// @brief Extended version of MinimalRaytracingStageBase limited to a single output image, descriptorset but providing
     /// built in support for scene (Camera, Tlas, Geometry, Materials), EnvironmentMap and Noise Texture
     /// @details
+    /// Textures are sampled through the bindless heap (Context::Bindless, bound as set rtbindpoints::SET_BINDLESS), addressed via the texture table.
     /// # Features
     ///  * Fully setup descriptorset
     ///  * Pipeline Barriers
@@ -22,12 +23,13 @@ namespace foray::stages {
     {
       public:
         /// @brief Nominal init for DefaultRaytracingStageBase
+        /// @param context Requires Bindless
         /// @param scene Scene provides Camera, Tlas, Geometry and Materials
         /// @param envMap Environment Map
         /// @param noiseImage Noise Texture
         void Init(core::Context* context, scene::Scene* scene, core::CombinedImageSampler* envMap = nullptr, core::ManagedImage* noiseImage = nullptr);
 
-        /// @brief Calls RecordFramePrepare(), RecordFrameBind(), RecordFrameTraceRays() in this order
+        /// @brief Calls UpdateTextureDescriptors(), RecordFramePrepare(), RecordFrameBind(), RecordFrameTraceRays() in this order
         virtual void RecordFrame(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo) override;
         /// @brief Calls RenderStage::Resize(..) which resizes any image registered to mImageOutputs, calls CreateOrUpdateDescriptors() afterwards.
         /// @param extent New render extent
@@ -46,7 +48,7 @@ namespace foray::stages {
         /// @details mOutput initialized as rgba32f with Swapchains extent and usage flags VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
         virtual void CreateOutputImages();
 
-        /// @brief Creates Pipeline layout with mDescriptorSets layout and an optional single uint pushconstant (see mRngSeedPushCOffset)
+        /// @brief Creates Pipeline layout with mDescriptorSets layout, the bindless heaps layout and an optional single uint pushconstant (see mRngSeedPushCOffset)
         virtual void CreatePipelineLayout();
         /// @brief Inheriting types should create mPipeline here (load shaders, configure sbts, build)
         virtual void ApiCreateRtPipeline() = 0;
@@ -62,13 +64,15 @@ namespace foray::stages {
         virtual void CreateOrUpdateDescriptors();
         /// @brief Destroys the descriptor set
         virtual void DestroyDescriptors();
+        /// @brief Rewrites the texture table binding if the TextureManager recreated its bindless table
+        virtual void UpdateTextureDescriptors();
 
         /// @brief Calls ApiDestroyRtPipeline(), ApiCreateRtPipeline() in this order
         virtual void ReloadShaders() override;
 
         /// @brief Pipeline barriers
         virtual void RecordFramePrepare(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo);
-        /// @brief Bind pipeline and descriptorset
+        /// @brief Bind pipeline, descriptorset and bindless heap
         virtual void RecordFrameBind(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo);
         /// @brief Push constant and Trace rays
         virtual void RecordFrameTraceRays(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo);
@@ -94,5 +98,8 @@ namespace foray::stages {
 
         /// @brief If set to anything other than ~0U a uint push constant containing the current frame idx as a seed value is added
         uint32_t mRngSeedPushCOffset = 0;
+
+        /// @brief TextureManager::GetBindlessTableVersion() the texture table binding was written with
+        uint64_t mBindlessTableVersion = 0;
     };
 }  // namespace foray::stages
\ No newline at end of file
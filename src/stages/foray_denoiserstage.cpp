@@ -1,4 +1,47 @@
 #include "foray_denoiserstage.hpp"
+#include "../core/foray_barrierbatch.hpp"
 
 namespace foray::stages {
+    void DenoiserStage::AddConfigBarriers(
+        const DenoiserConfig& config, core::BarrierBatch& barriers, VkPipelineStageFlags2 dstStageMask, VkImageLayout inputLayout, VkImageLayout outputLayout)
+    {
+        auto fullRange = [](const core::ManagedImage* image) {
+            return VkImageSubresourceRange{.aspectMask     = image->GetCreateInfo().ImageViewCI.subresourceRange.aspectMask,
+                                           .baseMipLevel   = 0,
+                                           .levelCount     = VK_REMAINING_MIP_LEVELS,
+                                           .baseArrayLayer = 0,
+                                           .layerCount     = VK_REMAINING_ARRAY_LAYERS};
+        };
+        auto addInput = [&](const core::ManagedImage* image) {
+            if(!image || image == config.PrimaryOutput)
+            {
+                return;
+            }
+            barriers.AddImage(image, core::ImageLayoutCache::Barrier2{.SrcStageMask     = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                                      .SrcAccessMask    = VK_ACCESS_2_MEMORY_WRITE_BIT,
+                                                                      .DstStageMask     = dstStageMask,
+                                                                      .DstAccessMask    = VK_ACCESS_2_SHADER_READ_BIT,
+                                                                      .NewLayout        = inputLayout,
+                                                                      .SubresourceRange = fullRange(image)});
+        };
+
+        addInput(config.PrimaryInput);
+        for(const core::ManagedImage* image : config.GBufferOutputs)
+        {
+            addInput(image);
+        }
+        for(const auto& entry : config.AuxiliaryInputs)
+        {
+            addInput(entry.second);
+        }
+        if(!!config.PrimaryOutput)
+        {
+            barriers.AddImage(config.PrimaryOutput, core::ImageLayoutCache::Barrier2{.SrcStageMask     = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                                                     .SrcAccessMask    = VK_ACCESS_2_MEMORY_WRITE_BIT | VK_ACCESS_2_MEMORY_READ_BIT,
+                                                                                     .DstStageMask     = dstStageMask,
+                                                                                     .DstAccessMask    = VK_ACCESS_2_SHADER_WRITE_BIT,
+                                                                                     .NewLayout        = outputLayout,
+                                                                                     .SubresourceRange = fullRange(config.PrimaryOutput)});
+        }
+    }
 }  // namespace foray::stages
@@ -1,5 +1,6 @@
 #pragma once
 #include "../bench/foray_bench_declares.hpp"
+#include "../core/foray_core_declares.hpp"
 #include "../util/foray_externalsemaphore.hpp"
 #include "foray_gbuffer.hpp"
 #include "foray_renderstage.hpp"
@@ -48,6 +49,19 @@ namespace foray::stages {
         virtual void DisplayImguiConfiguration(){};
         /// @brief Signals the denoiser stage that history information is to be ignored for the coming frame
         virtual void IgnoreHistoryNextFrame(){};
+
+      protected:
+        /// @brief Adds layout transitions for all images referenced by config, so a denoiser can prepare its inputs and output with a single barrier command
+        /// @param config Denoiser configuration. Unset images are skipped, all mip levels and array layers are transitioned
+        /// @param barriers Batch the barriers are added to. Requires an ImageLayoutCache
+        /// @param dstStageMask Stages accessing the images
+        /// @param inputLayout Layout for the primary, GBuffer and auxiliary inputs
+        /// @param outputLayout Layout for the primary output
+        static void AddConfigBarriers(const DenoiserConfig& config,
+                                      core::BarrierBatch&   barriers,
+                                      VkPipelineStageFlags2 dstStageMask,
+                                      VkImageLayout         inputLayout  = VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                      VkImageLayout         outputLayout = VkImageLayout::VK_IMAGE_LAYOUT_GENERAL);
     };
 
     /// @brief Base class for externally computing denoiser implementations (e.g. OptiX Denoiser)
@@ -0,0 +1,219 @@
+#include "foray_frustumcullingstage.hpp"
+#include "../scene/foray_scene.hpp"
+#include "../scene/globalcomponents/foray_cameramanager.hpp"
+#include "../scene/globalcomponents/foray_drawmanager.hpp"
+#include "../scene/globalcomponents/foray_geometrymanager.hpp"
+
+const uint32_t SHADER_INSTANCES[] =
+#include "foray_frustumculling_instances.comp.spv.h"
+    ;
+const uint32_t SHADER_COMMANDS[] =
+#include "foray_frustumculling_commands.comp.spv.h"
+    ;
+
+namespace foray::stages {
+#pragma region Init
+    void FrustumCullingStage::Init(core::Context* context, scene::Scene* scene)
+    {
+        Destroy();
+        mContext = context;
+        mScene   = scene;
+
+        auto drawDirector = mScene->GetComponent<scene::gcomp::DrawDirector>();
+        Assert(!!drawDirector && !!mScene->GetComponent<scene::gcomp::GeometryStore>() && !!mScene->GetComponent<scene::gcomp::CameraManager>(),
+               "FrustumCullingStage requires DrawDirector, GeometryStore and CameraManager global components");
+        drawDirector->SetUseIndirectDraw(true);
+
+        LoadShaders();
+        CreateBuffers();
+        SetupDescriptors();
+        mDescriptorSet.Create(mContext, "Frustum Culling Descriptor Set");
+        CreatePipelines();
+    }
+
+    void FrustumCullingStage::LoadShaders()
+    {
+        mInstancesShader.LoadFromBinary(mContext, SHADER_INSTANCES, sizeof(SHADER_INSTANCES));
+        mCommandsShader.LoadFromBinary(mContext, SHADER_COMMANDS, sizeof(SHADER_COMMANDS));
+    }
+
+    void FrustumCullingStage::CreateBuffers()
+    {
+        auto drawDirector = mScene->GetComponent<scene::gcomp::DrawDirector>();
+
+        VkDeviceSize countsSize = std::max<VkDeviceSize>(drawDirector->GetTotalCount(), 1) * sizeof(uint32_t);
+        if(countsSize > mVisibleCountsBuffer.GetSize())
+        {
+            mVisibleCountsBuffer.Destroy();
+            core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, countsSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0,
+                                               "Frustum Culling Visible Counts");
+            mVisibleCountsBuffer.Create(mContext, ci);
+        }
+        if(!mStatisticsBuffer.Exists())
+        {
+            core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, sizeof(Statistics),
+                                               VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Frustum Culling Statistics");
+            mStatisticsBuffer.Create(mContext, ci);
+        }
+        if(!mReadbackBuffer.Exists())
+        {
+            core::ManagedBuffer::CreateInfo ci(VK_BUFFER_USAGE_TRANSFER_DST_BIT, sizeof(Statistics) * INFLIGHT_FRAME_COUNT, VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+                                               VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT, "Frustum Culling Statistics Readback");
+            mReadbackBuffer.Create(mContext, ci);
+            mReadbackBuffer.Map(mReadbackMap);
+            memset(mReadbackMap, 0, sizeof(Statistics) * INFLIGHT_FRAME_COUNT);
+        }
+    }
+
+    void FrustumCullingStage::SetupDescriptors()
+    {
+        auto cameraManager = mScene->GetComponent<scene::gcomp::CameraManager>();
+        auto drawDirector  = mScene->GetComponent<scene::gcomp::DrawDirector>();
+        auto geometryStore = mScene->GetComponent<scene::gcomp::GeometryStore>();
+        mDescriptorSet.SetDescriptorAt(0, cameraManager->GetVkDescriptorInfo(), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        mDescriptorSet.SetDescriptorAt(1, drawDirector->GetTransformsDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        mDescriptorSet.SetDescriptorAt(2, geometryStore->GetMeshBoundsDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        mDescriptorSet.SetDescriptorAt(3, drawDirector->GetInstanceCullInfoDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        mDescriptorSet.SetDescriptorAt(4, mVisibleCountsBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        mDescriptorSet.SetDescriptorAt(5, drawDirector->GetDrawInstancesDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        mDescriptorSet.SetDescriptorAt(6, drawDirector->GetIndirectCommandsDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        mDescriptorSet.SetDescriptorAt(7, mStatisticsBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    }
+
+    void FrustumCullingStage::CreatePipelines()
+    {
+        mPipelineLayout.AddDescriptorSetLayout(mDescriptorSet);
+        mPipelineLayout.AddPushConstantRange<PushConstant>(VK_SHADER_STAGE_COMPUTE_BIT);
+        mPipelineLayout.Build(mContext);
+
+        VkPipelineShaderStageCreateInfo shaderStageCi{.sType  = VkStructureType::VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                                                      .stage  = VkShaderStageFlagBits::VK_SHADER_STAGE_COMPUTE_BIT,
+                                                      .module = mInstancesShader,
+                                                      .pName  = "main"};
+
+        VkComputePipelineCreateInfo pipelineCi{
+            .sType  = VkStructureType::VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .flags  = mDescriptorSet.GetPipelineCreateFlags(),
+            .stage  = shaderStageCi,
+            .layout = mPipelineLayout,
+        };
+        AssertVkResult(mContext->VkbDispatchTable->createComputePipelines(mContext->PipelineCache, 1U, &pipelineCi, nullptr, &mInstancesPipeline));
+
+        pipelineCi.stage.module = mCommandsShader;
+        AssertVkResult(mContext->VkbDispatchTable->createComputePipelines(mContext->PipelineCache, 1U, &pipelineCi, nullptr, &mCommandsPipeline));
+    }
+
+    void FrustumCullingStage::UpdateDescriptors()
+    {
+        CreateBuffers();
+        SetupDescriptors();
+        mDescriptorSet.Update();
+    }
+
+    void FrustumCullingStage::Destroy()
+    {
+        if(!!mContext && !!mContext->VkbDispatchTable)
+        {
+            if(!!mInstancesPipeline)
+            {
+                mContext->VkbDispatchTable->destroyPipeline(mInstancesPipeline, nullptr);
+                mInstancesPipeline = nullptr;
+            }
+            if(!!mCommandsPipeline)
+            {
+                mContext->VkbDispatchTable->destroyPipeline(mCommandsPipeline, nullptr);
+                mCommandsPipeline = nullptr;
+            }
+        }
+        mInstancesShader.Destroy();
+        mCommandsShader.Destroy();
+        mPipelineLayout.Destroy();
+        mDescriptorSet.Destroy();
+        if(mReadbackBuffer.Exists())
+        {
+            mReadbackBuffer.Unmap();
+            mReadbackMap = nullptr;
+        }
+        mReadbackBuffer.Destroy();
+        mStatisticsBuffer.Destroy();
+        mVisibleCountsBuffer.Destroy();
+    }
+
+#pragma endregion
+#pragma region Render
+
+    void FrustumCullingStage::RecordFrame(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)
+    {
+        auto drawDirector = mScene->GetComponent<scene::gcomp::DrawDirector>();
+
+        // The readback slot of this frame was last written INFLIGHT_FRAME_COUNT frames ago, which has finished executing before this frame started recording
+        const uint32_t readbackIndex = (uint32_t)(renderInfo.GetFrameNumber() % INFLIGHT_FRAME_COUNT);
+        memcpy(&mStatistics, reinterpret_cast<const uint8_t*>(mReadbackMap) + readbackIndex * sizeof(Statistics), sizeof(Statistics));
+
+        PushConstant pushC{.InstanceCount  = drawDirector->GetTotalCount(),
+                           .CommandCount   = drawDirector->GetIndirectDrawCount(),
+                           .CullingEnabled = mCullingEnabled ? VK_TRUE : VK_FALSE,
+                           .TransformBase  = drawDirector->GetCurrentTransformBase()};
+
+        Assert(pushC.InstanceCount * sizeof(uint32_t) <= mVisibleCountsBuffer.GetSize(),
+               "FrustumCullingStage: Visible counts buffer too small. Call UpdateDescriptors() after DrawDirector::InitOrUpdate()");
+
+        auto lMemoryBarrier = [&](VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) {
+            VkMemoryBarrier2 barrier{.sType         = VkStructureType::VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                                     .srcStageMask  = srcStage,
+                                     .srcAccessMask = srcAccess,
+                                     .dstStageMask  = dstStage,
+                                     .dstAccessMask = dstAccess};
+            VkDependencyInfo depInfo{.sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO, .memoryBarrierCount = 1U, .pMemoryBarriers = &barrier};
+            vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
+        };
+
+        // STEP #1    Reset counters. Previous frames draws must have finished reading the indirect buffers, transform and camera uploads must be visible
+
+        lMemoryBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                       VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                       VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+        vkCmdFillBuffer(cmdBuffer, mVisibleCountsBuffer.GetBuffer(), 0, VK_WHOLE_SIZE, 0);
+        vkCmdFillBuffer(cmdBuffer, mStatisticsBuffer.GetBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+        lMemoryBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                       VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+        // STEP #2    Test instances, compact visible instances per draw op
+
+        mDescriptorSet.CmdBind(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0U);
+        mContext->VkbDispatchTable->cmdPushConstants(cmdBuffer, mPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0U, sizeof(PushConstant), &pushC);
+
+        const uint32_t localSize = 64;
+        if(pushC.InstanceCount > 0)
+        {
+            mContext->VkbDispatchTable->cmdBindPipeline(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, mInstancesPipeline);
+            mContext->VkbDispatchTable->cmdDispatch(cmdBuffer, (pushC.InstanceCount + localSize - 1) / localSize, 1U, 1U);
+        }
+
+        lMemoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                       VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+        // STEP #3    Write visible instance counts into the indirect draw commands
+
+        if(pushC.CommandCount > 0)
+        {
+            mContext->VkbDispatchTable->cmdBindPipeline(cmdBuffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, mCommandsPipeline);
+            mContext->VkbDispatchTable->cmdDispatch(cmdBuffer, (pushC.CommandCount + localSize - 1) / localSize, 1U, 1U);
+        }
+
+        lMemoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                       VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT);
+
+        // STEP #4    Copy statistics for host readback
+
+        VkBufferCopy copy{.srcOffset = 0, .dstOffset = readbackIndex * sizeof(Statistics), .size = sizeof(Statistics)};
+        vkCmdCopyBuffer(cmdBuffer, mStatisticsBuffer.GetBuffer(), mReadbackBuffer.GetBuffer(), 1U, &copy);
+
+        lMemoryBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT);
+    }
+
+#pragma endregion
+}  // namespace foray::stages
@@ -0,0 +1,85 @@
+#pragma once
+#include "../core/foray_managedbuffer.hpp"
+#include "../core/foray_shadermodule.hpp"
+#include "../scene/foray_scene_declares.hpp"
+#include "../util/foray_pipelinelayout.hpp"
+#include "foray_renderstage.hpp"
+#include <array>
+
+namespace foray::stages {
+
+    /// @brief Compute pre-pass culling DrawDirector mesh instances against the camera frustum
+    /// @details
+    /// Runs two compute passes before the GBuffer (or any other stage drawing via DrawDirector::Draw()) renders:
+    ///  1. One invocation per instance transforms the meshes bounding sphere (GeometryStore mesh bounds table) to world space and tests it against the frustum
+    ///     planes of the selected camera. Visible instances are compacted to the front of their draw ops instance slots in the DrawDirector draw instance buffer.
+    ///  2. One invocation per indirect draw command writes the visible instance count of its draw op into instanceCount.
+    /// Requires DrawDirector::UseIndirectDraw (set by Init()). Non-indexed primitives are drawn directly and are not culled.
+    /// If the device lacks indirect draw support (see DrawDirector::IsIndirectDrawSupported()), DrawDirector draws from the CPU and culling results are ignored.
+    /// Visible and culled counts are copied to a host visible buffer every frame, see GetStatistics().
+    class FrustumCullingStage : public RenderStage
+    {
+      public:
+        /// @brief Visible and culled totals of a frame
+        struct Statistics
+        {
+            uint32_t VisibleInstances = 0;
+            uint32_t CulledInstances  = 0;
+            /// @brief Indirect draw commands with at least one visible instance
+            uint32_t VisibleDraws = 0;
+            /// @brief Indirect draw commands with all instances culled
+            uint32_t CulledDraws = 0;
+        };
+
+        /// @param scene Scene providing DrawDirector, GeometryStore and CameraManager global components
+        virtual void Init(core::Context* context, scene::Scene* scene);
+
+        /// @brief Reads back statistics, records both culling passes
+        virtual void RecordFrame(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo) override;
+
+        /// @brief Rewrites the descriptor set. Call after DrawDirector::InitOrUpdate() or GeometryStore::InitOrUpdate() recreated their buffers
+        virtual void UpdateDescriptors();
+
+        virtual void Destroy() override;
+
+        /// @brief Statistics of the frame recorded INFLIGHT_FRAME_COUNT frames ago (the most recent frame guaranteed to have finished executing)
+        FORAY_GETTER_CR(Statistics)
+        /// @brief If false, all instances are considered visible (indirect buffers are still written, so toggling at runtime is safe)
+        FORAY_PROPERTY_V(CullingEnabled)
+
+      protected:
+        struct PushConstant
+        {
+            uint32_t InstanceCount  = 0;
+            uint32_t CommandCount   = 0;
+            VkBool32 CullingEnabled = VK_TRUE;
+            uint32_t TransformBase  = 0;
+        };
+
+        void LoadShaders();
+        void CreateBuffers();
+        void SetupDescriptors();
+        void CreatePipelines();
+
+        scene::Scene* mScene = nullptr;
+
+        core::ShaderModule mInstancesShader;
+        core::ShaderModule mCommandsShader;
+
+        core::DescriptorSet  mDescriptorSet;
+        util::PipelineLayout mPipelineLayout;
+        VkPipeline           mInstancesPipeline = nullptr;
+        VkPipeline           mCommandsPipeline  = nullptr;
+
+        /// @brief uint32 visible instance counter per transform (only the slots at draw op first instances are used)
+        core::ManagedBuffer mVisibleCountsBuffer;
+        /// @brief Statistics struct written by the culling passes
+        core::ManagedBuffer mStatisticsBuffer;
+        /// @brief One Statistics struct per frame in flight, host visible
+        core::ManagedBuffer mReadbackBuffer;
+        void*               mReadbackMap = nullptr;
+
+        Statistics mStatistics;
+        bool       mCullingEnabled = true;
+    };
+}  // namespace foray::stages
@@ -1,5 +1,7 @@
 #include "foray_gbuffer.hpp"
 #include "../bench/foray_devicebenchmark.hpp"
+#include "../core/foray_barrierbatch.hpp"
+#include "../core/foray_bindlessheap.hpp"
 #include "../core/foray_shadermanager.hpp"
 #include "../scene/components/foray_meshinstance.hpp"
 #include "../scene/globalcomponents/foray_cameramanager.hpp"
@@ -31,6 +33,7 @@ namespace foray::stages {
         mScene              = scene;
         mVertexShaderPath   = vertexShaderPath;
         mFragmentShaderPath = fragmentShaderPath;
+        Assert(!!mContext->Bindless && mContext->Bindless->Exists(), "[GBufferStage::Init] Textures are sampled through the bindless heap, Context::Bindless is required");
 
         CreateImages();
         PrepareRenderpass();
@@ -278,20 +281,25 @@ namespace foray::stages {
         auto cameraManager  = mScene->GetComponent<scene::gcomp::CameraManager>();
         auto drawDirector   = mScene->GetComponent<scene::gcomp::DrawDirector>();
         mDescriptorSet.SetDescriptorAt(0, materialBuffer->GetVkDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT);
-        mDescriptorSet.SetDescriptorAt(1, textureStore->GetDescriptorInfos(), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT);
+        mDescriptorSet.SetDescriptorAt(1, textureStore->GetBindlessTableDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT);
+        mBindlessTableVersion = textureStore->GetBindlessTableVersion();
         mDescriptorSet.SetDescriptorAt(2, cameraManager->GetVkDescriptorInfo(), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
-        mDescriptorSet.SetDescriptorAt(3, drawDirector->GetCurrentTransformsDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
-        mDescriptorSet.SetDescriptorAt(4, drawDirector->GetPreviousTransformsDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
+        mDescriptorSet.SetDescriptorAt(3, drawDirector->GetTransformsDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
+        mDescriptorSet.SetDescriptorAt(4, drawDirector->GetDrawMaterialIndicesDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
+        mDescriptorSet.SetDescriptorAt(5, drawDirector->GetDrawInstancesDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
     }
 
     void GBufferStage::CreateDescriptorSets()
     {
+        // Pipelines can not mix descriptor buffer backed and pool allocated sets
+        mDescriptorSet.SetAllowDescriptorBuffer(mContext->Bindless->GetUsesDescriptorBuffer());
         mDescriptorSet.Create(mContext, "GBuffer_DescriptorSet");
     }
 
     void GBufferStage::CreatePipelineLayout()
     {
-        mPipelineLayout.AddDescriptorSetLayout(mDescriptorSet.GetDescriptorSetLayout());
+        mPipelineLayout.AddDescriptorSetLayout(mDescriptorSet);
+        mPipelineLayout.AddDescriptorSetLayout(*mContext->Bindless);
         mPipelineLayout.AddPushConstantRange<scene::DrawPushConstant>(VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT | VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT);
         mPipelineLayout.Build(mContext);
     }
@@ -336,6 +344,7 @@ namespace foray::stages {
             .SetVertexInputStateBuilder(&vertexInputStateBuilder)
             .SetShaderStageCreateInfos(shaderStageCreateInfos.Get())
             .SetPipelineCache(mContext->PipelineCache)
+            .SetPipelineCreateFlags(mPipelineLayout.GetPipelineCreateFlags())
             .SetRenderPass(mRenderpass)
             .Build();
         // clang-format on
@@ -392,6 +401,20 @@ namespace foray::stages {
         PrepareRenderpass();
     }
 
+    void GBufferStage::UpdateTextureDescriptors()
+    {
+        // Textures added or removed only change heap elements and table entries, the table binding is rewritten if the table was recreated
+        auto textureStore = mScene->GetComponent<scene::gcomp::TextureManager>();
+        if(textureStore->GetBindlessTableVersion() == mBindlessTableVersion)
+        {
+            return;
+        }
+        WaitForPreviousFrames();
+        mBindlessTableVersion = textureStore->GetBindlessTableVersion();
+        mDescriptorSet.SetDescriptorAt(1, textureStore->GetBindlessTableDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT);
+        mDescriptorSet.Update();
+    }
+
 #pragma endregion
 #pragma region Misc
 
@@ -404,6 +427,7 @@ namespace foray::stages {
 
     void GBufferStage::RecordFrame(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)
     {
+        UpdateTextureDescriptors();
 
         uint32_t frameNum = renderInfo.GetFrameNumber();
         if(!!mBenchmark)
@@ -412,13 +436,16 @@ namespace foray::stages {
             mBenchmark->CmdWriteTimestamp(cmdBuffer, frameNum, bench::BenchmarkTimestamp::BEGIN, VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
         }
 
+        // Attachment contents are discarded (UNDEFINED old layout) as they're cleared and rewritten completely, so the layout cache is bypassed here
+        core::BarrierBatch barriers(renderInfo.GetImageLayoutCache());
+
         VkImageMemoryBarrier2 attachmentMemBarrier{
             .sType               = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
             .srcStageMask        = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
             .srcAccessMask       = VK_ACCESS_2_NONE,
             .dstStageMask        = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
             .dstAccessMask       = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
-            .oldLayout           = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,  // We do not care about the contents of all attachments as they're cleared and rewritten completely
+            .oldLayout           = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
             .newLayout           = VkImageLayout::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
             .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
             .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -432,58 +459,30 @@ namespace foray::stages {
                 },
         };
 
-        std::array<VkImageMemoryBarrier2, (size_t)EOutput::MaxEnum> imgBarriers;
-
         for(int32_t i = 0; i < (int32_t)EOutput::Depth; i++)
         {
-            PerImageInfo&          info    = mImageInfos[i];
-            VkImageMemoryBarrier2& barrier = imgBarriers[i];
-
-            barrier       = attachmentMemBarrier;
-            barrier.image = info.Image.GetImage();
+            attachmentMemBarrier.image = mImageInfos[i].Image.GetImage();
+            barriers.AddImage(attachmentMemBarrier);
         }
-        VkImageMemoryBarrier2& depthBarrier      = imgBarriers[(size_t)EOutput::Depth];
-        depthBarrier                             = attachmentMemBarrier;
+        VkImageMemoryBarrier2 depthBarrier       = attachmentMemBarrier;
         depthBarrier.dstStageMask                = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
         depthBarrier.dstAccessMask               = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR;
         depthBarrier.newLayout                   = VkImageLayout::VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
         depthBarrier.subresourceRange.aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_DEPTH_BIT;
         depthBarrier.image                       = mImageInfos[(size_t)EOutput::Depth].Image.GetImage();
-
-        std::vector<VkBufferMemoryBarrier2> bufferBarriers;
-
-        VkBufferMemoryBarrier2 bufferBarrier{.sType               = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
-                                             .srcStageMask        = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
-                                             .srcAccessMask       = VK_ACCESS_2_MEMORY_WRITE_BIT,
-                                             .dstStageMask        = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
-                                             .dstAccessMask       = VK_ACCESS_2_SHADER_READ_BIT,
-                                             .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                             .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                             .offset              = 0,
-                                             .size                = VK_WHOLE_SIZE};
+        barriers.AddImage(depthBarrier);
 
         auto materialBuffer = mScene->GetComponent<scene::gcomp::MaterialManager>();
         auto cameraManager  = mScene->GetComponent<scene::gcomp::CameraManager>();
         auto drawDirector   = mScene->GetComponent<scene::gcomp::DrawDirector>();
 
-        bufferBarrier.buffer = materialBuffer->GetVkBuffer();
-        bufferBarriers.push_back(bufferBarrier);
-        bufferBarriers.push_back(cameraManager->GetUbo().MakeBarrierPrepareForRead(VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT));
-        bufferBarrier.buffer = drawDirector->GetCurrentTransformsVkBuffer();
-        bufferBarriers.push_back(bufferBarrier);
-        bufferBarrier.buffer = drawDirector->GetPreviousTransformsVkBuffer();
-        bufferBarriers.push_back(bufferBarrier);
-
-        VkDependencyInfo depInfo{
-            .sType                    = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            .dependencyFlags          = VkDependencyFlagBits::VK_DEPENDENCY_BY_REGION_BIT,
-            .bufferMemoryBarrierCount = (uint32_t)bufferBarriers.size(),
-            .pBufferMemoryBarriers    = bufferBarriers.data(),
-            .imageMemoryBarrierCount  = (uint32_t)imgBarriers.size(),
-            .pImageMemoryBarriers     = imgBarriers.data(),
-        };
+        barriers.AddBuffer(materialBuffer->GetVkBuffer(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                           VK_ACCESS_2_SHADER_READ_BIT);
+        barriers.AddBuffer(cameraManager->GetUbo().MakeBarrierPrepareForRead(VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT));
+        barriers.AddBuffer(drawDirector->GetTransformsVkBuffer(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                           VK_ACCESS_2_SHADER_READ_BIT);
 
-        vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
+        barriers.CmdFlush(mContext, cmdBuffer, VkDependencyFlagBits::VK_DEPENDENCY_BY_REGION_BIT);
 
         std::array<VkClearValue, (size_t)EOutput::MaxEnum> clearValues;
 
@@ -510,9 +509,8 @@ namespace foray::stages {
 
         vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
 
-        VkDescriptorSet descriptorSet = mDescriptorSet.GetDescriptorSet();
         // Instanced object
-        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+        core::DescriptorSet::CmdBindSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, {&mDescriptorSet, mContext->Bindless});
 
         if(!!mBenchmark)
         {
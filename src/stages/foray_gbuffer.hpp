@@ -18,11 +18,15 @@ namespace foray::stages {
     ///  * MeshInstanceIdx  r32u        Mesh Instance Index. Unique for every ncomp::MeshInstance component
     ///  * LinearZ          rg16f       Linear Depth (projected.z * projected.w), absolute linear depth Gradient
     ///  * Depth            d32f        Vulkan Depth output
+    /// # Descriptors
+    /// Set 0 holds the stages own bindings (see shaders/gbuffer/bindpoints.glsl). Textures are sampled through the bindless heap (Context::Bindless) bound as set 1,
+    /// addressed via TextureManager::GetBindlessTableDescriptorInfo()
     class GBufferStage : public RasterizedRenderStage
     {
       public:
         GBufferStage() = default;
 
+        /// @param context Requires Bindless
         /// @param scene Scene required for transforms, vertex/index buffers, materials, textures, ...
         /// @param vertexShaderPath (optional) override with a custom vertex shader
         /// @param fragmentShaderPath (optional) override with a custom fragment shader
@@ -87,6 +91,11 @@ namespace foray::stages {
         virtual void CreateDescriptorSets() override;
         virtual void CreatePipelineLayout() override;
         void         CreatePipeline();
+        /// @brief Rewrites the texture table binding if the TextureManager recreated its bindless table
+        void UpdateTextureDescriptors();
+
+        /// @brief TextureManager::GetBindlessTableVersion() the texture table binding was written with
+        uint64_t mBindlessTableVersion = 0;
 
         bench::DeviceBenchmark* mBenchmark = nullptr;
 
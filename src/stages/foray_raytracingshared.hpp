@@ -16,14 +16,16 @@ namespace foray::stages {
         const uint32_t BIND_INDICES = 4;
         /// @brief Material Buffer Bind Point
         const uint32_t BIND_MATERIAL_BUFFER = 5;
-        /// @brief Texture Array Bind Point
-        const uint32_t BIND_TEXTURES_ARRAY = 6;
+        /// @brief Texture Table Bind Point (TextureManager::GetBindlessTableDescriptorInfo(), maps texture ids to bindless heap indices)
+        const uint32_t BIND_TEXTURE_TABLE = 6;
         /// @brief GeometryMeta Buffer Bind Point (provided by as::Tlas, maps Blas instances to Index Buffer Offsets and Materials)
         const uint32_t BIND_GEOMETRYMETA = 7;
         /// @brief Environmentmap Sampler Bind Point
         const uint32_t BIND_ENVMAP_SPHERESAMPLER = 9;
         /// @brief  Noise Texture Storage Image Bind Point
         const uint32_t BIND_NOISETEX = 10;
+        /// @brief Set index the bindless heap (Context::Bindless) is bound to. The stages own set is set 0
+        const uint32_t SET_BINDLESS = 1;
     }  // namespace rtbindpoints
 
     /// @brief All shaderstage flags usable in a raytracing pipeline
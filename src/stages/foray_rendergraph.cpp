@@ -0,0 +1,519 @@
+#include "foray_rendergraph.hpp"
+#include "../foray_exception.hpp"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace foray::stages {
+
+#pragma region PassBuilder
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask)
+    {
+        return AddAccess(ImageAccess{.Image = image, .Layout = layout, .StageMask = stageMask, .AccessMask = accessMask, .Read = true});
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask)
+    {
+        return AddAccess(ImageAccess{.Image = image, .Layout = layout, .StageMask = stageMask, .AccessMask = accessMask, .Write = true});
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::ReadHistory(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask)
+    {
+        return AddAccess(ImageAccess{.Image = image, .Layout = layout, .StageMask = stageMask, .AccessMask = accessMask, .Read = true, .History = true});
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::ReadWrite(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask)
+    {
+        return AddAccess(ImageAccess{.Image = image, .Layout = layout, .StageMask = stageMask, .AccessMask = accessMask, .Read = true, .Write = true});
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetSideEffects(bool sideEffects)
+    {
+        mGraph->mPasses[mIndex].SideEffects = sideEffects;
+        mGraph->mCompiled                   = false;
+        return *this;
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::AddAccess(const ImageAccess& access)
+    {
+        Assert(!!access.Image, "[RenderGraph] Image access requires an image");
+        Pass& pass        = mGraph->mPasses[mIndex];
+        mGraph->mCompiled = false;
+        for(ImageAccess& existing : pass.Accesses)
+        {
+            if(existing.Image != access.Image)
+            {
+                continue;
+            }
+            FORAY_ASSERTFMT(existing.Layout == access.Layout, "[RenderGraph] Pass \"{}\" accesses an image in differing layouts", pass.Name)
+            FORAY_ASSERTFMT(!existing.History && !access.History, "[RenderGraph] Pass \"{}\" combines a history read with other accesses of an image", pass.Name)
+            existing.StageMask |= access.StageMask;
+            existing.AccessMask |= access.AccessMask;
+            existing.Read |= access.Read;
+            existing.Write |= access.Write;
+            return *this;
+        }
+        pass.Accesses.push_back(access);
+        return *this;
+    }
+
+#pragma endregion
+#pragma region Setup
+
+    RenderGraph::PassBuilder RenderGraph::AddPass(std::string_view name, RenderStage* stage)
+    {
+        Assert(!!stage, "[RenderGraph] AddPass requires a stage");
+        mPasses.push_back(Pass{.Name = std::string(name), .Stage = stage});
+        mCompiled = false;
+        return PassBuilder(this, (uint32_t)mPasses.size() - 1);
+    }
+
+    RenderGraph::PassBuilder RenderGraph::AddPass(std::string_view name, RecordFunc record)
+    {
+        Assert(!!record, "[RenderGraph] AddPass requires a record function");
+        mPasses.push_back(Pass{.Name = std::string(name), .Record = record});
+        mCompiled = false;
+        return PassBuilder(this, (uint32_t)mPasses.size() - 1);
+    }
+
+    void RenderGraph::MarkOutput(core::ManagedImage* image)
+    {
+        if(std::find(mOutputs.begin(), mOutputs.end(), image) == mOutputs.end())
+        {
+            mOutputs.push_back(image);
+        }
+        mCompiled = false;
+    }
+
+    void RenderGraph::Clear()
+    {
+        mPasses.clear();
+        mOutputs.clear();
+        mOrder.clear();
+        mCompiled             = false;
+        mCulledPassCount      = 0;
+        mPlannedBarrierCount  = 0;
+        mRecordedBarrierCount = 0;
+    }
+
+#pragma endregion
+#pragma region Compile
+
+    void RenderGraph::Compile()
+    {
+        std::vector<std::vector<uint32_t>> dependencies;
+        std::vector<std::vector<uint32_t>> historySources;
+        BuildDependencies(dependencies, historySources);
+        CullPasses(dependencies, historySources);
+        SortPasses(dependencies);
+        PlanBarriers();
+        mCompiled = true;
+    }
+
+    void RenderGraph::BuildDependencies(std::vector<std::vector<uint32_t>>& outDependencies, std::vector<std::vector<uint32_t>>& outHistorySources) const
+    {
+        outDependencies.assign(mPasses.size(), {});
+        outHistorySources.assign(mPasses.size(), {});
+
+        // Collect accesses per image in declaration order
+        std::unordered_map<const core::ManagedImage*, std::vector<std::pair<uint32_t, const ImageAccess*>>> accessesPerImage;
+        for(uint32_t passIndex = 0; passIndex < mPasses.size(); passIndex++)
+        {
+            for(const ImageAccess& access : mPasses[passIndex].Accesses)
+            {
+                accessesPerImage[access.Image].push_back(std::make_pair(passIndex, &access));
+            }
+        }
+
+        auto lAddUnique = [](std::vector<uint32_t>& list, uint32_t pass, uint32_t dependency) {
+            if(pass != dependency && std::find(list.begin(), list.end(), dependency) == list.end())
+            {
+                list.push_back(dependency);
+            }
+        };
+        auto lAddDependency = [&](uint32_t pass, uint32_t dependency) { lAddUnique(outDependencies[pass], pass, dependency); };
+
+        for(auto& [image, accesses] : accessesPerImage)
+        {
+            // History reads see the previous frames contents: every writer waits for them, and keeps them supplied
+            std::vector<uint32_t> historyReaders;
+            for(const auto& [passIndex, access] : accesses)
+            {
+                if(access->History)
+                {
+                    historyReaders.push_back(passIndex);
+                }
+            }
+            std::erase_if(accesses, [](const std::pair<uint32_t, const ImageAccess*>& entry) { return entry.second->History; });
+
+            uint32_t writerCount = 0;
+            uint32_t writer      = 0;
+            for(const auto& [passIndex, access] : accesses)
+            {
+                if(access->Write)
+                {
+                    writerCount++;
+                    writer = passIndex;
+                    for(uint32_t reader : historyReaders)
+                    {
+                        lAddDependency(passIndex, reader);
+                        lAddUnique(outHistorySources[reader], reader, passIndex);
+                    }
+                }
+            }
+
+            if(writerCount == 1)
+            {
+                // Produced by a single pass: everyone else reads the produced contents
+                for(const auto& [passIndex, access] : accesses)
+                {
+                    lAddDependency(passIndex, writer);
+                }
+                continue;
+            }
+
+            // Multiple writers: accesses happen in declaration order
+            int32_t               lastWriter = -1;
+            std::vector<uint32_t> readersSinceWrite;
+            for(const auto& [passIndex, access] : accesses)
+            {
+                if(lastWriter >= 0)
+                {
+                    lAddDependency(passIndex, (uint32_t)lastWriter);
+                }
+                if(access->Write)
+                {
+                    for(uint32_t reader : readersSinceWrite)
+                    {
+                        lAddDependency(passIndex, reader);
+                    }
+                    readersSinceWrite.clear();
+                    lastWriter = (int32_t)passIndex;
+                }
+                else
+                {
+                    readersSinceWrite.push_back(passIndex);
+                }
+            }
+        }
+    }
+
+    void RenderGraph::CullPasses(const std::vector<std::vector<uint32_t>>& dependencies, const std::vector<std::vector<uint32_t>>& historySources)
+    {
+        mCulledPassCount = 0;
+
+        std::vector<uint32_t> stack;
+        for(uint32_t passIndex = 0; passIndex < mPasses.size(); passIndex++)
+        {
+            const Pass& pass   = mPasses[passIndex];
+            bool        isRoot = pass.SideEffects;
+            for(const ImageAccess& access : pass.Accesses)
+            {
+                isRoot |= access.Write && std::find(mOutputs.begin(), mOutputs.end(), access.Image) != mOutputs.end();
+            }
+            if(isRoot)
+            {
+                stack.push_back(passIndex);
+            }
+        }
+
+        if(stack.empty())
+        {
+            // Nothing to determine relevance by
+            for(Pass& pass : mPasses)
+            {
+                pass.Culled = false;
+            }
+            return;
+        }
+
+        for(Pass& pass : mPasses)
+        {
+            pass.Culled = true;
+        }
+        while(!stack.empty())
+        {
+            uint32_t passIndex = stack.back();
+            stack.pop_back();
+            if(!mPasses[passIndex].Culled)
+            {
+                continue;
+            }
+            mPasses[passIndex].Culled = false;
+            for(uint32_t dependency : dependencies[passIndex])
+            {
+                stack.push_back(dependency);
+            }
+            for(uint32_t source : historySources[passIndex])
+            {
+                stack.push_back(source);
+            }
+        }
+
+        for(const Pass& pass : mPasses)
+        {
+            if(pass.Culled)
+            {
+                mCulledPassCount++;
+            }
+        }
+    }
+
+    void RenderGraph::SortPasses(const std::vector<std::vector<uint32_t>>& dependencies)
+    {
+        // Kahn's algorithm, always picking the ready pass declared first
+        std::vector<uint32_t>              unresolved(mPasses.size(), 0);
+        std::vector<std::vector<uint32_t>> dependents(mPasses.size());
+        uint32_t                           keptCount = 0;
+        for(uint32_t passIndex = 0; passIndex < mPasses.size(); passIndex++)
+        {
+            if(mPasses[passIndex].Culled)
+            {
+                continue;
+            }
+            keptCount++;
+            for(uint32_t dependency : dependencies[passIndex])
+            {
+                // Dependencies of kept passes are never culled
+                unresolved[passIndex]++;
+                dependents[dependency].push_back(passIndex);
+            }
+        }
+
+        std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+        for(uint32_t passIndex = 0; passIndex < mPasses.size(); passIndex++)
+        {
+            if(!mPasses[passIndex].Culled && unresolved[passIndex] == 0)
+            {
+                ready.push(passIndex);
+            }
+        }
+
+        mOrder.clear();
+        while(!ready.empty())
+        {
+            uint32_t passIndex = ready.top();
+            ready.pop();
+            mOrder.push_back(passIndex);
+            for(uint32_t dependent : dependents[passIndex])
+            {
+                if(--unresolved[dependent] == 0)
+                {
+                    ready.push(dependent);
+                }
+            }
+        }
+
+        FORAY_ASSERTFMT(mOrder.size() == keptCount, "[RenderGraph] Pass dependencies contain a cycle ({} of {} passes ordered)", mOrder.size(), keptCount)
+    }
+
+    void RenderGraph::PlanBarriers()
+    {
+        /// @brief Synchronization state of an image while walking the ordered passes
+        struct ImageState
+        {
+            VkImageLayout         Layout      = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags2 WriteStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2        WriteAccess = VK_ACCESS_2_NONE;
+            /// @brief Stages reading since the last write or layout transition
+            VkPipelineStageFlags2 ReadStages = VK_PIPELINE_STAGE_2_NONE;
+            /// @brief Barrier after which the image is readable in its current layout. Later reads widen its destination
+            PlannedBarrier* ReadBarrier = nullptr;
+        };
+
+        std::unordered_map<const core::ManagedImage*, ImageState> states;
+        mPlannedBarrierCount = 0;
+
+        for(Pass& pass : mPasses)
+        {
+            pass.Barriers.clear();
+            // Pointers into Barriers are kept in ReadBarrier, so they must not reallocate
+            pass.Barriers.reserve(pass.Accesses.size());
+        }
+
+        for(uint32_t passIndex : mOrder)
+        {
+            Pass& pass = mPasses[passIndex];
+            for(const ImageAccess& access : pass.Accesses)
+            {
+                bool        firstUse   = !states.contains(access.Image);
+                ImageState& state      = states[access.Image];
+                bool        sameLayout = !firstUse && state.Layout == access.Layout;
+
+                if(!access.Write && sameLayout)
+                {
+                    if(!!state.ReadBarrier)
+                    {
+                        // Widen the barrier which made the image readable. Covers this pass as well, as it is recorded later
+                        state.ReadBarrier->Barrier.DstStageMask |= access.StageMask;
+                        state.ReadBarrier->Barrier.DstAccessMask |= access.AccessMask;
+                        state.ReadStages |= access.StageMask;
+                        continue;
+                    }
+                    if(state.WriteStages == VK_PIPELINE_STAGE_2_NONE)
+                    {
+                        // Nothing written since the last barrier
+                        state.ReadStages |= access.StageMask;
+                        continue;
+                    }
+                }
+
+                core::ImageLayoutCache::Barrier2 barrier{
+                    .DstStageMask     = access.StageMask,
+                    .DstAccessMask    = access.AccessMask,
+                    .NewLayout        = access.Layout,
+                    .SubresourceRange = sFullRange(access.Image),
+                };
+                if(firstUse)
+                {
+                    // Unknown prior use (e.g. previous frame)
+                    barrier.SrcStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                    barrier.SrcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+                }
+                else
+                {
+                    barrier.SrcStageMask  = state.WriteStages | state.ReadStages;
+                    barrier.SrcAccessMask = state.WriteAccess;
+                }
+                pass.Barriers.push_back(PlannedBarrier{.Image = access.Image, .Barrier = barrier});
+                mPlannedBarrierCount++;
+
+                state.Layout = access.Layout;
+                if(access.Write)
+                {
+                    state.WriteStages = access.StageMask;
+                    state.WriteAccess = access.AccessMask;
+                    state.ReadStages  = VK_PIPELINE_STAGE_2_NONE;
+                    state.ReadBarrier = nullptr;
+                }
+                else
+                {
+                    // The barrier synchronizes all prior writes (and the layout transition) with this and subsequent reads
+                    state.WriteStages = VK_PIPELINE_STAGE_2_NONE;
+                    state.WriteAccess = VK_ACCESS_2_NONE;
+                    state.ReadStages  = access.StageMask;
+                    state.ReadBarrier = &pass.Barriers.back();
+                }
+            }
+        }
+    }
+
+    VkImageSubresourceRange RenderGraph::sFullRange(const core::ManagedImage* image)
+    {
+        return VkImageSubresourceRange{.aspectMask     = image->GetCreateInfo().ImageViewCI.subresourceRange.aspectMask,
+                                       .baseMipLevel   = 0,
+                                       .levelCount     = VK_REMAINING_MIP_LEVELS,
+                                       .baseArrayLayer = 0,
+                                       .layerCount     = VK_REMAINING_ARRAY_LAYERS};
+    }
+
+#pragma endregion
+#pragma region Record
+
+    void RenderGraph::RecordFrame(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)
+    {
+        if(!mCompiled)
+        {
+            Compile();
+        }
+
+        core::ImageLayoutCache& layoutCache = renderInfo.GetImageLayoutCache();
+        core::BarrierBatch      batch(layoutCache);
+        mRecordedBarrierCount = 0;
+
+        for(uint32_t passIndex : mOrder)
+        {
+            Pass& pass = mPasses[passIndex];
+            for(const ImageAccess& access : pass.Accesses)
+            {
+                auto planned = std::find_if(pass.Barriers.begin(), pass.Barriers.end(), [&](const PlannedBarrier& barrier) { return barrier.Image == access.Image; });
+                if(planned != pass.Barriers.end())
+                {
+                    batch.AddImage(access.Image, planned->Barrier);
+                }
+                else if(layoutCache.Get(access.Image) != access.Layout)
+                {
+                    // A pass left the image in an undeclared layout. Fall back to a full barrier
+                    batch.AddImage(access.Image, core::ImageLayoutCache::Barrier2{
+                                                     .SrcStageMask     = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                     .SrcAccessMask    = VK_ACCESS_2_MEMORY_WRITE_BIT,
+                                                     .DstStageMask     = access.StageMask,
+                                                     .DstAccessMask    = access.AccessMask,
+                                                     .NewLayout        = access.Layout,
+                                                     .SubresourceRange = sFullRange(access.Image),
+                                                 });
+                }
+            }
+            mRecordedBarrierCount += batch.CmdFlush(cmdBuffer);
+
+            if(!!pass.Stage)
+            {
+                pass.Stage->RecordFrame(cmdBuffer, renderInfo);
+            }
+            else
+            {
+                pass.Record(cmdBuffer, renderInfo);
+            }
+        }
+    }
+
+#pragma endregion
+#pragma region Queries
+
+    std::vector<std::string_view> RenderGraph::GetPassOrder() const
+    {
+        std::vector<std::string_view> result;
+        result.reserve(mOrder.size());
+        for(uint32_t passIndex : mOrder)
+        {
+            result.push_back(mPasses[passIndex].Name);
+        }
+        return result;
+    }
+
+    std::vector<RenderGraph::PlannedBarrier> RenderGraph::GetPlannedBarriers(std::string_view name) const
+    {
+        for(const Pass& pass : mPasses)
+        {
+            if(pass.Name == name && !pass.Culled)
+            {
+                return pass.Barriers;
+            }
+        }
+        return {};
+    }
+
+    std::unordered_map<const core::ManagedImage*, core::TransientImageAllocator::Lifetime> RenderGraph::GetImageLifetimes() const
+    {
+        std::unordered_map<const core::ManagedImage*, core::TransientImageAllocator::Lifetime> result;
+        for(uint32_t position = 0; position < mOrder.size(); position++)
+        {
+            for(const ImageAccess& access : mPasses[mOrder[position]].Accesses)
+            {
+                auto iter = result.find(access.Image);
+                if(iter == result.end())
+                {
+                    bool carriedOver     = access.Read;
+                    result[access.Image] = core::TransientImageAllocator::Lifetime{.FirstUse = carriedOver ? 0 : position, .LastUse = carriedOver ? ~0U : position};
+                }
+                else if(iter->second.LastUse != ~0U)
+                {
+                    iter->second.LastUse = position;
+                }
+            }
+        }
+        for(const core::ManagedImage* output : mOutputs)
+        {
+            auto iter = result.find(output);
+            if(iter != result.end())
+            {
+                iter->second.LastUse = ~0U;
+            }
+        }
+        return result;
+    }
+
+#pragma endregion
+}  // namespace foray::stages
@@ -0,0 +1,144 @@
+#pragma once
+#include "../base/foray_framerenderinfo.hpp"
+#include "../core/foray_barrierbatch.hpp"
+#include "../core/foray_managedimage.hpp"
+#include "../core/foray_transientimageallocator.hpp"
+#include "../foray_basics.hpp"
+#include "foray_renderstage.hpp"
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace foray::stages {
+
+    /// @brief Optional frame graph, ordering passes by their declared image accesses and deriving the barriers between them
+    /// @details
+    /// Passes (render stages or record callbacks) declare which images they read and write (typically outputs obtained via RenderStage::GetImageOutput()),
+    /// along with the layout, pipeline stages and access they require. Compile() then
+    /// - orders the passes topologically. If an image is written by a single pass, all reads of it depend on that pass, regardless of declaration order.
+    ///   Images written by multiple passes are accessed in declaration order. Independent passes keep their declaration order.
+    ///   Reads of the previous frames contents (PassBuilder::ReadHistory(), e.g. temporal accumulation) are ordered before all writes of the image instead.
+    /// - culls passes which neither have side effects nor contribute to an image marked via MarkOutput(). If neither exist, no pass is culled.
+    /// - plans image barriers: one per hazard or layout change, consecutive reads in the same layout share a single barrier whose destination covers all of them.
+    /// RecordFrame() records all barriers planned for a pass in a single vkCmdPipelineBarrier2 (old layouts are taken from the frames ImageLayoutCache),
+    /// then records the pass.
+    /// @remark The first access of an image per frame always synchronizes against all prior commands, as the graph does not know about previous frames.
+    /// @remark Stages still emit their own barriers. Recorded after the graphs barriers, these do not change layouts anymore.
+    class RenderGraph
+    {
+      public:
+        using RecordFunc = std::function<void(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo)>;
+
+        /// @brief Access of a pass to an image. Accesses of one pass to the same image are merged
+        struct ImageAccess
+        {
+            core::ManagedImage*   Image      = nullptr;
+            /// @brief Layout the image is required to be in during the pass. The pass must leave the image in this layout
+            VkImageLayout         Layout     = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags2 StageMask  = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2        AccessMask = VK_ACCESS_2_NONE;
+            bool                  Read       = false;
+            bool                  Write      = false;
+            /// @brief Reads the contents of the previous frame, see PassBuilder::ReadHistory()
+            bool                  History    = false;
+        };
+
+        /// @brief Image barrier planned by Compile()
+        struct PlannedBarrier
+        {
+            core::ManagedImage*              Image = nullptr;
+            core::ImageLayoutCache::Barrier2 Barrier;
+        };
+
+        /// @brief Declares the accesses of a pass added via AddPass()
+        class PassBuilder
+        {
+          public:
+            /// @brief Declares a read of image
+            PassBuilder& Read(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask);
+            /// @brief Declares a write of image. Previous contents are not preserved across layout changes
+            PassBuilder& Write(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask);
+            /// @brief Declares a read of the contents image had at the end of the previous frame (e.g. a history buffer for temporal reprojection).
+            /// The pass is ordered before all passes writing image, and keeps them from being culled.
+            /// @remark May not be combined with other accesses of the same image in one pass. Use ReadWrite() for accumulating in place
+            PassBuilder& ReadHistory(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask);
+            /// @brief Declares a read and write of image (e.g. accumulation in a storage image)
+            PassBuilder& ReadWrite(core::ManagedImage* image, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask);
+            /// @brief Passes with side effects (e.g. presenting, writing to host visible buffers) are never culled
+            PassBuilder& SetSideEffects(bool sideEffects = true);
+
+          protected:
+            friend RenderGraph;
+            inline PassBuilder(RenderGraph* graph, uint32_t index) : mGraph(graph), mIndex(index) {}
+
+            PassBuilder& AddAccess(const ImageAccess& access);
+
+            RenderGraph* mGraph = nullptr;
+            uint32_t     mIndex = 0;
+        };
+
+        /// @brief Adds a pass recording stage->RecordFrame()
+        PassBuilder AddPass(std::string_view name, RenderStage* stage);
+        /// @brief Adds a pass invoking record
+        PassBuilder AddPass(std::string_view name, RecordFunc record);
+        /// @brief Marks image as consumed after the graph (e.g. blitted to the swapchain). Passes contributing to it are not culled
+        void MarkOutput(core::ManagedImage* image);
+
+        /// @brief Orders and culls passes and plans barriers. Required after adding passes or declaring accesses
+        void Compile();
+        /// @brief Records barriers and passes in compiled order
+        void RecordFrame(VkCommandBuffer cmdBuffer, base::FrameRenderInfo& renderInfo);
+
+        /// @brief Removes all passes and outputs
+        void Clear();
+
+        /// @brief Names of the passes not culled, in execution order
+        std::vector<std::string_view> GetPassOrder() const;
+        /// @brief Barriers planned for the pass with name (empty if there is no such pass or it has been culled)
+        std::vector<PlannedBarrier> GetPlannedBarriers(std::string_view name) const;
+        /// @brief Lifetimes of all accessed images in compiled pass order, for core::TransientImageAllocator::Build()
+        /// @details Images marked as output live until the end of the frame. Images read before being written in a frame live for the entire frame,
+        /// as their contents are carried over from the previous frame.
+        std::unordered_map<const core::ManagedImage*, core::TransientImageAllocator::Lifetime> GetImageLifetimes() const;
+
+        FORAY_GETTER_V(Compiled)
+        /// @brief Number of passes culled by the last Compile()
+        FORAY_GETTER_V(CulledPassCount)
+        /// @brief Number of image barriers planned by the last Compile()
+        FORAY_GETTER_V(PlannedBarrierCount)
+        /// @brief Number of image barriers recorded by the last RecordFrame(). Exceeds the planned count if passes left images in undeclared layouts
+        FORAY_GETTER_V(RecordedBarrierCount)
+
+      protected:
+        struct Pass
+        {
+            std::string                 Name;
+            RenderStage*                Stage = nullptr;
+            RecordFunc                  Record;
+            std::vector<ImageAccess>    Accesses;
+            bool                        SideEffects = false;
+            bool                        Culled      = false;
+            std::vector<PlannedBarrier> Barriers;
+        };
+
+        /// @brief Fills outDependencies[pass] with the indices of passes pass depends on, and outHistorySources[pass] with the indices of passes writing
+        /// images pass reads the history of. These run after pass, but must be kept alive along with it
+        void BuildDependencies(std::vector<std::vector<uint32_t>>& outDependencies, std::vector<std::vector<uint32_t>>& outHistorySources) const;
+        void CullPasses(const std::vector<std::vector<uint32_t>>& dependencies, const std::vector<std::vector<uint32_t>>& historySources);
+        void SortPasses(const std::vector<std::vector<uint32_t>>& dependencies);
+        void PlanBarriers();
+
+        static VkImageSubresourceRange sFullRange(const core::ManagedImage* image);
+
+        std::vector<Pass>                mPasses;
+        std::vector<core::ManagedImage*> mOutputs;
+        /// @brief Indices into mPasses in execution order, culled passes excluded
+        std::vector<uint32_t> mOrder;
+
+        bool     mCompiled             = false;
+        uint32_t mCulledPassCount      = 0;
+        uint32_t mPlannedBarrierCount  = 0;
+        uint32_t mRecordedBarrierCount = 0;
+    };
+}  // namespace foray::stages
@@ -1,4 +1,5 @@
 #include "foray_renderstage.hpp"
+#include "../core/foray_frametimeline.hpp"
 #include "../core/foray_shadermanager.hpp"
 #include "../core/foray_shadermodule.hpp"
 
@@ -61,4 +62,16 @@ namespace foray::stages {
             ReloadShaders();
         }
     }
-}  // namespace foray::stages
\ No newline at end of file
+
+    void RenderStage::WaitForPreviousFrames()
+    {
+        core::FrameTimeline* timeline = mContext->Timeline;
+        if(!!timeline && timeline->Exists())
+        {
+            uint64_t current = timeline->GetSubmittedValue();
+            timeline->Wait(current > 0 ? current - 1 : 0);
+            return;
+        }
+        AssertVkResult(mContext->VkbDispatchTable->deviceWaitIdle());
+    }
+}  // namespace foray::stages
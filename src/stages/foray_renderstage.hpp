@@ -51,6 +51,9 @@ namespace foray::stages {
         virtual void ReloadShaders() {}
         /// @brief Calls Destroy() on any image in mImageOutputs and clears mImageOutputs
         virtual void DestroyOutputImages();
+        /// @brief Blocks until all frames recorded before the current one have finished executing, so descriptor sets they bind may be rewritten during RecordFrame()
+        /// @details Waits on Context::Timeline if set (the current frame has been assigned a value already), for the device to become idle otherwise
+        void WaitForPreviousFrames();
 
         /// @brief Inheriting types should emplace their images onto this collection to provide them in GetImageOutput interface
         std::unordered_map<std::string, core::ManagedImage*> mImageOutputs;
@@ -11,4 +11,6 @@ namespace foray::stages
     class GBufferStage;
     class DenoiserStage;
     class BlitStage;
+    class FrustumCullingStage;
+    class RenderGraph;
 } // namespace foray::stages
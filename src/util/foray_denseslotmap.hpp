@@ -0,0 +1,193 @@
+#pragma once
+#include "../foray_basics.hpp"
+#include "../foray_exception.hpp"
+#include <vector>
+
+namespace foray::util {
+
+    /// @brief Generational slot map storing its values densely packed
+    /// @details
+    /// Insert, Remove and lookup by key are O(1). Removal moves the last value into the freed position (swap-remove), so the dense arrays
+    /// never contain gaps and can be handed to memcpy or buffer uploads directly. Dense order is therefore not stable across removals, keys are.
+    /// A key is invalidated when its value is removed, and is never handed out again for a different value (generation counter).
+    /// Every entry consists of a TValue (densely packed, e.g. for upload to the GPU) and a TAux (host side bookkeeping), stored in two parallel arrays.
+    /// @tparam TValue Densely packed value type
+    /// @tparam TAux Auxiliary value type, stored in a parallel dense array with matching indices
+    template <typename TValue, typename TAux>
+    class DenseSlotMap
+    {
+      public:
+        /// @brief Key identifying an entry. Bits 0..31: Slot index, bits 32..62: Generation, bit 63: Always zero (free for use by the owner)
+        using Key = uint64_t;
+
+        inline static constexpr Key    INVALID_KEY   = ~0ULL;
+        inline static constexpr size_t INVALID_INDEX = ~(size_t)0;
+
+        /// @brief Inserts a new entry at the end of the dense arrays
+        /// @return Key identifying the entry
+        Key Insert(const TValue& value, TAux aux);
+        /// @brief Removes the entry identified by key. The last entry is moved into its dense position.
+        /// @return True, if an entry was removed
+        bool Remove(Key key);
+        /// @brief Removes all entries. Invalidates all keys.
+        void Clear();
+
+        /// @brief Checks if key identifies an existing entry
+        bool Contains(Key key) const { return GetDenseIndex(key) != INVALID_INDEX; }
+        /// @brief Get the index of the entry identified by key into the dense arrays. INVALID_INDEX if not contained.
+        size_t GetDenseIndex(Key key) const;
+
+        /// @brief Get the value identified by key. nullptr if not contained.
+        TValue* GetValue(Key key);
+        /// @brief Get the value identified by key. nullptr if not contained.
+        const TValue* GetValue(Key key) const;
+        /// @brief Get the auxiliary value identified by key. nullptr if not contained.
+        TAux* GetAux(Key key);
+        /// @brief Get the auxiliary value identified by key. nullptr if not contained.
+        const TAux* GetAux(Key key) const;
+
+        inline size_t Size() const { return mValues.size(); }
+        inline bool   Empty() const { return mValues.empty(); }
+
+        /// @brief Densely packed values
+        FORAY_GETTER_R(Values)
+        /// @brief Auxiliary values, index matching Values
+        FORAY_GETTER_R(AuxValues)
+        /// @brief Keys, index matching Values
+        FORAY_GETTER_CR(Keys)
+
+      protected:
+        inline static constexpr uint32_t FREE_SLOT       = ~0U;
+        inline static constexpr uint32_t GENERATION_MASK = 0x7FFFFFFFU;
+
+        struct Slot
+        {
+            /// @brief Incremented whenever the slot is freed
+            uint32_t Generation = 0;
+            /// @brief Index into the dense arrays, FREE_SLOT if unused
+            uint32_t DenseIndex = FREE_SLOT;
+        };
+
+        inline static Key MakeKey(uint32_t slotIndex, uint32_t generation) { return ((Key)generation << 32) | (Key)slotIndex; }
+
+        std::vector<Slot>     mSlots;
+        std::vector<uint32_t> mFreeSlots;
+        std::vector<TValue>   mValues;
+        std::vector<TAux>     mAuxValues;
+        std::vector<Key>      mKeys;
+    };
+
+    template <typename TValue, typename TAux>
+    typename DenseSlotMap<TValue, TAux>::Key DenseSlotMap<TValue, TAux>::Insert(const TValue& value, TAux aux)
+    {
+        uint32_t slotIndex = 0;
+        if(mFreeSlots.size() > 0)
+        {
+            slotIndex = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        else
+        {
+            Assert(mSlots.size() < (size_t)FREE_SLOT, "DenseSlotMap: Slot count exhausted");
+            slotIndex = (uint32_t)mSlots.size();
+            mSlots.emplace_back();
+        }
+
+        Slot& slot      = mSlots[slotIndex];
+        slot.DenseIndex = (uint32_t)mValues.size();
+        Key key         = MakeKey(slotIndex, slot.Generation);
+
+        mValues.push_back(value);
+        mAuxValues.push_back(std::move(aux));
+        mKeys.push_back(key);
+        return key;
+    }
+
+    template <typename TValue, typename TAux>
+    bool DenseSlotMap<TValue, TAux>::Remove(Key key)
+    {
+        size_t denseIndex = GetDenseIndex(key);
+        if(denseIndex == INVALID_INDEX)
+        {
+            return false;
+        }
+
+        size_t lastIndex = mValues.size() - 1;
+        if(denseIndex != lastIndex)
+        {
+            mValues[denseIndex]    = mValues[lastIndex];
+            mAuxValues[denseIndex] = std::move(mAuxValues[lastIndex]);
+            mKeys[denseIndex]      = mKeys[lastIndex];
+
+            mSlots[(uint32_t)mKeys[denseIndex]].DenseIndex = (uint32_t)denseIndex;
+        }
+        mValues.pop_back();
+        mAuxValues.pop_back();
+        mKeys.pop_back();
+
+        uint32_t slotIndex = (uint32_t)key;
+        Slot&    slot      = mSlots[slotIndex];
+        slot.Generation    = (slot.Generation + 1) & GENERATION_MASK;
+        slot.DenseIndex    = FREE_SLOT;
+        mFreeSlots.push_back(slotIndex);
+        return true;
+    }
+
+    template <typename TValue, typename TAux>
+    void DenseSlotMap<TValue, TAux>::Clear()
+    {
+        for(Key key : mKeys)
+        {
+            uint32_t slotIndex = (uint32_t)key;
+            Slot&    slot      = mSlots[slotIndex];
+            slot.Generation    = (slot.Generation + 1) & GENERATION_MASK;
+            slot.DenseIndex    = FREE_SLOT;
+            mFreeSlots.push_back(slotIndex);
+        }
+        mValues.clear();
+        mAuxValues.clear();
+        mKeys.clear();
+    }
+
+    template <typename TValue, typename TAux>
+    size_t DenseSlotMap<TValue, TAux>::GetDenseIndex(Key key) const
+    {
+        uint32_t slotIndex  = (uint32_t)key;
+        uint32_t generation = (uint32_t)(key >> 32);
+        if(slotIndex >= mSlots.size())
+        {
+            return INVALID_INDEX;
+        }
+        const Slot& slot = mSlots[slotIndex];
+        if(slot.DenseIndex == FREE_SLOT || slot.Generation != generation)
+        {
+            return INVALID_INDEX;
+        }
+        return slot.DenseIndex;
+    }
+
+    template <typename TValue, typename TAux>
+    TValue* DenseSlotMap<TValue, TAux>::GetValue(Key key)
+    {
+        size_t denseIndex = GetDenseIndex(key);
+        return denseIndex != INVALID_INDEX ? &mValues[denseIndex] : nullptr;
+    }
+    template <typename TValue, typename TAux>
+    const TValue* DenseSlotMap<TValue, TAux>::GetValue(Key key) const
+    {
+        size_t denseIndex = GetDenseIndex(key);
+        return denseIndex != INVALID_INDEX ? &mValues[denseIndex] : nullptr;
+    }
+    template <typename TValue, typename TAux>
+    TAux* DenseSlotMap<TValue, TAux>::GetAux(Key key)
+    {
+        size_t denseIndex = GetDenseIndex(key);
+        return denseIndex != INVALID_INDEX ? &mAuxValues[denseIndex] : nullptr;
+    }
+    template <typename TValue, typename TAux>
+    const TAux* DenseSlotMap<TValue, TAux>::GetAux(Key key) const
+    {
+        size_t denseIndex = GetDenseIndex(key);
+        return denseIndex != INVALID_INDEX ? &mAuxValues[denseIndex] : nullptr;
+    }
+}  // namespace foray::util
@@ -101,6 +101,7 @@ namespace foray::util {
 
         VkGraphicsPipelineCreateInfo pipelineInfo = {};
         pipelineInfo.sType                        = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.flags                        = mPipelineCreateFlags;
         pipelineInfo.stageCount                   = mShaderStageCreateInfos->size();
         pipelineInfo.pStages                      = mShaderStageCreateInfos->data();
         pipelineInfo.pVertexInputState            = &mVertexInputStateBuilder->InputStateCI;
@@ -116,8 +117,11 @@ namespace foray::util {
         pipelineInfo.subpass                      = 0;
         pipelineInfo.basePipelineHandle           = VK_NULL_HANDLE;
 
+        // Fall back to the applications pipeline cache if none was set explicitly
+        VkPipelineCache pipelineCache = !!mPipelineCache ? mPipelineCache : mContext->PipelineCache;
+
         VkPipeline pipeline;
-        AssertVkResult(vkCreateGraphicsPipelines(mContext->Device(), mPipelineCache, 1, &pipelineInfo, nullptr, &pipeline));
+        AssertVkResult(vkCreateGraphicsPipelines(mContext->Device(), pipelineCache, 1, &pipelineInfo, nullptr, &pipeline));
         return pipeline;
     }
 }  // namespace foray
\ No newline at end of file
@@ -36,6 +36,8 @@ namespace foray::util {
         FORAY_PROPERTY_V(ShaderStageCreateInfos)
         FORAY_PROPERTY_V(PipelineCache)
         FORAY_PROPERTY_V(ColorAttachmentBlendCount)
+        /// @brief Assigned to VkGraphicsPipelineCreateInfo::flags (e.g. DescriptorSet::GetPipelineCreateFlags())
+        FORAY_PROPERTY_V(PipelineCreateFlags)
 
       protected:
         core::Context* mContext{};
@@ -55,6 +57,7 @@ namespace foray::util {
         scene::VertexInputStateBuilder*                   mVertexInputStateBuilder{};
         VkPipelineCache                                   mPipelineCache{};
         uint32_t                                          mColorAttachmentBlendCount{0};
+        VkPipelineCreateFlags                             mPipelineCreateFlags{0};
     };
 
 }  // namespace foray::util
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "foray_pipelinelayout.hpp"
 #include "../core/foray_context.hpp"
+#include "../core/foray_descriptorset.hpp"
 
 namespace foray::util {
 
@@ -12,7 +13,9 @@ namespace foray::util {
         }
         mDescriptorSetLayouts.clear();
         mPushConstantRanges.clear();
-        mPushConstantOffset = 0U;
+        mPushConstantOffset       = 0U;
+        mDescriptorBufferSetCount = 0U;
+        mPoolSetCount             = 0U;
     }
 
     void PipelineLayout::AddDescriptorSetLayout(VkDescriptorSetLayout layout)
@@ -26,6 +29,18 @@ namespace foray::util {
             mDescriptorSetLayouts.push_back(layout);
         }
     }
+    void PipelineLayout::AddDescriptorSetLayout(const core::DescriptorSet& set)
+    {
+        if(set.GetUsesDescriptorBuffer())
+        {
+            mDescriptorBufferSetCount++;
+        }
+        else
+        {
+            mPoolSetCount++;
+        }
+        mDescriptorSetLayouts.push_back(set.GetDescriptorSetLayout());
+    }
     void PipelineLayout::AddPushConstantRange(VkPushConstantRange range)
     {
         if(range.offset == ~0U)
@@ -54,6 +69,11 @@ namespace foray::util {
 
         mContext = context;
 
+        FORAY_ASSERTFMT(mDescriptorBufferSetCount == 0 || mPoolSetCount == 0,
+                        "[PipelineLayout::Build] Can not combine {} descriptor buffer backed set(s) with {} pool allocated set(s). Create the sets with "
+                        "DescriptorSet::SetAllowDescriptorBuffer(false)",
+                        mDescriptorBufferSetCount, mPoolSetCount)
+
         VkPipelineLayoutCreateInfo ci = {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
             .pNext = pNext,
@@ -75,6 +95,17 @@ namespace foray::util {
         return mPipelineLayout;
     }
 
+    VkPipelineCreateFlags PipelineLayout::GetPipelineCreateFlags() const
+    {
+#ifdef VK_EXT_descriptor_buffer
+        if(mDescriptorBufferSetCount > 0)
+        {
+            return VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+#endif
+        return 0;
+    }
+
     VkPipelineLayout PipelineLayout::Build(core::Context*                            context,
                                            const std::vector<VkDescriptorSetLayout>& descriptorLayouts,
                                            const std::vector<VkPushConstantRange>&   pushConstantRanges,
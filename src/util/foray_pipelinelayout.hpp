@@ -28,6 +28,8 @@ namespace foray::util {
         void AddDescriptorSetLayout(VkDescriptorSetLayout layout);
         /// @brief Add descriptorset layouts to the pipeline layout prior to building
         void AddDescriptorSetLayouts(const std::vector<VkDescriptorSetLayout>& layouts);
+        /// @brief Add the layout of set (or core::BindlessHeap) to the pipeline layout prior to building. Build() asserts that descriptor buffer backed and pool allocated sets are not mixed
+        void AddDescriptorSetLayout(const core::DescriptorSet& set);
         /// @brief Add a push constant range to the pipeline layout prior to building
         /// @remark If range.offset is set to PUSHC_OFFSET_AUTO, it is automatically set based on previously added pushconstants
         void AddPushConstantRange(VkPushConstantRange range);
@@ -43,6 +45,7 @@ namespace foray::util {
         inline void AddPushConstantRange(VkShaderStageFlags stageFlags, uint32_t offset = PUSHC_OFFSET_AUTO);
 
         /// @brief Builds the pipelinelayout based on previously added descriptorset layouts and push constant ranges
+        /// @remark Pipelines using this layout must be created with GetPipelineCreateFlags()
         /// @param context Requires DispatchTable
         /// @param flags VkPipelineLayoutCreateInfo::flags
         /// @param pNext VkPipelineLayoutCreateInfo::pNext
@@ -60,6 +63,9 @@ namespace foray::util {
                                 VkPipelineLayoutCreateFlags               flags = 0,
                                 void*                                     pNext = nullptr);
 
+        /// @brief VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, if descriptor buffer backed sets were added. 0 otherwise
+        VkPipelineCreateFlags GetPipelineCreateFlags() const;
+
         FORAY_GETTER_V(PipelineLayout)
 
         inline operator VkPipelineLayout() const { return mPipelineLayout; }
@@ -71,6 +77,9 @@ namespace foray::util {
         std::vector<VkDescriptorSetLayout> mDescriptorSetLayouts;
         std::vector<VkPushConstantRange>   mPushConstantRanges;
         uint32_t mPushConstantOffset = 0U;
+        /// @brief Number of added core::DescriptorSet layouts using descriptor buffers / descriptor pools
+        uint32_t mDescriptorBufferSetCount = 0U;
+        uint32_t mPoolSetCount             = 0U;
     };
 
     template <typename TPushC>
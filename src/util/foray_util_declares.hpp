@@ -13,4 +13,5 @@ namespace foray::util {
     class PipelineBuilder;
     class PipelineLayout;
     class ShaderStageCreateInfos;
+    class WorkerPool;
 }  // namespace foray::util
@@ -0,0 +1,130 @@
+#include "foray_workerpool.hpp"
+#include <algorithm>
+
+namespace foray::util {
+    void WorkerPool::Create(uint32_t threadCount)
+    {
+        Destroy();
+        if(threadCount == 0)
+        {
+            threadCount = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+        }
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop      = false;
+            generation = mGeneration;
+        }
+        mThreads.reserve(threadCount);
+        for(uint32_t i = 0; i < threadCount; i++)
+        {
+            mThreads.emplace_back(&WorkerPool::WorkerMain, this, generation);
+        }
+    }
+
+    void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& func)
+    {
+        if(count == 0)
+        {
+            return;
+        }
+        if(mThreads.empty() || count == 1)
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                func(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> loopLock(mLoopMutex);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFunc        = &func;
+            mCount       = count;
+            mNextIndex   = 0;
+            mFailed      = false;
+            mException   = nullptr;
+            mBusyWorkers = (uint32_t)mThreads.size();
+            mGeneration++;
+        }
+        mLoopStarted.notify_all();
+
+        RunLoop();
+
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mLoopFinished.wait(lock, [this] { return mBusyWorkers == 0; });
+            mFunc     = nullptr;
+            exception = mException;
+        }
+        if(exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void WorkerPool::RunLoop()
+    {
+        while(!mFailed)
+        {
+            size_t index = mNextIndex.fetch_add(1);
+            if(index >= mCount)
+            {
+                return;
+            }
+            try
+            {
+                (*mFunc)(index);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if(!mException)
+                {
+                    mException = std::current_exception();
+                }
+                mFailed = true;
+            }
+        }
+    }
+
+    void WorkerPool::WorkerMain(uint64_t generation)
+    {
+        while(true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mLoopStarted.wait(lock, [&] { return mStop || mGeneration != generation; });
+                if(mStop)
+                {
+                    return;
+                }
+                generation = mGeneration;
+            }
+
+            RunLoop();
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mBusyWorkers--;
+            }
+            mLoopFinished.notify_one();
+        }
+    }
+
+    void WorkerPool::Destroy()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mLoopStarted.notify_all();
+        for(std::thread& thread : mThreads)
+        {
+            thread.join();
+        }
+        mThreads.clear();
+    }
+}  // namespace foray::util
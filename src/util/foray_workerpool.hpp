@@ -0,0 +1,63 @@
+#pragma once
+#include "../foray_basics.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace foray::util {
+
+    /// @brief A fixed set of worker threads executing parallel loops
+    /// @details
+    /// ParallelFor() distributes loop indices dynamically across the workers and the calling thread, and blocks until all indices have been processed.
+    /// Only one loop executes at a time. Calls from multiple threads are serialized.
+    class WorkerPool : public NoMoveDefaults
+    {
+      public:
+        /// @brief Starts the worker threads
+        /// @param threadCount Number of worker threads. If 0, uses one less than the hardware concurrency (the calling thread participates in loops)
+        void Create(uint32_t threadCount = 0);
+
+        /// @brief Invokes func(index) for every index in [0, count)
+        /// @remark If any invocation throws, remaining indices are skipped and the first exception is rethrown on the calling thread
+        void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+        inline bool Exists() const { return mThreads.size() > 0; }
+        /// @brief Number of worker threads (excluding the calling thread)
+        inline uint32_t GetThreadCount() const { return (uint32_t)mThreads.size(); }
+
+        /// @brief Stops and joins the worker threads
+        void Destroy();
+
+        inline virtual ~WorkerPool() { Destroy(); }
+
+      protected:
+        /// @param generation mGeneration at thread creation. Workers wait for the next loop, even if the pool has been recreated
+        void WorkerMain(uint64_t generation);
+        /// @brief Processes indices of the current loop until none are left
+        void RunLoop();
+
+        std::vector<std::thread> mThreads;
+
+        /// @brief Serializes ParallelFor() calls
+        std::mutex mLoopMutex;
+        /// @brief Guards loop state handed to the workers
+        std::mutex              mMutex;
+        std::condition_variable mLoopStarted;
+        std::condition_variable mLoopFinished;
+        /// @brief Incremented for every loop, so workers can detect a new one
+        uint64_t mGeneration = 0;
+        bool     mStop       = false;
+
+        const std::function<void(size_t)>* mFunc  = nullptr;
+        size_t                             mCount = 0;
+        std::atomic<size_t>                mNextIndex{0};
+        /// @brief Workers still processing the current loop
+        uint32_t           mBusyWorkers = 0;
+        std::exception_ptr mException;
+        std::atomic<bool>  mFailed{false};
+    };
+}  // namespace foray::util
@@ -0,0 +1,71 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/util/foray_workerpool.hpp"
+#include "foray_testanimation.hpp"
+#include "foray_test.hpp"
+
+using namespace foray;
+
+/// @brief Transforms of all nodes must be bitwise identical
+bool TransformsEqual(scene::Scene& a, scene::Scene& b)
+{
+    std::vector<scene::Node*> nodesA;
+    std::vector<scene::Node*> nodesB;
+    a.FindNodesWithComponent<scene::ncomp::Transform>(nodesA);
+    b.FindNodesWithComponent<scene::ncomp::Transform>(nodesB);
+    if(nodesA.size() != nodesB.size())
+    {
+        return false;
+    }
+    for(size_t i = 0; i < nodesA.size(); i++)
+    {
+        scene::ncomp::Transform* transformA = nodesA[i]->GetTransform();
+        scene::ncomp::Transform* transformB = nodesB[i]->GetTransform();
+        if(transformA->GetTranslation() != transformB->GetTranslation() || transformA->GetRotation() != transformB->GetRotation()
+           || transformA->GetScale() != transformB->GetScale() || transformA->GetGlobalMatrix() != transformB->GetGlobalMatrix())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Identical scenes, one evaluating animations serially, the other on a worker pool. After every frame all transforms and playback cursors must match exactly
+void TestSerialVsParallel(uint32_t characterCount, uint32_t threadCount)
+{
+    scene::Scene                    serial(nullptr);
+    scene::Scene                    parallel(nullptr);
+    scene::gcomp::AnimationManager* serialManager   = test::MakeAnimatedCharacters(serial, characterCount, 24, 1234);
+    scene::gcomp::AnimationManager* parallelManager = test::MakeAnimatedCharacters(parallel, characterCount, 24, 1234);
+
+    util::WorkerPool pool;
+    pool.Create(threadCount);
+    parallelManager->SetWorkerPool(&pool);
+
+    base::FrameRenderInfo renderInfo;
+    for(uint64_t frame = 0; frame < 200; frame++)
+    {
+        // Irregular frame times, larger steps every few frames loop the animations
+        renderInfo.SetFrameNumber(frame);
+        renderInfo.SetFrameTime(frame % 17 == 16 ? 1.3f : 0.004f + 0.003f * (fp32_t)(frame % 5));
+        serial.Update(renderInfo, (VkCommandBuffer) nullptr);
+        parallel.Update(renderInfo, (VkCommandBuffer) nullptr);
+
+        FORAY_CHECK(TransformsEqual(serial, parallel));
+        for(size_t i = 0; i < serialManager->GetAnimations().size(); i++)
+        {
+            FORAY_CHECK(serialManager->GetAnimations()[i].GetPlaybackConfig().Cursor == parallelManager->GetAnimations()[i].GetPlaybackConfig().Cursor);
+        }
+    }
+
+    parallelManager->SetWorkerPool(nullptr);
+    pool.Destroy();
+}
+
+int main()
+{
+    TestSerialVsParallel(64, 4);
+    TestSerialVsParallel(64, 1);
+    // A single animation is evaluated serially even with a pool set
+    TestSerialVsParallel(1, 4);
+    return test::Result();
+}
@@ -0,0 +1,99 @@
+#include "../src/scene/foray_animation.hpp"
+#include "foray_test.hpp"
+#include <random>
+
+using namespace foray;
+
+/// @brief Exposes the protected keyframe selection
+struct TestSampler : public scene::AnimationSampler
+{
+    using AnimationSampler::SelectKeyframe;
+};
+
+/// @brief Keyframe selection as implemented before the cursor and binary search: forward scan for lower, backward scan for upper
+void SelectKeyframeLinear(const std::vector<scene::AnimationKeyframe>& keyframes, float time, size_t& lower, size_t& upper)
+{
+    int32_t lowerIndex = 0;
+    int32_t upperIndex = (int32_t)keyframes.size() - 1;
+    while(lowerIndex + 1 < (int32_t)keyframes.size() && keyframes[lowerIndex + 1].Time <= time)
+    {
+        lowerIndex++;
+    }
+    while(upperIndex - 1 >= 0 && keyframes[upperIndex - 1].Time >= time)
+    {
+        upperIndex--;
+    }
+    lower = (size_t)lowerIndex;
+    upper = (size_t)upperIndex;
+}
+
+void CheckSelect(const TestSampler& sampler, float time)
+{
+    const scene::AnimationKeyframe* lower = nullptr;
+    const scene::AnimationKeyframe* upper = nullptr;
+    sampler.SelectKeyframe(time, lower, upper);
+
+    size_t expectedLower = 0;
+    size_t expectedUpper = 0;
+    SelectKeyframeLinear(sampler.Keyframes, time, expectedLower, expectedUpper);
+    FORAY_CHECK(lower == &sampler.Keyframes[expectedLower]);
+    FORAY_CHECK(upper == &sampler.Keyframes[expectedUpper]);
+}
+
+/// @brief Builds sorted keyframes, some sharing the same time
+TestSampler MakeSampler(std::mt19937& rng, size_t count)
+{
+    TestSampler sampler;
+    float       time = 0.f;
+    for(size_t i = 0; i < count; i++)
+    {
+        if(i == 0 || std::uniform_int_distribution<int32_t>(0, 4)(rng) > 0)
+        {
+            time += std::uniform_real_distribution<float>(0.01f, 1.f)(rng);
+        }
+        sampler.Keyframes.push_back(scene::AnimationKeyframe(time, glm::vec4((float)i)));
+    }
+    return sampler;
+}
+
+/// @brief Playback: small forward steps, loops back to the start (exercises the cursor and its successor)
+void TestPlayback()
+{
+    std::mt19937 rng(42);
+    for(size_t count : {2, 3, 17, 100})
+    {
+        TestSampler sampler = MakeSampler(rng, count);
+        float       end     = sampler.Keyframes.back().Time;
+        for(int32_t loop = 0; loop < 3; loop++)
+        {
+            for(float time = -0.5f; time < end + 0.5f; time += 0.037f)
+            {
+                CheckSelect(sampler, time);
+            }
+        }
+    }
+}
+
+/// @brief Random seeks, exact keyframe times and out of range times (exercises the binary search)
+void TestSeek()
+{
+    std::mt19937 rng(7);
+    for(size_t count : {2, 5, 64, 1000})
+    {
+        TestSampler                           sampler = MakeSampler(rng, count);
+        std::uniform_real_distribution<float> seek(-1.f, sampler.Keyframes.back().Time + 1.f);
+        std::uniform_int_distribution<size_t> keyframe(0, count - 1);
+        for(int32_t i = 0; i < 2000; i++)
+        {
+            CheckSelect(sampler, seek(rng));
+            CheckSelect(sampler, sampler.Keyframes[keyframe(rng)].Time);
+        }
+    }
+}
+
+int main()
+{
+    TestPlayback();
+    TestSeek();
+    return test::Result();
+}
@@ -0,0 +1,55 @@
+#include "../src/bench/foray_benchmarkbase.hpp"
+#include "foray_test.hpp"
+#include <algorithm>
+#include <sstream>
+
+using namespace foray;
+
+/// @brief Benchmark with manually provided timestamps
+class TestBenchmark : public bench::BenchmarkBase
+{
+  public:
+    using BenchmarkBase::Begin;
+    using BenchmarkBase::End;
+    using BenchmarkBase::LogTimestamp;
+    using BenchmarkBase::LogValue;
+};
+
+/// @brief Runs logging different ids print as one table: single header, same column count in every row, empty cells for ids a run did not log
+void TestFixedColumns()
+{
+    TestBenchmark benchmark;
+    benchmark.Begin(0.0);
+    benchmark.LogTimestamp("A", 1.0);
+    benchmark.LogValue("X", 5.0);
+    benchmark.End(2.0);
+    benchmark.Begin(10.0);
+    benchmark.LogTimestamp("B", 11.0);
+    benchmark.End(12.0);
+
+    std::stringstream        csv(benchmark.PrintCsv(';'));
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(csv, line);)
+    {
+        lines.push_back(line);
+    }
+    FORAY_CHECK(lines.size() == 3);
+    if(lines.size() != 3)
+    {
+        return;
+    }
+    FORAY_CHECK(lines[0] == "Begin;A;B;End;X");
+    for(const std::string& line : lines)
+    {
+        FORAY_CHECK(std::count(line.begin(), line.end(), ';') == 4);
+    }
+    // Second run logged neither A nor X
+    FORAY_CHECK(lines[2].find(";;") != std::string::npos);
+    FORAY_CHECK(lines[2].back() == ';');
+}
+
+int main()
+{
+    TestFixedColumns();
+    return test::Result();
+}
@@ -0,0 +1,154 @@
+#include "../src/core/foray_bindlessheap.hpp"
+#include "../src/core/foray_managedbuffer.hpp"
+#include "../src/util/foray_pipelinelayout.hpp"
+#include "foray_testdevice.hpp"
+#include <array>
+#include <map>
+#include <random>
+
+using namespace foray;
+
+/// @brief Exposes the index allocator
+class TestHeap : public core::BindlessHeap
+{
+  public:
+    using BindlessHeap::Slots;
+};
+using Slots = TestHeap::Slots;
+
+/// @brief Loading and unloading never moves live indices, freed indices are reused last and in the order they were freed
+void TestLoadUnload()
+{
+    Slots slots{.Capacity = 4};
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        FORAY_CHECK(slots.Acquire() == i);
+    }
+    slots.Release(1);
+    slots.Release(0);
+    FORAY_CHECK(slots.Live == 1);
+    FORAY_CHECK(!slots.IsUsed(0) && !slots.IsUsed(1) && slots.IsUsed(2));
+
+    // Never used indices first, then freed ones in the order they were freed
+    FORAY_CHECK(slots.Acquire() == 3);
+    FORAY_CHECK(slots.Acquire() == 1);
+    FORAY_CHECK(slots.Acquire() == 0);
+    FORAY_CHECK(slots.Live == 4);
+    FORAY_CHECK(slots.Free.empty());
+}
+
+/// @brief Random load / unload cycles: live indices stay unique and unchanged, freed indices stay unused for as long as possible
+void TestRandomCycles()
+{
+    const uint32_t                          capacity = 64;
+    std::mt19937                            rng(21);
+    std::uniform_int_distribution<uint32_t> coin(0, 2);
+    Slots                                   slots{.Capacity = capacity};
+
+    // Resource id => index, assigned when the resource was loaded
+    std::map<uint32_t, uint32_t> loaded;
+    uint32_t                     nextId = 0;
+    for(int32_t cycle = 0; cycle < 10000; cycle++)
+    {
+        bool unload = !loaded.empty() && (loaded.size() == capacity || coin(rng) == 0);
+        if(unload)
+        {
+            auto iter = loaded.begin();
+            std::advance(iter, std::uniform_int_distribution<size_t>(0, loaded.size() - 1)(rng));
+            slots.Release(iter->second);
+            loaded.erase(iter);
+        }
+        else
+        {
+            uint32_t expected = slots.Next < capacity ? slots.Next : slots.Free.front();
+            uint32_t index    = slots.Acquire();
+            FORAY_CHECK(index == expected);
+            FORAY_CHECK(index < capacity);
+            loaded[nextId++] = index;
+        }
+
+        FORAY_CHECK(slots.Live == loaded.size());
+        std::vector<bool> seen(capacity, false);
+        for(const auto& [id, index] : loaded)
+        {
+            FORAY_CHECK(slots.IsUsed(index));
+            FORAY_CHECK(!seen[index]);
+            seen[index] = true;
+        }
+    }
+}
+
+/// @brief The heap follows the descriptor buffer availability like DescriptorSet does, so default sets combine with it in a pipeline layout
+void TestPipelineLayout(core::Context* context, const core::BindlessHeap& heap, const core::ManagedBuffer& buffer)
+{
+    FORAY_CHECK(heap.GetUsesDescriptorBuffer() == !!context->DescriptorBufferProperties);
+
+    core::DescriptorSet set;
+    set.SetDescriptorAt(0, buffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    set.Create(context, "Stage Set");
+    FORAY_CHECK(set.GetUsesDescriptorBuffer() == heap.GetUsesDescriptorBuffer());
+
+    // Build() asserts both sets use the same backend
+    util::PipelineLayout layout;
+    layout.AddDescriptorSetLayout(set);
+    layout.AddDescriptorSetLayout(heap);
+    FORAY_CHECK(!!layout.Build(context));
+    FORAY_CHECK(layout.GetPipelineCreateFlags() == set.GetPipelineCreateFlags());
+    layout.Destroy();
+    set.Destroy();
+}
+
+/// @brief Registered buffers keep their index across unregistering other buffers
+void TestDeviceHeap(core::Context* context)
+{
+    core::BindlessHeap heap;
+    heap.Create(context, 16, 4);
+
+    std::array<core::ManagedBuffer, 3> buffers;
+    std::array<uint32_t, 3>            indices;
+    for(size_t i = 0; i < buffers.size(); i++)
+    {
+        buffers[i].Create(context, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 256, VMA_MEMORY_USAGE_AUTO);
+        indices[i] = heap.RegisterBuffer(buffers[i].GetVkDescriptorBufferInfo());
+        FORAY_CHECK(indices[i] == i);
+    }
+    heap.UnregisterBuffer(indices[1]);
+    FORAY_CHECK(heap.GetRegisteredBufferCount() == 2);
+
+    // Updating in place keeps the index
+    heap.RegisterOrUpdateBuffer(indices[2], buffers[1].GetVkDescriptorBufferInfo());
+    FORAY_CHECK(indices[2] == 2);
+
+    // The never used index 3 is handed out before the freed index 1
+    FORAY_CHECK(heap.RegisterBuffer(buffers[1].GetVkDescriptorBufferInfo()) == 3);
+    FORAY_CHECK(heap.RegisterBuffer(buffers[1].GetVkDescriptorBufferInfo()) == 1);
+    FORAY_CHECK(heap.GetRegisteredBufferCount() == 4);
+
+    TestPipelineLayout(context, heap, buffers[0]);
+
+    heap.Destroy();
+    for(core::ManagedBuffer& buffer : buffers)
+    {
+        buffer.Destroy();
+    }
+}
+
+int main()
+{
+    TestLoadUnload();
+    TestRandomCycles();
+
+    test::TestDevice device;
+    if(!device.Create())
+    {
+        return test::Result();
+    }
+    const VkPhysicalDeviceVulkan12Features& features = device.GetVulkan12Features();
+    if(features.descriptorBindingPartiallyBound == VK_TRUE && features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE
+       && features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE && features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE)
+    {
+        TestDeviceHeap(&device.GetContext());
+    }
+    device.Destroy();
+    return test::Result();
+}
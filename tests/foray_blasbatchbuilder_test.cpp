@@ -0,0 +1,106 @@
+#include "../src/as/foray_blasbatchbuilder.hpp"
+#include "../src/scene/foray_mesh.hpp"
+#include "../src/scene/globalcomponents/foray_geometrymanager.hpp"
+#include "foray_testdevice.hpp"
+#include <memory>
+
+using namespace foray;
+
+/// @brief Counts vkWaitForFences calls made through the dispatch table
+uint32_t            gFenceWaits    = 0;
+PFN_vkWaitForFences gWaitForFences = nullptr;
+
+VKAPI_ATTR VkResult VKAPI_CALL CountingWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll, uint64_t timeout)
+{
+    gFenceWaits++;
+    return gWaitForFences(device, fenceCount, pFences, waitAll, timeout);
+}
+
+/// @brief Geometry store filled directly, without a scene
+class TestStore : public scene::gcomp::GeometryStore
+{
+  public:
+    /// @brief One triangle per mesh, each mesh referencing its own vertices
+    void Fill(core::Context* context, uint32_t meshCount)
+    {
+        for(uint32_t i = 0; i < meshCount; i++)
+        {
+            scene::Primitive primitive;
+            primitive.Type                   = scene::Primitive::EType::Index;
+            primitive.First                  = (uint32_t)mIndices.size();
+            primitive.VertexOrIndexCount     = 3;
+            primitive.HighestReferencedIndex = (uint32_t)mVertices.size() + 2;
+            for(uint32_t corner = 0; corner < 3; corner++)
+            {
+                scene::Vertex vertex{};
+                vertex.Pos = glm::vec3((fp32_t)i + (corner == 1 ? 1.f : 0.f), corner == 2 ? 1.f : 0.f, 0.f);
+                mIndices.push_back((uint32_t)mVertices.size());
+                mVertices.push_back(vertex);
+            }
+            auto mesh = std::make_unique<scene::Mesh>();
+            mesh->SetPrimitives({primitive});
+            mMeshes.push_back(std::move(mesh));
+        }
+
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+                                   | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+        mVerticesBuffer.Create(context, usage, mVertices.size() * sizeof(scene::Vertex), VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        mIndicesBuffer.Create(context, usage, mIndices.size() * sizeof(uint32_t), VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        mVerticesBuffer.WriteDataDeviceLocal(mVertices.data(), mVertices.size() * sizeof(scene::Vertex));
+        mIndicesBuffer.WriteDataDeviceLocal(mIndices.data(), mIndices.size() * sizeof(uint32_t));
+    }
+};
+
+/// @brief 1000 small Blas are built with a single fence wait, also when the scratch arena limit splits the builds into several passes
+void TestBatch(core::Context* context, VkDeviceSize maxScratchSize)
+{
+    const uint32_t meshCount = 1000;
+    TestStore      store;
+    store.Fill(context, meshCount);
+
+    as::BlasBatchBuilder builder;
+    builder.SetMaxScratchSize(maxScratchSize);
+    for(std::unique_ptr<scene::Mesh>& mesh : store.GetMeshes())
+    {
+        mesh->BuildAccelerationStructure(context, &store, builder);
+    }
+    FORAY_CHECK(builder.GetCount() == meshCount);
+
+    gFenceWaits = 0;
+    builder.Build(context, &store);
+    FORAY_CHECK(gFenceWaits == 1);
+    FORAY_CHECK(builder.GetCount() == 0);
+
+    for(std::unique_ptr<scene::Mesh>& mesh : store.GetMeshes())
+    {
+        const as::Blas& blas = mesh->GetBlas();
+        FORAY_CHECK(!!blas.GetAccelerationStructure());
+        FORAY_CHECK(blas.GetBlasAddress() != 0);
+        FORAY_CHECK(blas.GetMesh() == mesh.get());
+    }
+    store.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(true, true))
+    {
+        return test::SKIPPED;
+    }
+    if(!device.HasAccelerationStructure())
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context                       = device.GetContext();
+    gWaitForFences                               = context.VkbDispatchTable->fp_vkWaitForFences;
+    context.VkbDispatchTable->fp_vkWaitForFences = &CountingWaitForFences;
+
+    TestBatch(&context, 256ULL * 1024ULL * 1024ULL);
+    // Small enough to require one pass per few builds
+    TestBatch(&context, 64ULL * 1024ULL);
+
+    context.VkbDispatchTable->fp_vkWaitForFences = gWaitForFences;
+    device.Destroy();
+    return test::Result();
+}
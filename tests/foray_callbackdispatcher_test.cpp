@@ -0,0 +1,190 @@
+#include "../src/core/foray_context.hpp"
+#include "../src/scene/foray_callbackdispatcher.hpp"
+#include "../src/util/foray_workerpool.hpp"
+#include "foray_test.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+
+using namespace foray;
+using UpdateCallback = scene::Component::UpdateCallback;
+
+/// @brief Update callback with configurable order and data categories, recording the sequence it was invoked in
+class TestCallback : public UpdateCallback
+{
+  public:
+    TestCallback(int32_t order, uint32_t reads, uint32_t writes) : mOrder(order), mReads(reads), mWrites(writes) {}
+
+    virtual void     Update(scene::SceneUpdateInfo&) override { InvokedAt = Counter->fetch_add(1); }
+    virtual int32_t  GetOrder() const override { return mOrder; }
+    virtual uint32_t GetUpdateReads() const override { return mReads; }
+    virtual uint32_t GetUpdateWrites() const override { return mWrites; }
+    virtual bool     GetUpdateRecordsCommands() const override { return false; }
+
+    bool ConflictsWith(const TestCallback& other) const
+    {
+        return (mWrites & (other.mReads | other.mWrites)) > 0 || (mReads & other.mWrites) > 0;
+    }
+
+    std::atomic<uint32_t>* Counter   = nullptr;
+    uint32_t               InvokedAt = 0;
+
+  protected:
+    int32_t  mOrder;
+    uint32_t mReads;
+    uint32_t mWrites;
+};
+
+/// @brief Exposes callback registration and records PrepareConcurrentReads() invocations
+class TestDispatcher : public scene::CallbackDispatcher
+{
+  public:
+    void Add(UpdateCallback* callback) { mUpdate.Add(callback); }
+    void Remove(UpdateCallback* callback) { mUpdate.Remove(callback); }
+
+    std::vector<uint32_t> PreparedReads;
+
+  protected:
+    virtual void PrepareConcurrentReads(uint32_t reads) override { PreparedReads.push_back(reads); }
+};
+
+/// @brief Wave index of every callback. Checks that no wave is empty and no callback is listed twice
+std::map<const UpdateCallback*, int32_t> GetWaveIndices(TestDispatcher& dispatcher)
+{
+    std::map<const UpdateCallback*, int32_t> indices;
+    const auto&                              waves = dispatcher.GetUpdateWaves();
+    for(size_t wave = 0; wave < waves.size(); wave++)
+    {
+        FORAY_CHECK(!waves[wave].empty());
+        for(const UpdateCallback* callback : waves[wave])
+        {
+            FORAY_CHECK(indices.count(callback) == 0);
+            indices[callback] = (int32_t)wave;
+        }
+    }
+    return indices;
+}
+
+/// @brief The default scene setup: transform writers, the transform system, then concurrent transform readers
+void TestSceneLayout()
+{
+    using C = UpdateCallback;
+    TestDispatcher dispatcher;
+    TestCallback   animation(0, C::DATA_ANIMATIONS, C::DATA_ANIMATIONS | C::DATA_TRANSFORMS);
+    TestCallback   controller(0, C::DATA_CAMERAS, C::DATA_TRANSFORMS);
+    TestCallback   transformSystem(C::ORDER_HIERARCHY, C::DATA_TRANSFORMS, C::DATA_TRANSFORMS);
+    TestCallback   drawDirector(C::ORDER_TRANSFORM, C::DATA_TRANSFORMS, C::DATA_DRAWDATA);
+    TestCallback   cameraManager(C::ORDER_DEVICEUPLOAD, C::DATA_TRANSFORMS | C::DATA_CAMERAS, C::DATA_CAMERAS);
+    TestCallback   lightManager(C::ORDER_DEVICEUPLOAD, C::DATA_TRANSFORMS | C::DATA_LIGHTS, C::DATA_LIGHTS);
+    TestCallback   tlasManager(C::ORDER_DEVICEUPLOAD, C::DATA_TRANSFORMS | C::DATA_TLAS, C::DATA_TLAS);
+    for(TestCallback* callback : {&tlasManager, &drawDirector, &animation, &lightManager, &transformSystem, &controller, &cameraManager})
+    {
+        dispatcher.Add(callback);
+    }
+
+    std::map<const UpdateCallback*, int32_t> waves = GetWaveIndices(dispatcher);
+    FORAY_CHECK(waves.size() == 7);
+    // Transform writers conflict with each other, the system follows them
+    FORAY_CHECK(waves[&animation] != waves[&controller]);
+    FORAY_CHECK(waves[&transformSystem] > std::max(waves[&animation], waves[&controller]));
+    // All readers share the wave after the system
+    for(TestCallback* reader : {&drawDirector, &cameraManager, &lightManager, &tlasManager})
+    {
+        FORAY_CHECK(waves[reader] == waves[&transformSystem] + 1);
+    }
+
+    // Adding a callback invalidates the waves
+    TestCallback lateWriter(C::ORDER_DEVICEUPLOAD + 1, C::DATA_NONE, C::DATA_TRANSFORMS);
+    dispatcher.Add(&lateWriter);
+    waves = GetWaveIndices(dispatcher);
+    FORAY_CHECK(waves.size() == 8);
+    FORAY_CHECK(waves[&lateWriter] == waves[&drawDirector] + 1);
+    dispatcher.Remove(&lateWriter);
+    FORAY_CHECK(GetWaveIndices(dispatcher).size() == 7);
+}
+
+/// @brief Random callbacks: conflicting callbacks are placed in waves following their order, every wave is as early as possible
+void TestRandomOrdering()
+{
+    std::mt19937                            rng(99);
+    std::uniform_int_distribution<int32_t>  order(0, 4);
+    std::uniform_int_distribution<uint32_t> categories(0, 15);
+
+    for(int32_t round = 0; round < 100; round++)
+    {
+        TestDispatcher                             dispatcher;
+        std::vector<std::unique_ptr<TestCallback>> callbacks;
+        for(int32_t i = 0; i < 20; i++)
+        {
+            callbacks.push_back(std::make_unique<TestCallback>(order(rng) * 10, categories(rng), categories(rng) & categories(rng)));
+            dispatcher.Add(callbacks.back().get());
+        }
+
+        std::map<const UpdateCallback*, int32_t> waves = GetWaveIndices(dispatcher);
+        FORAY_CHECK(waves.size() == callbacks.size());
+
+        for(const auto& a : callbacks)
+        {
+            bool hasPredecessor = false;
+            for(const auto& b : callbacks)
+            {
+                if(a == b || !a->ConflictsWith(*b))
+                {
+                    continue;
+                }
+                if(a->GetOrder() < b->GetOrder())
+                {
+                    FORAY_CHECK(waves[a.get()] < waves[b.get()]);
+                }
+                FORAY_CHECK(waves[a.get()] != waves[b.get()]);
+                hasPredecessor |= waves[b.get()] == waves[a.get()] - 1;
+            }
+            // A callback is only delayed by a conflict in the wave before
+            FORAY_CHECK(waves[a.get()] == 0 || hasPredecessor);
+        }
+    }
+}
+
+/// @brief Parallel invocation follows the wave order and prepares reads before every concurrent wave
+void TestParallelInvoke()
+{
+    using C = UpdateCallback;
+    std::atomic<uint32_t> counter{0};
+    TestDispatcher        dispatcher;
+    TestCallback          writer(0, C::DATA_NONE, C::DATA_TRANSFORMS);
+    TestCallback          readerA(C::ORDER_TRANSFORM, C::DATA_TRANSFORMS, C::DATA_DRAWDATA);
+    TestCallback          readerB(C::ORDER_TRANSFORM, C::DATA_TRANSFORMS | C::DATA_LIGHTS, C::DATA_LIGHTS);
+    TestCallback          last(C::ORDER_DEVICEUPLOAD, C::DATA_DRAWDATA | C::DATA_LIGHTS, C::DATA_NONE);
+    for(TestCallback* callback : {&writer, &readerA, &readerB, &last})
+    {
+        callback->Counter = &counter;
+        dispatcher.Add(callback);
+    }
+
+    core::Context    context;
+    util::WorkerPool pool;
+    pool.Create(2);
+    dispatcher.EnableParallelUpdate(&context, &pool);
+
+    base::FrameRenderInfo  renderInfo;
+    scene::SceneUpdateInfo updateInfo(renderInfo, (VkCommandBuffer) nullptr);
+    dispatcher.InvokeUpdate(updateInfo);
+
+    FORAY_CHECK(counter == 4);
+    FORAY_CHECK(writer.InvokedAt == 0);
+    FORAY_CHECK(std::min(readerA.InvokedAt, readerB.InvokedAt) == 1);
+    FORAY_CHECK(last.InvokedAt == 3);
+    // Only the wave of both readers executes concurrently
+    FORAY_CHECK(dispatcher.PreparedReads.size() == 1 && dispatcher.PreparedReads[0] == (C::DATA_TRANSFORMS | C::DATA_LIGHTS));
+
+    dispatcher.DisableParallelUpdate();
+}
+
+int main()
+{
+    TestSceneLayout();
+    TestRandomOrdering();
+    TestParallelInvoke();
+    return test::Result();
+}
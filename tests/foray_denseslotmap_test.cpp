@@ -0,0 +1,94 @@
+#include "../src/util/foray_denseslotmap.hpp"
+#include "foray_test.hpp"
+#include <random>
+#include <unordered_map>
+
+using namespace foray;
+using SlotMap = util::DenseSlotMap<uint32_t, std::string>;
+
+/// @brief Every key maps to the values it was inserted with, dense arrays are consistent
+void CheckConsistent(const SlotMap& map, const std::unordered_map<SlotMap::Key, uint32_t>& expected)
+{
+    FORAY_CHECK(map.Size() == expected.size());
+    FORAY_CHECK(map.GetKeys().size() == map.Size());
+    for(const auto& [key, value] : expected)
+    {
+        FORAY_CHECK(map.Contains(key));
+        const uint32_t*    mapValue = map.GetValue(key);
+        const std::string* aux      = map.GetAux(key);
+        FORAY_CHECK(!!mapValue && *mapValue == value);
+        FORAY_CHECK(!!aux && *aux == std::to_string(value));
+
+        size_t denseIndex = map.GetDenseIndex(key);
+        FORAY_CHECK(denseIndex < map.Size() && map.GetKeys()[denseIndex] == key);
+    }
+}
+
+void TestInsertRemove()
+{
+    SlotMap map;
+    SlotMap::Key a = map.Insert(1, "1");
+    SlotMap::Key b = map.Insert(2, "2");
+    SlotMap::Key c = map.Insert(3, "3");
+    CheckConsistent(map, {{a, 1}, {b, 2}, {c, 3}});
+
+    // Swap-remove: the last value fills the gap, the arrays stay dense
+    FORAY_CHECK(map.Remove(a));
+    FORAY_CHECK(!map.Contains(a));
+    FORAY_CHECK(map.GetValue(a) == nullptr);
+    FORAY_CHECK(map.GetValues()[0] == 3);
+    CheckConsistent(map, {{b, 2}, {c, 3}});
+
+    // Removing twice fails, stale keys never resolve to a value inserted into the reused slot
+    FORAY_CHECK(!map.Remove(a));
+    SlotMap::Key d = map.Insert(4, "4");
+    FORAY_CHECK((uint32_t)d == (uint32_t)a);
+    FORAY_CHECK(d != a);
+    FORAY_CHECK(!map.Contains(a));
+    CheckConsistent(map, {{b, 2}, {c, 3}, {d, 4}});
+
+    // Keys are independent of bit 63, which the owner may use
+    FORAY_CHECK((d & (1ULL << 63)) == 0);
+    FORAY_CHECK(!map.Contains(SlotMap::INVALID_KEY));
+
+    map.Clear();
+    FORAY_CHECK(map.Empty());
+    FORAY_CHECK(!map.Contains(b) && !map.Contains(c) && !map.Contains(d));
+}
+
+void TestRandomized()
+{
+    SlotMap                                   map;
+    std::unordered_map<SlotMap::Key, uint32_t> expected;
+    std::vector<SlotMap::Key>                 removed;
+    std::mt19937                              rng(1234);
+    for(uint32_t i = 0; i < 10000; i++)
+    {
+        if(expected.empty() || rng() % 3 != 0)
+        {
+            SlotMap::Key key = map.Insert(i, std::to_string(i));
+            FORAY_CHECK(expected.find(key) == expected.end());
+            expected[key] = i;
+        }
+        else
+        {
+            auto iter = expected.begin();
+            std::advance(iter, rng() % expected.size());
+            FORAY_CHECK(map.Remove(iter->first));
+            removed.push_back(iter->first);
+            expected.erase(iter);
+        }
+    }
+    CheckConsistent(map, expected);
+    for(SlotMap::Key key : removed)
+    {
+        FORAY_CHECK(!map.Contains(key));
+    }
+}
+
+int main()
+{
+    TestInsertRemove();
+    TestRandomized();
+    return test::Result();
+}
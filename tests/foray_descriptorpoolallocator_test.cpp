@@ -0,0 +1,180 @@
+#include "../src/core/foray_descriptorpoolallocator.hpp"
+#include "../src/core/foray_descriptorset.hpp"
+#include "../src/core/foray_managedbuffer.hpp"
+#include "../src/core/foray_managedimage.hpp"
+#include "../src/stages/foray_comparerstage.hpp"
+#include "foray_testdevice.hpp"
+#include <memory>
+#include <vector>
+
+using namespace foray;
+
+/// @brief Exposes the descriptor writes of both substages
+class TestComparer : public stages::ComparerStage
+{
+  public:
+    uint64_t GetDescriptorWriteCount() const
+    {
+        return mSubStages[0].DescriptorSet.GetDescriptorWriteCount() + mSubStages[1].DescriptorSet.GetDescriptorWriteCount();
+    }
+};
+
+/// @brief Creates a set with one storage buffer binding, and a uniform buffer binding if withUniform is set
+std::unique_ptr<core::DescriptorSet> MakeSet(core::Context* context, const core::ManagedBuffer& storage, const core::ManagedBuffer& uniform, bool withUniform)
+{
+    auto set = std::make_unique<core::DescriptorSet>();
+    set->SetAllowDescriptorBuffer(false);
+    set->SetDescriptorAt(0, storage, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    if(withUniform)
+    {
+        set->SetDescriptorAt(1, uniform, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    }
+    set->Create(context, "Test Set");
+    return set;
+}
+
+/// @brief Exists() reflects Create() / Destroy(), not whether a pool has been created
+void TestLifetime(core::Context* context)
+{
+    core::DescriptorPoolAllocator allocator;
+    FORAY_CHECK(!allocator.Exists());
+    allocator.Create(context);
+    FORAY_CHECK(allocator.Exists());
+    FORAY_CHECK(allocator.GetPoolCount() == 0);
+    allocator.Destroy();
+    FORAY_CHECK(!allocator.Exists());
+}
+
+/// @brief Sets of differing shapes share pools once the pools reserve every type they need. Freed capacity is reused, exhausted pools are followed by
+/// pools of twice the set capacity
+void TestSharedPools(core::Context* context, const core::ManagedBuffer& storage, const core::ManagedBuffer& uniform)
+{
+    core::DescriptorPoolAllocator allocator;
+    allocator.SetInitialSetsPerPool(4);
+    allocator.SetMaxSetsPerPool(64);
+    allocator.Create(context);
+    context->DescriptorAllocator = &allocator;
+
+    std::vector<std::unique_ptr<core::DescriptorSet>> sets;
+    std::vector<bool>                                 withUniform;
+    auto add = [&](bool uniformBinding) {
+        sets.push_back(MakeSet(context, storage, uniform, uniformBinding));
+        withUniform.push_back(uniformBinding);
+    };
+
+    add(false);
+    FORAY_CHECK(allocator.GetPoolCreationCount() == 1);
+    // The first pool (4 sets) reserves no uniform buffers
+    add(true);
+    FORAY_CHECK(allocator.GetPoolCreationCount() == 2);
+    // The second pool (8 sets) reserves both types. Both shapes fit the remaining capacity
+    for(uint32_t i = 0; i < 6; i++)
+    {
+        add(i % 2 == 0);
+    }
+    FORAY_CHECK(allocator.GetPoolCreationCount() == 2);
+    FORAY_CHECK(allocator.GetLiveSetCount() == 8);
+
+    // Churn is served from freed capacity
+    for(uint32_t round = 0; round < 40; round++)
+    {
+        size_t index = round % sets.size();
+        sets[index].reset();
+        sets[index] = MakeSet(context, storage, uniform, withUniform[index]);
+    }
+    FORAY_CHECK(allocator.GetPoolCreationCount() == 2);
+    FORAY_CHECK(allocator.GetLiveSetCount() == 8);
+
+    // 4 more sets fill the second pool, the third pool holds 16
+    for(uint32_t i = 0; i < 20; i++)
+    {
+        add(false);
+    }
+    FORAY_CHECK(allocator.GetPoolCreationCount() == 3);
+    add(false);
+    FORAY_CHECK(allocator.GetPoolCreationCount() == 4);
+    FORAY_CHECK(allocator.GetAllocationCount() == 8 + 40 + 21);
+
+    sets.clear();
+    FORAY_CHECK(allocator.GetLiveSetCount() == 0);
+    FORAY_CHECK(allocator.GetPoolCount() == 4);
+    context->DescriptorAllocator = nullptr;
+    allocator.Destroy();
+}
+
+/// @brief Resizing a stage rewrites only the bindings referencing resized images, and neither creates pools nor allocates sets
+void TestResize(core::Context* context)
+{
+    core::DescriptorPoolAllocator allocator;
+    allocator.Create(context);
+    context->DescriptorAllocator = &allocator;
+
+    VkImageUsageFlags  usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+    core::ManagedImage left;
+    core::ManagedImage right;
+    left.Create(context, usage, VK_FORMAT_R32G32B32A32_SFLOAT, context->GetSwapchainSize(), "Left");
+    right.Create(context, usage, VK_FORMAT_R32G32B32A32_SFLOAT, context->GetSwapchainSize(), "Right");
+
+    TestComparer comparer;
+    comparer.Init(context, false);
+    comparer.SetInput(0, stages::ComparerStage::InputInfo{.Image = &left});
+    comparer.SetInput(1, stages::ComparerStage::InputInfo{.Image = &right});
+
+    const uint64_t pools       = allocator.GetPoolCreationCount();
+    const uint64_t allocations = allocator.GetAllocationCount();
+    FORAY_CHECK(allocations == 2);
+    for(uint32_t i = 0; i < 10; i++)
+    {
+        uint64_t writes = comparer.GetDescriptorWriteCount();
+        comparer.Resize(VkExtent2D{32U + 8U * i, 32U + 4U * i});
+        // Input and output binding per substage. The pipette buffer binding is untouched
+        FORAY_CHECK(comparer.GetDescriptorWriteCount() == writes + 4);
+    }
+    FORAY_CHECK(allocator.GetPoolCreationCount() == pools);
+    FORAY_CHECK(allocator.GetAllocationCount() == allocations);
+    FORAY_CHECK(allocator.GetLiveSetCount() == 2);
+
+    // Swapping inputs keeps the substage sets
+    for(uint32_t i = 0; i < 10; i++)
+    {
+        comparer.SetInput(i % 2, stages::ComparerStage::InputInfo{.Image = i % 4 < 2 ? &right : &left});
+    }
+    FORAY_CHECK(allocator.GetPoolCreationCount() == pools);
+    FORAY_CHECK(allocator.GetAllocationCount() == allocations);
+
+    comparer.Destroy();
+    FORAY_CHECK(allocator.GetLiveSetCount() == 0);
+    left.Destroy();
+    right.Destroy();
+    context->DescriptorAllocator = nullptr;
+    allocator.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(false))
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context = device.GetContext();
+    // Stages size their outputs to the swapchain
+    vkb::Swapchain swapchain;
+    swapchain.extent  = VkExtent2D{32, 32};
+    context.Swapchain = &swapchain;
+
+    core::ManagedBuffer storage;
+    core::ManagedBuffer uniform;
+    storage.Create(&context, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 256, VMA_MEMORY_USAGE_AUTO);
+    uniform.Create(&context, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 256, VMA_MEMORY_USAGE_AUTO);
+
+    TestLifetime(&context);
+    TestSharedPools(&context, storage, uniform);
+    TestResize(&context);
+
+    storage.Destroy();
+    uniform.Destroy();
+    context.Swapchain = nullptr;
+    device.Destroy();
+    return test::Result();
+}
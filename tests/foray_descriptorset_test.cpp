@@ -0,0 +1,157 @@
+#include "../src/core/foray_descriptorset.hpp"
+#include "../src/core/foray_managedbuffer.hpp"
+#include "../src/util/foray_pipelinelayout.hpp"
+#include "foray_testdevice.hpp"
+
+using namespace foray;
+
+void CreateStorageBuffer(core::Context* context, core::ManagedBuffer& buffer)
+{
+    buffer.Create(context, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, 256, VMA_MEMORY_USAGE_AUTO);
+}
+
+/// @brief Every SetDescriptorAt() call is written by the next Update(), even if the handles equal the ones written before
+void TestDirtyBindings(core::Context* context, bool allowDescriptorBuffer)
+{
+    core::ManagedBuffer a;
+    core::ManagedBuffer b;
+    CreateStorageBuffer(context, a);
+    CreateStorageBuffer(context, b);
+
+    core::DescriptorSet set;
+    set.SetAllowDescriptorBuffer(allowDescriptorBuffer);
+    set.SetDescriptorAt(0, a, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    set.SetDescriptorAt(1, b, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    set.Create(context, "Test Set");
+    uint64_t writes = set.GetDescriptorWriteCount();
+    FORAY_CHECK(writes == 2);
+
+    // Nothing set, nothing written
+    set.Update();
+    FORAY_CHECK(set.GetDescriptorWriteCount() == writes);
+
+    // Recreated buffers may reuse the destroyed buffers handle. The binding is rewritten regardless
+    a.Destroy();
+    CreateStorageBuffer(context, a);
+    set.SetDescriptorAt(0, a, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    set.Update();
+    FORAY_CHECK(set.GetDescriptorWriteCount() == writes + 1);
+
+    set.Update(true);
+    FORAY_CHECK(set.GetDescriptorWriteCount() == writes + 3);
+
+    set.Destroy();
+    a.Destroy();
+    b.Destroy();
+}
+
+void CreateSet(core::Context* context, core::DescriptorSet& set, const core::ManagedBuffer& buffer, bool allowDescriptorBuffer)
+{
+    set.SetAllowDescriptorBuffer(allowDescriptorBuffer);
+    set.SetDescriptorAt(0, buffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    set.Create(context, "Test Set");
+}
+
+/// @brief Two sets of one pipeline layout are bound with a single call, on both the pool and the descriptor buffer path
+void TestBindSets(core::Context* context, bool allowDescriptorBuffer)
+{
+    core::ManagedBuffer buffer;
+    CreateStorageBuffer(context, buffer);
+    core::DescriptorSet a;
+    core::DescriptorSet b;
+    CreateSet(context, a, buffer, allowDescriptorBuffer);
+    CreateSet(context, b, buffer, allowDescriptorBuffer);
+    FORAY_CHECK(a.GetUsesDescriptorBuffer() == allowDescriptorBuffer);
+
+    util::PipelineLayout layout;
+    layout.AddDescriptorSetLayout(a);
+    layout.AddDescriptorSetLayout(b);
+    layout.Build(context);
+    FORAY_CHECK(layout.GetPipelineCreateFlags() == a.GetPipelineCreateFlags());
+    FORAY_CHECK((a.GetPipelineCreateFlags() != 0) == allowDescriptorBuffer);
+
+    VkCommandBuffer             cmdBuffer = nullptr;
+    VkCommandBufferAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, .commandPool = context->CommandPool, .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY, .commandBufferCount = 1U};
+    AssertVkResult(context->VkbDispatchTable->allocateCommandBuffers(&allocInfo, &cmdBuffer));
+    VkCommandBufferBeginInfo beginInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+    AssertVkResult(context->VkbDispatchTable->beginCommandBuffer(cmdBuffer, &beginInfo));
+    // Devices may support a single resource descriptor buffer binding only
+    if(!allowDescriptorBuffer || context->DescriptorBufferProperties->maxResourceDescriptorBufferBindings >= 2)
+    {
+        core::DescriptorSet::CmdBindSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0U, {&a, &b});
+    }
+    a.CmdBind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0U);
+    AssertVkResult(context->VkbDispatchTable->endCommandBuffer(cmdBuffer));
+
+    VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO, .commandBufferCount = 1U, .pCommandBuffers = &cmdBuffer};
+    AssertVkResult(context->VkbDispatchTable->queueSubmit(context->Queue, 1U, &submitInfo, nullptr));
+    AssertVkResult(context->VkbDispatchTable->queueWaitIdle(context->Queue));
+    context->VkbDispatchTable->freeCommandBuffers(context->CommandPool, 1U, &cmdBuffer);
+
+    layout.Destroy();
+    a.Destroy();
+    b.Destroy();
+    buffer.Destroy();
+}
+
+/// @brief Descriptor buffer backed and pool allocated sets can not be combined in one pipeline
+void TestRefuseMixedSets(core::Context* context)
+{
+    core::ManagedBuffer buffer;
+    CreateStorageBuffer(context, buffer);
+    core::DescriptorSet descriptorBufferSet;
+    core::DescriptorSet poolSet;
+    CreateSet(context, descriptorBufferSet, buffer, true);
+    CreateSet(context, poolSet, buffer, false);
+
+    util::PipelineLayout layout;
+    layout.AddDescriptorSetLayout(descriptorBufferSet);
+    layout.AddDescriptorSetLayout(poolSet);
+    bool refused = false;
+    try
+    {
+        layout.Build(context);
+    }
+    catch(const Exception&)
+    {
+        refused = true;
+    }
+    FORAY_CHECK(refused);
+    FORAY_CHECK(!layout.Exists());
+
+    refused = false;
+    try
+    {
+        core::DescriptorSet::CmdBindSets(nullptr, VK_PIPELINE_BIND_POINT_COMPUTE, nullptr, 0U, {&descriptorBufferSet, &poolSet});
+    }
+    catch(const Exception&)
+    {
+        refused = true;
+    }
+    FORAY_CHECK(refused);
+
+    layout.Destroy();
+    descriptorBufferSet.Destroy();
+    poolSet.Destroy();
+    buffer.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create())
+    {
+        return test::SKIPPED;
+    }
+    TestDirtyBindings(&device.GetContext(), false);
+    TestBindSets(&device.GetContext(), false);
+    if(device.HasDescriptorBuffer())
+    {
+        TestDirtyBindings(&device.GetContext(), true);
+        TestBindSets(&device.GetContext(), true);
+        TestRefuseMixedSets(&device.GetContext());
+    }
+    device.Destroy();
+    return test::Result();
+}
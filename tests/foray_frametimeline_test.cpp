@@ -0,0 +1,109 @@
+#include "../src/core/foray_frametimeline.hpp"
+#include "foray_testdevice.hpp"
+#include <algorithm>
+
+using namespace foray;
+
+/// @brief Signals value on the timeline from the queue, as a frames primary command buffer submission does
+void SubmitSignal(core::Context* context, const core::FrameTimeline& timeline, uint64_t value)
+{
+    VkSemaphore                   semaphore = timeline.GetSemaphore();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO, .signalSemaphoreValueCount = 1U, .pSignalSemaphoreValues = &value};
+    VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO, .pNext = &timelineInfo, .signalSemaphoreCount = 1U, .pSignalSemaphores = &semaphore};
+    AssertVkResult(context->VkbDispatchTable->queueSubmit(context->Queue, 1U, &submitInfo, nullptr));
+}
+
+/// @brief 1000 frames with two in flight: values count frames, deferred callbacks run in order and only once their frame has finished
+void TestFrames(core::Context* context)
+{
+    const uint64_t      frameCount = 1000;
+    core::FrameTimeline timeline;
+    timeline.Create(context, "Test Timeline");
+
+    // Frame value each callback was deferred at, in invocation order
+    std::vector<uint64_t> invoked;
+    auto                  lDefer = [&](uint64_t value) {
+        timeline.Defer([&, value]() {
+            FORAY_CHECK(timeline.HasCompleted(value));
+            invoked.push_back(value);
+        });
+    };
+
+    uint64_t redeferredAt = 0;
+    for(uint64_t frame = 1; frame <= frameCount; frame++)
+    {
+        // Two frames in flight: wait for the frame before the previous one
+        timeline.Wait(frame > 2 ? frame - 2 : 0);
+        timeline.Collect();
+
+        uint64_t value = timeline.Advance();
+        FORAY_CHECK(value == frame);
+        FORAY_CHECK(timeline.GetSubmittedValue() == frame);
+
+        lDefer(value);
+        if(frame == frameCount / 2)
+        {
+            // Callbacks deferring again run once the frame current at their invocation has finished
+            timeline.Defer([&]() {
+                redeferredAt = timeline.GetSubmittedValue();
+                lDefer(redeferredAt);
+            });
+        }
+
+        // Not signalled yet, so the callback deferred for this frame must not run
+        timeline.Collect();
+        FORAY_CHECK(!timeline.HasCompleted(value));
+        FORAY_CHECK(invoked.empty() || invoked.back() < value);
+
+        SubmitSignal(context, timeline, value);
+    }
+
+    AssertVkResult(context->VkbDispatchTable->queueWaitIdle(context->Queue));
+    FORAY_CHECK(timeline.GetCompletedValue() == frameCount);
+    FORAY_CHECK(timeline.HasCompleted(frameCount));
+    timeline.Collect();
+    FORAY_CHECK(timeline.GetDeferredCount() == 0);
+
+    // Every frame exactly once plus the redeferred callback, in value order
+    FORAY_CHECK(invoked.size() == frameCount + 1);
+    FORAY_CHECK(redeferredAt > frameCount / 2);
+    for(size_t i = 1; i < invoked.size(); i++)
+    {
+        FORAY_CHECK(invoked[i - 1] <= invoked[i]);
+    }
+    FORAY_CHECK(std::count(invoked.begin(), invoked.end(), redeferredAt) == 2);
+
+    timeline.Destroy();
+}
+
+/// @brief Destroying the timeline runs outstanding callbacks
+void TestDestroy(core::Context* context)
+{
+    core::FrameTimeline timeline;
+    timeline.Create(context, "Test Timeline");
+    bool ran = false;
+    timeline.Advance();
+    timeline.Defer([&]() { ran = true; });
+    timeline.Collect();
+    FORAY_CHECK(!ran);
+    timeline.Destroy();
+    FORAY_CHECK(ran);
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create())
+    {
+        return test::SKIPPED;
+    }
+    if(device.GetVulkan12Features().timelineSemaphore != VK_TRUE)
+    {
+        return test::SKIPPED;
+    }
+    TestFrames(&device.GetContext());
+    TestDestroy(&device.GetContext());
+    device.Destroy();
+    return test::Result();
+}
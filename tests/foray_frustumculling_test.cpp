@@ -0,0 +1,224 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/scene/components/foray_camera.hpp"
+#include "../src/scene/components/foray_meshinstance.hpp"
+#include "../src/scene/components/foray_transform.hpp"
+#include "../src/scene/foray_mesh.hpp"
+#include "../src/scene/foray_node.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/foray_scenedrawing.hpp"
+#include "../src/scene/globalcomponents/foray_cameramanager.hpp"
+#include "../src/scene/globalcomponents/foray_drawmanager.hpp"
+#include "../src/scene/globalcomponents/foray_geometrymanager.hpp"
+#include "../src/stages/foray_frustumcullingstage.hpp"
+#include "foray_testcompute.hpp"
+#include "foray_testdevice.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace foray;
+
+const uint32_t INSTANCE_COUNT = 2000;
+
+/// @brief Smallest signed distance of the sphere surface to the frustum planes, mirroring frustumculling_instances.comp. Negative if culled
+fp32_t FrustumMargin(const glm::mat4& projectionView, const glm::vec3& center, fp32_t radius)
+{
+    glm::mat4 m         = glm::transpose(projectionView);
+    glm::vec4 planes[6] = {m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[2], m[3] - m[2]};
+    fp32_t    margin    = std::numeric_limits<fp32_t>::max();
+    for(const glm::vec4& plane : planes)
+    {
+        fp32_t len = glm::length(glm::vec3(plane));
+        if(len < 1e-6f)
+        {
+            continue;
+        }
+        margin = std::min(margin, (glm::dot(glm::vec3(plane), center) + plane.w) / len + radius);
+    }
+    return margin;
+}
+
+/// @brief World space bounding sphere of an instance, as computed by the culling shader
+glm::vec4 WorldBounds(const glm::mat4& model, const glm::vec4& bounds)
+{
+    glm::vec3 center   = glm::vec3(model * glm::vec4(glm::vec3(bounds), 1.f));
+    fp32_t    maxScale = std::max(glm::length(glm::vec3(model[0])), std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    return glm::vec4(center, bounds.w * maxScale);
+}
+
+/// @brief Two meshes (a unit cube and an elongated box), each split into two indexed primitives
+void BuildMeshes(scene::gcomp::GeometryStore* geo, std::vector<scene::Mesh*>& out_meshes)
+{
+    for(glm::vec3 extent : {glm::vec3(0.5f), glm::vec3(4.f, 0.25f, 0.25f)})
+    {
+        uint32_t firstVertex = (uint32_t)geo->GetVertices().size();
+        for(uint32_t corner = 0; corner < 8; corner++)
+        {
+            scene::Vertex vertex{};
+            vertex.Pos = extent * glm::vec3(corner & 1 ? 1.f : -1.f, corner & 2 ? 1.f : -1.f, corner & 4 ? 1.f : -1.f);
+            geo->GetVertices().push_back(vertex);
+        }
+        std::vector<scene::Primitive> primitives;
+        // Faces -z/+z, then -y/+y/-x/+x
+        const uint32_t faces[2][12] = {{0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6}, {0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7}};
+        for(uint32_t part = 0; part < 2; part++)
+        {
+            uint32_t first = (uint32_t)geo->GetIndices().size();
+            for(uint32_t index : faces[part])
+            {
+                geo->GetIndices().push_back(firstVertex + index);
+            }
+            primitives.push_back(scene::Primitive(scene::Primitive::EType::Index, first, 12U, (int32_t)part, (int32_t)firstVertex + 7, geo->GetVertices(), {}));
+        }
+        auto mesh = std::make_unique<scene::Mesh>();
+        mesh->SetPrimitives(primitives);
+        out_meshes.push_back(mesh.get());
+        geo->GetMeshes().push_back(std::move(mesh));
+    }
+}
+
+/// @brief Copies count elements of buffer into host memory
+template <typename T>
+std::vector<T> ReadBack(core::Context* context, const core::ManagedBuffer& buffer, size_t count)
+{
+    core::ManagedBuffer readback;
+    readback.Create(context, VK_BUFFER_USAGE_TRANSFER_DST_BIT, count * sizeof(T), VMA_MEMORY_USAGE_AUTO_PREFER_HOST, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) {
+        VkBufferCopy copy{.srcOffset = 0, .dstOffset = 0, .size = count * sizeof(T)};
+        vkCmdCopyBuffer(cmdBuffer, buffer.GetBuffer(), readback.GetBuffer(), 1U, &copy);
+    });
+    std::vector<T> result(count);
+    void*          mapped = nullptr;
+    readback.Map(mapped);
+    vmaInvalidateAllocation(context->Allocator, readback.GetAllocation(), 0, VK_WHOLE_SIZE);
+    memcpy(result.data(), mapped, count * sizeof(T));
+    readback.Unmap();
+    return result;
+}
+
+/// @brief Random instances around a camera at the origin. Visible and culled counts, per draw op instance counts and the compacted draw instances
+/// must match a CPU evaluation of the same test. Instances within a small margin of a frustum plane are moved, so float differences cannot flip the result
+void TestCulling(core::Context* context, bool cullingEnabled)
+{
+    scene::Scene scene(context);
+    auto         geo           = scene.GetComponent<scene::gcomp::GeometryStore>();
+    auto         drawDirector  = scene.GetComponent<scene::gcomp::DrawDirector>();
+    auto         cameraManager = scene.GetComponent<scene::gcomp::CameraManager>();
+
+    scene::Node*          cameraNode = scene.MakeNode();
+    scene::ncomp::Camera* camera     = cameraNode->MakeComponent<scene::ncomp::Camera>();
+    camera->SetProjectionMatrix(glm::radians(60.f), 1.5f, 0.1f, 40.f);
+    cameraManager->RefreshCameraList();
+    cameraManager->SelectCamera(camera);
+    const glm::mat4 projectionView = camera->ProjectionMat() * glm::inverse(cameraNode->GetTransform()->GetGlobalMatrix());
+
+    std::vector<scene::Mesh*> meshes;
+    BuildMeshes(geo, meshes);
+    geo->InitOrUpdate();
+
+    std::mt19937                          rng(42);
+    std::uniform_real_distribution<float> position(-30.f, 30.f);
+    std::uniform_real_distribution<float> scale(0.5f, 3.f);
+    std::uniform_real_distribution<float> unit(-1.f, 1.f);
+    for(uint32_t i = 0; i < INSTANCE_COUNT; i++)
+    {
+        scene::Node*             node      = scene.MakeNode();
+        scene::Mesh*             mesh      = meshes[i % meshes.size()];
+        const glm::vec4&         bounds    = geo->GetMeshBounds()[mesh->GetBoundsIndex()];
+        scene::ncomp::Transform* transform = node->GetTransform();
+        node->MakeComponent<scene::ncomp::MeshInstance>()->SetMesh(mesh);
+        glm::vec4 world;
+        do
+        {
+            glm::vec3 axis = glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.f, 0.f, 1e-3f);
+            transform->SetTranslation(glm::vec3(position(rng), position(rng), position(rng)));
+            transform->SetRotation(glm::angleAxis(unit(rng) * 3.14f, glm::normalize(axis)));
+            transform->SetScale(glm::vec3(scale(rng)));
+            world = WorldBounds(transform->GetGlobalMatrix(), bounds);
+        } while(std::abs(FrustumMargin(projectionView, glm::vec3(world), world.w)) < 0.05f);
+    }
+    drawDirector->InitOrUpdate();
+
+    // CPU reference per draw op
+    std::vector<std::vector<uint32_t>> expectedVisible;
+    uint32_t                           visibleTotal = 0;
+    for(const scene::gcomp::DrawOp& drawop : drawDirector->GetDrawOps())
+    {
+        const glm::vec4&      bounds = geo->GetMeshBounds()[drawop.Target->GetBoundsIndex()];
+        std::vector<uint32_t> visible;
+        for(uint32_t i = 0; i < drawop.Instances.size(); i++)
+        {
+            glm::vec4 world = WorldBounds(drawop.Instances[i]->GetNode()->GetTransform()->GetGlobalMatrix(), bounds);
+            if(!cullingEnabled || FrustumMargin(projectionView, glm::vec3(world), world.w) >= 0.f)
+            {
+                visible.push_back(drawop.TransformOffset + i);
+            }
+        }
+        visibleTotal += (uint32_t)visible.size();
+        expectedVisible.push_back(visible);
+    }
+    // Without culling everything is visible, with culling the scene must contain both outcomes for the test to mean anything
+    FORAY_CHECK(cullingEnabled ? visibleTotal > 0 && visibleTotal < INSTANCE_COUNT : visibleTotal == INSTANCE_COUNT);
+
+    stages::FrustumCullingStage stage;
+    stage.Init(context, &scene);
+    stage.SetCullingEnabled(cullingEnabled);
+
+    base::FrameRenderInfo renderInfo;
+    renderInfo.SetFrameNumber(1);
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) {
+        scene::SceneUpdateInfo updateInfo(renderInfo, cmdBuffer);
+        drawDirector->Update(updateInfo);
+        cameraManager->Update(updateInfo);
+        stage.RecordFrame(cmdBuffer, renderInfo);
+    });
+
+    // Compacted draw instances: The first visible count slots of each draw op hold its visible transform indices, in any order
+    std::vector<uint32_t> drawInstances = ReadBack<uint32_t>(context, drawDirector->GetDrawInstanceBuffer(), INSTANCE_COUNT);
+    const auto&           drawOps       = drawDirector->GetDrawOps();
+    for(size_t op = 0; op < drawOps.size(); op++)
+    {
+        auto                  first = drawInstances.begin() + drawOps[op].TransformOffset;
+        std::vector<uint32_t> actual(first, first + expectedVisible[op].size());
+        std::sort(actual.begin(), actual.end());
+        FORAY_CHECK(actual == expectedVisible[op]);
+    }
+
+    // Every indirect command of a draw op draws its visible instance count
+    std::vector<VkDrawIndexedIndirectCommand> commands =
+        ReadBack<VkDrawIndexedIndirectCommand>(context, drawDirector->GetIndirectCommandBuffer(), drawDirector->GetIndirectDrawCount());
+    uint32_t visibleDraws = 0;
+    for(const VkDrawIndexedIndirectCommand& command : commands)
+    {
+        auto op = std::find_if(drawOps.begin(), drawOps.end(), [&](const scene::gcomp::DrawOp& drawop) { return drawop.TransformOffset == command.firstInstance; });
+        FORAY_CHECK(op != drawOps.end());
+        FORAY_CHECK(command.instanceCount == expectedVisible[op - drawOps.begin()].size());
+        visibleDraws += command.instanceCount > 0 ? 1 : 0;
+    }
+
+    // Statistics are read back when the frame INFLIGHT_FRAME_COUNT frames later is recorded
+    base::FrameRenderInfo nextRenderInfo;
+    nextRenderInfo.SetFrameNumber(1 + INFLIGHT_FRAME_COUNT);
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) { stage.RecordFrame(cmdBuffer, nextRenderInfo); });
+    const stages::FrustumCullingStage::Statistics& statistics = stage.GetStatistics();
+    FORAY_CHECK(statistics.VisibleInstances == visibleTotal);
+    FORAY_CHECK(statistics.CulledInstances == INSTANCE_COUNT - visibleTotal);
+    FORAY_CHECK(statistics.VisibleDraws == visibleDraws);
+    FORAY_CHECK(statistics.CulledDraws == drawDirector->GetIndirectDrawCount() - visibleDraws);
+
+    stage.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(false))
+    {
+        return test::SKIPPED;
+    }
+    TestCulling(&device.GetContext(), true);
+    TestCulling(&device.GetContext(), false);
+    device.Destroy();
+    return test::Result();
+}
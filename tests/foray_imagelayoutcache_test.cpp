@@ -0,0 +1,102 @@
+#include "../src/core/foray_imagelayoutcache.hpp"
+#include "foray_test.hpp"
+
+using namespace foray;
+using Barrier2 = core::ImageLayoutCache::Barrier2;
+
+/// @brief Layout tracking never dereferences image handles, so distinct fake handles suffice
+VkImage FakeImage(uintptr_t id)
+{
+    return reinterpret_cast<VkImage>(id);
+}
+
+VkImageSubresourceRange Range(uint32_t baseMip, uint32_t mipCount, uint32_t baseLayer, uint32_t layerCount)
+{
+    return VkImageSubresourceRange{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = baseMip, .levelCount = mipCount, .baseArrayLayer = baseLayer, .layerCount = layerCount};
+}
+
+const VkImageSubresourceRange sFullRange = Range(0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+
+std::vector<VkImageMemoryBarrier2> Transition(core::ImageLayoutCache& cache, VkImage image, VkImageLayout layout, const VkImageSubresourceRange& range)
+{
+    std::vector<VkImageMemoryBarrier2> barriers;
+    cache.MakeBarriers(image, Barrier2{.NewLayout = layout, .SubresourceRange = range}, barriers);
+    return barriers;
+}
+
+/// @brief Ranges written with explicit counts cover single mip / single layer images completely
+void TestSingleSubresource()
+{
+    core::ImageLayoutCache cache;
+
+    // Counts declared up front
+    VkImage a = FakeImage(1);
+    cache.SetSubresourceCounts(a, 1, 1);
+    Transition(cache, a, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, Range(0, 1, 0, 1));
+    std::vector<VkImageMemoryBarrier2> barriers = Transition(cache, a, VK_IMAGE_LAYOUT_GENERAL, sFullRange);
+    FORAY_CHECK(barriers.size() == 1);
+    FORAY_CHECK(barriers[0].oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    FORAY_CHECK(barriers[0].subresourceRange.levelCount == 1 && barriers[0].subresourceRange.layerCount == 1);
+
+    // Counts declared after the override was recorded
+    VkImage b = FakeImage(2);
+    Transition(cache, b, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, Range(0, 1, 0, 1));
+    cache.SetSubresourceCounts(b, 1, 1);
+    barriers = Transition(cache, b, VK_IMAGE_LAYOUT_GENERAL, sFullRange);
+    FORAY_CHECK(barriers.size() == 1);
+    FORAY_CHECK(barriers[0].oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Ranges reaching beyond the image are clamped
+    barriers = Transition(cache, b, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Range(0, 4, 0, 1));
+    FORAY_CHECK(barriers.size() == 1);
+    FORAY_CHECK(barriers[0].subresourceRange.levelCount == 1);
+    FORAY_CHECK(cache.Get(b, sFullRange) == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+}
+
+/// @brief Partially transitioned mip chains split into subranges with exact counts, which sum up to the whole image
+void TestMipChain()
+{
+    core::ImageLayoutCache cache;
+    VkImage                image = FakeImage(3);
+    cache.SetSubresourceCounts(image, 4, 2);
+    Transition(cache, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, sFullRange);
+    Transition(cache, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Range(1, 1, 0, 2));
+
+    std::vector<VkImageMemoryBarrier2> barriers = Transition(cache, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, sFullRange);
+    FORAY_CHECK(barriers.size() == 3);
+    uint32_t subresources = 0;
+    for(const VkImageMemoryBarrier2& barrier : barriers)
+    {
+        const VkImageSubresourceRange& range = barrier.subresourceRange;
+        FORAY_CHECK(range.levelCount != VK_REMAINING_MIP_LEVELS && range.layerCount != VK_REMAINING_ARRAY_LAYERS);
+        FORAY_CHECK(range.baseMipLevel + range.levelCount <= 4 && range.baseArrayLayer + range.layerCount <= 2);
+        FORAY_CHECK(barrier.oldLayout == (range.baseMipLevel == 1 ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL));
+        subresources += range.levelCount * range.layerCount;
+    }
+    FORAY_CHECK(subresources == 8);
+
+    // The whole image is uniform again
+    barriers = Transition(cache, image, VK_IMAGE_LAYOUT_GENERAL, sFullRange);
+    FORAY_CHECK(barriers.size() == 1);
+    FORAY_CHECK(barriers[0].oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+/// @brief Without known counts, explicit ranges can not be assumed to cover the image
+void TestUnknownCounts()
+{
+    core::ImageLayoutCache cache;
+    VkImage                image = FakeImage(4);
+    Transition(cache, image, VK_IMAGE_LAYOUT_GENERAL, Range(0, 1, 0, 1));
+    std::vector<VkImageMemoryBarrier2> barriers = Transition(cache, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, sFullRange);
+    FORAY_CHECK(barriers.size() == 3);
+    FORAY_CHECK(cache.Get(image, sFullRange) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+int main()
+{
+    TestSingleSubresource();
+    TestMipChain();
+    TestUnknownCounts();
+    return test::Result();
+}
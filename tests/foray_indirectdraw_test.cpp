@@ -0,0 +1,379 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/core/foray_managedimage.hpp"
+#include "../src/scene/components/foray_meshinstance.hpp"
+#include "../src/scene/components/foray_transform.hpp"
+#include "../src/scene/foray_mesh.hpp"
+#include "../src/scene/foray_node.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/foray_scenedrawing.hpp"
+#include "../src/scene/globalcomponents/foray_drawmanager.hpp"
+#include "../src/scene/globalcomponents/foray_geometrymanager.hpp"
+#include "foray_testcompute.hpp"
+#include "foray_testdevice.hpp"
+#include <cstring>
+#include <set>
+
+using namespace foray;
+
+/// @brief Counts indirect draw commands recorded through the dispatch table
+uint32_t                          gIndirectCountDraws       = 0;
+uint32_t                          gIndirectDraws            = 0;
+PFN_vkCmdDrawIndexedIndirectCount gDrawIndexedIndirectCount = nullptr;
+PFN_vkCmdDrawIndexedIndirect      gDrawIndexedIndirect      = nullptr;
+
+VKAPI_ATTR void VKAPI_CALL CountingDrawIndexedIndirectCount(
+    VkCommandBuffer cmdBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
+{
+    gIndirectCountDraws++;
+    gDrawIndexedIndirectCount(cmdBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
+}
+
+VKAPI_ATTR void VKAPI_CALL CountingDrawIndexedIndirect(VkCommandBuffer cmdBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+{
+    gIndirectDraws++;
+    gDrawIndexedIndirect(cmdBuffer, buffer, offset, drawCount, stride);
+}
+
+const uint32_t GRID_CELLS     = 8;
+const uint32_t CELL_PIXELS    = 8;
+const uint32_t IMAGE_SIZE     = GRID_CELLS * CELL_PIXELS;
+const uint32_t MESH_COUNT     = 3;
+const uint32_t INSTANCE_COUNT = 60;
+
+/// @brief Resolves transform and material index like gbuffer_stage.vert and writes both (+1, so that 0 means "not drawn" or "header mismatch")
+const char* VERTEX_SHADER = R"(#version 460
+layout(location = 0) in vec3 inPos;
+layout(location = 0) flat out uvec2 outIds;
+layout(push_constant) uniform PushConstant_T
+{
+    uint TransformBufferOffset;
+    int  MaterialIndex;
+    uint IndirectDraw;
+    uint CurrentTransformBase;
+    uint PreviousTransformBase;
+} PushConstant;
+layout(set = 0, binding = 0, std430) readonly buffer TransformBuffer_T
+{
+    uint  CurrentTransformBase;
+    uint  PreviousTransformBase;
+    uvec2 HeaderPadding0;
+    uvec4 HeaderPadding1[3];
+    mat4  Array[];
+} TransformBuffer;
+layout(set = 0, binding = 1, std430) readonly buffer DrawInstanceBuffer_T { uint Array[]; } DrawInstanceBuffer;
+layout(set = 0, binding = 2, std430) readonly buffer DrawMaterialBuffer_T { int Array[]; } DrawMaterialBuffer;
+void main()
+{
+    uint transformIndex = PushConstant.IndirectDraw != 0 ? DrawInstanceBuffer.Array[gl_InstanceIndex] : PushConstant.TransformBufferOffset + gl_InstanceIndex;
+    int  materialIndex  = PushConstant.IndirectDraw != 0 ? DrawMaterialBuffer.Array[gl_DrawID] : PushConstant.MaterialIndex;
+    gl_Position         = TransformBuffer.Array[PushConstant.CurrentTransformBase + transformIndex] * vec4(inPos, 1.0);
+    outIds              = uvec2(transformIndex + 1, uint(materialIndex + 1));
+    // The buffer header (read by GetCurrentTransform() in transformbuffer.glsl) must agree with the pushed bases
+    if(TransformBuffer.CurrentTransformBase != PushConstant.CurrentTransformBase || TransformBuffer.PreviousTransformBase != PushConstant.PreviousTransformBase)
+    {
+        outIds = uvec2(0);
+    }
+}
+)";
+
+const char* FRAGMENT_SHADER = R"(#version 460
+layout(location = 0) flat in uvec2 inIds;
+layout(location = 0) out uvec2 outIds;
+void main()
+{
+    outIds = inIds;
+}
+)";
+
+/// @brief Scene of INSTANCE_COUNT instances of MESH_COUNT meshes, one per grid cell. Every mesh is a unit quad split into two indexed primitives (left and right half)
+/// with materials 2 * mesh and 2 * mesh + 1
+void BuildScene(scene::Scene& scene)
+{
+    auto geo = scene.GetComponent<scene::gcomp::GeometryStore>();
+    for(uint32_t y = 0; y <= 1; y++)
+    {
+        for(uint32_t x = 0; x <= 2; x++)
+        {
+            scene::Vertex vertex{};
+            vertex.Pos = glm::vec3(0.5f * (fp32_t)x, (fp32_t)y, 0.f);
+            geo->GetVertices().push_back(vertex);
+        }
+    }
+    std::vector<scene::Mesh*> meshes;
+    for(uint32_t mesh = 0; mesh < MESH_COUNT; mesh++)
+    {
+        std::vector<scene::Primitive> primitives;
+        for(uint32_t half = 0; half < 2; half++)
+        {
+            uint32_t first = (uint32_t)geo->GetIndices().size();
+            for(uint32_t index : {0U, 1U, 4U, 0U, 4U, 3U})
+            {
+                geo->GetIndices().push_back(index + half);
+            }
+            primitives.push_back(scene::Primitive(scene::Primitive::EType::Index, first, 6U, (int32_t)(2 * mesh + half), 5, geo->GetVertices(), {}));
+        }
+        auto newMesh = std::make_unique<scene::Mesh>();
+        newMesh->SetPrimitives(primitives);
+        meshes.push_back(newMesh.get());
+        geo->GetMeshes().push_back(std::move(newMesh));
+    }
+
+    for(uint32_t i = 0; i < INSTANCE_COUNT; i++)
+    {
+        scene::Node* node = scene.MakeNode();
+        node->MakeComponent<scene::ncomp::MeshInstance>()->SetMesh(meshes[i % MESH_COUNT]);
+        fp32_t cellSize = 2.f / (fp32_t)GRID_CELLS;
+        node->GetTransform()->SetTranslation(glm::vec3(-1.f + cellSize * (fp32_t)(i % GRID_CELLS), -1.f + cellSize * (fp32_t)(i / GRID_CELLS), 0.f));
+        node->GetTransform()->SetRotation(glm::quat(1.f, 0.f, 0.f, 0.f));
+        node->GetTransform()->SetScale(glm::vec3(cellSize, cellSize, 1.f));
+    }
+    geo->InitOrUpdate();
+}
+
+/// @brief Draws a scene via DrawDirector::Draw() into an R32G32_UINT image and reads it back
+class IdRenderer
+{
+  public:
+    /// @return False, if the shaders could not be compiled
+    bool Create(core::Context* context, scene::gcomp::DrawDirector* drawDirector)
+    {
+        mContext = context;
+        if(!test::CompileTestShader(context, mShaderManager, "indirectdraw.vert", VERTEX_SHADER, mVertexShader)
+           || !test::CompileTestShader(context, mShaderManager, "indirectdraw.frag", FRAGMENT_SHADER, mFragmentShader))
+        {
+            return false;
+        }
+
+        mImage.Create(context, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_FORMAT_R32G32_UINT, VkExtent2D{IMAGE_SIZE, IMAGE_SIZE}, "Id Image");
+        mReadback.Create(context, VK_BUFFER_USAGE_TRANSFER_DST_BIT, IMAGE_SIZE * IMAGE_SIZE * sizeof(glm::uvec2), VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+                         VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+
+        mDescriptorSet.SetDescriptorAt(0, drawDirector->GetTransformsDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
+        mDescriptorSet.SetDescriptorAt(1, drawDirector->GetDrawInstancesDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
+        mDescriptorSet.SetDescriptorAt(2, drawDirector->GetDrawMaterialIndicesDescriptorInfo(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
+        mDescriptorSet.Create(context, "Id Set");
+
+        mPipelineLayout.AddDescriptorSetLayout(mDescriptorSet);
+        mPipelineLayout.AddPushConstantRange(scene::DrawPushConstant::GetPushConstantRange());
+        mPipelineLayout.Build(context);
+
+        VkPipelineShaderStageCreateInfo shaderStages[] = {mVertexShader.GetShaderStageCi(VK_SHADER_STAGE_VERTEX_BIT), mFragmentShader.GetShaderStageCi(VK_SHADER_STAGE_FRAGMENT_BIT)};
+
+        VkVertexInputBindingDescription      vertexBinding{.binding = 0U, .stride = sizeof(scene::Vertex), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX};
+        VkVertexInputAttributeDescription    vertexAttribute{.location = 0U, .binding = 0U, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = offsetof(scene::Vertex, Pos)};
+        VkPipelineVertexInputStateCreateInfo vertexInput{.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+                                                         .vertexBindingDescriptionCount   = 1U,
+                                                         .pVertexBindingDescriptions      = &vertexBinding,
+                                                         .vertexAttributeDescriptionCount = 1U,
+                                                         .pVertexAttributeDescriptions    = &vertexAttribute};
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+        VkViewport                             viewport{.width = (fp32_t)IMAGE_SIZE, .height = (fp32_t)IMAGE_SIZE, .maxDepth = 1.f};
+        VkRect2D                               scissor{.extent = VkExtent2D{IMAGE_SIZE, IMAGE_SIZE}};
+        VkPipelineViewportStateCreateInfo      viewportState{
+                 .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, .viewportCount = 1U, .pViewports = &viewport, .scissorCount = 1U, .pScissors = &scissor};
+        VkPipelineRasterizationStateCreateInfo rasterization{.sType       = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+                                                             .polygonMode = VK_POLYGON_MODE_FILL,
+                                                             .cullMode    = VK_CULL_MODE_NONE,
+                                                             .lineWidth   = 1.f};
+        VkPipelineMultisampleStateCreateInfo   multisample{.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT};
+        VkPipelineColorBlendAttachmentState    blendAttachment{.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT};
+        VkPipelineColorBlendStateCreateInfo    colorBlend{.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, .attachmentCount = 1U, .pAttachments = &blendAttachment};
+        VkFormat                               colorFormat = VK_FORMAT_R32G32_UINT;
+        VkPipelineRenderingCreateInfo          renderingCi{.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO, .colorAttachmentCount = 1U, .pColorAttachmentFormats = &colorFormat};
+
+        VkGraphicsPipelineCreateInfo pipelineCi{.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                                .pNext               = &renderingCi,
+                                                .flags               = mPipelineLayout.GetPipelineCreateFlags(),
+                                                .stageCount          = 2U,
+                                                .pStages             = shaderStages,
+                                                .pVertexInputState   = &vertexInput,
+                                                .pInputAssemblyState = &inputAssembly,
+                                                .pViewportState      = &viewportState,
+                                                .pRasterizationState = &rasterization,
+                                                .pMultisampleState   = &multisample,
+                                                .pColorBlendState    = &colorBlend,
+                                                .layout              = mPipelineLayout};
+        AssertVkResult(context->VkbDispatchTable->createGraphicsPipelines(nullptr, 1U, &pipelineCi, nullptr, &mPipeline));
+        return true;
+    }
+
+    /// @brief Renders the scene with the draw directors current draw mode, returns (transform index + 1, material index + 1) per pixel
+    std::vector<glm::uvec2> Render(scene::gcomp::DrawDirector* drawDirector, const base::FrameRenderInfo& renderInfo)
+    {
+        test::SubmitAndWait(mContext, [&](VkCommandBuffer cmdBuffer) {
+            VkImageMemoryBarrier2 barrier{.sType            = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                                          .srcStageMask     = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                          .srcAccessMask    = VK_ACCESS_2_TRANSFER_READ_BIT,
+                                          .dstStageMask     = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                          .dstAccessMask    = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                          .oldLayout        = VK_IMAGE_LAYOUT_UNDEFINED,
+                                          .newLayout        = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                          .image            = mImage.GetImage(),
+                                          .subresourceRange = VkImageSubresourceRange{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .levelCount = 1U, .layerCount = 1U}};
+            VkDependencyInfo      depInfo{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO, .imageMemoryBarrierCount = 1U, .pImageMemoryBarriers = &barrier};
+            vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
+
+            VkRenderingAttachmentInfo attachment{.sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                                                 .imageView   = mImage.GetImageView(),
+                                                 .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                                 .loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                 .storeOp     = VK_ATTACHMENT_STORE_OP_STORE};
+            VkRenderingInfo           renderingInfo{.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                                                    .renderArea           = VkRect2D{.extent = VkExtent2D{IMAGE_SIZE, IMAGE_SIZE}},
+                                                    .layerCount           = 1U,
+                                                    .colorAttachmentCount = 1U,
+                                                    .pColorAttachments    = &attachment};
+            vkCmdBeginRendering(cmdBuffer, &renderingInfo);
+            mContext->VkbDispatchTable->cmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+            mDescriptorSet.CmdBind(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout);
+            scene::SceneDrawInfo drawInfo(renderInfo, mPipelineLayout, cmdBuffer);
+            drawDirector->Draw(drawInfo);
+            vkCmdEndRendering(cmdBuffer);
+
+            barrier.srcStageMask  = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+            barrier.dstStageMask  = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+            barrier.oldLayout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            barrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
+
+            VkBufferImageCopy copy{.imageSubresource = VkImageSubresourceLayers{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .layerCount = 1U},
+                                   .imageExtent      = VkExtent3D{IMAGE_SIZE, IMAGE_SIZE, 1U}};
+            vkCmdCopyImageToBuffer(cmdBuffer, mImage.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, mReadback.GetBuffer(), 1U, &copy);
+        });
+
+        std::vector<glm::uvec2> pixels(IMAGE_SIZE * IMAGE_SIZE);
+        void*                   mapped = nullptr;
+        mReadback.Map(mapped);
+        vmaInvalidateAllocation(mContext->Allocator, mReadback.GetAllocation(), 0, VK_WHOLE_SIZE);
+        memcpy(pixels.data(), mapped, pixels.size() * sizeof(glm::uvec2));
+        mReadback.Unmap();
+        return pixels;
+    }
+
+    void Destroy()
+    {
+        if(!!mPipeline)
+        {
+            mContext->VkbDispatchTable->destroyPipeline(mPipeline, nullptr);
+            mPipeline = nullptr;
+        }
+        mPipelineLayout.Destroy();
+        mDescriptorSet.Destroy();
+        mVertexShader.Destroy();
+        mFragmentShader.Destroy();
+        mReadback.Destroy();
+        mImage.Destroy();
+    }
+    ~IdRenderer() { Destroy(); }
+
+  protected:
+    core::Context*       mContext = nullptr;
+    core::ShaderManager  mShaderManager{nullptr};
+    core::ShaderModule   mVertexShader;
+    core::ShaderModule   mFragmentShader;
+    core::DescriptorSet  mDescriptorSet;
+    util::PipelineLayout mPipelineLayout;
+    VkPipeline           mPipeline = nullptr;
+    core::ManagedImage   mImage;
+    core::ManagedBuffer  mReadback;
+};
+
+/// @brief Every instance covers its grid cell, left half with the meshes first material, right half with its second. Transform indices are unique per instance
+void CheckDirectImage(const std::vector<glm::uvec2>& pixels)
+{
+    std::set<uint32_t> transformIds;
+    for(uint32_t i = 0; i < INSTANCE_COUNT; i++)
+    {
+        uint32_t         cellX = (i % GRID_CELLS) * CELL_PIXELS;
+        uint32_t         cellY = (i / GRID_CELLS) * CELL_PIXELS;
+        const glm::uvec2 left  = pixels[(cellY + CELL_PIXELS / 2) * IMAGE_SIZE + cellX + CELL_PIXELS / 4];
+        const glm::uvec2 right = pixels[(cellY + CELL_PIXELS / 2) * IMAGE_SIZE + cellX + 3 * CELL_PIXELS / 4];
+        FORAY_CHECK(left.y == 2 * (i % MESH_COUNT) + 1);
+        FORAY_CHECK(right.y == 2 * (i % MESH_COUNT) + 2);
+        FORAY_CHECK(left.x == right.x);
+        FORAY_CHECK(left.x >= 1 && left.x <= INSTANCE_COUNT);
+        transformIds.insert(left.x);
+    }
+    FORAY_CHECK(transformIds.size() == INSTANCE_COUNT);
+    // Cells without an instance stay cleared
+    FORAY_CHECK(pixels[(IMAGE_SIZE - CELL_PIXELS / 2) * IMAGE_SIZE + IMAGE_SIZE - CELL_PIXELS / 2] == glm::uvec2(0U));
+}
+
+/// @brief Renders the same scene with CPU draws, vkCmdDrawIndexedIndirectCount and vkCmdDrawIndexedIndirect (drawIndirectCount disabled). All images must be identical
+/// @return False, if the shaders could not be compiled
+bool TestIndirectDraw(core::Context* context)
+{
+    scene::Scene scene(context);
+    BuildScene(scene);
+    auto drawDirector = scene.GetComponent<scene::gcomp::DrawDirector>();
+    drawDirector->InitOrUpdate();
+    FORAY_CHECK(drawDirector->GetIndirectDrawCount() == 2 * MESH_COUNT);
+
+    base::FrameRenderInfo renderInfo;
+    renderInfo.SetFrameNumber(1);
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) {
+        scene::SceneUpdateInfo updateInfo(renderInfo, cmdBuffer);
+        drawDirector->Update(updateInfo);
+    });
+
+    IdRenderer renderer;
+    if(!renderer.Create(context, drawDirector))
+    {
+        return false;
+    }
+
+    drawDirector->SetUseIndirectDraw(false);
+    std::vector<glm::uvec2> direct = renderer.Render(drawDirector, renderInfo);
+    CheckDirectImage(direct);
+    FORAY_CHECK(gIndirectCountDraws == 0 && gIndirectDraws == 0);
+
+    drawDirector->SetUseIndirectDraw(true);
+    if(scene::gcomp::DrawDirector::IsIndirectDrawCountSupported(context))
+    {
+        FORAY_CHECK(renderer.Render(drawDirector, renderInfo) == direct);
+        FORAY_CHECK(gIndirectCountDraws == 1 && gIndirectDraws == 0);
+    }
+
+    // Without drawIndirectCount, Draw() falls back to vkCmdDrawIndexedIndirect (multiDrawIndirect) or to CPU draws
+    const VkPhysicalDeviceVulkan12Features* enabled12    = context->EnabledVulkan12Features;
+    VkPhysicalDeviceVulkan12Features        withoutCount = *enabled12;
+    withoutCount.drawIndirectCount   = VK_FALSE;
+    context->EnabledVulkan12Features = &withoutCount;
+
+    bool     multiDraw          = scene::gcomp::DrawDirector::IsIndirectDrawSupported(context);
+    uint32_t indirectCountDraws = gIndirectCountDraws;
+    FORAY_CHECK(renderer.Render(drawDirector, renderInfo) == direct);
+    FORAY_CHECK(gIndirectCountDraws == indirectCountDraws);
+    FORAY_CHECK(gIndirectDraws == (multiDraw ? 1U : 0U));
+    context->EnabledVulkan12Features = enabled12;
+
+    renderer.Destroy();
+    return true;
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(false))
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context = device.GetContext();
+    if(!scene::gcomp::DrawDirector::IsIndirectDrawSupported(&context))
+    {
+        return test::SKIPPED;
+    }
+    gDrawIndexedIndirectCount                                  = context.VkbDispatchTable->fp_vkCmdDrawIndexedIndirectCount;
+    gDrawIndexedIndirect                                       = context.VkbDispatchTable->fp_vkCmdDrawIndexedIndirect;
+    context.VkbDispatchTable->fp_vkCmdDrawIndexedIndirectCount = &CountingDrawIndexedIndirectCount;
+    context.VkbDispatchTable->fp_vkCmdDrawIndexedIndirect      = &CountingDrawIndexedIndirect;
+
+    bool rendered = TestIndirectDraw(&context);
+
+    context.VkbDispatchTable->fp_vkCmdDrawIndexedIndirectCount = gDrawIndexedIndirectCount;
+    context.VkbDispatchTable->fp_vkCmdDrawIndexedIndirect      = gDrawIndexedIndirect;
+    device.Destroy();
+    return rendered || test::FailureCount() > 0 ? test::Result() : test::SKIPPED;
+}
@@ -0,0 +1,139 @@
+#include "../src/core/foray_descriptorset.hpp"
+#include "../src/core/foray_managedbuffer.hpp"
+#include "../src/core/foray_pipelinecache.hpp"
+#include "foray_testcompute.hpp"
+#include "foray_testdevice.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace foray;
+namespace fs = std::filesystem;
+
+const char* FILL_SHADER = R"(#version 460
+layout(local_size_x = 64) in;
+layout(set = 0, binding = 0, std430) buffer Values_T { uint Values[]; } Values;
+void main() { Values.Values[gl_GlobalInvocationID.x] = gl_GlobalInvocationID.x * 3u + 1u; }
+)";
+
+/// @brief Exposes the file header layout
+struct TestPipelineCache : public core::PipelineCache
+{
+    using PipelineCache::FileHeader;
+};
+
+/// @brief Records the initial data size passed to vkCreatePipelineCache
+size_t                    gInitialDataSize     = 0;
+PFN_vkCreatePipelineCache gCreatePipelineCache = nullptr;
+
+VKAPI_ATTR VkResult VKAPI_CALL RecordingCreatePipelineCache(VkDevice device, const VkPipelineCacheCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineCache* pPipelineCache)
+{
+    gInitialDataSize = pCreateInfo->initialDataSize;
+    return gCreatePipelineCache(device, pCreateInfo, pAllocator, pPipelineCache);
+}
+
+/// @brief Creates the cache from dir (a "run"), builds a compute pipeline through it and saves the cache
+/// @return False, if the shader failed to compile
+bool Run(core::Context* context, const fs::path& dir, TestPipelineCache& cache)
+{
+    cache.Create(context, osi::ToUtf8Path(dir));
+    context->PipelineCache = cache;
+
+    core::ManagedBuffer values;
+    values.Create(context, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 64 * sizeof(uint32_t), VMA_MEMORY_USAGE_AUTO);
+    core::DescriptorSet set;
+    set.SetDescriptorAt(0, values, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+    set.Create(context, "Fill Set");
+    test::TestComputePipeline pipeline;
+    bool                      compiled = pipeline.Create(context, "pipelinecache_fill", FILL_SHADER, set);
+    pipeline.Destroy();
+
+    context->PipelineCache = nullptr;
+    if(compiled)
+    {
+        FORAY_CHECK(cache.Save());
+    }
+    return compiled;
+}
+
+/// @brief Rewrites the DataSize of the cache file header
+void SetFileDataSize(const fs::path& file, uint64_t dataSize)
+{
+    TestPipelineCache::FileHeader header;
+    {
+        std::ifstream in(file, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    header.DataSize = dataSize;
+    std::fstream out(file, std::ios::binary | std::ios::in | std::ios::out);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+/// @brief A second run must load the cache file written by the first. Files whose header data size does not match the file size are cache misses
+bool TestReuse(core::Context* context)
+{
+    fs::path dir = fs::temp_directory_path() / "foray_pipelinecache_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    TestPipelineCache first;
+    if(!Run(context, dir, first))
+    {
+        return false;
+    }
+    FORAY_CHECK(!first.GetLoadedFromFile());
+    FORAY_CHECK(gInitialDataSize == 0);
+    fs::path file = (fs::path)osi::Utf8Path(first.GetFilePath());
+    first.Destroy();
+    FORAY_CHECK(fs::exists(file));
+    const uintmax_t dataSize = fs::file_size(file) - sizeof(TestPipelineCache::FileHeader);
+
+    TestPipelineCache second;
+    Run(context, dir, second);
+    FORAY_CHECK(second.GetLoadedFromFile());
+    FORAY_CHECK(second.GetFilePath() == osi::ToUtf8Path(file));
+    FORAY_CHECK(gInitialDataSize == dataSize);
+    second.Destroy();
+
+    // Claims more data than the file holds (e.g. an interrupted copy)
+    SetFileDataSize(file, dataSize + 1);
+    TestPipelineCache oversized;
+    oversized.Create(context, osi::ToUtf8Path(dir));
+    FORAY_CHECK(!oversized.GetLoadedFromFile());
+    FORAY_CHECK(gInitialDataSize == 0);
+    oversized.Destroy();
+
+    // Absurd size, must not be allocated
+    SetFileDataSize(file, UINT64_MAX / 2);
+    TestPipelineCache corrupt;
+    corrupt.Create(context, osi::ToUtf8Path(dir));
+    FORAY_CHECK(!corrupt.GetLoadedFromFile());
+    corrupt.Destroy();
+
+    // Claims less data than the file holds
+    SetFileDataSize(file, dataSize - 1);
+    TestPipelineCache undersized;
+    undersized.Create(context, osi::ToUtf8Path(dir));
+    FORAY_CHECK(!undersized.GetLoadedFromFile());
+    undersized.Destroy();
+
+    fs::remove_all(dir);
+    return true;
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(false))
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context                             = device.GetContext();
+    gCreatePipelineCache                               = context.VkbDispatchTable->fp_vkCreatePipelineCache;
+    context.VkbDispatchTable->fp_vkCreatePipelineCache = &RecordingCreatePipelineCache;
+
+    bool ran = TestReuse(&context);
+
+    context.VkbDispatchTable->fp_vkCreatePipelineCache = gCreatePipelineCache;
+    device.Destroy();
+    return ran ? test::Result() : test::SKIPPED;
+}
@@ -0,0 +1,195 @@
+#include "../src/stages/foray_rendergraph.hpp"
+#include "foray_test.hpp"
+
+using namespace foray;
+using RenderGraph = stages::RenderGraph;
+
+/// @brief Passes are never recorded. Compile() does not touch the images either, so images which have not been created suffice
+void RecordNothing(VkCommandBuffer, base::FrameRenderInfo&) {}
+
+const VkPipelineStageFlags2 COMPUTE  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+const VkPipelineStageFlags2 FRAGMENT = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+const VkPipelineStageFlags2 ATTACH   = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+const VkImageLayout READONLY = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+const VkImageLayout GENERAL  = VK_IMAGE_LAYOUT_GENERAL;
+const VkImageLayout COLOR    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+/// @brief Deferred shading chain with a dead debug pass: one barrier per hazard or layout change, consecutive reads share a barrier
+void TestDeferredChain()
+{
+    core::ManagedImage gbuffer;
+    core::ManagedImage debug;
+    core::ManagedImage lit;
+    core::ManagedImage bloom;
+    core::ManagedImage output;
+    RenderGraph        graph;
+    graph.AddPass("gbuffer", RecordNothing).Write(&gbuffer, COLOR, ATTACH, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+    graph.AddPass("debug", RecordNothing)
+        .Read(&gbuffer, READONLY, FRAGMENT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Write(&debug, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("lighting", RecordNothing)
+        .Read(&gbuffer, READONLY, COMPUTE, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Write(&lit, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("bloom", RecordNothing)
+        .Read(&lit, READONLY, COMPUTE, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Write(&bloom, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("tonemap", RecordNothing)
+        .Read(&lit, READONLY, FRAGMENT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Read(&bloom, READONLY, FRAGMENT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Write(&output, COLOR, ATTACH, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+    graph.MarkOutput(&output);
+    graph.Compile();
+
+    // The debug pass contributes to no output
+    FORAY_CHECK(graph.GetCulledPassCount() == 1);
+    FORAY_CHECK((graph.GetPassOrder() == std::vector<std::string_view>{"gbuffer", "lighting", "bloom", "tonemap"}));
+    FORAY_CHECK(graph.GetPlannedBarriers("debug").empty());
+
+    FORAY_CHECK(graph.GetPlannedBarriers("gbuffer").size() == 1);
+    FORAY_CHECK(graph.GetPlannedBarriers("lighting").size() == 2);
+    FORAY_CHECK(graph.GetPlannedBarriers("bloom").size() == 2);
+    // lit was made readable for bloom already, only the layout change of bloom and the first use of output remain
+    FORAY_CHECK(graph.GetPlannedBarriers("tonemap").size() == 2);
+    FORAY_CHECK(graph.GetPlannedBarrierCount() == 7);
+
+    // The gbuffer read synchronizes with the attachment write only (the culled debug read is not waited on)
+    for(const RenderGraph::PlannedBarrier& planned : graph.GetPlannedBarriers("lighting"))
+    {
+        if(planned.Image == &gbuffer)
+        {
+            FORAY_CHECK(planned.Barrier.SrcStageMask == ATTACH);
+            FORAY_CHECK(planned.Barrier.SrcAccessMask == VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+            FORAY_CHECK(planned.Barrier.NewLayout == READONLY);
+        }
+    }
+    // The barrier before bloom covers the tonemap read as well
+    for(const RenderGraph::PlannedBarrier& planned : graph.GetPlannedBarriers("bloom"))
+    {
+        if(planned.Image == &lit)
+        {
+            FORAY_CHECK(planned.Barrier.DstStageMask == (COMPUTE | FRAGMENT));
+        }
+    }
+}
+
+/// @brief Write after write and read after write each need a barrier, reads in the same layout after that do not
+void TestHazards()
+{
+    core::ManagedImage accumulation;
+    RenderGraph        graph;
+    graph.AddPass("clear", RecordNothing).Write(&accumulation, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("accumulate", RecordNothing)
+        .ReadWrite(&accumulation, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("readA", RecordNothing).Read(&accumulation, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_READ_BIT).SetSideEffects();
+    graph.AddPass("readB", RecordNothing).Read(&accumulation, GENERAL, FRAGMENT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT).SetSideEffects();
+    graph.Compile();
+
+    FORAY_CHECK(graph.GetCulledPassCount() == 0);
+    FORAY_CHECK(graph.GetPlannedBarriers("clear").size() == 1);
+    FORAY_CHECK(graph.GetPlannedBarriers("accumulate").size() == 1);
+    FORAY_CHECK(graph.GetPlannedBarriers("readA").size() == 1);
+    FORAY_CHECK(graph.GetPlannedBarriers("readB").empty());
+    FORAY_CHECK(graph.GetPlannedBarrierCount() == 3);
+
+    std::vector<RenderGraph::PlannedBarrier> barriers = graph.GetPlannedBarriers("accumulate");
+    FORAY_CHECK(barriers[0].Barrier.SrcAccessMask == VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    barriers = graph.GetPlannedBarriers("readA");
+    FORAY_CHECK(barriers[0].Barrier.DstStageMask == (COMPUTE | FRAGMENT));
+}
+
+/// @brief Passes are ordered by their dependencies, not their declaration. Without outputs or side effects, nothing is culled
+void TestOrderAndCulling()
+{
+    core::ManagedImage a;
+    core::ManagedImage b;
+    core::ManagedImage unused;
+    RenderGraph        graph;
+    graph.AddPass("consumer", RecordNothing).Read(&b, READONLY, FRAGMENT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+    graph.AddPass("middle", RecordNothing)
+        .Read(&a, READONLY, COMPUTE, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Write(&b, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("producer", RecordNothing).Write(&a, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("dead", RecordNothing).Write(&unused, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.Compile();
+
+    FORAY_CHECK(graph.GetCulledPassCount() == 0);
+    FORAY_CHECK((graph.GetPassOrder() == std::vector<std::string_view>{"producer", "middle", "consumer", "dead"}));
+
+    // With an output, only its contributors remain
+    graph.MarkOutput(&b);
+    FORAY_CHECK(!graph.GetCompiled());
+    graph.Compile();
+    FORAY_CHECK(graph.GetCulledPassCount() == 2);
+    FORAY_CHECK((graph.GetPassOrder() == std::vector<std::string_view>{"producer", "middle"}));
+    FORAY_CHECK(graph.GetPlannedBarrierCount() == 3);
+
+    // Side effects keep a pass alive
+    graph.Clear();
+    graph.AddPass("producer", RecordNothing).Write(&a, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("present", RecordNothing).Read(&a, READONLY, FRAGMENT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT).SetSideEffects();
+    graph.AddPass("dead", RecordNothing).Write(&unused, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.Compile();
+    FORAY_CHECK(graph.GetCulledPassCount() == 1);
+    FORAY_CHECK((graph.GetPassOrder() == std::vector<std::string_view>{"producer", "present"}));
+    FORAY_CHECK(graph.GetPlannedBarrierCount() == 2);
+}
+
+/// @brief History reads are ordered before the writer of the image, regardless of declaration order, and keep the writer from being culled
+void TestHistory()
+{
+    core::ManagedImage color;
+    core::ManagedImage history;
+    core::ManagedImage output;
+    RenderGraph        graph;
+    graph.AddPass("copy", RecordNothing)
+        .Read(&output, READONLY, COMPUTE, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Write(&history, GENERAL, COMPUTE, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    graph.AddPass("taa", RecordNothing)
+        .ReadHistory(&history, READONLY, FRAGMENT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Read(&color, READONLY, FRAGMENT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+        .Write(&output, COLOR, ATTACH, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+    graph.AddPass("render", RecordNothing).Write(&color, COLOR, ATTACH, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+    graph.MarkOutput(&output);
+    graph.Compile();
+
+    // copy contributes to no output, but supplies the history taa reads next frame
+    FORAY_CHECK(graph.GetCulledPassCount() == 0);
+    FORAY_CHECK((graph.GetPassOrder() == std::vector<std::string_view>{"render", "taa", "copy"}));
+
+    // taa reads the previous frames contents, copy overwrites them once taa is done
+    for(const RenderGraph::PlannedBarrier& planned : graph.GetPlannedBarriers("taa"))
+    {
+        if(planned.Image == &history)
+        {
+            FORAY_CHECK(planned.Barrier.SrcStageMask == VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+            FORAY_CHECK(planned.Barrier.NewLayout == READONLY);
+        }
+    }
+    bool historyBarrier = false;
+    for(const RenderGraph::PlannedBarrier& planned : graph.GetPlannedBarriers("copy"))
+    {
+        if(planned.Image == &history)
+        {
+            historyBarrier = true;
+            FORAY_CHECK(planned.Barrier.SrcStageMask == FRAGMENT);
+            FORAY_CHECK(planned.Barrier.SrcAccessMask == VK_ACCESS_2_NONE);
+            FORAY_CHECK(planned.Barrier.NewLayout == GENERAL);
+        }
+    }
+    FORAY_CHECK(historyBarrier);
+
+    // The history is carried over between frames, so it can not alias other images
+    auto lifetimes = graph.GetImageLifetimes();
+    FORAY_CHECK(lifetimes.at(&history).FirstUse == 0 && lifetimes.at(&history).LastUse == ~0U);
+    FORAY_CHECK(lifetimes.at(&color).FirstUse == 0 && lifetimes.at(&color).LastUse == 1);
+}
+
+int main()
+{
+    TestDeferredChain();
+    TestHazards();
+    TestOrderAndCulling();
+    TestHistory();
+    return test::Result();
+}
@@ -0,0 +1,307 @@
+#include "../src/core/foray_shadermanager.hpp"
+#include "foray_test.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+#include <sstream>
+#include <unordered_set>
+
+using namespace foray;
+namespace fs = std::filesystem;
+
+/// @brief Empty temporary directory for a test
+fs::path MakeTestDirectory(std::string_view name)
+{
+    fs::path dir = fs::temp_directory_path() / "foray_shadermanager_test" / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+void WriteFile(const fs::path& path, std::string_view content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+/// @brief Concurrently compiles valid and broken shaders. Every compilation must report its own result and compiler output
+void TestBatchCompile()
+{
+    fs::path dir = MakeTestDirectory("batch");
+
+    core::ShaderManager manager(nullptr);
+    manager.SetBackend(core::EShaderCompilerBackend::Glslc);
+    manager.SetCacheDirectory(osi::Utf8Path(osi::ToUtf8Path(dir / "cache")));
+
+    const int32_t                          validCount  = 12;
+    const int32_t                          brokenCount = 4;
+    std::vector<core::ShaderCompileRequest> requests;
+    for(int32_t i = 0; i < validCount + brokenCount; i++)
+    {
+        bool     broken = i >= validCount;
+        fs::path path   = dir / fmt::format("shader{}.comp", i);
+        if(broken)
+        {
+            WriteFile(path, fmt::format("#version 460\nlayout(local_size_x = 1) in;\nvoid main() {{ undefined_symbol_{} = 1; }}\n", i));
+        }
+        else
+        {
+            WriteFile(path, fmt::format("#version 460\nlayout(local_size_x = {}) in;\nvoid main() {{}}\n", i + 1));
+        }
+        requests.push_back(core::ShaderCompileRequest{.SourceFilePath = osi::Utf8Path(osi::ToUtf8Path(path))});
+    }
+
+    std::vector<core::ShaderCompileResult> results;
+    std::vector<uint64_t>                  keys = manager.CompileShaders(requests, nullptr, &results);
+    FORAY_CHECK(keys.size() == requests.size());
+    FORAY_CHECK(results.size() == requests.size());
+    for(int32_t i = 0; i < (int32_t)results.size(); i++)
+    {
+        const core::ShaderCompileResult& result = results[i];
+        FORAY_CHECK(result.Key == keys[i]);
+        if(i < validCount)
+        {
+            FORAY_CHECK(result.Success);
+            continue;
+        }
+        FORAY_CHECK(!result.Success);
+        // The output belongs to this compilation only
+        FORAY_CHECK(result.CompilerOutput.find(fmt::format("undefined_symbol_{}", i)) != std::string::npos);
+        for(int32_t other = validCount; other < validCount + brokenCount; other++)
+        {
+            if(other != i)
+            {
+                FORAY_CHECK(result.CompilerOutput.find(fmt::format("undefined_symbol_{}", other)) == std::string::npos);
+            }
+        }
+    }
+
+    // Nothing changed, nothing to recompile
+    std::unordered_set<uint64_t> recompiled;
+    FORAY_CHECK(!manager.CheckAndUpdateShaders(recompiled));
+    FORAY_CHECK(recompiled.empty());
+}
+
+/// @brief Marks a file as modified, even on filesystems with coarse write time resolution
+void Touch(const fs::path& path)
+{
+    fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(2));
+}
+
+/// @brief Files in dir with the given extension
+std::vector<fs::path> ListFiles(const fs::path& dir, std::string_view extension)
+{
+    std::vector<fs::path> files;
+    for(const fs::directory_entry& entry : fs::directory_iterator(dir))
+    {
+        if(entry.path().extension() == extension)
+        {
+            files.push_back(entry.path());
+        }
+    }
+    return files;
+}
+
+/// @brief Comment and whitespace edits keep the content hash, real edits recompile. Outdated spirv files next to the source are deleted once a newer content state compiled
+void TestContentHashing()
+{
+    fs::path dir    = MakeTestDirectory("hashing");
+    fs::path source = dir / "shader.comp";
+    WriteFile(source, "#version 460\nlayout(local_size_x = 4) in;\nvoid main() {}\n");
+
+    core::ShaderManager manager(nullptr);
+    manager.SetBackend(core::EShaderCompilerBackend::Glslc);
+    std::vector<core::ShaderCompileResult> results;
+    uint64_t key = manager.CompileShaders({core::ShaderCompileRequest{.SourceFilePath = osi::Utf8Path(osi::ToUtf8Path(source))}}, nullptr, &results).front();
+    FORAY_CHECK(results.size() == 1 && results[0].Success);
+    FORAY_CHECK(ListFiles(dir, ".spv").size() == 1);
+
+    // Comment only edit
+    WriteFile(source, "#version 460\n// A comment\nlayout(local_size_x = 4) in; /* another one */\n\nvoid main() {}   \n");
+    Touch(source);
+    std::unordered_set<uint64_t> recompiled;
+    FORAY_CHECK(!manager.CheckAndUpdateShaders(recompiled));
+    FORAY_CHECK(recompiled.empty());
+
+    // Real edit, the previous spirv file is pruned
+    WriteFile(source, "#version 460\nlayout(local_size_x = 8) in;\nvoid main() {}\n");
+    Touch(source);
+    FORAY_CHECK(manager.CheckAndUpdateShaders(recompiled));
+    FORAY_CHECK(recompiled.count(key) == 1);
+    FORAY_CHECK(ListFiles(dir, ".spv").size() == 1);
+    FORAY_CHECK(ListFiles(dir, ".tmp").empty());
+
+    // Broken edit, the last good spirv file is kept until a later edit compiles
+    std::vector<fs::path> good = ListFiles(dir, ".spv");
+    WriteFile(source, "#version 460\nlayout(local_size_x = 8) in;\nvoid main() { error }\n");
+    Touch(source);
+    recompiled.clear();
+    manager.CheckAndUpdateShaders(recompiled);
+    FORAY_CHECK(ListFiles(dir, ".spv") == good);
+
+    WriteFile(source, "#version 460\nlayout(local_size_x = 16) in;\nvoid main() {}\n");
+    Touch(source);
+    FORAY_CHECK(manager.CheckAndUpdateShaders(recompiled));
+    std::vector<fs::path> fixed = ListFiles(dir, ".spv");
+    FORAY_CHECK(fixed.size() == 1 && fixed != good);
+}
+
+/// @brief A truncated spirv file in the cache directory is recompiled instead of loaded
+void TestTruncatedCache()
+{
+    fs::path dir    = MakeTestDirectory("truncated");
+    fs::path cache  = dir / "cache";
+    fs::path source = dir / "shader.comp";
+    WriteFile(source, "#version 460\nlayout(local_size_x = 4) in;\nvoid main() {}\n");
+    core::ShaderCompileRequest request{.SourceFilePath = osi::Utf8Path(osi::ToUtf8Path(source))};
+
+    uintmax_t size = 0;
+    {
+        core::ShaderManager manager(nullptr);
+        manager.SetBackend(core::EShaderCompilerBackend::Glslc);
+        manager.SetCacheDirectory(osi::Utf8Path(osi::ToUtf8Path(cache)));
+        manager.CompileShaders({request});
+        std::vector<fs::path> files = ListFiles(cache, ".spv");
+        FORAY_CHECK(files.size() == 1);
+        size = fs::file_size(files.front());
+        fs::resize_file(files.front(), size / 2);
+    }
+
+    core::ShaderManager manager(nullptr);
+    manager.SetBackend(core::EShaderCompilerBackend::Glslc);
+    manager.SetCacheDirectory(osi::Utf8Path(osi::ToUtf8Path(cache)));
+    std::vector<core::ShaderCompileResult> results;
+    manager.CompileShaders({request}, nullptr, &results);
+    FORAY_CHECK(results.size() == 1 && results[0].Success);
+    std::vector<fs::path> files = ListFiles(cache, ".spv");
+    FORAY_CHECK(files.size() == 1 && fs::file_size(files.front()) == size);
+    FORAY_CHECK(ListFiles(cache, ".tmp").empty());
+}
+
+/// @brief Reads the only spirv file of a cache directory
+std::vector<uint32_t> ReadCachedSpirv(const fs::path& cacheDir)
+{
+    std::vector<uint32_t> spirv;
+    int32_t               count = 0;
+    for(const fs::directory_entry& entry : fs::directory_iterator(cacheDir))
+    {
+        if(entry.path().extension() != ".spv")
+        {
+            continue;
+        }
+        count++;
+        std::ifstream file(entry.path(), std::ios::binary);
+        spirv.resize(fs::file_size(entry.path()) / sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(spirv.data()), spirv.size() * sizeof(uint32_t));
+    }
+    FORAY_CHECK(count == 1);
+    return spirv;
+}
+
+/// @brief Spirv instructions without debug information (names, source strings, line info), which differs between the compiler frontends
+std::vector<uint32_t> StripDebugInstructions(const std::vector<uint32_t>& spirv)
+{
+    const size_t headerSize = 5;
+    if(spirv.size() < headerSize)
+    {
+        return {};
+    }
+    std::vector<uint32_t> stripped(spirv.begin(), spirv.begin() + headerSize);
+    for(size_t offset = headerSize; offset < spirv.size();)
+    {
+        uint32_t wordCount = spirv[offset] >> 16;
+        uint32_t opcode    = spirv[offset] & 0xFFFF;
+        if(wordCount == 0 || offset + wordCount > spirv.size())
+        {
+            FORAY_CHECK(false && "Malformed spirv");
+            return {};
+        }
+        // OpSourceContinued, OpSource, OpSourceExtension, OpName, OpMemberName, OpString, OpLine, OpNoLine, OpModuleProcessed
+        bool debug = (opcode >= 2 && opcode <= 8) || opcode == 317 || opcode == 330;
+        if(!debug)
+        {
+            stripped.insert(stripped.end(), spirv.begin() + offset, spirv.begin() + offset + wordCount);
+        }
+        offset += wordCount;
+    }
+    return stripped;
+}
+
+/// @brief The in process shaderc backend produces the same spirv and tracks the same includes as the glslc backend
+void TestBackendsMatch()
+{
+#ifdef FORAY_SHADERC
+    fs::path dir = MakeTestDirectory("backends");
+    fs::create_directories(dir / "include");
+    WriteFile(dir / "include" / "common.glsl", "#include \"nested.glsl\"\nfloat Scale(float v) { return v * SCALE; }\n");
+    WriteFile(dir / "include" / "nested.glsl", "const float SCALE = 2.0;\n");
+    WriteFile(dir / "local.glsl", "float Offset(float v) { return v + OFFSET; }\n");
+    WriteFile(dir / "shader.comp", "#version 460\n"
+                                   "#extension GL_GOOGLE_include_directive : enable\n"
+                                   "#include \"common.glsl\"\n"
+                                   "#include \"local.glsl\"\n"
+                                   "layout(local_size_x = 8) in;\n"
+                                   "layout(set = 0, binding = 0) buffer Data { float Values[]; };\n"
+                                   "void main() { Values[gl_GlobalInvocationID.x] = Offset(Scale(Values[gl_GlobalInvocationID.x])); }\n");
+
+    core::ShaderCompilerConfig config{.IncludeDirs = {osi::Utf8Path(osi::ToUtf8Path(dir / "include"))}, .Definitions = {"OFFSET=1.0", "UNUSED"}};
+    osi::Utf8Path              source(osi::ToUtf8Path(dir / "shader.comp"));
+
+    core::ShaderManager glslc(nullptr);
+    glslc.SetBackend(core::EShaderCompilerBackend::Glslc);
+    glslc.SetCacheDirectory(osi::Utf8Path(osi::ToUtf8Path(dir / "glslc")));
+    core::ShaderManager shaderc(nullptr);
+    shaderc.SetBackend(core::EShaderCompilerBackend::Shaderc);
+    shaderc.SetCacheDirectory(osi::Utf8Path(osi::ToUtf8Path(dir / "shaderc")));
+
+    std::vector<core::ShaderCompileResult> glslcResults;
+    std::vector<core::ShaderCompileResult> shadercResults;
+    uint64_t glslcKey   = glslc.CompileShaders({core::ShaderCompileRequest{.SourceFilePath = source, .Config = config}}, nullptr, &glslcResults).front();
+    uint64_t shadercKey = shaderc.CompileShaders({core::ShaderCompileRequest{.SourceFilePath = source, .Config = config}}, nullptr, &shadercResults).front();
+    FORAY_CHECK(glslcResults.size() == 1 && glslcResults[0].Success);
+    FORAY_CHECK(shadercResults.size() == 1 && shadercResults[0].Success);
+
+    std::vector<uint32_t> glslcSpirv   = ReadCachedSpirv(dir / "glslc");
+    std::vector<uint32_t> shadercSpirv = ReadCachedSpirv(dir / "shaderc");
+    FORAY_CHECK(glslcSpirv.size() > 5 && glslcSpirv[0] == 0x07230203);
+    FORAY_CHECK(StripDebugInstructions(glslcSpirv) == StripDebugInstructions(shadercSpirv));
+
+    // Both track every include, including the nested one resolved via the include directory
+    for(const fs::path& include : {dir / "include" / "nested.glsl", dir / "include" / "common.glsl", dir / "local.glsl"})
+    {
+        std::ifstream     file(include, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        file.close();
+        WriteFile(include, content.str() + "const float UNUSED_" + include.stem().string() + " = 0.0;\n");
+        Touch(include);
+
+        std::unordered_set<uint64_t> glslcRecompiled;
+        std::unordered_set<uint64_t> shadercRecompiled;
+        glslc.CheckAndUpdateShaders(glslcRecompiled);
+        shaderc.CheckAndUpdateShaders(shadercRecompiled);
+        FORAY_CHECK(glslcRecompiled.count(glslcKey) == 1);
+        FORAY_CHECK(shadercRecompiled.count(shadercKey) == 1);
+    }
+#endif
+}
+
+int main()
+{
+    core::ShaderManager probe(nullptr);
+    std::string         version;
+    if(!probe.CallGlslCompiler(" --version", version))
+    {
+        std::fprintf(stderr, "glslc not available, skipping\n");
+        return test::SKIPPED;
+    }
+    // Single argument overload, logging the output
+    FORAY_CHECK(probe.CallGlslCompiler(" --version"));
+
+    TestBatchCompile();
+    TestContentHashing();
+    TestTruncatedCache();
+    TestBackendsMatch();
+    return test::Result();
+}
@@ -0,0 +1,229 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/core/foray_barrierbatch.hpp"
+#include "../src/core/foray_bindlessheap.hpp"
+#include "../src/core/foray_managedimage.hpp"
+#include "../src/scene/components/foray_meshinstance.hpp"
+#include "../src/scene/components/foray_transform.hpp"
+#include "../src/scene/foray_mesh.hpp"
+#include "../src/scene/foray_node.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/globalcomponents/foray_drawmanager.hpp"
+#include "../src/scene/globalcomponents/foray_geometrymanager.hpp"
+#include "../src/scene/globalcomponents/foray_materialmanager.hpp"
+#include "../src/stages/foray_comparerstage.hpp"
+#include "../src/stages/foray_denoiserstage.hpp"
+#include "../src/stages/foray_gbuffer.hpp"
+#include "foray_testcompute.hpp"
+#include "foray_testdevice.hpp"
+
+using namespace foray;
+
+/// @brief Counts pipeline barrier commands and the barriers they contain, recorded through the dispatch table
+struct BarrierCounts
+{
+    uint32_t Commands       = 0;
+    uint32_t Images         = 0;
+    uint32_t Buffers        = 0;
+    uint32_t Memory         = 0;
+    uint32_t LegacyCommands = 0;
+};
+BarrierCounts             gCounts;
+PFN_vkCmdPipelineBarrier2 gCmdPipelineBarrier2 = nullptr;
+PFN_vkCmdPipelineBarrier  gCmdPipelineBarrier  = nullptr;
+
+VKAPI_ATTR void VKAPI_CALL CountingCmdPipelineBarrier2(VkCommandBuffer cmdBuffer, const VkDependencyInfo* pDependencyInfo)
+{
+    gCounts.Commands++;
+    gCounts.Images += pDependencyInfo->imageMemoryBarrierCount;
+    gCounts.Buffers += pDependencyInfo->bufferMemoryBarrierCount;
+    gCounts.Memory += pDependencyInfo->memoryBarrierCount;
+    gCmdPipelineBarrier2(cmdBuffer, pDependencyInfo);
+}
+
+VKAPI_ATTR void VKAPI_CALL CountingCmdPipelineBarrier(VkCommandBuffer              cmdBuffer,
+                                                      VkPipelineStageFlags         srcStageMask,
+                                                      VkPipelineStageFlags         dstStageMask,
+                                                      VkDependencyFlags            dependencyFlags,
+                                                      uint32_t                     memoryBarrierCount,
+                                                      const VkMemoryBarrier*       pMemoryBarriers,
+                                                      uint32_t                     bufferMemoryBarrierCount,
+                                                      const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+                                                      uint32_t                     imageMemoryBarrierCount,
+                                                      const VkImageMemoryBarrier*  pImageMemoryBarriers)
+{
+    gCounts.LegacyCommands++;
+    gCmdPipelineBarrier(cmdBuffer, srcStageMask, dstStageMask, dependencyFlags, memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount, pBufferMemoryBarriers,
+                        imageMemoryBarrierCount, pImageMemoryBarriers);
+}
+
+/// @brief Exposes the config barrier helper
+class TestDenoiser : public stages::DenoiserStage
+{
+  public:
+    using DenoiserStage::AddConfigBarriers;
+};
+
+const VkExtent2D EXTENT{64, 64};
+
+/// @brief Scene of a single unit quad instance with one material
+void BuildScene(scene::Scene& scene)
+{
+    auto geo = scene.GetComponent<scene::gcomp::GeometryStore>();
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        scene::Vertex vertex{};
+        vertex.Pos = glm::vec3((fp32_t)(i % 2), (fp32_t)(i / 2), 0.f);
+        geo->GetVertices().push_back(vertex);
+    }
+    for(uint32_t index : {0U, 1U, 3U, 0U, 3U, 2U})
+    {
+        geo->GetIndices().push_back(index);
+    }
+    auto mesh = std::make_unique<scene::Mesh>();
+    mesh->SetPrimitives({scene::Primitive(scene::Primitive::EType::Index, 0U, 6U, 0, 3, geo->GetVertices(), {})});
+    scene.MakeNode()->MakeComponent<scene::ncomp::MeshInstance>()->SetMesh(mesh.get());
+    geo->GetMeshes().push_back(std::move(mesh));
+    geo->InitOrUpdate();
+
+    scene.GetComponent<scene::gcomp::MaterialManager>()->UpdateDeviceLocal();
+    scene.GetComponent<scene::gcomp::DrawDirector>()->InitOrUpdate();
+}
+
+/// @brief Records stage via RecordFrame(), returns the barriers recorded
+template <typename TStage>
+BarrierCounts Record(core::Context* context, TStage& stage, base::FrameRenderInfo& renderInfo)
+{
+    gCounts = BarrierCounts();
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) { stage.RecordFrame(cmdBuffer, renderInfo); });
+    return gCounts;
+}
+
+/// @brief All attachment transitions (7 color + depth) and the material, camera and transform buffer barriers are recorded in a single command, every frame
+void TestGBuffer(core::Context* context, stages::GBufferStage& gbuffer, base::FrameRenderInfo& renderInfo)
+{
+    for(uint32_t frame = 0; frame < 2; frame++)
+    {
+        renderInfo.SetFrameNumber(frame);
+        BarrierCounts counts = Record(context, gbuffer, renderInfo);
+        FORAY_CHECK(counts.Commands == 1);
+        FORAY_CHECK(counts.Images == 8);
+        FORAY_CHECK(counts.Buffers == 3);
+        FORAY_CHECK(counts.Memory == 0);
+        FORAY_CHECK(counts.LegacyCommands == 0);
+    }
+
+    const core::ImageLayoutCache& layouts = renderInfo.GetImageLayoutCache();
+    FORAY_CHECK(layouts.Get(gbuffer.GetImageEOutput(stages::GBufferStage::EOutput::Albedo)) == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    FORAY_CHECK(layouts.Get(gbuffer.GetImageEOutput(stages::GBufferStage::EOutput::Depth)) == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+}
+
+/// @brief Input and output transitions of both substages are recorded in a single command. An input shared by both substages is transitioned once
+void TestComparer(core::Context* context, stages::GBufferStage& gbuffer, base::FrameRenderInfo& renderInfo)
+{
+    core::ManagedImage* albedo = gbuffer.GetImageEOutput(stages::GBufferStage::EOutput::Albedo);
+    core::ManagedImage* normal = gbuffer.GetImageEOutput(stages::GBufferStage::EOutput::Normal);
+
+    stages::ComparerStage comparer;
+    comparer.Init(context, false);
+    comparer.SetInput(0, stages::ComparerStage::InputInfo{.Image = albedo});
+    comparer.SetInput(1, stages::ComparerStage::InputInfo{.Image = normal});
+
+    BarrierCounts counts = Record(context, comparer, renderInfo);
+    FORAY_CHECK(counts.Commands == 1);
+    FORAY_CHECK(counts.Images == 3);
+    FORAY_CHECK(counts.Buffers == 0 && counts.Memory == 0);
+    FORAY_CHECK(counts.LegacyCommands == 0);
+
+    const core::ImageLayoutCache& layouts = renderInfo.GetImageLayoutCache();
+    FORAY_CHECK(layouts.Get(albedo) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    FORAY_CHECK(layouts.Get(normal) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    FORAY_CHECK(layouts.Get(comparer.GetImageOutput(stages::ComparerStage::OutputName)) == VK_IMAGE_LAYOUT_GENERAL);
+
+    comparer.SetInput(1, stages::ComparerStage::InputInfo{.Image = albedo});
+    counts = Record(context, comparer, renderInfo);
+    FORAY_CHECK(counts.Commands == 1);
+    FORAY_CHECK(counts.Images == 2);
+
+    comparer.Destroy();
+}
+
+/// @brief AddConfigBarriers() transitions primary input, all GBuffer outputs and the primary output, recorded in a single command
+void TestDenoiserConfig(core::Context* context, stages::GBufferStage& gbuffer, base::FrameRenderInfo& renderInfo)
+{
+    core::ManagedImage input;
+    core::ManagedImage output;
+    input.Create(context, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_FORMAT_R32G32B32A32_SFLOAT, EXTENT, "Denoiser Input");
+    output.Create(context, VK_IMAGE_USAGE_STORAGE_BIT, VK_FORMAT_R32G32B32A32_SFLOAT, EXTENT, "Denoiser Output");
+    stages::DenoiserConfig config(&input, &output, &gbuffer);
+
+    gCounts = BarrierCounts();
+    uint32_t flushed = 0;
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) {
+        core::BarrierBatch barriers(renderInfo.GetImageLayoutCache());
+        TestDenoiser::AddConfigBarriers(config, barriers, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+        flushed = barriers.CmdFlush(context, cmdBuffer);
+    });
+    FORAY_CHECK(flushed == 10);
+    FORAY_CHECK(gCounts.Commands == 1);
+    FORAY_CHECK(gCounts.Images == 10);
+
+    const core::ImageLayoutCache& layouts = renderInfo.GetImageLayoutCache();
+    FORAY_CHECK(layouts.Get(input) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    FORAY_CHECK(layouts.Get(gbuffer.GetImageEOutput(stages::GBufferStage::EOutput::Depth)) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    FORAY_CHECK(layouts.Get(output) == VK_IMAGE_LAYOUT_GENERAL);
+
+    input.Destroy();
+    output.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create(false))
+    {
+        return test::SKIPPED;
+    }
+    const VkPhysicalDeviceVulkan12Features& features = device.GetVulkan12Features();
+    if(features.descriptorBindingPartiallyBound != VK_TRUE || features.descriptorBindingSampledImageUpdateAfterBind != VK_TRUE
+       || features.descriptorBindingStorageBufferUpdateAfterBind != VK_TRUE || features.descriptorBindingUpdateUnusedWhilePending != VK_TRUE)
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context = device.GetContext();
+    // Stages size their outputs to the swapchain
+    vkb::Swapchain swapchain;
+    swapchain.extent  = EXTENT;
+    context.Swapchain = &swapchain;
+
+    gCmdPipelineBarrier2                               = context.VkbDispatchTable->fp_vkCmdPipelineBarrier2;
+    gCmdPipelineBarrier                                = context.VkbDispatchTable->fp_vkCmdPipelineBarrier;
+    context.VkbDispatchTable->fp_vkCmdPipelineBarrier2 = &CountingCmdPipelineBarrier2;
+    context.VkbDispatchTable->fp_vkCmdPipelineBarrier  = &CountingCmdPipelineBarrier;
+
+    // The GBuffer samples textures through the bindless heap
+    core::BindlessHeap heap;
+    heap.Create(&context, 64, 16);
+    context.Bindless = &heap;
+
+    {
+        scene::Scene scene(&context);
+        BuildScene(scene);
+        stages::GBufferStage gbuffer;
+        gbuffer.Init(&context, &scene);
+
+        base::FrameRenderInfo renderInfo;
+        TestGBuffer(&context, gbuffer, renderInfo);
+        TestComparer(&context, gbuffer, renderInfo);
+        TestDenoiserConfig(&context, gbuffer, renderInfo);
+
+        gbuffer.Destroy();
+    }
+    context.Bindless = nullptr;
+    heap.Destroy();
+
+    context.VkbDispatchTable->fp_vkCmdPipelineBarrier2 = gCmdPipelineBarrier2;
+    context.VkbDispatchTable->fp_vkCmdPipelineBarrier  = gCmdPipelineBarrier;
+    context.Swapchain                                  = nullptr;
+    device.Destroy();
+    return test::Result();
+}
@@ -0,0 +1,139 @@
+#include "../src/core/foray_stagingring.hpp"
+#include "foray_testcompute.hpp"
+#include "foray_testdevice.hpp"
+#include <cstring>
+
+using namespace foray;
+
+/// @brief Counts vkQueueSubmit2 calls made through the dispatch table
+uint32_t           gSubmits      = 0;
+PFN_vkQueueSubmit2 gQueueSubmit2 = nullptr;
+
+VKAPI_ATTR VkResult VKAPI_CALL CountingQueueSubmit2(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence fence)
+{
+    gSubmits++;
+    return gQueueSubmit2(queue, submitCount, pSubmits, fence);
+}
+
+/// @brief Deterministic pseudo random numbers (LCG)
+uint32_t NextRandom(uint32_t& state)
+{
+    state = state * 1664525U + 1013904223U;
+    return state >> 8;
+}
+
+/// @brief Copies buffer into host memory
+std::vector<uint8_t> ReadBack(core::Context* context, const core::ManagedBuffer& buffer, VkDeviceSize size)
+{
+    core::ManagedBuffer readback;
+    readback.Create(context, VK_BUFFER_USAGE_TRANSFER_DST_BIT, size, VMA_MEMORY_USAGE_AUTO_PREFER_HOST, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) {
+        VkBufferCopy copy{.srcOffset = 0, .dstOffset = 0, .size = size};
+        vkCmdCopyBuffer(cmdBuffer, buffer.GetBuffer(), readback.GetBuffer(), 1U, &copy);
+    });
+    std::vector<uint8_t> result(size);
+    void*                mapped = nullptr;
+    readback.Map(mapped);
+    vmaInvalidateAllocation(context->Allocator, readback.GetAllocation(), 0, VK_WHOLE_SIZE);
+    memcpy(result.data(), mapped, size);
+    readback.Unmap();
+    return result;
+}
+
+/// @brief 10k uploads of 4 B to 2 KiB through a 256 KiB ring: The ring wraps and retires batches many times, every 97th upload overwrites an earlier range,
+/// and one upload exceeds the ring capacity. The device buffer must match the host reference, uploads must be batched into few submissions.
+void TestUploads(core::Context* context, bool transferQueue)
+{
+    const uint32_t     uploadCount  = 10000;
+    const VkDeviceSize ringCapacity = 256ULL * 1024ULL;
+    const VkDeviceSize bufferSize   = 16ULL * 1024ULL * 1024ULL;
+
+    core::ManagedBuffer dstBuffer;
+    dstBuffer.Create(context, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, bufferSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, {}, "Upload Target");
+    std::vector<uint8_t> reference(bufferSize, 0);
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) { vkCmdFillBuffer(cmdBuffer, dstBuffer.GetBuffer(), 0, VK_WHOLE_SIZE, 0U); });
+
+    core::StagingRing ring;
+    ring.Create(context, ringCapacity);
+    FORAY_CHECK(ring.GetUseTransferQueue() == transferQueue);
+
+    gSubmits                 = 0;
+    uint32_t             rng = 1234U;
+    VkDeviceSize         end = 0;
+    std::vector<uint8_t> data;
+    core::UploadTicket   firstTicket;
+    for(uint32_t i = 0; i < uploadCount; i++)
+    {
+        VkDeviceSize size   = 4 * (1 + NextRandom(rng) % 512);
+        VkDeviceSize offset = end;
+        if(i % 97 == 96)
+        {
+            // Overwrite part of what was written before, the later write must win
+            offset = 4 * (NextRandom(rng) % (end / 4 - size / 4));
+        }
+        else
+        {
+            end += size;
+        }
+        data.resize(size);
+        for(uint8_t& byte : data)
+        {
+            byte = (uint8_t)NextRandom(rng);
+        }
+        memcpy(reference.data() + offset, data.data(), size);
+        core::UploadTicket ticket = ring.Upload(dstBuffer.GetBuffer(), offset, data.data(), size);
+        FORAY_CHECK(ticket.TimelineValue > 0);
+        if(i == 0)
+        {
+            firstTicket = ticket;
+        }
+        if(i % 100 == 99)
+        {
+            ring.Flush();
+        }
+        FORAY_CHECK(ring.GetInUse() <= ringCapacity);
+    }
+
+    // Larger than the ring: Blocking fallback, ordered after everything queued before
+    data.assign(ringCapacity * 2, 0xAB);
+    memcpy(reference.data(), data.data(), data.size());
+    FORAY_CHECK(ring.Upload(dstBuffer.GetBuffer(), 0, data.data(), data.size()).TimelineValue == 0);
+
+    ring.WaitIdle();
+    FORAY_CHECK(ring.HasCompleted(firstTicket));
+    FORAY_CHECK(ring.GetInUse() == 0);
+    // One submission per Flush() (two with ownership transfers), plus ring-full flushes. Never one per upload
+    uint32_t submitsPerBatch = transferQueue ? 2 : 1;
+    FORAY_CHECK(gSubmits >= submitsPerBatch * uploadCount / 100);
+    FORAY_CHECK(gSubmits < submitsPerBatch * uploadCount / 10);
+
+    FORAY_CHECK(ReadBack(context, dstBuffer, bufferSize) == reference);
+    ring.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create())
+    {
+        return test::SKIPPED;
+    }
+    if(device.GetVulkan12Features().timelineSemaphore != VK_TRUE)
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context                      = device.GetContext();
+    gQueueSubmit2                               = context.VkbDispatchTable->fp_vkQueueSubmit2;
+    context.VkbDispatchTable->fp_vkQueueSubmit2 = &CountingQueueSubmit2;
+
+    TestUploads(&context, false);
+    // Copies on the transfer queue with ownership transfers, if the device has a second queue family supporting transfers (lavapipe does not)
+    if(device.SelectTransferQueue())
+    {
+        TestUploads(&context, true);
+    }
+
+    context.VkbDispatchTable->fp_vkQueueSubmit2 = gQueueSubmit2;
+    device.Destroy();
+    return test::Result();
+}
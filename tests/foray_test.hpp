@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdio>
+
+namespace foray::test {
+    /// @brief Exit code reported to CTest for tests which can not run in the current environment (e.g. no Vulkan device)
+    inline static constexpr int SKIPPED = 77;
+
+    /// @brief Number of failed checks in the current test executable
+    inline int& FailureCount()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    /// @brief Prints and counts a failed check. Use via FORAY_CHECK
+    inline void Check(bool condition, const char* expression, const char* file, int line)
+    {
+        if(!condition)
+        {
+            std::fprintf(stderr, "%s:%d: Check failed: %s\n", file, line, expression);
+            FailureCount()++;
+        }
+    }
+
+    /// @brief Exit code of the test executable. Non-zero if any check failed
+    inline int Result()
+    {
+        if(FailureCount() > 0)
+        {
+            std::fprintf(stderr, "%d check(s) failed\n", FailureCount());
+            return 1;
+        }
+        return 0;
+    }
+}  // namespace foray::test
+
+/// @brief Checks condition, continues the test on failure
+#define FORAY_CHECK(condition) ::foray::test::Check(!!(condition), #condition, __FILE__, __LINE__)
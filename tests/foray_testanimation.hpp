@@ -0,0 +1,85 @@
+#pragma once
+#include "../src/scene/components/foray_transform.hpp"
+#include "../src/scene/foray_animation.hpp"
+#include "../src/scene/foray_node.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/globalcomponents/foray_animationmanager.hpp"
+#include <algorithm>
+#include <random>
+
+namespace foray::test {
+    /// @brief Adds characterCount skeletons of boneCount nodes to scene, each animated by one animation with a translation, rotation and scale channel per bone
+    /// @details Keyframes, interpolation modes and playback speeds are random but deterministic for a given seed, so identical scenes can be built repeatedly
+    inline scene::gcomp::AnimationManager* MakeAnimatedCharacters(scene::Scene& scene, uint32_t characterCount, uint32_t boneCount, uint32_t seed)
+    {
+        scene::gcomp::AnimationManager* manager = scene.GetComponent<scene::gcomp::AnimationManager>();
+        if(!manager)
+        {
+            manager = scene.MakeComponent<scene::gcomp::AnimationManager>();
+        }
+
+        const uint32_t                        keyframeCount = 32;
+        std::mt19937                          rng(seed);
+        std::uniform_real_distribution<float> unit(-1.f, 1.f);
+        std::uniform_real_distribution<float> step(0.02f, 0.1f);
+
+        for(uint32_t character = 0; character < characterCount; character++)
+        {
+            scene::Animation animation;
+            animation.SetName("Character");
+            std::vector<scene::Node*> bones;
+            for(uint32_t bone = 0; bone < boneCount; bone++)
+            {
+                scene::Node* parent = bones.empty() ? nullptr : bones[rng() % bones.size()];
+                bones.push_back(scene.MakeNode(parent));
+
+                for(scene::EAnimationTargetPath path :
+                    {scene::EAnimationTargetPath::Translation, scene::EAnimationTargetPath::Rotation, scene::EAnimationTargetPath::Scale})
+                {
+                    scene::AnimationSampler sampler;
+                    uint32_t                mode = rng() % 3;
+                    sampler.Interpolation        = mode == 0 ? scene::EAnimationInterpolation::Step : scene::EAnimationInterpolation::Linear;
+                    if(mode == 2 && path != scene::EAnimationTargetPath::Rotation)
+                    {
+                        sampler.Interpolation = scene::EAnimationInterpolation::Cubicspline;
+                    }
+                    float time = 0.f;
+                    for(uint32_t i = 0; i < keyframeCount; i++)
+                    {
+                        glm::vec4 value(unit(rng), unit(rng), unit(rng), unit(rng));
+                        if(path == scene::EAnimationTargetPath::Rotation)
+                        {
+                            value = glm::normalize(value + glm::vec4(0.f, 0.f, 0.f, 2.f));
+                        }
+                        else if(path == scene::EAnimationTargetPath::Scale)
+                        {
+                            value = glm::vec4(1.f) + 0.5f * value;
+                        }
+                        glm::vec4 inTangent(unit(rng), unit(rng), unit(rng), 0.f);
+                        glm::vec4 outTangent(unit(rng), unit(rng), unit(rng), 0.f);
+                        sampler.Keyframes.push_back(scene::AnimationKeyframe(time, value, inTangent, outTangent));
+                        time += step(rng);
+                    }
+                    animation.GetSamplers().push_back(sampler);
+
+                    scene::AnimationChannel channel;
+                    channel.SamplerIndex = (int32_t)animation.GetSamplers().size() - 1;
+                    channel.Target       = bones.back();
+                    channel.TargetPath   = path;
+                    animation.GetChannels().push_back(channel);
+                }
+            }
+
+            float end = 0.f;
+            for(const scene::AnimationSampler& sampler : animation.GetSamplers())
+            {
+                end = std::max(end, sampler.Keyframes.back().Time);
+            }
+            animation.SetStart(0.f);
+            animation.SetEnd(end);
+            animation.GetPlaybackConfig().PlaybackSpeed = 0.5f + (float)(rng() % 100) / 50.f;
+            manager->GetAnimations().push_back(animation);
+        }
+        return manager;
+    }
+}  // namespace foray::test
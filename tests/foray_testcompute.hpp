@@ -0,0 +1,116 @@
+#pragma once
+#include "../src/core/foray_commandbuffer.hpp"
+#include "../src/core/foray_descriptorset.hpp"
+#include "../src/core/foray_shadermanager.hpp"
+#include "../src/core/foray_shadermodule.hpp"
+#include "../src/util/foray_pipelinelayout.hpp"
+#include "foray_test.hpp"
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+namespace foray::test {
+    /// @brief Records commands via record, submits them to the contexts queue and waits for completion
+    inline void SubmitAndWait(core::Context* context, const std::function<void(VkCommandBuffer)>& record)
+    {
+        core::HostSyncCommandBuffer cmdBuffer;
+        cmdBuffer.Create(context);
+        cmdBuffer.Begin();
+        record(cmdBuffer);
+        cmdBuffer.SubmitAndWait();
+    }
+
+    /// @brief Writes source to a temporary file named fileName (the extension selects the shader stage) and compiles it with the ShaderManager glslc backend
+    /// @return False, if the shader failed to compile (e.g. glslc is missing), in which case the test should return test::SKIPPED
+    inline bool CompileTestShader(core::Context* context, core::ShaderManager& shaderManager, std::string_view fileName, std::string_view source, core::ShaderModule& out_shader)
+    {
+        namespace fs = std::filesystem;
+
+        fs::path dir = fs::temp_directory_path() / "foray_testcompute";
+        fs::create_directories(dir);
+        fs::path path = dir / fileName;
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << source;
+        }
+
+        shaderManager.SetBackend(core::EShaderCompilerBackend::Glslc);
+        shaderManager.SetCacheDirectory(osi::Utf8Path(osi::ToUtf8Path(dir / "cache")));
+        std::vector<core::ShaderCompileResult> results;
+        shaderManager.CompileShaders({core::ShaderCompileRequest{.SourceFilePath = osi::Utf8Path(osi::ToUtf8Path(path))}}, context, &results);
+        if(!results.front().Success)
+        {
+            std::fprintf(stderr, "%s\n", results.front().CompilerOutput.c_str());
+            return false;
+        }
+        shaderManager.CompileShader(osi::Utf8Path(osi::ToUtf8Path(path)), out_shader, {}, context);
+        return true;
+    }
+
+    /// @brief Compute pipeline compiled at runtime from GLSL source, using a single descriptor set and optional push constants
+    class TestComputePipeline
+    {
+      public:
+        /// @brief Compiles source (ShaderManager, glslc backend) and creates the pipeline. set must have been created.
+        /// @return False, if the shader failed to compile (e.g. glslc is missing), in which case the test should return test::SKIPPED
+        inline bool Create(core::Context* context, std::string_view name, std::string_view source, const core::DescriptorSet& set, uint32_t pushConstantSize = 0);
+        /// @brief Binds pipeline and set, pushes pushConstants (if any) and dispatches
+        inline void CmdDispatch(VkCommandBuffer cmdBuffer, const core::DescriptorSet& set, uint32_t groupsX, uint32_t groupsY = 1, const void* pushConstants = nullptr);
+        inline void Destroy();
+        inline ~TestComputePipeline() { Destroy(); }
+
+      protected:
+        core::Context*       mContext = nullptr;
+        core::ShaderManager  mShaderManager{nullptr};
+        core::ShaderModule   mShader;
+        util::PipelineLayout mPipelineLayout;
+        VkPipeline           mPipeline         = nullptr;
+        uint32_t             mPushConstantSize = 0;
+    };
+
+    bool TestComputePipeline::Create(core::Context* context, std::string_view name, std::string_view source, const core::DescriptorSet& set, uint32_t pushConstantSize)
+    {
+        mContext = context;
+        if(!CompileTestShader(context, mShaderManager, std::string(name) + ".comp", source, mShader))
+        {
+            return false;
+        }
+
+        mPushConstantSize = pushConstantSize;
+        mPipelineLayout.AddDescriptorSetLayout(set);
+        if(pushConstantSize > 0)
+        {
+            mPipelineLayout.AddPushConstantRange(VkPushConstantRange{.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0U, .size = pushConstantSize});
+        }
+        mPipelineLayout.Build(context);
+
+        VkComputePipelineCreateInfo pipelineCi{.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                                               .flags  = mPipelineLayout.GetPipelineCreateFlags(),
+                                               .stage  = mShader.GetShaderStageCi(VK_SHADER_STAGE_COMPUTE_BIT),
+                                               .layout = mPipelineLayout};
+        AssertVkResult(context->VkbDispatchTable->createComputePipelines(context->PipelineCache, 1U, &pipelineCi, nullptr, &mPipeline));
+        return true;
+    }
+
+    void TestComputePipeline::CmdDispatch(VkCommandBuffer cmdBuffer, const core::DescriptorSet& set, uint32_t groupsX, uint32_t groupsY, const void* pushConstants)
+    {
+        mContext->VkbDispatchTable->cmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipeline);
+        set.CmdBind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout);
+        if(mPushConstantSize > 0)
+        {
+            mContext->VkbDispatchTable->cmdPushConstants(cmdBuffer, mPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0U, mPushConstantSize, pushConstants);
+        }
+        mContext->VkbDispatchTable->cmdDispatch(cmdBuffer, groupsX, groupsY, 1U);
+    }
+
+    void TestComputePipeline::Destroy()
+    {
+        if(!!mPipeline)
+        {
+            mContext->VkbDispatchTable->destroyPipeline(mPipeline, nullptr);
+            mPipeline = nullptr;
+        }
+        mPipelineLayout.Destroy();
+        mShader.Destroy();
+    }
+}  // namespace foray::test
@@ -0,0 +1,233 @@
+#pragma once
+#include "../src/core/foray_context.hpp"
+#include "foray_test.hpp"
+#include <string>
+
+namespace foray::test {
+    /// @brief Headless Vulkan 1.3 device for tests requiring a device (hardware or e.g. lavapipe)
+    /// @details Every Vulkan 1.0 - 1.3 feature the device supports is enabled and published via Context::Enabled...Features. VK_EXT_descriptor_buffer and VK_KHR_acceleration_structure are enabled if present and requested.
+    /// Fills the context with instance, device, dispatch table, main queue, command pool and allocator
+    class TestDevice
+    {
+      public:
+        /// @brief Creates the device. Returns false if no Vulkan 1.3 device is available, in which case the test should return test::SKIPPED
+        inline bool Create(bool enableDescriptorBuffer = true, bool enableAccelerationStructure = false);
+        /// @brief Fills Context::TransferQueue, TransferQueueFamilyIndex and TransferCommandPool with a queue of a family other than the main one, as VulkanDevice::SelectQueues() does
+        /// @return False, if the device has no such queue family (e.g. lavapipe). The transfer fields stay unset then
+        inline bool SelectTransferQueue();
+        inline void Destroy();
+        inline ~TestDevice() { Destroy(); }
+
+        inline core::Context& GetContext() { return mContext; }
+        /// @brief True, if VK_EXT_descriptor_buffer is enabled and its properties are published via Context::DescriptorBufferProperties
+        inline bool HasDescriptorBuffer() const { return mHasDescriptorBuffer; }
+        /// @brief True, if VK_KHR_acceleration_structure is enabled (Blas / Tlas building)
+        inline bool HasAccelerationStructure() const { return mHasAccelerationStructure; }
+        /// @brief True, if VK_KHR_ray_query is enabled in addition to acceleration structures (tracing rays from compute shaders)
+        inline bool HasRayQuery() const { return mHasRayQuery; }
+        inline const VkPhysicalDeviceVulkan11Features& GetVulkan11Features() const { return mVulkan11Features; }
+        inline const VkPhysicalDeviceVulkan12Features& GetVulkan12Features() const { return mVulkan12Features; }
+
+      protected:
+        core::Context       mContext;
+        vkb::Instance       mInstance;
+        vkb::PhysicalDevice mPhysicalDevice;
+        vkb::Device         mDevice;
+        vkb::DispatchTable  mDispatchTable;
+        bool                mHasDescriptorBuffer      = false;
+        bool                mHasAccelerationStructure = false;
+        bool                mHasRayQuery              = false;
+
+        VkPhysicalDeviceVulkan11Features                 mVulkan11Features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
+        VkPhysicalDeviceVulkan12Features                 mVulkan12Features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+        VkPhysicalDeviceVulkan13Features                 mVulkan13Features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+        VkPhysicalDeviceAccelerationStructureFeaturesKHR mAccelerationStructureFeatures{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR};
+        VkPhysicalDeviceRayQueryFeaturesKHR              mRayQueryFeatures{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR};
+#ifdef VK_EXT_descriptor_buffer
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT   mDescriptorBufferFeatures{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT};
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT mDescriptorBufferProperties{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+#endif
+    };
+
+    bool TestDevice::Create(bool enableDescriptorBuffer, bool enableAccelerationStructure)
+    {
+        vkb::InstanceBuilder instanceBuilder;
+        instanceBuilder.set_headless().require_api_version(VK_MAKE_API_VERSION(0, 1, 3, 0));
+        auto systemInfo = vkb::SystemInfo::get_system_info();
+        if(systemInfo.has_value() && systemInfo->is_extension_available(VK_EXT_DEBUG_UTILS_EXTENSION_NAME))
+        {
+            // Resources name their vulkan objects
+            instanceBuilder.enable_extension(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+        auto instanceRet = instanceBuilder.build();
+        if(!instanceRet)
+        {
+            return false;
+        }
+        mInstance            = *instanceRet;
+        mContext.VkbInstance = &mInstance;
+
+        vkb::PhysicalDeviceSelector selector(mInstance);
+        selector.defer_surface_initialization().set_minimum_version(1U, 3U);
+#ifdef VK_EXT_descriptor_buffer
+        if(enableDescriptorBuffer)
+        {
+            selector.add_desired_extension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        }
+#endif
+        if(enableAccelerationStructure)
+        {
+            selector.add_desired_extensions({VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME, VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME, VK_KHR_RAY_QUERY_EXTENSION_NAME});
+        }
+        auto physicalRet = selector.select();
+        if(!physicalRet)
+        {
+            Destroy();
+            return false;
+        }
+        mPhysicalDevice            = *physicalRet;
+        mContext.VkbPhysicalDevice = &mPhysicalDevice;
+
+        // Query supported features, then enable all of them
+        VkPhysicalDeviceFeatures2 features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &mVulkan11Features};
+        mVulkan11Features.pNext = &mVulkan12Features;
+        mVulkan12Features.pNext = &mVulkan13Features;
+#ifdef VK_EXT_descriptor_buffer
+        mVulkan13Features.pNext = &mDescriptorBufferFeatures;
+        mDescriptorBufferFeatures.pNext = &mAccelerationStructureFeatures;
+#else
+        mVulkan13Features.pNext = &mAccelerationStructureFeatures;
+#endif
+        mAccelerationStructureFeatures.pNext = &mRayQueryFeatures;
+        vkGetPhysicalDeviceFeatures2(mPhysicalDevice.physical_device, &features);
+        mPhysicalDevice.features             = features.features;
+        mVulkan11Features.pNext              = nullptr;
+        mVulkan12Features.pNext              = nullptr;
+        mVulkan13Features.pNext              = nullptr;
+        mAccelerationStructureFeatures.pNext = nullptr;
+
+        vkb::DeviceBuilder builder(mPhysicalDevice);
+        builder.add_pNext(&mVulkan11Features);
+        builder.add_pNext(&mVulkan12Features);
+        builder.add_pNext(&mVulkan13Features);
+#ifdef VK_EXT_descriptor_buffer
+        for(const std::string& extension : mPhysicalDevice.get_extensions())
+        {
+            mHasDescriptorBuffer |= extension == VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME;
+        }
+        mHasDescriptorBuffer &= enableDescriptorBuffer && mDescriptorBufferFeatures.descriptorBuffer == VK_TRUE && mVulkan12Features.bufferDeviceAddress == VK_TRUE;
+        mDescriptorBufferFeatures.pNext = nullptr;
+        if(mHasDescriptorBuffer)
+        {
+            builder.add_pNext(&mDescriptorBufferFeatures);
+            VkPhysicalDeviceProperties2 properties{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &mDescriptorBufferProperties};
+            vkGetPhysicalDeviceProperties2(mPhysicalDevice.physical_device, &properties);
+            mContext.DescriptorBufferProperties = &mDescriptorBufferProperties;
+        }
+#endif
+        bool hasAsExtension       = false;
+        bool hasRayQueryExtension = false;
+        for(const std::string& extension : mPhysicalDevice.get_extensions())
+        {
+            hasAsExtension |= extension == VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME;
+            hasRayQueryExtension |= extension == VK_KHR_RAY_QUERY_EXTENSION_NAME;
+        }
+        mHasAccelerationStructure = enableAccelerationStructure && hasAsExtension && mAccelerationStructureFeatures.accelerationStructure == VK_TRUE
+                                    && mVulkan12Features.bufferDeviceAddress == VK_TRUE;
+        if(mHasAccelerationStructure)
+        {
+            // Host commands, capture replay and indirect builds are not used
+            mAccelerationStructureFeatures = VkPhysicalDeviceAccelerationStructureFeaturesKHR{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR,
+                                                                                              .accelerationStructure = VK_TRUE};
+            builder.add_pNext(&mAccelerationStructureFeatures);
+            mHasRayQuery = hasRayQueryExtension && mRayQueryFeatures.rayQuery == VK_TRUE;
+            if(mHasRayQuery)
+            {
+                builder.add_pNext(&mRayQueryFeatures);
+            }
+        }
+        auto deviceRet = builder.build();
+        if(!deviceRet)
+        {
+            Destroy();
+            return false;
+        }
+        mDevice                          = *deviceRet;
+        mDispatchTable                   = mDevice.make_table();
+        mContext.VkbDevice               = &mDevice;
+        mContext.VkbDispatchTable        = &mDispatchTable;
+        mContext.EnabledFeatures         = &mPhysicalDevice.features;
+        mContext.EnabledVulkan11Features = &mVulkan11Features;
+        mContext.EnabledVulkan12Features = &mVulkan12Features;
+        mContext.Queue                   = mDevice.get_queue(vkb::QueueType::graphics).value();
+        mContext.QueueFamilyIndex        = mDevice.get_queue_index(vkb::QueueType::graphics).value();
+
+        VkCommandPoolCreateInfo poolCi{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, .queueFamilyIndex = mContext.QueueFamilyIndex};
+        AssertVkResult(mDispatchTable.createCommandPool(&poolCi, nullptr, &mContext.CommandPool));
+
+        VmaVulkanFunctions vulkanFunctions{.vkGetInstanceProcAddr = &vkGetInstanceProcAddr, .vkGetDeviceProcAddr = &vkGetDeviceProcAddr};
+        VmaAllocatorCreateInfo allocatorCi{.physicalDevice   = mPhysicalDevice.physical_device,
+                                           .device           = mDevice.device,
+                                           .pVulkanFunctions = &vulkanFunctions,
+                                           .instance         = mInstance.instance,
+                                           .vulkanApiVersion = VK_API_VERSION_1_2};
+        if(mVulkan12Features.bufferDeviceAddress == VK_TRUE)
+        {
+            allocatorCi.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+        }
+        AssertVkResult(vmaCreateAllocator(&allocatorCi, &mContext.Allocator));
+        return true;
+    }
+
+    bool TestDevice::SelectTransferQueue()
+    {
+        auto retIndex = mDevice.get_dedicated_queue_index(vkb::QueueType::transfer);
+        if(!retIndex)
+        {
+            retIndex = mDevice.get_queue_index(vkb::QueueType::transfer);
+        }
+        if(!retIndex || *retIndex == mContext.QueueFamilyIndex)
+        {
+            return false;
+        }
+        mDispatchTable.getDeviceQueue(*retIndex, 0, &mContext.TransferQueue);
+        mContext.TransferQueueFamilyIndex = *retIndex;
+        VkCommandPoolCreateInfo poolCi{.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, .queueFamilyIndex = *retIndex};
+        AssertVkResult(mDispatchTable.createCommandPool(&poolCi, nullptr, &mContext.TransferCommandPool));
+        return true;
+    }
+
+    void TestDevice::Destroy()
+    {
+        if(!!mContext.Allocator)
+        {
+            vmaDestroyAllocator(mContext.Allocator);
+            mContext.Allocator = nullptr;
+        }
+        if(!!mContext.CommandPool)
+        {
+            mDispatchTable.destroyCommandPool(mContext.CommandPool, nullptr);
+            mContext.CommandPool = nullptr;
+        }
+        if(!!mContext.TransferCommandPool)
+        {
+            mDispatchTable.destroyCommandPool(mContext.TransferCommandPool, nullptr);
+            mContext.TransferCommandPool = nullptr;
+        }
+        if(!!mDevice.device)
+        {
+            vkb::destroy_device(mDevice);
+            mDevice = vkb::Device();
+        }
+        if(!!mInstance.instance)
+        {
+            vkb::destroy_instance(mInstance);
+            mInstance = vkb::Instance();
+        }
+        mContext                  = core::Context();
+        mHasDescriptorBuffer      = false;
+        mHasAccelerationStructure = false;
+        mHasRayQuery              = false;
+    }
+}  // namespace foray::test
@@ -0,0 +1,138 @@
+#include "../src/core/foray_bindlessheap.hpp"
+#include "../src/core/foray_managedimage.hpp"
+#include "../src/core/foray_samplercollection.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/globalcomponents/foray_texturemanager.hpp"
+#include "foray_testdevice.hpp"
+#include <cstring>
+#include <spdlog/fmt/fmt.h>
+
+using namespace foray;
+
+/// @brief Exposes the bindless table contents
+class TestTextures : public scene::gcomp::TextureManager
+{
+  public:
+    std::vector<uint32_t> ReadTable()
+    {
+        std::vector<uint32_t> table(mBindlessTable->GetSize() / sizeof(uint32_t));
+        void*                 data = nullptr;
+        mBindlessTable->Map(data);
+        std::memcpy(table.data(), data, table.size() * sizeof(uint32_t));
+        mBindlessTable->Unmap();
+        return table;
+    }
+};
+
+/// @brief Prepares texture texId with a small image and a default sampler
+void Load(core::Context* context, TestTextures& textures, int32_t texId)
+{
+    scene::gcomp::TextureManager::Texture& texture = textures.PrepareTexture(texId);
+    texture.GetImage().Create(context, VK_IMAGE_USAGE_SAMPLED_BIT, VK_FORMAT_R8G8B8A8_UNORM, VkExtent2D{4, 4}, fmt::format("Texture {}", texId));
+    VkSamplerCreateInfo samplerCi{
+        .sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter    = VK_FILTER_LINEAR,
+        .minFilter    = VK_FILTER_LINEAR,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .maxLod       = VK_LOD_CLAMP_NONE,
+    };
+    texture.GetSampler().Init(context, samplerCi);
+}
+
+uint32_t IndexOf(TestTextures& textures, int32_t texId)
+{
+    return textures.GetTextures().at(texId).GetBindlessIndex();
+}
+
+/// @brief Loading and unloading textures keeps the heap indices of live textures, reuses freed indices last and redirects removed ids to the fallback texture
+void TestLoadUnload(core::Context* context, core::BindlessHeap& heap)
+{
+    scene::Scene  scene(context);
+    TestTextures& textures = *scene.MakeComponent<TestTextures>();
+
+    for(int32_t texId = 0; texId < 3; texId++)
+    {
+        Load(context, textures, texId);
+    }
+    textures.RegisterBindless();
+    FORAY_CHECK(heap.GetRegisteredImageCount() == 3);
+    for(int32_t texId = 0; texId < 3; texId++)
+    {
+        FORAY_CHECK(IndexOf(textures, texId) == (uint32_t)texId);
+    }
+    FORAY_CHECK(textures.GetBindlessTableVersion() == 1);
+    std::vector<uint32_t> table = textures.ReadTable();
+    FORAY_CHECK(table.size() == 64);
+    FORAY_CHECK(table[0] == 0 && table[1] == 1 && table[2] == 2);
+    // Unused ids map to the fallback (lowest texture id)
+    FORAY_CHECK(table[3] == 0 && table[63] == 0);
+
+    // Without Context::Timeline the texture is unregistered immediately
+    textures.RemoveTexture(1);
+    FORAY_CHECK(!textures.GetTextures().contains(1));
+    FORAY_CHECK(heap.GetRegisteredImageCount() == 2);
+    FORAY_CHECK(textures.ReadTable()[1] == IndexOf(textures, 0));
+
+    // The heap holds 4 images. The never used index 3 is handed out before the freed index 1
+    Load(context, textures, 3);
+    textures.RegisterBindless();
+    FORAY_CHECK(IndexOf(textures, 3) == 3);
+    Load(context, textures, 4);
+    textures.RegisterBindless();
+    FORAY_CHECK(IndexOf(textures, 4) == 1);
+    FORAY_CHECK(IndexOf(textures, 0) == 0 && IndexOf(textures, 2) == 2);
+    table = textures.ReadTable();
+    FORAY_CHECK(table[0] == 0 && table[1] == 0 && table[2] == 2 && table[3] == 3 && table[4] == 1);
+
+    // Removing the fallback texture redirects to the next lowest id
+    textures.RemoveTexture(0);
+    table = textures.ReadTable();
+    FORAY_CHECK(table[0] == 2 && table[1] == 2 && table[2] == 2);
+    FORAY_CHECK(textures.GetBindlessTableVersion() == 1);
+
+    // An id beyond the table grows it. Stages notice via the version
+    Load(context, textures, 100);
+    textures.RegisterBindless();
+    FORAY_CHECK(IndexOf(textures, 100) == 0);
+    FORAY_CHECK(textures.GetBindlessTableVersion() == 2);
+    table = textures.ReadTable();
+    FORAY_CHECK(table.size() == 128);
+    FORAY_CHECK(table[100] == 0 && table[3] == 3 && table[4] == 1 && table[99] == 2);
+
+    textures.Destroy();
+    FORAY_CHECK(heap.GetRegisteredImageCount() == 0);
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create())
+    {
+        return test::SKIPPED;
+    }
+    const VkPhysicalDeviceVulkan12Features& features = device.GetVulkan12Features();
+    if(features.descriptorBindingPartiallyBound != VK_TRUE || features.descriptorBindingSampledImageUpdateAfterBind != VK_TRUE
+       || features.descriptorBindingStorageBufferUpdateAfterBind != VK_TRUE || features.descriptorBindingUpdateUnusedWhilePending != VK_TRUE)
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context = device.GetContext();
+
+    core::SamplerCollection samplers;
+    samplers.Init(&context);
+    context.SamplerCol = &samplers;
+    core::BindlessHeap heap;
+    heap.Create(&context, 4, 16);
+    context.Bindless = &heap;
+
+    TestLoadUnload(&context, heap);
+
+    context.Bindless = nullptr;
+    heap.Destroy();
+    context.SamplerCol = nullptr;
+    samplers.Destroy();
+    device.Destroy();
+    return test::Result();
+}
@@ -0,0 +1,86 @@
+#include "../src/core/foray_context.hpp"
+#include "foray_test.hpp"
+
+using namespace foray;
+
+template <typename THandle>
+THandle FakeHandle(uintptr_t value)
+{
+    return reinterpret_cast<THandle>(value);
+}
+
+/// @brief Main queue setup as written by VulkanDevice and DefaultAppBase
+core::Context MakeMainContext()
+{
+    core::Context context;
+    context.Queue            = FakeHandle<VkQueue>(0x10);
+    context.QueueFamilyIndex = 0;
+    context.CommandPool      = FakeHandle<VkCommandPool>(0x20);
+    return context;
+}
+
+void CheckFallsBackToMainQueue(const core::Context& context)
+{
+    FORAY_CHECK(!context.HasDedicatedTransferQueue());
+    core::Context transfer = context.GetTransferContext();
+    FORAY_CHECK(transfer.Queue == context.Queue);
+    FORAY_CHECK(transfer.QueueFamilyIndex == context.QueueFamilyIndex);
+    FORAY_CHECK(transfer.CommandPool == context.CommandPool);
+}
+
+int main()
+{
+    // No dedicated transfer queue family (e.g. lavapipe): VulkanDevice::SelectQueues leaves the transfer fields unset
+    core::Context noTransferQueue = MakeMainContext();
+    CheckFallsBackToMainQueue(noTransferQueue);
+
+    // Transfer queue of the main family, or without a command pool, is not dedicated
+    core::Context sameFamily            = MakeMainContext();
+    sameFamily.TransferQueue            = FakeHandle<VkQueue>(0x11);
+    sameFamily.TransferQueueFamilyIndex = 0;
+    sameFamily.TransferCommandPool      = FakeHandle<VkCommandPool>(0x21);
+    CheckFallsBackToMainQueue(sameFamily);
+
+    core::Context noPool            = MakeMainContext();
+    noPool.TransferQueue            = FakeHandle<VkQueue>(0x11);
+    noPool.TransferQueueFamilyIndex = 1;
+    CheckFallsBackToMainQueue(noPool);
+
+    // Dedicated transfer queue
+    core::Context dedicated            = MakeMainContext();
+    dedicated.TransferQueue            = FakeHandle<VkQueue>(0x11);
+    dedicated.TransferQueueFamilyIndex = 1;
+    dedicated.TransferCommandPool      = FakeHandle<VkCommandPool>(0x21);
+    FORAY_CHECK(dedicated.HasDedicatedTransferQueue());
+    core::Context transfer = dedicated.GetTransferContext();
+    FORAY_CHECK(transfer.Queue == dedicated.TransferQueue);
+    FORAY_CHECK(transfer.QueueFamilyIndex == 1);
+    FORAY_CHECK(transfer.CommandPool == dedicated.TransferCommandPool);
+    FORAY_CHECK(dedicated.Queue == FakeHandle<VkQueue>(0x10));
+
+    // Async compute queue: Same fallback rules
+    core::Context noComputeQueue = MakeMainContext();
+    FORAY_CHECK(!noComputeQueue.HasAsyncComputeQueue());
+    FORAY_CHECK(noComputeQueue.GetComputeContext().Queue == noComputeQueue.Queue);
+    FORAY_CHECK(noComputeQueue.GetComputeContext().CommandPool == noComputeQueue.CommandPool);
+
+    core::Context computeSameFamily           = MakeMainContext();
+    computeSameFamily.ComputeQueue            = FakeHandle<VkQueue>(0x12);
+    computeSameFamily.ComputeQueueFamilyIndex = 0;
+    computeSameFamily.ComputeCommandPool      = FakeHandle<VkCommandPool>(0x22);
+    FORAY_CHECK(!computeSameFamily.HasAsyncComputeQueue());
+    FORAY_CHECK(computeSameFamily.GetComputeContext().Queue == computeSameFamily.Queue);
+
+    core::Context asyncCompute           = MakeMainContext();
+    asyncCompute.ComputeQueue            = FakeHandle<VkQueue>(0x12);
+    asyncCompute.ComputeQueueFamilyIndex = 2;
+    asyncCompute.ComputeCommandPool      = FakeHandle<VkCommandPool>(0x22);
+    FORAY_CHECK(asyncCompute.HasAsyncComputeQueue());
+    FORAY_CHECK(!asyncCompute.HasDedicatedTransferQueue());
+    core::Context compute = asyncCompute.GetComputeContext();
+    FORAY_CHECK(compute.Queue == asyncCompute.ComputeQueue);
+    FORAY_CHECK(compute.QueueFamilyIndex == 2);
+    FORAY_CHECK(compute.CommandPool == asyncCompute.ComputeCommandPool);
+
+    return test::Result();
+}
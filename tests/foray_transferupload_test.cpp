@@ -0,0 +1,113 @@
+#include "../src/core/foray_managedbuffer.hpp"
+#include "../src/core/foray_managedimage.hpp"
+#include "foray_testcompute.hpp"
+#include "foray_testdevice.hpp"
+#include <cstring>
+
+using namespace foray;
+
+/// @brief Counts vkWaitForFences calls made through the dispatch table
+uint32_t            gFenceWaits    = 0;
+PFN_vkWaitForFences gWaitForFences = nullptr;
+
+VKAPI_ATTR VkResult VKAPI_CALL CountingWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll, uint64_t timeout)
+{
+    gFenceWaits++;
+    return gWaitForFences(device, fenceCount, pFences, waitAll, timeout);
+}
+
+std::vector<uint8_t> MakeData(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> data(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        data[i] = (uint8_t)(i * 31 + seed);
+    }
+    return data;
+}
+
+/// @brief Records a copy into a host visible buffer of size bytes and returns its contents
+std::vector<uint8_t> ReadBack(core::Context* context, VkDeviceSize size, const std::function<void(VkCommandBuffer, VkBuffer)>& recordCopy)
+{
+    core::ManagedBuffer readback;
+    readback.Create(context, VK_BUFFER_USAGE_TRANSFER_DST_BIT, size, VMA_MEMORY_USAGE_AUTO_PREFER_HOST, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+    test::SubmitAndWait(context, [&](VkCommandBuffer cmdBuffer) { recordCopy(cmdBuffer, readback.GetBuffer()); });
+    std::vector<uint8_t> result(size);
+    void*                mapped = nullptr;
+    readback.Map(mapped);
+    vmaInvalidateAllocation(context->Allocator, readback.GetAllocation(), 0, VK_WHOLE_SIZE);
+    memcpy(result.data(), mapped, size);
+    readback.Unmap();
+    return result;
+}
+
+/// @brief Device local writes of buffers (with offset) and images arrive intact, with the host blocking exactly once per write.
+/// Via the transfer queue, the acquire submission waits for the copy on the device instead of the host waiting for both.
+void TestWrites(core::Context* context)
+{
+    const VkDeviceSize bufferSize = 64 * 1024;
+    const VkDeviceSize offset     = 1024;
+    const VkExtent2D   extent{64, 64};
+
+    std::vector<uint8_t> bufferData = MakeData(bufferSize - offset, 7);
+    core::ManagedBuffer  buffer;
+    buffer.Create(context, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, bufferSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, {}, "Upload Buffer");
+    gFenceWaits = 0;
+    buffer.WriteDataDeviceLocal(bufferData.data(), bufferData.size(), offset);
+    FORAY_CHECK(gFenceWaits == 1);
+
+    std::vector<uint8_t> readBuffer = ReadBack(context, bufferData.size(), [&](VkCommandBuffer cmdBuffer, VkBuffer readback) {
+        VkBufferCopy copy{.srcOffset = offset, .dstOffset = 0, .size = bufferData.size()};
+        vkCmdCopyBuffer(cmdBuffer, buffer.GetBuffer(), readback, 1U, &copy);
+    });
+    FORAY_CHECK(readBuffer == bufferData);
+
+    std::vector<uint8_t> imageData = MakeData(extent.width * extent.height * 4, 3);
+    core::ManagedImage   image;
+    image.Create(context, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_FORMAT_R8G8B8A8_UNORM, extent, "Upload Image");
+    gFenceWaits = 0;
+    image.WriteDeviceLocalData(imageData.data(), imageData.size(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    FORAY_CHECK(gFenceWaits == 1);
+
+    std::vector<uint8_t> readImage = ReadBack(context, imageData.size(), [&](VkCommandBuffer cmdBuffer, VkBuffer readback) {
+        VkBufferImageCopy copy{.imageSubresource = VkImageSubresourceLayers{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .layerCount = 1U},
+                               .imageExtent      = VkExtent3D{extent.width, extent.height, 1U}};
+        vkCmdCopyImageToBuffer(cmdBuffer, image.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback, 1U, &copy);
+    });
+    FORAY_CHECK(readImage == imageData);
+
+    image.Destroy();
+    buffer.Destroy();
+}
+
+int main()
+{
+    test::TestDevice device;
+    if(!device.Create())
+    {
+        return test::SKIPPED;
+    }
+    core::Context& context                       = device.GetContext();
+    gWaitForFences                               = context.VkbDispatchTable->fp_vkWaitForFences;
+    context.VkbDispatchTable->fp_vkWaitForFences = &CountingWaitForFences;
+
+    // Fallback: Without a dedicated transfer queue, writes use the main queue
+    FORAY_CHECK(!context.HasDedicatedTransferQueue());
+    TestWrites(&context);
+
+    // Ownership transfer path, if the device has a second queue family supporting transfers (lavapipe does not)
+    bool hasTransferQueue = device.SelectTransferQueue();
+    if(hasTransferQueue)
+    {
+        FORAY_CHECK(context.HasDedicatedTransferQueue());
+        TestWrites(&context);
+    }
+    else
+    {
+        std::printf("No dedicated transfer queue family, ownership transfer path not tested\n");
+    }
+
+    context.VkbDispatchTable->fp_vkWaitForFences = gWaitForFences;
+    device.Destroy();
+    return test::Result();
+}
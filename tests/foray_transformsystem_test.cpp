@@ -0,0 +1,159 @@
+#include "../src/base/foray_framerenderinfo.hpp"
+#include "../src/scene/components/foray_transform.hpp"
+#include "../src/scene/foray_node.hpp"
+#include "../src/scene/foray_scene.hpp"
+#include "../src/scene/foray_scenedrawing.hpp"
+#include "../src/scene/globalcomponents/foray_transformsystem.hpp"
+#include "foray_test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace foray;
+
+/// @brief Two host only scenes receiving identical edits. Scene A is updated by the TransformSystem, scene B uses the recursive Transform::GetGlobalMatrix() path
+struct ScenePair
+{
+    scene::Scene               A{nullptr};
+    scene::Scene               B{nullptr};
+    std::vector<scene::Node*> NodesA;
+    std::vector<scene::Node*> NodesB;
+
+    void MakeNode(int32_t parent)
+    {
+        NodesA.push_back(A.MakeNode(parent >= 0 ? NodesA[parent] : nullptr));
+        NodesB.push_back(B.MakeNode(parent >= 0 ? NodesB[parent] : nullptr));
+    }
+    void SetTrs(size_t node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        for(scene::Node* n : {NodesA[node], NodesB[node]})
+        {
+            n->GetTransform()->SetTranslation(translation);
+            n->GetTransform()->SetRotation(rotation);
+            n->GetTransform()->SetScale(scale);
+        }
+    }
+    void SetParent(size_t node, int32_t parent)
+    {
+        NodesA[node]->SetParent(parent >= 0 ? NodesA[parent] : nullptr);
+        NodesB[node]->SetParent(parent >= 0 ? NodesB[parent] : nullptr);
+    }
+};
+
+bool IsSelfOrDescendant(scene::Node* node, scene::Node* candidate)
+{
+    for(scene::Node* ancestor = candidate; !!ancestor; ancestor = ancestor->GetParent())
+    {
+        if(ancestor == node)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NearlyEqual(const glm::mat4& a, const glm::mat4& b)
+{
+    for(int32_t col = 0; col < 4; col++)
+    {
+        for(int32_t row = 0; row < 4; row++)
+        {
+            if(std::abs(a[col][row] - b[col][row]) > 1e-3f * std::max(1.f, std::abs(b[col][row])))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Random node creation, TRS edits and reparenting. After every round the system output must match the recursive path
+void TestRandomEdits()
+{
+    ScenePair                             scenes;
+    scene::gcomp::TransformSystem*        system = scenes.A.GetComponent<scene::gcomp::TransformSystem>();
+    std::mt19937                          rng(1234);
+    std::uniform_real_distribution<float> unit(-1.f, 1.f);
+    std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+
+    for(int32_t i = 0; i < 8; i++)
+    {
+        scenes.MakeNode(-1);
+    }
+    system->InitOrUpdate();
+
+    base::FrameRenderInfo  renderInfo;
+    scene::SceneUpdateInfo updateInfo(renderInfo, (VkCommandBuffer) nullptr);
+
+    for(int32_t round = 0; round < 200; round++)
+    {
+        int32_t edits = std::uniform_int_distribution<int32_t>(1, 8)(rng);
+        for(int32_t edit = 0; edit < edits; edit++)
+        {
+            size_t  count = scenes.NodesA.size();
+            size_t  node  = std::uniform_int_distribution<size_t>(0, count - 1)(rng);
+            int32_t other = std::uniform_int_distribution<int32_t>(-1, (int32_t)count - 1)(rng);
+            switch(std::uniform_int_distribution<int32_t>(0, 2)(rng))
+            {
+                case 0:
+                    if(count < 256)
+                    {
+                        scenes.MakeNode(other);
+                    }
+                    break;
+                case 1:
+                    scenes.SetTrs(node, glm::vec3(unit(rng), unit(rng), unit(rng)) * 10.f,
+                                  glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)) + glm::quat(0.01f, 0.f, 0.f, 0.f)),
+                                  glm::vec3(scale(rng), scale(rng), scale(rng)));
+                    break;
+                case 2:
+                    if(other < 0 || !IsSelfOrDescendant(scenes.NodesA[node], scenes.NodesA[other]))
+                    {
+                        scenes.SetParent(node, other);
+                    }
+                    break;
+            }
+        }
+
+        system->Update(updateInfo);
+        FORAY_CHECK(system->GetCount() == scenes.NodesA.size());
+
+        for(size_t i = 0; i < scenes.NodesA.size(); i++)
+        {
+            scene::ncomp::Transform* transformA = scenes.NodesA[i]->GetTransform();
+            FORAY_CHECK(!transformA->GetDirty());
+            FORAY_CHECK(NearlyEqual(transformA->GetGlobalMatrix(), scenes.NodesB[i]->GetTransform()->GetGlobalMatrix()));
+        }
+    }
+}
+
+/// @brief Reparenting keeps the children and root node lists consistent
+void TestReparentLists()
+{
+    scene::Scene scene(nullptr);
+    scene::Node* a = scene.MakeNode();
+    scene::Node* b = scene.MakeNode();
+    scene::Node* c = scene.MakeNode(a);
+
+    uint64_t version = scene.GetHierarchyVersion();
+    c->SetParent(b);
+    FORAY_CHECK(scene.GetHierarchyVersion() != version);
+    FORAY_CHECK(c->GetParent() == b);
+    FORAY_CHECK(a->GetChildren().empty());
+    FORAY_CHECK(b->GetChildren().size() == 1 && b->GetChildren()[0] == c);
+
+    c->SetParent(nullptr);
+    FORAY_CHECK(b->GetChildren().empty());
+    FORAY_CHECK(scene.GetRootNodes().size() == 3);
+
+    a->SetParent(c);
+    FORAY_CHECK(scene.GetRootNodes().size() == 2);
+    FORAY_CHECK(c->GetChildren().size() == 1 && c->GetChildren()[0] == a);
+}
+
+int main()
+{
+    TestReparentLists();
+    TestRandomEdits();
+    return test::Result();
+}
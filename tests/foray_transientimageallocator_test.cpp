@@ -0,0 +1,127 @@
+#include "../src/core/foray_transientimageallocator.hpp"
+#include "foray_test.hpp"
+#include <random>
+
+using namespace foray;
+using Allocator = core::TransientImageAllocator;
+using Lifetime  = Allocator::Lifetime;
+using Request   = Allocator::Request;
+using Block     = Allocator::Block;
+
+Lifetime Life(uint32_t firstUse, uint32_t lastUse)
+{
+    return Lifetime{.FirstUse = firstUse, .LastUse = lastUse};
+}
+
+/// @brief Checks the invariants of an assignment: every request is member of exactly its assigned block, blocks fit all members,
+/// share a memory type with them and never hold members with overlapping lifetimes
+void CheckAssignment(const std::vector<Request>& requests, const std::vector<uint32_t>& assignment, const std::vector<Block>& blocks)
+{
+    FORAY_CHECK(assignment.size() == requests.size());
+    std::vector<uint32_t> membership(requests.size(), 0);
+    for(uint32_t blockIndex = 0; blockIndex < blocks.size(); blockIndex++)
+    {
+        const Block& block = blocks[blockIndex];
+        FORAY_CHECK(!block.Members.empty());
+        FORAY_CHECK(block.MemoryTypeBits != 0);
+        for(size_t i = 0; i < block.Members.size(); i++)
+        {
+            const Request& member = requests[block.Members[i]];
+            membership[block.Members[i]]++;
+            FORAY_CHECK(assignment[block.Members[i]] == blockIndex);
+            FORAY_CHECK(member.Size <= block.Size);
+            FORAY_CHECK(block.Alignment % member.Alignment == 0);
+            FORAY_CHECK((block.MemoryTypeBits & member.MemoryTypeBits) == block.MemoryTypeBits);
+            for(size_t j = i + 1; j < block.Members.size(); j++)
+            {
+                FORAY_CHECK(!member.Life.Overlaps(requests[block.Members[j]].Life));
+            }
+        }
+    }
+    for(uint32_t count : membership)
+    {
+        FORAY_CHECK(count == 1);
+    }
+}
+
+/// @brief Inclusive lifetimes touching at a single pass overlap, the default lifetime overlaps everything
+void TestOverlaps()
+{
+    FORAY_CHECK(Life(0, 2).Overlaps(Life(2, 3)));
+    FORAY_CHECK(!Life(0, 1).Overlaps(Life(2, 3)));
+    FORAY_CHECK(!Life(4, 4).Overlaps(Life(2, 3)));
+    FORAY_CHECK(Lifetime{}.Overlaps(Life(7, 7)));
+}
+
+/// @brief A chain of passes handing images on shares two blocks, images alive for the whole frame get one each
+void TestChain()
+{
+    std::vector<Request> requests;
+    for(uint32_t pass = 0; pass < 6; pass++)
+    {
+        // Written in pass, read in pass + 1
+        requests.push_back(Request{.Size = 1024, .Alignment = 256, .Life = Life(pass, pass + 1)});
+    }
+    requests.push_back(Request{.Size = 512, .Alignment = 256});
+    requests.push_back(Request{.Size = 512, .Alignment = 256});
+
+    std::vector<Block>    blocks;
+    std::vector<uint32_t> assignment = Allocator::AssignBlocks(requests, blocks);
+    CheckAssignment(requests, assignment, blocks);
+    FORAY_CHECK(blocks.size() == 4);
+    FORAY_CHECK(assignment[6] != assignment[7]);
+}
+
+/// @brief Requests without a common memory type never share a block
+void TestMemoryTypes()
+{
+    std::vector<Request> requests{
+        Request{.Size = 64, .MemoryTypeBits = 0b01, .Life = Life(0, 0)},
+        Request{.Size = 64, .MemoryTypeBits = 0b10, .Life = Life(1, 1)},
+        Request{.Size = 64, .MemoryTypeBits = 0b11, .Life = Life(2, 2)},
+    };
+    std::vector<Block>    blocks;
+    std::vector<uint32_t> assignment = Allocator::AssignBlocks(requests, blocks);
+    CheckAssignment(requests, assignment, blocks);
+    FORAY_CHECK(blocks.size() == 2);
+    FORAY_CHECK(assignment[0] != assignment[1]);
+}
+
+/// @brief Random requests never place overlapping lifetimes in the same block
+void TestRandomRequests()
+{
+    std::mt19937                            rng(24);
+    std::uniform_int_distribution<uint32_t> pass(0, 15);
+    std::uniform_int_distribution<uint32_t> length(0, 4);
+    std::uniform_int_distribution<uint32_t> size(1, 64);
+    std::uniform_int_distribution<uint32_t> alignmentShift(0, 4);
+    std::uniform_int_distribution<uint32_t> memoryTypes(1, 7);
+
+    for(int32_t round = 0; round < 200; round++)
+    {
+        std::vector<Request> requests(std::uniform_int_distribution<size_t>(0, 40)(rng));
+        for(Request& request : requests)
+        {
+            uint32_t firstUse      = pass(rng);
+            request.Size           = size(rng) * 1024;
+            request.Alignment      = 256ULL << alignmentShift(rng);
+            request.MemoryTypeBits = memoryTypes(rng);
+            // Some images live for the entire frame
+            request.Life           = length(rng) == 0 ? Lifetime{} : Life(firstUse, firstUse + length(rng));
+        }
+
+        std::vector<Block>    blocks;
+        std::vector<uint32_t> assignment = Allocator::AssignBlocks(requests, blocks);
+        CheckAssignment(requests, assignment, blocks);
+        FORAY_CHECK(blocks.size() <= requests.size());
+    }
+}
+
+int main()
+{
+    TestOverlaps();
+    TestChain();
+    TestMemoryTypes();
+    TestRandomRequests();
+    return test::Result();
+}
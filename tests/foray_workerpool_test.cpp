@@ -0,0 +1,84 @@
+#include "../src/util/foray_workerpool.hpp"
+#include "foray_test.hpp"
+#include <chrono>
+#include <stdexcept>
+
+using namespace foray;
+
+/// @brief Every index is processed exactly once, and all invocations have finished when ParallelFor() returns
+void CheckLoop(util::WorkerPool& pool, size_t count, std::chrono::microseconds work = {})
+{
+    std::vector<std::atomic<uint32_t>> hits(count);
+    pool.ParallelFor(count, [&](size_t index) {
+        std::this_thread::sleep_for(work);
+        hits[index]++;
+    });
+    for(size_t i = 0; i < count; i++)
+    {
+        FORAY_CHECK(hits[i] == 1);
+    }
+}
+
+void TestLoops()
+{
+    util::WorkerPool pool;
+    pool.Create(4);
+    FORAY_CHECK(pool.GetThreadCount() == 4);
+    for(size_t count : {0, 1, 2, 3, 100, 10000})
+    {
+        CheckLoop(pool, count);
+    }
+}
+
+/// @brief Recreating the pool must not let new workers mistake the previous loop for a pending one
+void TestRecreate()
+{
+    util::WorkerPool pool;
+    for(int32_t round = 0; round < 20; round++)
+    {
+        pool.Create(3);
+        for(int32_t loop = 0; loop < 10; loop++)
+        {
+            // Loop starts right after Create(), while the new workers are still starting up
+            CheckLoop(pool, 64, std::chrono::microseconds(50));
+        }
+        pool.Destroy();
+        FORAY_CHECK(!pool.Exists());
+    }
+    // Create() without a Destroy() in between
+    pool.Create(2);
+    CheckLoop(pool, 64);
+    pool.Create(5);
+    CheckLoop(pool, 64);
+}
+
+void TestException()
+{
+    util::WorkerPool pool;
+    pool.Create(3);
+    bool thrown = false;
+    try
+    {
+        pool.ParallelFor(1000, [](size_t index) {
+            if(index == 500)
+            {
+                throw std::runtime_error("test");
+            }
+        });
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    FORAY_CHECK(thrown);
+    // The pool stays usable
+    CheckLoop(pool, 1000);
+}
+
+int main()
+{
+    TestLoops();
+    TestRecreate();
+    TestException();
+    return test::Result();
+}